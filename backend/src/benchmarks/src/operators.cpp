@@ -0,0 +1,1045 @@
+/**
+ * Micro-benchmarks of the operator templates used by the generated code.
+ *
+ * The operators are instantiated on hand-written tuple types (playing the role
+ * of the types emitted by the code generator) and fed with synthetic data
+ * from an in-memory source. Every benchmark is run for a sweep of parameters
+ * (key cardinality, skew, tuple width, number of threads) and the results are
+ * written as JSON such that runs before and after a change can be compared.
+ */
+
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <regex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/program_options.hpp>
+#include <nlohmann/json.hpp>
+#include <omp.h>
+
+#include "Utils.h"
+#include "runtime/jit/memory/shared_pointer.hpp"
+#include "runtime/jit/operators/optional.hpp"
+
+// Tuple types. These mimic the structs emitted by the code generator, so
+// std::tuple signatures need to be unique per struct.
+
+struct Long1 {
+    long v0;
+};
+
+struct Long2 {
+    long v0;
+    long v1;
+};
+
+struct Long3 {
+    long v0;
+    long v1;
+    long v2;
+};
+
+struct Long4 {
+    long v0;
+    long v1;
+    long v2;
+    long v3;
+};
+
+struct Long7 {
+    long v0;
+    long v1;
+    long v2;
+    long v3;
+    long v4;
+    long v5;
+    long v6;
+};
+
+struct Long8 {
+    long v0;
+    long v1;
+    long v2;
+    long v3;
+    long v4;
+    long v5;
+    long v6;
+    long v7;
+};
+
+template <class InnerTuple>
+struct Array {
+    runtime::memory::SharedPointer<InnerTuple> data;
+    size_t outer_shape[1];
+    size_t offsets[1];
+    size_t shape[1];
+};
+
+template <class InnerTuple>
+struct Group {
+    long v0;
+    Array<InnerTuple> v1;
+};
+
+struct Columns2 {
+    Array<Long1> v0;
+    Array<Long1> v1;
+};
+
+template <class InnerTuple>
+struct HashIndex {
+    Array<Long1> v0;
+    Array<InnerTuple> v1;
+};
+
+template <>
+auto INLINE TupleToStdTuple<Long1>(const Long1 &t) {
+    return std::make_tuple(t.v0);
+}
+
+template <>
+auto INLINE TupleToStdTuple<Long2>(const Long2 &t) {
+    return std::make_tuple(t.v0, t.v1);
+}
+
+template <>
+auto INLINE TupleToStdTuple<Long3>(const Long3 &t) {
+    return std::make_tuple(t.v0, t.v1, t.v2);
+}
+
+template <>
+auto INLINE TupleToStdTuple<Long4>(const Long4 &t) {
+    return std::make_tuple(t.v0, t.v1, t.v2, t.v3);
+}
+
+template <>
+auto INLINE TupleToStdTuple<Long7>(const Long7 &t) {
+    return std::make_tuple(t.v0, t.v1, t.v2, t.v3, t.v4, t.v5, t.v6);
+}
+
+template <>
+auto INLINE TupleToStdTuple<Long8>(const Long8 &t) {
+    return std::make_tuple(t.v0, t.v1, t.v2, t.v3, t.v4, t.v5, t.v6, t.v7);
+}
+
+template <>
+auto INLINE TupleToStdTuple<Columns2>(const Columns2 &t) {
+    return std::make_tuple(t.v0, t.v1);
+}
+
+template <>
+auto INLINE StdTupleToTuple<std::tuple<long>>(const std::tuple<long> &t) {
+    return Long1{std::get<0>(t)};
+}
+
+template <>
+auto INLINE StdTupleToTuple<std::tuple<long, long>>(
+        const std::tuple<long, long> &t) {
+    return Long2{std::get<0>(t), std::get<1>(t)};
+}
+
+template <>
+auto INLINE StdTupleToTuple<std::tuple<long, long, long>>(
+        const std::tuple<long, long, long> &t) {
+    return Long3{std::get<0>(t), std::get<1>(t), std::get<2>(t)};
+}
+
+template <>
+auto INLINE StdTupleToTuple<std::tuple<long, long, long, long>>(
+        const std::tuple<long, long, long, long> &t) {
+    return Long4{std::get<0>(t), std::get<1>(t), std::get<2>(t),
+                 std::get<3>(t)};
+}
+
+template <>
+auto INLINE StdTupleToTuple<std::tuple<long, long, long, long, long, long, long>>(
+        const std::tuple<long, long, long, long, long, long, long> &t) {
+    return Long7{std::get<0>(t), std::get<1>(t), std::get<2>(t),
+                 std::get<3>(t), std::get<4>(t), std::get<5>(t),
+                 std::get<6>(t)};
+}
+
+template <>
+auto INLINE
+StdTupleToTuple<std::tuple<long, long, long, long, long, long, long, long>>(
+        const std::tuple<long, long, long, long, long, long, long, long> &t) {
+    return Long8{std::get<0>(t), std::get<1>(t), std::get<2>(t),
+                 std::get<3>(t), std::get<4>(t), std::get<5>(t),
+                 std::get<6>(t), std::get<7>(t)};
+}
+
+template <>
+auto INLINE StdTupleToTuple<std::tuple<Array<Long1>, Array<Long1>>>(
+        const std::tuple<Array<Long1>, Array<Long1>> &t) {
+    return Columns2{std::get<0>(t), std::get<1>(t)};
+}
+
+// Operators under test. They have to be included after the conversion
+// functions of the tuple types above have been specialized.
+#include "ApproxCountDistinctOperator.h"
+#include "BloomFilterOperator.h"
+#include "ColumnScanOperator.h"
+#include "DistinctOperator.h"
+#include "FilterOperator.h"
+#include "GroupByOperator.h"
+#include "HashIndexOperator.h"
+#include "JoinOperator.h"
+#include "MapOperator.h"
+#include "MaterializeColumnChunksOperator.h"
+#include "MergeJoinOperator.h"
+#include "PartitionOperator.h"
+#include "ReduceByIndexOperator.h"
+#include "ReduceByKeyOperator.h"
+#include "SortOperator.h"
+#include "SortedDistinctOperator.h"
+#include "TopKOperator.h"
+#include "WindowGroupedOperator.h"
+#include "WindowOperator.h"
+
+namespace po = boost::program_options;
+
+namespace {
+
+// Produces the tuples of a vector, which is shared across repetitions. Like
+// the scan operators, it can push its tuples to the consumer.
+template <class Tuple>
+class VectorSource {
+public:
+    explicit VectorSource(const std::vector<Tuple> *const tuples)
+        : tuples_(tuples) {}
+
+    INLINE void open() { pos_ = 0; }
+
+    INLINE Optional<Tuple> next() {
+        if (pos_ >= tuples_->size()) return {};
+        return (*tuples_)[pos_++];
+    }
+
+    template <class Consumer>
+    INLINE void ForEach(Consumer &&consume) {
+        const size_t end = tuples_->size();
+        for (size_t i = pos_; i < end; i++) {
+            consume((*tuples_)[i]);
+        }
+        pos_ = end;
+    }
+
+    INLINE void close() {}
+
+private:
+    const std::vector<Tuple> *const tuples_;
+    size_t pos_ = 0;
+};
+
+// Produces a single tuple, used as configuration upstream
+template <class Tuple>
+class SingleTupleSource {
+public:
+    explicit SingleTupleSource(const Tuple &tuple) : tuple_(tuple) {}
+
+    INLINE void open() { is_consumed_ = false; }
+
+    INLINE Optional<Tuple> next() {
+        if (is_consumed_) return {};
+        is_consumed_ = true;
+        return tuple_;
+    }
+
+    INLINE void close() {}
+
+private:
+    const Tuple tuple_;
+    bool is_consumed_ = false;
+};
+
+// Drains the given operator and returns the number of produced tuples
+template <class Operator>
+auto Drain(Operator *const op) -> size_t {
+    size_t num_tuples = 0;
+    op->open();
+    while (auto const ret = op->next()) {
+        num_tuples++;
+    }
+    op->close();
+    return num_tuples;
+}
+
+// Generates keys in [0, cardinality) following a Zipf distribution with the
+// given exponent; an exponent of 0 yields uniformly distributed keys. The
+// ranks are scrambled such that frequent keys are spread over the key range.
+class KeyGenerator {
+public:
+    KeyGenerator(const size_t cardinality, const double skew,
+                 const uint64_t seed)
+        : cardinality_(cardinality), skew_(skew), engine_(seed) {
+        if (skew_ <= 0) return;
+        cdf_.resize(cardinality_);
+        double sum = 0;
+        for (size_t i = 0; i < cardinality_; i++) {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), skew_);
+            cdf_[i] = sum;
+        }
+        for (auto &p : cdf_) p /= sum;
+    }
+
+    auto operator()() -> long {
+        size_t rank;
+        if (skew_ <= 0) {
+            rank = std::uniform_int_distribution<size_t>(
+                    0, cardinality_ - 1)(engine_);
+        } else {
+            const double p = std::uniform_real_distribution<>(0, 1)(engine_);
+            rank = std::min<size_t>(
+                    std::lower_bound(cdf_.begin(), cdf_.end(), p) -
+                            cdf_.begin(),
+                    cardinality_ - 1);
+        }
+        return static_cast<long>(Scramble(rank));
+    }
+
+private:
+    // Bijection on [0, cardinality) mapping consecutive ranks far apart
+    auto Scramble(const size_t rank) const -> size_t {
+        constexpr size_t kPrime = 2654435761UL;
+        if (std::gcd(kPrime, cardinality_) != 1) return rank;
+        return static_cast<size_t>(
+                (static_cast<unsigned __int128>(rank) * kPrime) %
+                cardinality_);
+    }
+
+    const size_t cardinality_;
+    const double skew_;
+    std::mt19937_64 engine_;
+    std::vector<double> cdf_;
+};
+
+// Fills the key (first field) of tuples with generated keys and the remaining
+// fields with their position in the input
+template <class Tuple>
+auto GenerateTuples(const size_t num_tuples, const size_t cardinality,
+                    const double skew, const uint64_t seed)
+        -> std::vector<Tuple> {
+    static_assert(sizeof(Tuple) % sizeof(long) == 0);
+    constexpr size_t kNumFields = sizeof(Tuple) / sizeof(long);
+
+    KeyGenerator generate_key(cardinality, skew, seed);
+    std::vector<Tuple> tuples(num_tuples);
+    for (size_t i = 0; i < num_tuples; i++) {
+        auto *const fields = reinterpret_cast<long *>(&tuples[i]);
+        fields[0] = generate_key();
+        for (size_t j = 1; j < kNumFields; j++) {
+            fields[j] = static_cast<long>(i);
+        }
+    }
+    return tuples;
+}
+
+template <class Tuple>
+auto Sum(const Tuple &lhs, const Tuple &rhs) -> Tuple {
+    static_assert(sizeof(Tuple) % sizeof(long) == 0);
+    constexpr size_t kNumFields = sizeof(Tuple) / sizeof(long);
+
+    Tuple ret;
+    auto *const ret_fields = reinterpret_cast<long *>(&ret);
+    auto const *const lhs_fields = reinterpret_cast<const long *>(&lhs);
+    auto const *const rhs_fields = reinterpret_cast<const long *>(&rhs);
+    for (size_t j = 0; j < kNumFields; j++) {
+        ret_fields[j] = lhs_fields[j] + rhs_fields[j];
+    }
+    return ret;
+}
+
+struct Config {
+    size_t num_tuples;
+    size_t num_repetitions;
+    std::vector<size_t> cardinalities;
+    std::vector<double> skews;
+    std::vector<int> thread_counts;
+};
+
+struct Benchmark {
+    std::string name;
+    nlohmann::json params;
+    size_t num_input_tuples;
+    int num_threads;
+    // Generates the input data (which is thus only held in memory while the
+    // benchmark runs) and returns a function that runs the benchmark once and
+    // returns the number of result tuples
+    std::function<std::function<size_t()>()> prepare;
+};
+
+// Instantiation of one benchmark for all tuple widths
+template <template <class, class> class Registrar>
+void RegisterWidths(const Config &config, std::vector<Benchmark> *benchmarks) {
+    Registrar<Long2, Long1>()(config, benchmarks, 2);
+    Registrar<Long4, Long3>()(config, benchmarks, 4);
+    Registrar<Long8, Long7>()(config, benchmarks, 8);
+}
+
+// Adds a benchmark that is run once per thread count and key distribution
+template <class Setup>
+void RegisterSweep(const Config &config, std::vector<Benchmark> *benchmarks,
+                   const std::string &name, const nlohmann::json &params,
+                   const bool is_parallel, const Setup &setup) {
+    const std::vector<int> serial_thread_counts = {1};
+    auto const &thread_counts =
+            is_parallel ? config.thread_counts : serial_thread_counts;
+    for (auto const cardinality : config.cardinalities) {
+        for (auto const skew : config.skews) {
+            for (auto const num_threads : thread_counts) {
+                auto benchmark_params = params;
+                benchmark_params["cardinality"] = cardinality;
+                benchmark_params["skew"] = skew;
+                benchmarks->push_back(
+                        {name, benchmark_params, config.num_tuples,
+                         num_threads, [setup, cardinality, skew]() {
+                             return std::function<size_t()>(
+                                     setup(cardinality, skew));
+                         }});
+            }
+        }
+    }
+}
+
+template <class Tuple, class ValueType>
+struct RegisterReduceByKey {
+    void operator()(const Config &config, std::vector<Benchmark> *benchmarks,
+                    const size_t width) {
+        RegisterSweep(
+                config, benchmarks, "reduce_by_key", {{"width", width}}, false,
+                [&config](auto const cardinality, auto const skew) {
+                    auto const tuples =
+                            std::make_shared<std::vector<Tuple>>(
+                                    GenerateTuples<Tuple>(config.num_tuples,
+                                                          cardinality, skew,
+                                                          1));
+                    return [tuples]() {
+                        VectorSource<Tuple> source(tuples.get());
+                        auto op = makeReduceByKeyOperator<Tuple, Long1,
+                                                          ValueType, 1>(
+                                &source, Sum<ValueType>);
+                        return Drain(&op);
+                    };
+                });
+
+        RegisterSweep(
+                config, benchmarks, "reduce_by_index", {{"width", width}},
+                false, [&config](auto const cardinality, auto const skew) {
+                    auto const tuples =
+                            std::make_shared<std::vector<Tuple>>(
+                                    GenerateTuples<Tuple>(config.num_tuples,
+                                                          cardinality, skew,
+                                                          1));
+                    return [tuples, cardinality]() {
+                        VectorSource<Tuple> source(tuples.get());
+                        ReduceByIndexOperator<VectorSource<Tuple>, Tuple,
+                                              Long1, ValueType,
+                                              decltype(&Sum<ValueType>)>
+                                op(&source, Sum<ValueType>, 0,
+                                   static_cast<int64_t>(cardinality) - 1);
+                        return Drain(&op);
+                    };
+                });
+    }
+};
+
+template <class Tuple, class ValueType>
+struct RegisterSort {
+    void operator()(const Config &config, std::vector<Benchmark> *benchmarks,
+                    const size_t width) {
+        RegisterSweep(config, benchmarks, "sort", {{"width", width}}, false,
+                      [&config](auto const cardinality, auto const skew) {
+                          auto const tuples =
+                                  std::make_shared<std::vector<Tuple>>(
+                                          GenerateTuples<Tuple>(
+                                                  config.num_tuples,
+                                                  cardinality, skew, 2));
+                          return [tuples]() {
+                              VectorSource<Tuple> source(tuples.get());
+                              auto op = makeSortOperator<Tuple>(&source);
+                              return Drain(&op);
+                          };
+                      });
+
+        for (auto const k : {10, 1000}) {
+            RegisterSweep(
+                    config, benchmarks, "top_k", {{"width", width}, {"k", k}},
+                    false,
+                    [&config, k](auto const cardinality, auto const skew) {
+                        auto const tuples =
+                                std::make_shared<std::vector<Tuple>>(
+                                        GenerateTuples<Tuple>(
+                                                config.num_tuples,
+                                                cardinality, skew, 2));
+                        return [tuples, k]() {
+                            VectorSource<Tuple> source(tuples.get());
+                            auto op = makeTopKOperator<Tuple>(&source, k);
+                            return Drain(&op);
+                        };
+                    });
+        }
+    }
+};
+
+void RegisterJoin(const Config &config, std::vector<Benchmark> *benchmarks) {
+    // The build side has one tuple per key, the probe side follows the key
+    // distribution, so the result has as many tuples as the probe side
+    RegisterSweep(
+            config, benchmarks, "join", {{"width", 2}}, false,
+            [&config](auto const cardinality, auto const skew) {
+                auto const build = std::make_shared<std::vector<Long2>>(
+                        GenerateTuples<Long2>(cardinality, cardinality, 0, 3));
+                for (size_t i = 0; i < build->size(); i++) {
+                    (*build)[i].v0 = static_cast<long>(i);
+                }
+                auto const probe = std::make_shared<std::vector<Long2>>(
+                        GenerateTuples<Long2>(config.num_tuples, cardinality,
+                                              skew, 4));
+                return [build, probe]() {
+                    VectorSource<Long2> build_source(build.get());
+                    VectorSource<Long2> probe_source(probe.get());
+                    auto op = makeJoinOperator<Long3, Long1, Long1, Long1, 1>(
+                            &build_source, &probe_source);
+                    return Drain(&op);
+                };
+            });
+
+    RegisterSweep(
+            config, benchmarks, "join", {{"width", 4}}, false,
+            [&config](auto const cardinality, auto const skew) {
+                auto const build = std::make_shared<std::vector<Long4>>(
+                        GenerateTuples<Long4>(cardinality, cardinality, 0, 3));
+                for (size_t i = 0; i < build->size(); i++) {
+                    (*build)[i].v0 = static_cast<long>(i);
+                }
+                auto const probe = std::make_shared<std::vector<Long4>>(
+                        GenerateTuples<Long4>(config.num_tuples, cardinality,
+                                              skew, 4));
+                return [build, probe]() {
+                    VectorSource<Long4> build_source(build.get());
+                    VectorSource<Long4> probe_source(probe.get());
+                    auto op = makeJoinOperator<Long7, Long1, Long3, Long3, 1>(
+                            &build_source, &probe_source);
+                    return Drain(&op);
+                };
+            });
+
+    // Composite key (v0, v1) where v1 is a function of v0, so the result is
+    // the same as with a single key
+    RegisterSweep(
+            config, benchmarks, "join", {{"width", 3}, {"num_keys", 2}}, false,
+            [&config](auto const cardinality, auto const skew) {
+                auto const build = std::make_shared<std::vector<Long3>>(
+                        GenerateTuples<Long3>(cardinality, cardinality, 0, 3));
+                for (size_t i = 0; i < build->size(); i++) {
+                    (*build)[i].v0 = static_cast<long>(i);
+                    (*build)[i].v1 = static_cast<long>(i % 7);
+                }
+                auto const probe = std::make_shared<std::vector<Long3>>(
+                        GenerateTuples<Long3>(config.num_tuples, cardinality,
+                                              skew, 4));
+                for (auto &tuple : *probe) {
+                    tuple.v1 = tuple.v0 % 7;
+                }
+                return [build, probe]() {
+                    VectorSource<Long3> build_source(build.get());
+                    VectorSource<Long3> probe_source(probe.get());
+                    auto op = makeJoinOperator<Long4, Long2, Long1, Long1, 2>(
+                            &build_source, &probe_source);
+                    return Drain(&op);
+                };
+            });
+
+    // Probe-side filter of a join where every 16th key has a match, spread
+    // over the whole key range such that only the Bloom filter helps
+    RegisterSweep(
+            config, benchmarks, "bloom_filter", {{"width", 2}}, false,
+            [&config](auto const cardinality, auto const skew) {
+                auto const build = std::make_shared<std::vector<Long2>>(
+                        GenerateTuples<Long2>((cardinality + 15) / 16,
+                                              cardinality, 0, 3));
+                for (size_t i = 0; i < build->size(); i++) {
+                    (*build)[i].v0 = static_cast<long>(i * 16);
+                }
+                auto const probe = std::make_shared<std::vector<Long2>>(
+                        GenerateTuples<Long2>(config.num_tuples, cardinality,
+                                              skew, 4));
+                return [build, probe]() {
+                    VectorSource<Long2> build_source(build.get());
+                    VectorSource<Long2> probe_source(probe.get());
+                    auto op = makeBloomFilterOperator<Long2, 1, 0>(
+                            &probe_source, &build_source);
+                    return Drain(&op);
+                };
+            });
+
+    // Same as the first join benchmark but with both inputs sorted on the key
+    RegisterSweep(
+            config, benchmarks, "merge_join", {{"width", 2}}, false,
+            [&config](auto const cardinality, auto const skew) {
+                auto const build = std::make_shared<std::vector<Long2>>(
+                        GenerateTuples<Long2>(cardinality, cardinality, 0, 3));
+                for (size_t i = 0; i < build->size(); i++) {
+                    (*build)[i].v0 = static_cast<long>(i);
+                }
+                auto const probe = std::make_shared<std::vector<Long2>>(
+                        GenerateTuples<Long2>(config.num_tuples, cardinality,
+                                              skew, 4));
+                std::sort(probe->begin(), probe->end(),
+                          [](auto const &lhs, auto const &rhs) {
+                              return lhs.v0 < rhs.v0;
+                          });
+                return [build, probe]() {
+                    VectorSource<Long2> build_source(build.get());
+                    VectorSource<Long2> probe_source(probe.get());
+                    auto op = makeMergeJoinOperator<Long3, Long1, Long1, Long1,
+                                                    1>(&build_source,
+                                                       &probe_source);
+                    return Drain(&op);
+                };
+            });
+
+    // Parallel build of the shared hash index used by the index join
+    RegisterSweep(config, benchmarks, "hash_index", {{"width", 2}}, true,
+                  [&config](auto const cardinality, auto const skew) {
+                      auto const tuples = std::make_shared<std::vector<Long2>>(
+                              GenerateTuples<Long2>(config.num_tuples,
+                                                    cardinality, skew, 3));
+                      return [tuples]() {
+                          VectorSource<Long2> source(tuples.get());
+                          auto op = makeHashIndexOperator<HashIndex<Long2>,
+                                                          Long1, 1>(&source);
+                          return Drain(&op);
+                      };
+                  });
+}
+
+void RegisterPartition(const Config &config,
+                       std::vector<Benchmark> *benchmarks) {
+    for (auto const fanout : {16L, 256L, 4096L}) {
+        RegisterSweep(
+                config, benchmarks, "partition",
+                {{"width", 2}, {"fanout", fanout}, {"two_pass", false}}, false,
+                [&config, fanout](auto const cardinality, auto const skew) {
+                    auto const tuples = std::make_shared<std::vector<Long2>>(
+                            GenerateTuples<Long2>(config.num_tuples,
+                                                  cardinality, skew, 5));
+                    return [tuples, fanout]() {
+                        VectorSource<Long2> source(tuples.get());
+                        SingleTupleSource<Long1> conf(Long1{fanout});
+                        auto op = makePartitionOperator<Group<Long2>, 42>(
+                                &source, &conf);
+                        return Drain(&op);
+                    };
+                });
+
+        RegisterSweep(
+                config, benchmarks, "partition",
+                {{"width", 2}, {"fanout", fanout}, {"two_pass", true}}, true,
+                [&config, fanout](auto const cardinality, auto const skew) {
+                    auto const tuples = std::make_shared<std::vector<Long2>>(
+                            GenerateTuples<Long2>(config.num_tuples,
+                                                  cardinality, skew, 5));
+                    return [tuples, fanout]() {
+                        VectorSource<Long2> source(tuples.get());
+                        SingleTupleSource<Long1> conf(Long1{fanout});
+                        auto op = makePartitionOperator<Group<Long2>, 42, 1,
+                                                        true>(&source, &conf);
+                        return Drain(&op);
+                    };
+                });
+
+        RegisterSweep(
+                config, benchmarks, "partition",
+                {{"width", 2},
+                 {"fanout", fanout},
+                 {"two_pass", true},
+                 {"numa_aware", true}},
+                true,
+                [&config, fanout](auto const cardinality, auto const skew) {
+                    auto const tuples = std::make_shared<std::vector<Long2>>(
+                            GenerateTuples<Long2>(config.num_tuples,
+                                                  cardinality, skew, 5));
+                    return [tuples, fanout]() {
+                        VectorSource<Long2> source(tuples.get());
+                        SingleTupleSource<Long1> conf(Long1{fanout});
+                        auto op = makePartitionOperator<Group<Long2>, 42, 1,
+                                                        true, false, true>(
+                                &source, &conf);
+                        return Drain(&op);
+                    };
+                });
+    }
+}
+
+void RegisterGroupBy(const Config &config,
+                     std::vector<Benchmark> *benchmarks) {
+    RegisterSweep(config, benchmarks, "group_by", {{"width", 2}}, true,
+                  [&config](auto const cardinality, auto const skew) {
+                      auto const tuples = std::make_shared<std::vector<Long2>>(
+                              GenerateTuples<Long2>(config.num_tuples,
+                                                    cardinality, skew, 6));
+                      return [tuples]() {
+                          VectorSource<Long2> source(tuples.get());
+                          auto op = makeGroupByOperator<Group<Long2>>(&source);
+                          return Drain(&op);
+                      };
+                  });
+}
+
+void RegisterDistinct(const Config &config,
+                      std::vector<Benchmark> *benchmarks) {
+    RegisterSweep(config, benchmarks, "distinct", {{"width", 1}}, false,
+                  [&config](auto const cardinality, auto const skew) {
+                      auto const tuples = std::make_shared<std::vector<Long1>>(
+                              GenerateTuples<Long1>(config.num_tuples,
+                                                    cardinality, skew, 8));
+                      return [tuples]() {
+                          VectorSource<Long1> source(tuples.get());
+                          auto op = makeDistinctOperator<Long1>(&source);
+                          return Drain(&op);
+                      };
+                  });
+
+    // Emulation of distinct with a dummy value and a UDF, which is what users
+    // had to write without the distinct operators
+    RegisterSweep(
+            config, benchmarks, "distinct_reduce_by_key", {{"width", 1}},
+            false, [&config](auto const cardinality, auto const skew) {
+                auto const tuples = std::make_shared<std::vector<Long1>>(
+                        GenerateTuples<Long1>(config.num_tuples, cardinality,
+                                              skew, 8));
+                return [tuples]() {
+                    VectorSource<Long1> source(tuples.get());
+                    auto map = makeMapOperator<Long2>(
+                            &source,
+                            [](const Long1 &t) { return Long2{t.v0, 0}; });
+                    auto op = makeReduceByKeyOperator<Long2, Long1, Long1, 1>(
+                            &map, Sum<Long1>);
+                    return Drain(&op);
+                };
+            });
+
+    RegisterSweep(config, benchmarks, "sorted_distinct", {{"width", 1}},
+                  false, [&config](auto const cardinality, auto const skew) {
+                      auto const tuples = std::make_shared<std::vector<Long1>>(
+                              GenerateTuples<Long1>(config.num_tuples,
+                                                    cardinality, skew, 8));
+                      std::sort(tuples->begin(), tuples->end(),
+                                [](const Long1 &lhs, const Long1 &rhs) {
+                                    return lhs.v0 < rhs.v0;
+                                });
+                      return [tuples]() {
+                          VectorSource<Long1> source(tuples.get());
+                          auto op = makeSortedDistinctOperator<Long1>(&source);
+                          return Drain(&op);
+                      };
+                  });
+
+    RegisterSweep(config, benchmarks, "approx_count_distinct", {{"width", 1}},
+                  false, [&config](auto const cardinality, auto const skew) {
+                      auto const tuples = std::make_shared<std::vector<Long1>>(
+                              GenerateTuples<Long1>(config.num_tuples,
+                                                    cardinality, skew, 8));
+                      return [tuples]() {
+                          VectorSource<Long1> source(tuples.get());
+                          auto op = makeApproxCountDistinctOperator<Long1, 14>(
+                                  &source);
+                          return Drain(&op);
+                      };
+                  });
+}
+
+// Running (frame size 0) and sliding sums per key. The cost per tuple should
+// not depend on the frame size.
+template <size_t kFrameSize>
+void RegisterWindowWithFrameSize(const Config &config,
+                                 std::vector<Benchmark> *benchmarks) {
+    RegisterSweep(config, benchmarks, "window",
+                  {{"width", 2}, {"frame_size", kFrameSize}}, false,
+                  [&config](auto const cardinality, auto const skew) {
+                      auto const tuples = std::make_shared<std::vector<Long2>>(
+                              GenerateTuples<Long2>(config.num_tuples,
+                                                    cardinality, skew, 9));
+                      return [tuples]() {
+                          VectorSource<Long2> source(tuples.get());
+                          auto op = makeWindowOperator<Long3, Long1, Long1, 1,
+                                                       kFrameSize>(
+                                  &source, Sum<Long1>);
+                          return Drain(&op);
+                      };
+                  });
+
+    RegisterSweep(config, benchmarks, "window_grouped",
+                  {{"width", 2}, {"frame_size", kFrameSize}}, false,
+                  [&config](auto const cardinality, auto const skew) {
+                      auto const tuples = std::make_shared<std::vector<Long2>>(
+                              GenerateTuples<Long2>(config.num_tuples,
+                                                    cardinality, skew, 9));
+                      std::stable_sort(tuples->begin(), tuples->end(),
+                                       [](const Long2 &lhs, const Long2 &rhs) {
+                                           return lhs.v0 < rhs.v0;
+                                       });
+                      return [tuples]() {
+                          VectorSource<Long2> source(tuples.get());
+                          auto op = makeWindowGroupedOperator<Long3, Long1, 1,
+                                                              kFrameSize>(
+                                  &source, Sum<Long1>);
+                          return Drain(&op);
+                      };
+                  });
+}
+
+void RegisterWindow(const Config &config, std::vector<Benchmark> *benchmarks) {
+    RegisterWindowWithFrameSize<0>(config, benchmarks);
+    RegisterWindowWithFrameSize<16>(config, benchmarks);
+    RegisterWindowWithFrameSize<1024>(config, benchmarks);
+}
+
+// Hash-based operators whose hash tables exceed the memory budget for high
+// cardinalities, such that they spill partitions to disk
+void RegisterSpilling(const Config &config,
+                      std::vector<Benchmark> *benchmarks) {
+    constexpr size_t kMemoryBudget = 1UL << 20U;
+
+    RegisterSweep(
+            config, benchmarks, "reduce_by_key",
+            {{"width", 2}, {"memory_budget", kMemoryBudget}}, false,
+            [&config](auto const cardinality, auto const skew) {
+                auto const tuples = std::make_shared<std::vector<Long2>>(
+                        GenerateTuples<Long2>(config.num_tuples, cardinality,
+                                              skew, 1));
+                return [tuples]() {
+                    VectorSource<Long2> source(tuples.get());
+                    auto op = makeReduceByKeyOperator<Long2, Long1, Long1, 1>(
+                            &source, Sum<Long1>, kMemoryBudget);
+                    return Drain(&op);
+                };
+            });
+
+    RegisterSweep(
+            config, benchmarks, "join",
+            {{"width", 2}, {"memory_budget", kMemoryBudget}}, false,
+            [&config](auto const cardinality, auto const skew) {
+                auto const build = std::make_shared<std::vector<Long2>>(
+                        GenerateTuples<Long2>(cardinality, cardinality, 0, 3));
+                for (size_t i = 0; i < build->size(); i++) {
+                    (*build)[i].v0 = static_cast<long>(i);
+                }
+                auto const probe = std::make_shared<std::vector<Long2>>(
+                        GenerateTuples<Long2>(config.num_tuples, cardinality,
+                                              skew, 4));
+                return [build, probe]() {
+                    VectorSource<Long2> build_source(build.get());
+                    VectorSource<Long2> probe_source(probe.get());
+                    auto op = makeJoinOperator<Long3, Long1, Long1, Long1, 1>(
+                            &build_source, &probe_source, kMemoryBudget);
+                    return Drain(&op);
+                };
+            });
+}
+
+// Materializes rows with consecutive keys into column chunks
+auto MaterializeChunks(const size_t num_tuples) -> std::vector<Columns2> {
+    auto const rows =
+            GenerateTuples<Long2>(num_tuples, std::max<size_t>(1, num_tuples),
+                                  0, 7);
+    std::vector<Columns2> chunks;
+    VectorSource<Long2> source(&rows);
+    auto op = makeMaterializeColumnChunksOperator<Columns2>(&source);
+    op.open();
+    while (auto const ret = op.next()) {
+        chunks.push_back(ret.value());
+    }
+    op.close();
+    return chunks;
+}
+
+void RegisterColumnar(const Config &config,
+                      std::vector<Benchmark> *benchmarks) {
+    const size_t num_tuples = config.num_tuples;
+
+    benchmarks->push_back(
+            {"materialize_column_chunks", nlohmann::json{{"width", 2}},
+             num_tuples, 1, [num_tuples]() {
+                 auto const rows = std::make_shared<std::vector<Long2>>(
+                         GenerateTuples<Long2>(
+                                 num_tuples, std::max<size_t>(1, num_tuples),
+                                 0, 7));
+                 return std::function<size_t()>([rows]() {
+                     VectorSource<Long2> source(rows.get());
+                     auto op = makeMaterializeColumnChunksOperator<Columns2>(
+                             &source);
+                     return Drain(&op);
+                 });
+             }});
+
+    benchmarks->push_back(
+            {"column_scan", nlohmann::json{{"width", 2}}, num_tuples, 1,
+             [num_tuples]() {
+                 auto const chunks = std::make_shared<std::vector<Columns2>>(
+                         MaterializeChunks(num_tuples));
+                 return std::function<size_t()>([chunks]() {
+                     VectorSource<Columns2> source(chunks.get());
+                     auto op = makeColumnScanOperator<Long2, false>(&source);
+                     return Drain(&op);
+                 });
+             }});
+
+    // Scans, maps, filters, and aggregates in one push-based pipeline
+    benchmarks->push_back(
+            {"pipeline", nlohmann::json{{"width", 2}}, num_tuples, 1,
+             [num_tuples]() {
+                 auto const chunks = std::make_shared<std::vector<Columns2>>(
+                         MaterializeChunks(num_tuples));
+                 return std::function<size_t()>([chunks]() {
+                     VectorSource<Columns2> source(chunks.get());
+                     auto scan = makeColumnScanOperator<Long2, false>(&source);
+                     auto map = makeMapOperator<Long2>(
+                             &scan, [](const Long2 &t) {
+                                 return Long2{t.v0 % 1024, t.v1 * 3};
+                             });
+                     auto filter = makeFilterOperator<Long2>(
+                             &map, [](const Long2 &t) { return t.v1 % 2 == 0; });
+                     auto op = makeReduceByKeyOperator<Long2, Long1, Long1, 1>(
+                             &filter, Sum<Long1>);
+                     return Drain(&op);
+                 });
+             }});
+}
+
+auto RunBenchmark(const Benchmark &benchmark, const size_t num_repetitions)
+        -> nlohmann::json {
+    auto const run = benchmark.prepare();
+
+    std::vector<double> times;
+    size_t num_output_tuples = 0;
+    for (size_t i = 0; i < num_repetitions; i++) {
+        auto const start = std::chrono::steady_clock::now();
+        // Operators with intra-operator parallelism spawn tasks, so they have
+        // to run inside of a parallel region, as in the generated code
+#pragma omp parallel num_threads(benchmark.num_threads)
+#pragma omp single
+        num_output_tuples = run();
+        auto const end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double>(end - start).count());
+    }
+
+    std::sort(times.begin(), times.end());
+    auto const min_time = times.front();
+    auto const median_time = times[times.size() / 2];
+
+    return {{"name", benchmark.name},
+            {"params", benchmark.params},
+            {"num_threads", benchmark.num_threads},
+            {"num_input_tuples", benchmark.num_input_tuples},
+            {"num_output_tuples", num_output_tuples},
+            {"times", times},
+            {"min_time", min_time},
+            {"median_time", median_time},
+            {"tuples_per_second", benchmark.num_input_tuples / min_time}};
+}
+
+}  // namespace
+
+auto main(int argc, char *argv[]) -> int {
+    Config config;
+    std::string filter;
+    std::string output_file_name;
+
+    po::options_description desc("Run micro-benchmarks of JITQ operators.");
+    desc.add_options()                             //
+            ("help", "Produce this help message")  //
+            ("num-tuples,n",
+             po::value<size_t>(&config.num_tuples)->default_value(1UL << 22U),
+             "Number of input tuples")  //
+            ("repetitions,r",
+             po::value<size_t>(&config.num_repetitions)->default_value(5),
+             "Number of runs of each benchmark")  //
+            ("cardinalities,c",
+             po::value<std::vector<size_t>>(&config.cardinalities)
+                     ->multitoken()
+                     ->default_value({1UL << 4U, 1UL << 12U, 1UL << 20U},
+                                     "16 4096 1048576"),
+             "Number of distinct keys")  //
+            ("skews,s",
+             po::value<std::vector<double>>(&config.skews)
+                     ->multitoken()
+                     ->default_value({0.0, 1.0}, "0 1"),
+             "Zipf exponents of the key distribution (0 means uniform)")  //
+            ("threads,t",
+             po::value<std::vector<int>>(&config.thread_counts)
+                     ->multitoken()
+                     ->default_value({1, omp_get_max_threads()},
+                                     "1 <max threads>"),
+             "Thread counts of parallel operators")  //
+            ("filter,f", po::value<std::string>(&filter)->default_value(".*"),
+             "Regular expression on the names of the benchmarks to run")  //
+            ("output,o", po::value<std::string>(&output_file_name),
+             "Path to file for the results in JSON format")  //
+            ;
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+
+    if (vm.count("help") > 0) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    po::notify(vm);
+
+    std::ofstream output_file(output_file_name);
+    assert(output_file_name.empty() or output_file.is_open());
+    std::ostream &output = output_file_name.empty() ? std::cout : output_file;
+
+    // Register benchmarks that match the filter
+    const std::regex filter_regex(filter);
+    std::vector<Benchmark> benchmarks;
+    RegisterWidths<RegisterReduceByKey>(config, &benchmarks);
+    RegisterWidths<RegisterSort>(config, &benchmarks);
+    RegisterJoin(config, &benchmarks);
+    RegisterPartition(config, &benchmarks);
+    RegisterGroupBy(config, &benchmarks);
+    RegisterDistinct(config, &benchmarks);
+    RegisterWindow(config, &benchmarks);
+    RegisterSpilling(config, &benchmarks);
+    RegisterColumnar(config, &benchmarks);
+
+    benchmarks.erase(std::remove_if(benchmarks.begin(), benchmarks.end(),
+                                    [&](auto const &b) {
+                                        return !std::regex_match(b.name,
+                                                                 filter_regex);
+                                    }),
+                     benchmarks.end());
+
+    // Run benchmarks, reporting progress on stderr
+    nlohmann::json results = nlohmann::json::array();
+    for (auto const &benchmark : benchmarks) {
+        std::cerr << benchmark.name << " " << benchmark.params.dump()
+                  << " threads=" << benchmark.num_threads << std::flush;
+        auto result = RunBenchmark(benchmark, config.num_repetitions);
+        std::cerr << " " << result["min_time"].get<double>() << "s"
+                  << std::endl;
+        results.push_back(std::move(result));
+    }
+
+    output << nlohmann::json{{"context",
+                              {{"num_tuples", config.num_tuples},
+                               {"num_repetitions", config.num_repetitions},
+                               {"max_threads", omp_get_max_threads()}}},
+                             {"benchmarks", results}}
+                      .dump(4)
+           << std::endl;
+}
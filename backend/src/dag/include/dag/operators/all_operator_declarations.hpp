@@ -3,13 +3,16 @@
 
 #include <type_traits>
 
+#include <boost/mpl/joint_view.hpp>
 #include <boost/mpl/list.hpp>
 #include <boost/mpl/placeholders.hpp>
 #include <boost/mpl/transform_view.hpp>
 
 class DAGAntiJoin;
 class DAGAntiJoinPredicated;
+class DAGApproxCountDistinct;
 class DAGAssertCorrectOpenNextClose;
+class DAGBloomFilter;
 class DAGBroadcast;
 class DAGCartesian;
 class DAGColumnScan;
@@ -18,19 +21,25 @@ class DAGConcurrentExecute;
 class DAGConcurrentExecuteLambda;
 class DAGConcurrentExecuteProcess;
 class DAGConstantTuple;
+class DAGCsvScan;
+class DAGDistinct;
 class DAGEnsureSingleTuple;
 class DAGExchange;
 class DAGExchangeS3;
 class DAGExchangeTcp;
 class DAGExpandPattern;
 class DAGFilter;
+class DAGFlatMap;
 class DAGGroupBy;
+class DAGHashIndex;
+class DAGIndexJoin;
 class DAGJoin;
 class DAGMap;
 class DAGMapCpp;
 class DAGMaterializeColumnChunks;
 class DAGMaterializeParquet;
 class DAGMaterializeRowVector;
+class DAGMergeJoin;
 class DAGNestedMap;
 class DAGParallelMap;
 class DAGParallelMapOmp;
@@ -50,60 +59,81 @@ class DAGSemiJoin;
 class DAGSplitColumnData;
 class DAGSplitRange;
 class DAGSplitRowData;
+class DAGSplitSkewedPartitions;
 class DAGSort;
+class DAGSortedDistinct;
 class DAGTopK;
+class DAGWindow;
+class DAGWindowGrouped;
 class DAGZip;
 
 namespace dag {
 
-using AllOperatorTypes = boost::mpl::list<  //
-        DAGAntiJoin,                        //
-        DAGAntiJoinPredicated,              //
-        DAGAssertCorrectOpenNextClose,      //
-        DAGBroadcast,                       //
-        DAGCartesian,                       //
-        DAGColumnScan,                      //
-        DAGCompiledPipeline,                //
-        DAGConcurrentExecute,               //
-        DAGConcurrentExecuteLambda,         //
-        DAGConcurrentExecuteProcess,        //
-        DAGConstantTuple,                   //
-        DAGEnsureSingleTuple,               //
-        DAGExchange,                        //
-        DAGExchangeS3,                      //
-        DAGExchangeTcp,                     //
-        DAGExpandPattern,                   //
-        DAGFilter,                          //
-        DAGGroupBy,                         //
-        DAGJoin,                            //
-        DAGMap,                             //
-        DAGMapCpp,                          //
-        DAGMaterializeColumnChunks,         //
-        DAGMaterializeParquet,              //
-        DAGMaterializeRowVector,            //
-        DAGNestedMap,                       //
-        DAGParallelMap,                     //
-        DAGParallelMapOmp,                  //
-        DAGParameterLookup,                 //
-        DAGParquetScan,                     //
-        DAGPartition,                       //
-        DAGPartitionedExchange,             //
-        DAGPipeline,                        //
-        DAGProjection,                      //
-        DAGRange,                           //
-        DAGReduce,                          //
-        DAGReduceByIndex,                   //
-        DAGReduceByKey,                     //
-        DAGReduceByKeyGrouped,              //
-        DAGRowScan,                         //
-        DAGSemiJoin,                        //
-        DAGSplitColumnData,                 //
-        DAGSplitRange,                      //
-        DAGSplitRowData,                    //
-        DAGSort,                            //
-        DAGTopK,                            //
-        DAGZip                              //
-        >::type;
+// Boost.MPL lists have at most 50 elements, so the operators are split into
+// two lists, which are concatenated
+using AllOperatorTypes = boost::mpl::joint_view<
+        boost::mpl::list<  //
+                DAGAntiJoin,                        //
+                DAGAntiJoinPredicated,              //
+                DAGApproxCountDistinct,             //
+                DAGAssertCorrectOpenNextClose,      //
+                DAGBloomFilter,                     //
+                DAGBroadcast,                       //
+                DAGCartesian,                       //
+                DAGColumnScan,                      //
+                DAGCompiledPipeline,                //
+                DAGConcurrentExecute,               //
+                DAGConcurrentExecuteLambda,         //
+                DAGConcurrentExecuteProcess,        //
+                DAGConstantTuple,                   //
+                DAGCsvScan,                         //
+                DAGDistinct,                        //
+                DAGEnsureSingleTuple,               //
+                DAGExchange,                        //
+                DAGExchangeS3,                      //
+                DAGExchangeTcp,                     //
+                DAGExpandPattern,                   //
+                DAGFilter,                          //
+                DAGFlatMap,                         //
+                DAGGroupBy,                         //
+                DAGHashIndex,                       //
+                DAGIndexJoin,                       //
+                DAGJoin                             //
+                >::type,
+        boost::mpl::list<  //
+                DAGMap,                             //
+                DAGMapCpp,                          //
+                DAGMaterializeColumnChunks,         //
+                DAGMaterializeParquet,              //
+                DAGMaterializeRowVector,            //
+                DAGMergeJoin,                       //
+                DAGNestedMap,                       //
+                DAGParallelMap,                     //
+                DAGParallelMapOmp,                  //
+                DAGParameterLookup,                 //
+                DAGParquetScan,                     //
+                DAGPartition,                       //
+                DAGPartitionedExchange,             //
+                DAGPipeline,                        //
+                DAGProjection,                      //
+                DAGRange,                           //
+                DAGReduce,                          //
+                DAGReduceByIndex,                   //
+                DAGReduceByKey,                     //
+                DAGReduceByKeyGrouped,              //
+                DAGRowScan,                         //
+                DAGSemiJoin,                        //
+                DAGSplitColumnData,                 //
+                DAGSplitRange,                      //
+                DAGSplitRowData,                    //
+                DAGSplitSkewedPartitions,           //
+                DAGSort,                            //
+                DAGSortedDistinct,                  //
+                DAGTopK,                            //
+                DAGWindow,                          //
+                DAGWindowGrouped,                   //
+                DAGZip                              //
+                >::type>;
 
 using AllOperatorPointerTypes = typename boost::mpl::transform_view<
         AllOperatorTypes, std::add_pointer<boost::mpl::placeholders::_>>::type;
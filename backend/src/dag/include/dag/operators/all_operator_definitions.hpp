@@ -3,7 +3,9 @@
 
 #include "antijoin.hpp"
 #include "antijoin_predicated.hpp"
+#include "approx_count_distinct.hpp"
 #include "assert_correct_open_next_close.hpp"
+#include "bloom_filter.hpp"
 #include "broadcast.hpp"
 #include "cartesian.hpp"
 #include "column_scan.hpp"
@@ -12,19 +14,25 @@
 #include "concurrent_execute_lambda.hpp"
 #include "concurrent_execute_process.hpp"
 #include "constant_tuple.hpp"
+#include "csv_scan.hpp"
+#include "distinct.hpp"
 #include "ensure_single_tuple.hpp"
 #include "exchange.hpp"
 #include "exchange_s3.hpp"
 #include "exchange_tcp.hpp"
 #include "expand_pattern.hpp"
 #include "filter.hpp"
+#include "flat_map.hpp"
 #include "group_by.hpp"
+#include "hash_index.hpp"
+#include "index_join.hpp"
 #include "join.hpp"
 #include "map.hpp"
 #include "map_cpp.hpp"
 #include "materialize_column_chunks.hpp"
 #include "materialize_parquet.hpp"
 #include "materialize_row_vector.hpp"
+#include "merge_join.hpp"
 #include "nested_map.hpp"
 #include "parallel_map.hpp"
 #include "parallel_map_omp.hpp"
@@ -42,10 +50,14 @@
 #include "row_scan.hpp"
 #include "semijoin.hpp"
 #include "sort.hpp"
+#include "sorted_distinct.hpp"
 #include "split_column_data.hpp"
 #include "split_range.hpp"
 #include "split_row_data.hpp"
+#include "split_skewed_partitions.hpp"
 #include "topk.hpp"
+#include "window.hpp"
+#include "window_grouped.hpp"
 #include "zip.hpp"
 
 #endif
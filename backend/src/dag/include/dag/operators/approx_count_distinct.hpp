@@ -0,0 +1,22 @@
+#ifndef DAG_OPERATORS_APPROX_COUNT_DISTINCT_HPP
+#define DAG_OPERATORS_APPROX_COUNT_DISTINCT_HPP
+
+#include "operator.hpp"
+
+// Estimates the number of distinct input tuples with a HyperLogLog sketch of
+// 2^precision registers
+class DAGApproxCountDistinct : public DAGOperator {
+    // cppcheck-suppress noExplicitConstructor  // false positive
+    JITQ_DAGOPERATOR(DAGApproxCountDistinct, "approx_count_distinct");
+
+public:
+    [[nodiscard]] auto num_in_ports() const -> size_t override { return 1; }
+    [[nodiscard]] auto num_out_ports() const -> size_t override { return 1; }
+
+    void to_json(nlohmann::json *json) const override;
+    void from_json(const nlohmann::json &json) override;
+
+    int precision = 14;
+};
+
+#endif  // DAG_OPERATORS_APPROX_COUNT_DISTINCT_HPP
@@ -0,0 +1,27 @@
+#ifndef DAG_OPERATORS_BLOOM_FILTER_HPP
+#define DAG_OPERATORS_BLOOM_FILTER_HPP
+
+#include <vector>
+
+#include "operator.hpp"
+
+// Keeps the tuples of the first input whose key may occur among the keys of
+// the second input, i.e., a semi-join with false positives
+class DAGBloomFilter : public DAGOperator {
+    // cppcheck-suppress noExplicitConstructor  // false positive
+    JITQ_DAGOPERATOR(DAGBloomFilter, "bloom_filter");
+
+public:
+    [[nodiscard]] auto num_in_ports() const -> size_t override { return 2; }
+    [[nodiscard]] auto num_out_ports() const -> size_t override { return 1; }
+
+    void to_json(nlohmann::json *json) const override;
+    void from_json(const nlohmann::json &json) override;
+
+    // Number of leading fields of the second input that form the key
+    size_t num_keys = 1;
+    // Positions of the key fields in the first input
+    std::vector<size_t> key_positions;
+};
+
+#endif  // DAG_OPERATORS_BLOOM_FILTER_HPP
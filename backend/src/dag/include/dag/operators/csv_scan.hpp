@@ -0,0 +1,31 @@
+#ifndef DAG_OPERATORS_CSV_SCAN_HPP
+#define DAG_OPERATORS_CSV_SCAN_HPP
+
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "operator.hpp"
+
+// Reads the given columns of a slice of the CSV file of each input tuple
+// (file_path, slice_from, slice_to, num_slices) in chunks of column arrays
+class DAGCsvScan : public DAGOperator {
+    // cppcheck-suppress noExplicitConstructor  // false positive
+    JITQ_DAGOPERATOR(DAGCsvScan, "csv_scan");
+
+public:
+    [[nodiscard]] auto num_in_ports() const -> size_t override { return 1; }
+    [[nodiscard]] auto num_out_ports() const -> size_t override { return 1; }
+
+    void to_json(nlohmann::json *json) const override;
+    void from_json(const nlohmann::json &json) override;
+
+    std::vector<uint16_t> column_indexes;
+    char delimiter = ',';
+    char quote = '"';
+    bool has_header = false;
+    std::string filesystem;
+};
+
+#endif  // DAG_OPERATORS_CSV_SCAN_HPP
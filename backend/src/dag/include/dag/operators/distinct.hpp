@@ -0,0 +1,16 @@
+#ifndef DAG_OPERATORS_DISTINCT_HPP
+#define DAG_OPERATORS_DISTINCT_HPP
+
+#include "operator.hpp"
+
+// Removes duplicate tuples, comparing all fields
+class DAGDistinct : public DAGOperator {
+    // cppcheck-suppress noExplicitConstructor  // false positive
+    JITQ_DAGOPERATOR(DAGDistinct, "distinct");
+
+public:
+    [[nodiscard]] auto num_in_ports() const -> size_t override { return 1; }
+    [[nodiscard]] auto num_out_ports() const -> size_t override { return 1; }
+};
+
+#endif  // DAG_OPERATORS_DISTINCT_HPP
@@ -0,0 +1,30 @@
+#ifndef DAG_OPERATORS_FLAT_MAP_HPP
+#define DAG_OPERATORS_FLAT_MAP_HPP
+
+#include <cstddef>
+
+#include "operator.hpp"
+
+/*
+ * Calls a generator function on each input tuple and returns all tuples it
+ * yields. The LLVM IR contains two functions: the entry function, which
+ * initializes the generator state from an input tuple, and the entry function
+ * with the suffix "_next", which writes the next yielded tuple and returns
+ * whether there was one. The state is opaque to the backend; only its size is
+ * known.
+ */
+class DAGFlatMap : public DAGOperator {
+    // cppcheck-suppress noExplicitConstructor  // false positive
+    JITQ_DAGOPERATOR(DAGFlatMap, "flat_map");
+
+public:
+    [[nodiscard]] auto num_in_ports() const -> size_t override { return 1; }
+    [[nodiscard]] auto num_out_ports() const -> size_t override { return 1; }
+
+    void to_json(nlohmann::json *json) const override;
+    void from_json(const nlohmann::json &json) override;
+
+    size_t state_size = 0;
+};
+
+#endif  // DAG_OPERATORS_FLAT_MAP_HPP
@@ -0,0 +1,22 @@
+#ifndef DAG_OPERATORS_HASH_INDEX_HPP
+#define DAG_OPERATORS_HASH_INDEX_HPP
+
+#include "operator.hpp"
+
+// Builds a hash index on the key of its input, which is returned as a single
+// tuple with the bucket offsets and the input tuples ordered by bucket
+class DAGHashIndex : public DAGOperator {
+    // cppcheck-suppress noExplicitConstructor  // false positive
+    JITQ_DAGOPERATOR(DAGHashIndex, "hash_index");
+
+public:
+    [[nodiscard]] auto num_in_ports() const -> size_t override { return 1; }
+    [[nodiscard]] auto num_out_ports() const -> size_t override { return 1; }
+
+    void to_json(nlohmann::json *json) const override;
+    void from_json(const nlohmann::json &json) override;
+
+    int num_keys = 1;
+};
+
+#endif  // DAG_OPERATORS_HASH_INDEX_HPP
@@ -0,0 +1,22 @@
+#ifndef DAG_OPERATORS_INDEX_JOIN_HPP
+#define DAG_OPERATORS_INDEX_JOIN_HPP
+
+#include "operator.hpp"
+
+// Join of a hash index produced by hash_index (first input) with the tuples of
+// the second input
+class DAGIndexJoin : public DAGOperator {
+    // cppcheck-suppress noExplicitConstructor  // false positive
+    JITQ_DAGOPERATOR(DAGIndexJoin, "index_join");
+
+public:
+    [[nodiscard]] auto num_in_ports() const -> size_t override { return 2; }
+    [[nodiscard]] auto num_out_ports() const -> size_t override { return 1; }
+
+    void to_json(nlohmann::json *json) const override;
+    void from_json(const nlohmann::json &json) override;
+
+    int num_keys = 1;
+};
+
+#endif  // DAG_OPERATORS_INDEX_JOIN_HPP
@@ -1,6 +1,8 @@
 #ifndef DAG_OPERATORS_JOIN_HPP
 #define DAG_OPERATORS_JOIN_HPP
 
+#include <string>
+
 #include "operator.hpp"
 
 class DAGJoin : public DAGOperator {
@@ -15,6 +17,9 @@ public:
     void from_json(const nlohmann::json &json) override;
 
     int num_keys = 1;
+    // Input to replicate to all workers in distributed plans ("left",
+    // "right", or empty for partitioning both inputs)
+    std::string broadcast;
 };
 
 #endif  // DAG_OPERATORS_JOIN_HPP
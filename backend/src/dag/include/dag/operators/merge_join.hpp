@@ -0,0 +1,21 @@
+#ifndef DAG_OPERATORS_MERGE_JOIN_HPP
+#define DAG_OPERATORS_MERGE_JOIN_HPP
+
+#include "operator.hpp"
+
+// Join of two inputs that are both sorted ascendingly on the key
+class DAGMergeJoin : public DAGOperator {
+    // cppcheck-suppress noExplicitConstructor  // false positive
+    JITQ_DAGOPERATOR(DAGMergeJoin, "merge_join");
+
+public:
+    [[nodiscard]] auto num_in_ports() const -> size_t override { return 2; }
+    [[nodiscard]] auto num_out_ports() const -> size_t override { return 1; }
+
+    void to_json(nlohmann::json *json) const override;
+    void from_json(const nlohmann::json &json) override;
+
+    int num_keys = 1;
+};
+
+#endif  // DAG_OPERATORS_MERGE_JOIN_HPP
@@ -17,6 +17,12 @@ public:
     void from_json(const nlohmann::json &json) override;
 
     size_t seed = 0;
+    // Number of leading fields that form the partition key
+    size_t num_keys = 1;
+    // Produce exactly-sized, contiguous partitions using a histogram pass
+    bool two_pass = false;
+    // Send every tuple to every partition (ignoring the key)
+    bool broadcast = false;
 };
 
 #endif  // DAG_OPERATORS_PARTITION_HPP
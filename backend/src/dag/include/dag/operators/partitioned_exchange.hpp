@@ -13,6 +13,8 @@ public:
 
     size_t num_levels{};
     size_t level_num{};
+    // Replicate the input to all workers rather than partitioning it
+    bool broadcast{};
 };
 
 #endif  // DAG_OPERATORS_PARTITIONED_EXCHANGE_HPP
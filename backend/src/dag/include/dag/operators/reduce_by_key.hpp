@@ -1,6 +1,9 @@
 #ifndef DAG_OPERATORS_REDUCE_BY_KEY_HPP
 #define DAG_OPERATORS_REDUCE_BY_KEY_HPP
 
+#include <optional>
+#include <utility>
+
 #include "operator.hpp"
 
 class DAGReduceByKey : public DAGOperator {
@@ -10,6 +13,15 @@ class DAGReduceByKey : public DAGOperator {
 public:
     [[nodiscard]] auto num_in_ports() const -> size_t override { return 1; }
     [[nodiscard]] auto num_out_ports() const -> size_t override { return 1; }
+
+    void to_json(nlohmann::json *json) const override;
+    void from_json(const nlohmann::json &json) override;
+
+    // Number of leading fields that form the key
+    size_t num_keys = 1;
+    // Optional hint: all keys lie in [first, second] (both inclusive); only
+    // used for single-field keys
+    std::optional<std::pair<int64_t, int64_t>> key_range;
 };
 
 #endif  // DAG_OPERATORS_REDUCE_BY_KEY_HPP
@@ -10,6 +10,12 @@ class DAGSemiJoin : public DAGOperator {
 public:
     [[nodiscard]] auto num_in_ports() const -> size_t override { return 2; }
     [[nodiscard]] auto num_out_ports() const -> size_t override { return 1; }
+
+    void to_json(nlohmann::json *json) const override;
+    void from_json(const nlohmann::json &json) override;
+
+    // Number of leading fields that form the key
+    size_t num_keys = 1;
 };
 
 #endif  // DAG_OPERATORS_SEMIJOIN_HPP
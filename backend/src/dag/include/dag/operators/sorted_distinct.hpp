@@ -0,0 +1,17 @@
+#ifndef DAG_OPERATORS_SORTED_DISTINCT_HPP
+#define DAG_OPERATORS_SORTED_DISTINCT_HPP
+
+#include "operator.hpp"
+
+// Removes duplicate tuples of an input that is sorted (or at least grouped)
+// on the first field
+class DAGSortedDistinct : public DAGOperator {
+    // cppcheck-suppress noExplicitConstructor  // false positive
+    JITQ_DAGOPERATOR(DAGSortedDistinct, "sorted_distinct");
+
+public:
+    [[nodiscard]] auto num_in_ports() const -> size_t override { return 1; }
+    [[nodiscard]] auto num_out_ports() const -> size_t override { return 1; }
+};
+
+#endif  // DAG_OPERATORS_SORTED_DISTINCT_HPP
@@ -0,0 +1,15 @@
+#ifndef DAG_OPERATORS_SPLIT_SKEWED_PARTITIONS_HPP
+#define DAG_OPERATORS_SPLIT_SKEWED_PARTITIONS_HPP
+
+#include "operator.hpp"
+
+class DAGSplitSkewedPartitions : public DAGOperator {
+    // cppcheck-suppress noExplicitConstructor  // false positive
+    JITQ_DAGOPERATOR(DAGSplitSkewedPartitions, "split_skewed_partitions");
+
+public:
+    [[nodiscard]] auto num_in_ports() const -> size_t override { return 1; }
+    [[nodiscard]] auto num_out_ports() const -> size_t override { return 1; }
+};
+
+#endif  // DAG_OPERATORS_SPLIT_SKEWED_PARTITIONS_HPP
@@ -0,0 +1,24 @@
+#ifndef DAG_OPERATORS_WINDOW_GROUPED_HPP
+#define DAG_OPERATORS_WINDOW_GROUPED_HPP
+
+#include "operator.hpp"
+
+class DAGWindowGrouped : public DAGOperator {
+    // cppcheck-suppress noExplicitConstructor  // false positive
+    JITQ_DAGOPERATOR(DAGWindowGrouped, "window_grouped");
+
+public:
+    [[nodiscard]] auto num_in_ports() const -> size_t override { return 1; }
+    [[nodiscard]] auto num_out_ports() const -> size_t override { return 1; }
+
+    void to_json(nlohmann::json *json) const override;
+    void from_json(const nlohmann::json &json) override;
+
+    // Number of leading fields that partition the input (may be zero)
+    size_t num_keys = 0;
+    // Number of rows of each frame, which ends with the current row; zero
+    // stands for frames with all previous rows of the partition
+    size_t frame_size = 0;
+};
+
+#endif  // DAG_OPERATORS_WINDOW_GROUPED_HPP
@@ -0,0 +1,13 @@
+#include "dag/operators/antijoin.hpp"
+
+void DAGAntiJoin::to_json(nlohmann::json *json) const {
+    if (this->num_keys != 1) {
+        json->emplace("num_keys", this->num_keys);
+    }
+}
+
+void DAGAntiJoin::from_json(const nlohmann::json &json) {
+    if (json.count("num_keys") > 0) {
+        this->num_keys = json.at("num_keys");
+    }
+}
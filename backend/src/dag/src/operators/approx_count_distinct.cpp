@@ -0,0 +1,9 @@
+#include "dag/operators/approx_count_distinct.hpp"
+
+void DAGApproxCountDistinct::to_json(nlohmann::json *json) const {
+    json->emplace("precision", this->precision);
+}
+
+void DAGApproxCountDistinct::from_json(const nlohmann::json &json) {
+    this->precision = json.at("precision");
+}
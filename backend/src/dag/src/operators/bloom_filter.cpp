@@ -0,0 +1,15 @@
+#include "dag/operators/bloom_filter.hpp"
+
+void DAGBloomFilter::to_json(nlohmann::json *json) const {
+    if (this->num_keys != 1) {
+        json->emplace("num_keys", this->num_keys);
+    }
+    json->emplace("key_positions", this->key_positions);
+}
+
+void DAGBloomFilter::from_json(const nlohmann::json &json) {
+    if (json.count("num_keys") > 0) {
+        this->num_keys = json.at("num_keys");
+    }
+    this->key_positions = json.at("key_positions").get<std::vector<size_t>>();
+}
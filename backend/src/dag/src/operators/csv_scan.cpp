@@ -0,0 +1,39 @@
+#include "dag/operators/csv_scan.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+auto ParseChar(const nlohmann::json &json, const std::string &name) -> char {
+    const std::string str = json.at(name);
+    if (str.size() != 1) {
+        throw std::invalid_argument("The " + name +
+                                    " of csv_scan must be a single character");
+    }
+    return str[0];
+}
+
+}  // namespace
+
+void DAGCsvScan::from_json(const nlohmann::json &json) {
+    for (const auto &c : json.at("columns")) {
+        column_indexes.emplace_back(c.at("idx"));
+    }
+    delimiter = ParseChar(json, "delimiter");
+    quote = ParseChar(json, "quote");
+    has_header = json.at("header");
+    filesystem = json.at("filesystem");
+}
+
+void DAGCsvScan::to_json(nlohmann::json *json) const {
+    auto columns = nlohmann::json::array();
+    for (const auto idx : column_indexes) {
+        columns.push_back({{"idx", idx}});
+    }
+    json->emplace("columns", columns);
+    json->emplace("delimiter", std::string(1, delimiter));
+    json->emplace("quote", std::string(1, quote));
+    json->emplace("header", has_header);
+    json->emplace("filesystem", filesystem);
+}
@@ -0,0 +1,9 @@
+#include "dag/operators/flat_map.hpp"
+
+void DAGFlatMap::to_json(nlohmann::json *json) const {
+    json->emplace("state_size", this->state_size);
+}
+
+void DAGFlatMap::from_json(const nlohmann::json &json) {
+    this->state_size = json.at("state_size");
+}
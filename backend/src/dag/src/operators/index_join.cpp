@@ -0,0 +1,9 @@
+#include "dag/operators/index_join.hpp"
+
+void DAGIndexJoin::to_json(nlohmann::json *json) const {
+    json->emplace("num_keys", this->num_keys);
+}
+
+void DAGIndexJoin::from_json(const nlohmann::json &json) {
+    this->num_keys = json.at("num_keys");
+}
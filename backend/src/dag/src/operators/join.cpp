@@ -1,9 +1,21 @@
 #include "dag/operators/join.hpp"
 
+#include <stdexcept>
+
 void DAGJoin::to_json(nlohmann::json *json) const {
     json->emplace("num_keys", this->num_keys);
+    if (!this->broadcast.empty()) {
+        json->emplace("broadcast", this->broadcast);
+    }
 }
 
 void DAGJoin::from_json(const nlohmann::json &json) {
     this->num_keys = json.at("num_keys");
+    if (json.count("broadcast") > 0) {
+        this->broadcast = json.at("broadcast");
+        if (this->broadcast != "left" && this->broadcast != "right") {
+            throw std::invalid_argument("Unknown broadcast side of join: '" +
+                                        this->broadcast + "'");
+        }
+    }
 }
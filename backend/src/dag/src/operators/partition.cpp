@@ -2,8 +2,26 @@
 
 void DAGPartition::from_json(const nlohmann::json &json) {
     this->seed = json.at("seed");
+    if (json.count("num_keys") > 0) {
+        this->num_keys = json.at("num_keys");
+    }
+    if (json.count("two_pass") > 0) {
+        this->two_pass = json.at("two_pass");
+    }
+    if (json.count("broadcast") > 0) {
+        this->broadcast = json.at("broadcast");
+    }
 }
 
 void DAGPartition::to_json(nlohmann::json *json) const {
     json->emplace("seed", this->seed);
+    if (this->num_keys != 1) {
+        json->emplace("num_keys", this->num_keys);
+    }
+    if (this->two_pass) {
+        json->emplace("two_pass", this->two_pass);
+    }
+    if (this->broadcast) {
+        json->emplace("broadcast", this->broadcast);
+    }
 }
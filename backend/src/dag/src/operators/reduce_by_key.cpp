@@ -0,0 +1,22 @@
+#include "dag/operators/reduce_by_key.hpp"
+
+void DAGReduceByKey::to_json(nlohmann::json *json) const {
+    if (this->num_keys != 1) {
+        json->emplace("num_keys", this->num_keys);
+    }
+    if (this->key_range) {
+        json->emplace("key_range", nlohmann::json::array({key_range->first,
+                                                          key_range->second}));
+    }
+}
+
+void DAGReduceByKey::from_json(const nlohmann::json &json) {
+    if (json.count("num_keys") > 0) {
+        this->num_keys = json.at("num_keys");
+    }
+    if (json.count("key_range") > 0) {
+        auto const &range = json.at("key_range");
+        this->key_range.emplace(range.at(0).get<int64_t>(),
+                                range.at(1).get<int64_t>());
+    }
+}
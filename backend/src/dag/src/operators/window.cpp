@@ -0,0 +1,19 @@
+#include "dag/operators/window.hpp"
+
+void DAGWindow::to_json(nlohmann::json *json) const {
+    if (this->num_keys != 0) {
+        json->emplace("num_keys", this->num_keys);
+    }
+    if (this->frame_size != 0) {
+        json->emplace("frame_size", this->frame_size);
+    }
+}
+
+void DAGWindow::from_json(const nlohmann::json &json) {
+    if (json.count("num_keys") > 0) {
+        this->num_keys = json.at("num_keys");
+    }
+    if (json.count("frame_size") > 0) {
+        this->frame_size = json.at("frame_size");
+    }
+}
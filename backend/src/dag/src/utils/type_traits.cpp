@@ -24,6 +24,7 @@ auto IsPipelinePredecessor(DAGOperator *const op) -> bool {
 
 auto IsSingleTupleProducer(DAGOperator *const op) -> bool {
     return IsInstanceOf<              //
+            DAGApproxCountDistinct,   //
             DAGMaterializeParquet,    //
             DAGMaterializeRowVector,  //
             DAGEnsureSingleTuple,     //
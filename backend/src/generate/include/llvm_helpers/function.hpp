@@ -23,6 +23,9 @@ public:
             "notuniquename218303dba31a092a63fd8a50e54f2c15";
     static const constexpr char *const kEntryFunctionName =
             "cfunc.notuniquename218303dba31a092a63fd8a50e54f2c15";
+    // Function returning the next tuple of a generator, see DAGFlatMap
+    static const constexpr char *const kGeneratorNextFunctionName =
+            "cfunc.notuniquename218303dba31a092a63fd8a50e54f2c15_next";
 
     explicit Function(const std::string &ir);
 
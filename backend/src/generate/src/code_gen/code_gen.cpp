@@ -60,9 +60,16 @@ auto GenerateCode(DAG *const dag, const std::string &config)
         std::set<std::string> includes;
         Context::TupleTypeRegistry tuple_type_descs;
 
+        const bool push_based = jconfig.value("/push-based", true);
+        const size_t memory_budget = jconfig.value("/memory-budget", 0UL);
+        const std::string spill_directory =
+                jconfig.value("/spill-directory", std::string());
+        const bool numa_aware = jconfig.value("/numa-aware", false);
         Context context(&declarations, &definitions,
                         llvm_code_dir.filename().string(), &llvm_code_files,
-                        &unique_counters, &includes, &tuple_type_descs);
+                        &unique_counters, &includes, &tuple_type_descs,
+                        push_based, memory_budget, spill_directory,
+                        numa_aware);
 
         function_name = GenerateExecutePipelines(&context, dag);
 
@@ -383,6 +390,7 @@ auto GenerateExecuteValues(DAG *const dag, Context *const context)
     auto execute_tuples = GenerateExecuteTuples(dag, context);
 
     // Includes needed for generate_values
+    context->includes().emplace("\"runtime/jit/memory/numa.hpp\"");
     context->includes().emplace("\"runtime/jit/memory/shared_pointer.hpp\"");
     context->includes().emplace("\"runtime/jit/values/array.hpp\"");
     context->includes().emplace("\"runtime/jit/values/atomics.hpp\"");
@@ -510,20 +518,31 @@ auto GenerateExecutePipelines(Context *const context, DAG *const dag)
             context->GenerateSymbolName("execute_pipelines", true);
     const auto sink_result_name = result_names[dag->output().op];
 
+    // Each worker stays on one core during the query, such that it keeps to
+    // its NUMA node; the calling thread gets its affinity back afterwards
+    const std::string pin_worker =
+            context->numa_aware()
+                    ? "const runtime::memory::WorkerPinningScope pinning("
+                      "omp_get_thread_num());"
+                    : "";
+
     context->definitions() <<  //
             format("extern \"C\" {"
                    "VectorOfValues %1%(const VectorOfValues &inputs) {"
                    "    VectorOfValues result;\n"
                    "    #pragma omp parallel shared(result)\n"
-                   "    #pragma omp single\n"
                    "    {"
-                   "        %2%\n"
-                   "        #pragma omp taskwait\n"
-                   "        result = %3%;"
+                   "        %4%\n"
+                   "        #pragma omp single\n"
+                   "        {"
+                   "            %2%\n"
+                   "            #pragma omp taskwait\n"
+                   "            result = %3%;"
+                   "        }"
                    "    }"
                    "    return std::move(result);"
                    "}}") %
-                    func_name % plan_body.str() % sink_result_name;
+                    func_name % plan_body.str() % sink_result_name % pin_worker;
 
     return func_name;
 }
@@ -630,6 +649,60 @@ auto GenerateLlvmFunctor(Context *const context,
     return class_name;
 }
 
+auto GenerateLlvmGeneratorFunctor(Context *const context,
+                                  const std::string &func_name_prefix,
+                                  const std::string &llvm_ir,
+                                  const StructDef *const input_type,
+                                  const std::string &return_type,
+                                  const size_t state_size) -> std::string {
+    // Generate symbol names
+    const auto func_name =
+            context->GenerateSymbolName(func_name_prefix + "_llvm");
+    const auto class_name =
+            context->GenerateSymbolName(func_name_prefix + "_functor");
+
+    // Emit LLVM code. This also renames the next function to func_name_next
+    StoreLlvmCode(context, llvm_ir, func_name);
+
+    // The state is the first argument of the init function, followed by the
+    // fields of the input tuple
+    std::vector<std::string> call_args = {"state_"};
+    for (auto const &field : input_type->names) {
+        call_args.emplace_back("t." + field);
+    }
+    std::vector<std::string> call_types = {"char*"};
+    call_types.insert(call_types.end(), input_type->types.begin(),
+                      input_type->types.end());
+
+    // Emit functor definition. The generator state lives in the functor, so
+    // each copy of the functor runs its own generator
+    context->definitions() <<  //
+            format("class %1% {"
+                   "public:"
+                   "    void init(%2% t) {"
+                   "        %3%(%4%);"
+                   "    }"
+                   "    bool next(%5% *res) {"
+                   "        return %3%_next(res, state_) != 0;"
+                   "    }"
+                   "private:"
+                   "    alignas(16) char state_[%6%];"
+                   "};") %
+                    class_name % input_type->name % func_name %
+                    join(call_args, ",") % return_type %
+                    std::max<size_t>(state_size, 1);
+
+    // Emit function declarations
+    context->declarations() <<  //
+            format("extern \"C\" {"
+                   "    void %1%(%2%);"
+                   "    int %1%_next(%3%*, char*);"
+                   "}") %
+                    func_name % join(call_types, ",") % return_type;
+
+    return class_name;
+}
+
 void StoreLlvmCode(Context *const context, const std::string &llvm_ir,
                    const std::string &func_name) {
     llvm_helpers::Function func(llvm_ir);
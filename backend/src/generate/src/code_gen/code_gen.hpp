@@ -1,6 +1,8 @@
 #ifndef CODE_GEN_CODE_GEN_HPP
 #define CODE_GEN_CODE_GEN_HPP
 
+#include <cstddef>
+
 #include <string>
 #include <utility>
 #include <vector>
@@ -49,6 +51,13 @@ auto GenerateLlvmFunctor(Context *context, const std::string &func_name_prefix,
                          const std::vector<const StructDef *> &input_types,
                          const std::string &return_type) -> std::string;
 
+auto GenerateLlvmGeneratorFunctor(Context *context,
+                                  const std::string &func_name_prefix,
+                                  const std::string &llvm_ir,
+                                  const StructDef *input_type,
+                                  const std::string &return_type,
+                                  size_t state_size) -> std::string;
+
 void StoreLlvmCode(Context *context, const std::string &llvm_ir,
                    const std::string &func_name);
 
@@ -15,6 +15,7 @@
 #include "dag/collection/atomic.hpp"
 #include "dag/operators/all_operator_definitions.hpp"
 #include "dag/type/array.hpp"
+#include "dag/utils/type_traits.hpp"
 #include "utils/visitor.hpp"
 
 using boost::format;
@@ -22,25 +23,52 @@ using boost::algorithm::join;
 
 namespace code_gen::cpp {
 
+namespace {
+
+// Whether the tuples produced by the given operator start with the ID of the
+// partition they belong to, i.e., are groups of partitions or the join of two
+// such groups (see Parallelize)
+auto YieldsPartitionIds(const DAG *const dag, const DAGOperator *const op)
+        -> bool {
+    using dag::utils::IsInstanceOf;
+    if (IsInstanceOf<DAGGroupBy>(op)) return true;
+    return IsInstanceOf<DAGJoin>(op) &&
+           IsInstanceOf<DAGGroupBy>(dag->predecessor(op, 0)) &&
+           IsInstanceOf<DAGGroupBy>(dag->predecessor(op, 1));
+}
+
+// Whether the given (inner) DAG aggregates into a dense array of its whole key
+// range. Every task running it allocates such an array, so its input should
+// not be split into more tasks than workers.
+auto HasDenseAggregation(const DAG *const dag) -> bool {
+    for (auto *const op : dag->operators()) {
+        if (dag::utils::IsInstanceOf<DAGReduceByIndex>(op)) return true;
+    }
+    return false;
+}
+
+}  // namespace
+
 void CodeGenVisitor::operator()(DAGAntiJoin *op) {
+    // The anti-join is a variant of the semi-join operator
     const std::string var_name =
-            CodeGenVisitor::visit_common(op, "AntiJoinOperator");
+            CodeGenVisitor::visit_common(op, "SemiJoinOperator");
 
     // Build key and value types
-    // TODO(sabir): This currently only works for keys of size 1
     const auto *const up1Type = dag_->predecessor(op, 0)->tuple->type;
-    const auto *key_Tuple = up1Type->ComputeHeadTuple();
+    const auto *key_Tuple = up1Type->ComputeHeadTuple(op->num_keys);
 
     const auto *key_type = EmitTupleStructDefinition(context_, key_Tuple);
 
-    const auto *value_tuple1 = up1Type->ComputeTailTuple();
+    const auto *value_tuple1 = up1Type->ComputeTailTuple(op->num_keys);
     const auto *value_type1 = EmitTupleStructDefinition(context_, value_tuple1);
 
     // Build operator
-    std::vector<std::string> template_args = {key_type->name,
-                                              value_type1->name};
+    std::vector<std::string> template_args = {
+            key_type->name, value_type1->name, std::to_string(op->num_keys)};
 
-    emitOperatorMake(var_name, "AntiJoinOperator", op, template_args);
+    emitOperatorMake(var_name, "AntiJoinOperator", op, template_args,
+                     memory_budget_args());
 };
 
 void CodeGenVisitor::operator()(DAGAntiJoinPredicated *op) {
@@ -48,21 +76,21 @@ void CodeGenVisitor::operator()(DAGAntiJoinPredicated *op) {
             CodeGenVisitor::visit_common(op, "AntiJoinPredicatedOperator");
 
     // Build key and value types
-    // TODO(sabir): This currently only works for keys of size 1
     const auto *const up1Type = dag_->predecessor(op, 0)->tuple->type;
     const auto *const up2Type = dag_->predecessor(op, 1)->tuple->type;
-    const auto *key_Tuple = up1Type->ComputeHeadTuple();
+    const auto *key_Tuple = up1Type->ComputeHeadTuple(op->num_keys);
 
     const auto *key_type = EmitTupleStructDefinition(context_, key_Tuple);
 
-    const auto *value_tuple1 = up1Type->ComputeTailTuple();
+    const auto *value_tuple1 = up1Type->ComputeTailTuple(op->num_keys);
     const auto *value_type1 = EmitTupleStructDefinition(context_, value_tuple1);
-    const auto *value_tuple2 = up2Type->ComputeTailTuple();
+    const auto *value_tuple2 = up2Type->ComputeTailTuple(op->num_keys);
     const auto *value_type2 = EmitTupleStructDefinition(context_, value_tuple2);
 
     // Build operator
     std::vector<std::string> template_args = {key_type->name, value_type1->name,
-                                              value_type2->name};
+                                              value_type2->name,
+                                              std::to_string(op->num_keys)};
 
     const auto *input_type1 =
             operator_descs_[dag_->predecessor(op, 0)].return_type;
@@ -169,6 +197,22 @@ void CodeGenVisitor::operator()(DAGGroupBy *op) {
     emitOperatorMake(var_name, "GroupByOperator", op, {}, {});
 }
 
+void CodeGenVisitor::operator()(DAGHashIndex *op) {
+    const std::string var_name =
+            CodeGenVisitor::visit_common(op, "HashIndexOperator");
+
+    const auto *const input_type = dag_->predecessor(op)->tuple->type;
+    const auto *const key_tuple = input_type->ComputeHeadTuple(op->num_keys);
+    const auto *const key_type = EmitTupleStructDefinition(context_, key_tuple);
+
+    emitOperatorMake(var_name, "HashIndexOperator", op,
+                     {key_type->name, std::to_string(op->num_keys)});
+}
+
+void CodeGenVisitor::operator()(DAGIndexJoin *op) {
+    visit_join(op, "IndexJoinOperator", op->num_keys);
+}
+
 void CodeGenVisitor::operator()(DAGMap *op) {
     const std::string var_name =
             CodeGenVisitor::visit_common(op, "MapOperator");
@@ -257,33 +301,17 @@ void CodeGenVisitor::operator()(DAGPartition *op) {
             CodeGenVisitor::visit_common(op, "PartitionOperator");
 
     emitOperatorMake(var_name, "PartitionOperator", op,
-                     {std::to_string(op->seed)});
+                     {std::to_string(op->seed), std::to_string(op->num_keys),
+                      op->two_pass ? "true" : "false",
+                      op->broadcast ? "true" : "false",
+                      context_->numa_aware() ? "true" : "false"});
 }
 
 void CodeGenVisitor::operator()(DAGProjection *op) {
     const std::string var_name =
             CodeGenVisitor::visit_common(op, "MapOperator");
 
-    const auto *input_type = operator_descs_[dag_->predecessor(op)].return_type;
-    const auto *return_type = operator_descs_[op].return_type;
-
-    const auto functor_class =
-            context_->GenerateSymbolName(var_name + "_func", true);
-
-    std::vector<std::string> call_args;
-    for (auto const pos : op->positions) {
-        call_args.emplace_back("t." + input_type->names[pos]);
-    }
-
-    context_->definitions() <<  //
-            format("class %s {"
-                   "public:"
-                   "    auto operator()(const %s &t) {"
-                   "        return %s{%s};"
-                   "    }"
-                   "};") %
-                    functor_class % input_type->name % return_type->name %
-                    join(call_args, ",");
+    const auto functor_class = emitProjectionFunctor(var_name + "_func", op);
 
     emitOperatorMake(var_name, "MapOperator", op, {}, {functor_class + "()"});
 }
@@ -370,30 +398,38 @@ void CodeGenVisitor::operator()(DAGFilter *op) {
                      {functor_class + "()"});
 };
 
-void CodeGenVisitor::operator()(DAGJoin *op) {
+void CodeGenVisitor::operator()(DAGFlatMap *op) {
     const std::string var_name =
-            CodeGenVisitor::visit_common(op, "JoinOperator");
+            CodeGenVisitor::visit_common(op, "FlatMapOperator");
 
-    // Build key and value types
-    const auto *const up1Type = dag_->predecessor(op, 0)->tuple->type;
-    const auto *const up2Type = dag_->predecessor(op, 1)->tuple->type;
+    const auto *input_type = operator_descs_[dag_->predecessor(op)].return_type;
+    const auto *return_type = operator_descs_[op].return_type;
+    const std::string functor_class = GenerateLlvmGeneratorFunctor(
+            context_, op->name(), op->llvm_ir, input_type, return_type->name,
+            op->state_size);
 
-    const auto *key_Tuple = up1Type->ComputeHeadTuple(op->num_keys);
+    emitOperatorMake(var_name, "FlatMapOperator", op, {},
+                     {functor_class + "()"});
+}
 
-    const auto *key_type = EmitTupleStructDefinition(context_, key_Tuple);
+void CodeGenVisitor::operator()(DAGJoin *op) {
+    visit_join(op, "JoinOperator", op->num_keys);
+};
 
-    const auto *value_tuple1 = up1Type->ComputeTailTuple(op->num_keys);
-    const auto *value_type1 = EmitTupleStructDefinition(context_, value_tuple1);
+void CodeGenVisitor::operator()(DAGMergeJoin *op) {
+    visit_join(op, "MergeJoinOperator", op->num_keys);
+};
 
-    const auto *value_tuple2 = up2Type->ComputeTailTuple(op->num_keys);
-    const auto *value_type2 = EmitTupleStructDefinition(context_, value_tuple2);
+void CodeGenVisitor::operator()(DAGBloomFilter *op) {
+    const std::string var_name =
+            CodeGenVisitor::visit_common(op, "BloomFilterOperator");
 
-    // Build operator
-    std::vector<std::string> template_args = {key_type->name, value_type1->name,
-                                              value_type2->name,
-                                              std::to_string(op->num_keys)};
+    std::vector<std::string> template_args = {std::to_string(op->num_keys)};
+    for (const auto pos : op->key_positions) {
+        template_args.emplace_back(std::to_string(pos));
+    }
 
-    emitOperatorMake(var_name, "JoinOperator", op, template_args);
+    emitOperatorMake(var_name, "BloomFilterOperator", op, template_args);
 };
 
 void CodeGenVisitor::operator()(DAGCartesian *op) {
@@ -413,8 +449,78 @@ void CodeGenVisitor::operator()(DAGParallelMapOmp *op) {
     const auto inner_plan =
             GenerateExecuteTuples(dag_->inner_dag(op), context_);
 
-    emitOperatorMake(var_name, "ParallelMapOmpOperator", op, {},
-                     {inner_plan.name});
+    if (!context_->numa_aware()) {
+        emitOperatorMake(var_name, "ParallelMapOmpOperator", op, {},
+                         {inner_plan.name});
+        return;
+    }
+
+    // The groups of a GroupBy are the partitions of the previous parallel map
+    // and are processed on the nodes they have been placed on. Their partition
+    // IDs are projected away before, so the operator consumes the input of the
+    // projection and applies it itself.
+    auto *const pred = dag_->predecessor(op);
+    auto *const proj_op = dynamic_cast<DAGProjection *>(pred);
+    if (proj_op == nullptr ||
+        !YieldsPartitionIds(dag_, dag_->predecessor(proj_op))) {
+        emitOperatorMake(var_name, "ParallelMapOmpOperator", op,
+                         {"true", "false"}, {inner_plan.name});
+        return;
+    }
+
+    const auto functor_class =
+            emitProjectionFunctor(var_name + "_proj_func", proj_op);
+    const auto &partitions_var_name =
+            operator_descs_[dag_->predecessor(proj_op)].var_name;
+    const auto *return_type = operator_descs_[op].return_type;
+
+    plan_body_ << format("auto %s = makeParallelMapOmpOperator<%s,true,true>"
+                         "(&%s,%s,%s());") %
+                          var_name % return_type->name % partitions_var_name %
+                          inner_plan.name % functor_class;
+    emitPullOperator(var_name, op);
+}
+
+void CodeGenVisitor::operator()(DAGCsvScan *op) {
+    const std::string var_name =
+            CodeGenVisitor::visit_common(op, "CsvScanOperator");
+
+    GenerateTupleToValue(context_, dag_->predecessor(op)->tuple->type);
+    GenerateValueToTuple(context_, op->tuple->type);
+
+    const auto &column_types = op->tuple->type->field_types;
+    assert(column_types.size() == op->column_indexes.size());
+
+    std::vector<std::string> column_type_names;
+    std::vector<std::string> column_ids;
+    for (size_t i = 0; i < column_types.size(); i++) {
+        const auto *const column_type =
+                dynamic_cast<const dag::type::Array *>(column_types[i]);
+        assert(column_type != nullptr);
+        const auto *const item_type = dynamic_cast<const dag::type::Atomic *>(
+                column_type->tuple_type->field_types.at(0));
+        assert(item_type != nullptr);
+        column_type_names.push_back("\"" + item_type->type + "\"");
+        column_ids.push_back(std::to_string(op->column_indexes[i]));
+    }
+
+    auto const column_types_expression =
+            (format("{%1%}") % join(column_type_names, ",")).str();
+    auto const column_ids_expression =
+            (format("{%1%}") % join(column_ids, ",")).str();
+    // Characters are emitted as numbers to avoid escaping
+    auto const delimiter = (format("static_cast<char>(%1%)") %
+                            static_cast<int>(op->delimiter))
+                                   .str();
+    auto const quote = (format("static_cast<char>(%1%)") %
+                        static_cast<int>(op->quote))
+                               .str();
+    auto const has_header = op->has_header ? "true" : "false";
+    auto const filesystem = (format("\"%1%\"") % op->filesystem).str();
+
+    emitOperatorMake(var_name, "CsvScanOperator", op, {},
+                     {column_types_expression, column_ids_expression,
+                      delimiter, quote, has_header, filesystem});
 }
 
 void CodeGenVisitor::operator()(DAGParquetScan *op) {
@@ -475,20 +581,20 @@ void CodeGenVisitor::operator()(DAGSemiJoin *op) {
             CodeGenVisitor::visit_common(op, "SemiJoinOperator");
 
     // Build key and value types
-    // TODO(sabir): This currently only works for keys of size 1
     const auto *const up1Type = dag_->predecessor(op, 0)->tuple->type;
-    const auto *key_Tuple = up1Type->ComputeHeadTuple();
+    const auto *key_Tuple = up1Type->ComputeHeadTuple(op->num_keys);
 
     const auto *key_type = EmitTupleStructDefinition(context_, key_Tuple);
 
-    const auto *value_tuple1 = up1Type->ComputeTailTuple();
+    const auto *value_tuple1 = up1Type->ComputeTailTuple(op->num_keys);
     const auto *value_type1 = EmitTupleStructDefinition(context_, value_tuple1);
 
     // Build operator
-    std::vector<std::string> template_args = {key_type->name,
-                                              value_type1->name};
+    std::vector<std::string> template_args = {
+            key_type->name, value_type1->name, std::to_string(op->num_keys)};
 
-    emitOperatorMake(var_name, "SemiJoinOperator", op, template_args);
+    emitOperatorMake(var_name, "SemiJoinOperator", op, template_args,
+                     memory_budget_args());
 };
 
 void CodeGenVisitor::operator()(DAGSplitColumnData *const op) {
@@ -505,15 +611,90 @@ void CodeGenVisitor::operator()(DAGSplitRowData *const op) {
     emitOperatorMake(var_name, "SplitRowDataOperator", op, {}, {});
 }
 
+void CodeGenVisitor::operator()(DAGSplitSkewedPartitions *const op) {
+    const std::string var_name =
+            CodeGenVisitor::visit_common(op, "SplitSkewedPartitionsOperator");
+
+    emitOperatorMake(var_name, "SplitSkewedPartitionsOperator", op, {}, {});
+}
+
 void CodeGenVisitor::operator()(DAGSplitRange *const op) {
     const std::string var_name =
             CodeGenVisitor::visit_common(op, "SplitRangeOperator");
 
-    emitOperatorMake(var_name, "SplitRangeOperator", op, {}, {});
+    // Ranges consumed by tasks of this process are split into morsels that
+    // can be balanced dynamically; otherwise, or if each task pre-aggregates
+    // into a dense array, into one slice per worker. The tasks may receive
+    // the morsels together with a shared hash index.
+    constexpr size_t kMorselSize = 1U << 16U;
+    const DAGOperator *consumer =
+            dag_->out_degree(op) == 1 ? dag_->successor(op) : nullptr;
+    if (dynamic_cast<const DAGCartesian *>(consumer) != nullptr &&
+        dag_->out_degree(consumer) == 1) {
+        consumer = dag_->successor(consumer);
+    }
+    const bool use_morsels =
+            dynamic_cast<const DAGParallelMapOmp *>(consumer) != nullptr &&
+            !HasDenseAggregation(dag_->inner_dag(consumer));
+
+    emitOperatorMake(var_name, "SplitRangeOperator", op,
+                     {std::to_string(use_morsels ? kMorselSize : 0)}, {});
+}
+
+void CodeGenVisitor::visit_join(DAGOperator *op,
+                                const std::string &operator_name,
+                                const size_t num_keys) {
+    assert(dynamic_cast<DAGJoin *>(op) != nullptr ||
+           dynamic_cast<DAGMergeJoin *>(op) != nullptr ||
+           dynamic_cast<DAGIndexJoin *>(op) != nullptr);
+
+    const std::string var_name =
+            CodeGenVisitor::visit_common(op, operator_name);
+
+    // Build key and value types
+    const auto *up1Type = dag_->predecessor(op, 0)->tuple->type;
+    if (dynamic_cast<DAGIndexJoin *>(op) != nullptr) {
+        // The left tuples are the elements of the hash index
+        up1Type = dynamic_cast<const dag::type::Array *>(
+                          up1Type->field_types[1])
+                          ->tuple_type;
+    }
+    const auto *const up2Type = dag_->predecessor(op, 1)->tuple->type;
+
+    const auto *key_Tuple = up1Type->ComputeHeadTuple(num_keys);
+
+    const auto *key_type = EmitTupleStructDefinition(context_, key_Tuple);
+
+    const auto *value_tuple1 = up1Type->ComputeTailTuple(num_keys);
+    const auto *value_type1 = EmitTupleStructDefinition(context_, value_tuple1);
+
+    const auto *value_tuple2 = up2Type->ComputeTailTuple(num_keys);
+    const auto *value_type2 = EmitTupleStructDefinition(context_, value_tuple2);
+
+    // Build operator
+    std::vector<std::string> template_args = {key_type->name, value_type1->name,
+                                              value_type2->name,
+                                              std::to_string(num_keys)};
+
+    // Only the hash join spills
+    const auto extra_args = operator_name == "JoinOperator"
+                                    ? memory_budget_args()
+                                    : std::vector<std::string>();
+
+    emitOperatorMake(var_name, operator_name, op, template_args, extra_args);
+}
+
+// Arguments of the hash-based operators that stay within a memory budget
+auto CodeGenVisitor::memory_budget_args() const -> std::vector<std::string> {
+    return {std::to_string(context_->memory_budget()) + "UL",
+            (format("R\"JITQSPILL(%1%)JITQSPILL\"") %
+             context_->spill_directory())
+                    .str()};
 }
 
 void CodeGenVisitor::visit_reduce_by_key(DAGOperator *op,
-                                         const std::string &operator_name) {
+                                         const std::string &operator_name,
+                                         const size_t num_keys) {
     assert(dynamic_cast<DAGReduceByKey *>(op) != nullptr ||
            dynamic_cast<DAGReduceByKeyGrouped *>(op) != nullptr);
 
@@ -521,12 +702,10 @@ void CodeGenVisitor::visit_reduce_by_key(DAGOperator *op,
             CodeGenVisitor::visit_common(op, operator_name);
 
     // Build key and value types
-
-    // TODO(sabir): This currently only works for keys of size 1
-    const auto *key_type_tuple = op->tuple->type->ComputeHeadTuple();
+    const auto *key_type_tuple = op->tuple->type->ComputeHeadTuple(num_keys);
     const auto *key_type = EmitTupleStructDefinition(context_, key_type_tuple);
 
-    const auto *value_type_tuple = op->tuple->type->ComputeTailTuple();
+    const auto *value_type_tuple = op->tuple->type->ComputeTailTuple(num_keys);
     const auto *value_type =
             EmitTupleStructDefinition(context_, value_type_tuple);
 
@@ -536,19 +715,25 @@ void CodeGenVisitor::visit_reduce_by_key(DAGOperator *op,
                                 {value_type, value_type}, value_type->name);
 
     // Collect template arguments
-    std::vector<std::string> template_args = {key_type->name, value_type->name};
+    std::vector<std::string> template_args = {key_type->name, value_type->name,
+                                              std::to_string(num_keys)};
+
+    std::vector<std::string> args = {functor_class + "()"};
+    if (operator_name == "ReduceByKeyOperator") {
+        const auto budget_args = memory_budget_args();
+        args.insert(args.end(), budget_args.begin(), budget_args.end());
+    }
 
     // Generate call
-    emitOperatorMake(var_name, operator_name, op, template_args,
-                     {functor_class + "()"});
+    emitOperatorMake(var_name, operator_name, op, template_args, args);
 }
 
 void CodeGenVisitor::operator()(DAGReduceByKey *op) {
-    visit_reduce_by_key(op, "ReduceByKeyOperator");
+    visit_reduce_by_key(op, "ReduceByKeyOperator", op->num_keys);
 }
 
 void CodeGenVisitor::operator()(DAGReduceByKeyGrouped *op) {
-    visit_reduce_by_key(op, "ReduceByKeyGroupedOperator");
+    visit_reduce_by_key(op, "ReduceByKeyGroupedOperator", op->num_keys);
 }
 
 void CodeGenVisitor::operator()(DAGReduceByIndex *op) {
@@ -592,6 +777,77 @@ void CodeGenVisitor::operator()(DAGSort *op) {
     emitOperatorMake(var_name, "SortOperator", op, {}, {});
 }
 
+void CodeGenVisitor::operator()(DAGDistinct *op) {
+    const std::string var_name =
+            CodeGenVisitor::visit_common(op, "DistinctOperator");
+    emitOperatorMake(var_name, "DistinctOperator", op, {}, {});
+}
+
+void CodeGenVisitor::operator()(DAGSortedDistinct *op) {
+    const std::string var_name =
+            CodeGenVisitor::visit_common(op, "SortedDistinctOperator");
+    emitOperatorMake(var_name, "SortedDistinctOperator", op, {}, {});
+}
+
+void CodeGenVisitor::operator()(DAGApproxCountDistinct *op) {
+    const std::string var_name =
+            CodeGenVisitor::visit_common(op, "ApproxCountDistinctOperator");
+    emitOperatorMake(var_name, "ApproxCountDistinctOperator", op,
+                     {std::to_string(op->precision)}, {});
+}
+
+void CodeGenVisitor::visit_window(DAGOperator *op, const size_t num_keys,
+                                  const size_t frame_size,
+                                  const bool is_grouped) {
+    assert(dynamic_cast<DAGWindow *>(op) != nullptr ||
+           dynamic_cast<DAGWindowGrouped *>(op) != nullptr);
+
+    // Without keys, the input forms a single partition, so it is grouped
+    const std::string operator_name = is_grouped || num_keys == 0
+                                              ? "WindowGroupedOperator"
+                                              : "WindowOperator";
+
+    const std::string var_name =
+            CodeGenVisitor::visit_common(op, operator_name);
+
+    // Build key and value types
+    const auto *const input_type = dag_->predecessor(op)->tuple->type;
+    const auto *const value_type_tuple =
+            num_keys == 0 ? input_type : input_type->ComputeTailTuple(num_keys);
+    const auto *const value_type =
+            EmitTupleStructDefinition(context_, value_type_tuple);
+
+    // Construct functor
+    const std::string functor_class =
+            GenerateLlvmFunctor(context_, op->name(), op->llvm_ir,
+                                {value_type, value_type}, value_type->name);
+
+    // Collect template arguments
+    std::vector<std::string> template_args;
+    if (operator_name == "WindowOperator") {
+        const auto *const key_type_tuple =
+                input_type->ComputeHeadTuple(num_keys);
+        const auto *const key_type =
+                EmitTupleStructDefinition(context_, key_type_tuple);
+        template_args.emplace_back(key_type->name);
+    }
+    template_args.emplace_back(value_type->name);
+    template_args.emplace_back(std::to_string(num_keys));
+    template_args.emplace_back(std::to_string(frame_size));
+
+    // Generate call
+    emitOperatorMake(var_name, operator_name, op, template_args,
+                     {functor_class + "()"});
+}
+
+void CodeGenVisitor::operator()(DAGWindow *op) {
+    visit_window(op, op->num_keys, op->frame_size, false);
+}
+
+void CodeGenVisitor::operator()(DAGWindowGrouped *op) {
+    visit_window(op, op->num_keys, op->frame_size, true);
+}
+
 void CodeGenVisitor::operator()(DAGZip *const op) {
     const std::string var_name =
             CodeGenVisitor::visit_common(op, "ZipOperator");
@@ -605,6 +861,32 @@ void CodeGenVisitor::operator()(DAGOperator *const op) {
 }
 
 // TODO(ingo): This could be an independent visitor
+auto CodeGenVisitor::emitProjectionFunctor(const std::string &prefix,
+                                           const DAGProjection *const op)
+        -> std::string {
+    const auto *input_type = operator_descs_[dag_->predecessor(op)].return_type;
+    const auto *return_type = operator_descs_[op].return_type;
+
+    const auto functor_class = context_->GenerateSymbolName(prefix, true);
+
+    std::vector<std::string> call_args;
+    for (auto const pos : op->positions) {
+        call_args.emplace_back("t." + input_type->names[pos]);
+    }
+
+    context_->definitions() <<  //
+            format("class %s {"
+                   "public:"
+                   "    auto operator()(const %s &t) {"
+                   "        return %s{%s};"
+                   "    }"
+                   "};") %
+                    functor_class % input_type->name % return_type->name %
+                    join(call_args, ",");
+
+    return functor_class;
+}
+
 auto CodeGenVisitor::visit_common(DAGOperator *op,
                                   const std::string &operator_name)
         -> std::string {
@@ -648,6 +930,23 @@ void CodeGenVisitor::emitOperatorMake(
     plan_body_ << format("auto %s = make%s<%s>(%s);") % variable_name %
                           operator_name % join(template_args, ",") %
                           join(args, ",");
+
+    emitPullOperator(variable_name, op);
+}
+
+void CodeGenVisitor::emitPullOperator(const std::string &variable_name,
+                                      const DAGOperator *const op) {
+    // Without push-based execution, hide the ForEach of the operator from
+    // its consumer such that it falls back to next()
+    if (!context_->push_based()) {
+        const auto *return_type = operator_descs_[op].return_type;
+        const auto pull_var_name = variable_name + "_pull";
+        plan_body_ << format("auto %s = makePullOperator<%s>(&%s);") %
+                              pull_var_name % return_type->name %
+                              variable_name;
+        operator_descs_[op].var_name = pull_var_name;
+        context_->includes().insert("\"PullOperator.h\"");
+    }
 }
 
 }  // namespace code_gen::cpp
@@ -40,17 +40,23 @@ public:
      */
     void operator()(DAGAntiJoin *op);
     void operator()(DAGAntiJoinPredicated *op);
+    void operator()(DAGApproxCountDistinct *op);
     void operator()(DAGAssertCorrectOpenNextClose *op);
     void operator()(DAGConcurrentExecuteLambda *op);
     void operator()(DAGConcurrentExecuteProcess *op);
     void operator()(DAGConstantTuple *op);
     void operator()(DAGColumnScan *op);
+    void operator()(DAGCsvScan *op);
+    void operator()(DAGDistinct *op);
     void operator()(DAGGroupBy *op);
+    void operator()(DAGHashIndex *op);
+    void operator()(DAGIndexJoin *op);
     void operator()(DAGMap *op);
     void operator()(DAGMapCpp *op);
     void operator()(DAGMaterializeColumnChunks *op);
     void operator()(DAGMaterializeParquet *op);
     void operator()(DAGMaterializeRowVector *op);
+    void operator()(DAGMergeJoin *op);
     void operator()(DAGNestedMap *op);
     void operator()(DAGParallelMapOmp *op);
     void operator()(DAGParameterLookup *op);
@@ -65,7 +71,9 @@ public:
     void operator()(DAGExchangeTcp *op);
     void operator()(DAGExpandPattern *op);
     void operator()(DAGFilter *op);
+    void operator()(DAGFlatMap *op);
     void operator()(DAGJoin *op);
+    void operator()(DAGBloomFilter *op);
     void operator()(DAGCartesian *op);
     void operator()(DAGReduceByIndex *op);
     void operator()(DAGReduceByKey *op);
@@ -75,8 +83,12 @@ public:
     void operator()(DAGSplitColumnData *op);
     void operator()(DAGSplitRange *op);
     void operator()(DAGSplitRowData *op);
+    void operator()(DAGSplitSkewedPartitions *op);
     void operator()(DAGTopK *op);
     void operator()(DAGSort *op);
+    void operator()(DAGSortedDistinct *op);
+    void operator()(DAGWindow *op);
+    void operator()(DAGWindowGrouped *op);
     void operator()(DAGZip *op);
     void operator()(DAGOperator *op);
 
@@ -94,12 +106,22 @@ private:
      */
     auto visit_common(DAGOperator *op, const std::string &operator_name)
             -> std::string;
-    void visit_reduce_by_key(DAGOperator *op, const std::string &operator_name);
+    void visit_join(DAGOperator *op, const std::string &operator_name,
+                    size_t num_keys);
+    void visit_reduce_by_key(DAGOperator *op, const std::string &operator_name,
+                             size_t num_keys);
+    void visit_window(DAGOperator *op, size_t num_keys, size_t frame_size,
+                      bool is_grouped);
+    auto memory_budget_args() const -> std::vector<std::string>;
     void emitOperatorMake(
             const std::string &variable_name, const std::string &operator_name,
             const DAGOperator *op,
             const std::vector<std::string> &extra_template_args = {},
             const std::vector<std::string> &extra_args = {});
+    void emitPullOperator(const std::string &variable_name,
+                          const DAGOperator *op);
+    auto emitProjectionFunctor(const std::string &prefix,
+                               const DAGProjection *op) -> std::string;
 };
 
 }  // namespace cpp
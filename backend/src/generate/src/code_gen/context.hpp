@@ -43,14 +43,21 @@ public:
             std::vector<std::string> *const llvm_code_files,
             std::unordered_map<std::string, size_t> *const unique_counters,
             std::set<std::string> *const includes,
-            TupleTypeRegistry *const tuple_type_descs)
+            TupleTypeRegistry *const tuple_type_descs, const bool push_based,
+            const size_t memory_budget = 0,
+            // cppcheck-suppress passedByValue
+            std::string spill_directory = "", const bool numa_aware = false)
         : declarations_(declarations),
           definitions_(definitions),
           llvm_code_dir_(std::move(llvm_code_dir)),
           llvm_code_files_(llvm_code_files),
           unique_counters_(unique_counters),
           includes_(includes),
-          tuple_type_descs_(tuple_type_descs) {}
+          tuple_type_descs_(tuple_type_descs),
+          push_based_(push_based),
+          memory_budget_(memory_budget),
+          spill_directory_(std::move(spill_directory)),
+          numa_aware_(numa_aware) {}
 
     auto GenerateSymbolName(const std::string &prefix,
                             bool try_empty_suffix = false) -> std::string;
@@ -72,6 +79,23 @@ public:
         return *tuple_type_descs_;
     }
 
+    // Whether consumers may drive their upstream pipelines with ForEach
+    [[nodiscard]] auto push_based() const -> bool { return push_based_; }
+
+    // Memory budget (in bytes, 0 for none) of each instance of the hash-based
+    // operators, beyond which they spill to the given directory (empty for
+    // the default temporary directory)
+    [[nodiscard]] auto memory_budget() const -> size_t {
+        return memory_budget_;
+    }
+    [[nodiscard]] auto spill_directory() const -> const std::string & {
+        return spill_directory_;
+    }
+
+    // Whether worker threads are pinned and parallel maps and partitions place
+    // their work and data on NUMA nodes
+    [[nodiscard]] auto numa_aware() const -> bool { return numa_aware_; }
+
 private:
     std::ostream *const declarations_;
     std::ostream *const definitions_;
@@ -80,6 +104,10 @@ private:
     std::unordered_map<std::string, size_t> *const unique_counters_;
     std::set<std::string> *const includes_;
     TupleTypeRegistry *const tuple_type_descs_;
+    const bool push_based_;
+    const size_t memory_budget_;
+    const std::string spill_directory_;
+    const bool numa_aware_;
 };
 
 }  // namespace cpp
@@ -6,7 +6,9 @@
 #include <utility>
 #include <vector>
 
+#include "CompositeKey.h"
 #include "Utils.h"
+#include "runtime/jit/memory/memory_tracker.hpp"
 #include "runtime/jit/operators/optional.hpp"
 
 /**
@@ -16,7 +18,8 @@
  * Keeps the left operator input ordered
  */
 template <class LeftUpstream, class RightUpstream, class Tuple, class KeyType,
-          class LeftValueType, class RightValueType, class Function>
+          class LeftValueType, class RightValueType, size_t kNumKeys,
+          class Function>
 class AntiJoinPredicatedOperator {
 public:
     AntiJoinPredicatedOperator(LeftUpstream *left_upstream,
@@ -39,7 +42,7 @@ public:
         // Build hash table from right upstream
         while (auto const ret = right_upstream_->next()) {
             auto const tuple = TupleToStdTuple(ret.value());
-            auto const [key, value] = SplitTuple(tuple);
+            auto const [key, value] = SplitTupleAt<kNumKeys>(tuple);
             auto const [it, _] =
                     build_table_.insert({StdTupleToTuple(key), {}});
             it->second.emplace_back(StdTupleToTuple(value));
@@ -49,7 +52,7 @@ public:
     Optional<Tuple> INLINE next() {
         while (auto ret = left_upstream_->next()) {
             auto const tuple = TupleToStdTuple(ret.value());
-            auto const [key_tuple, value_tuple] = SplitTuple(tuple);
+            auto const [key_tuple, value_tuple] = SplitTupleAt<kNumKeys>(tuple);
             auto const key = StdTupleToTuple(key_tuple);
             auto const value = StdTupleToTuple(value_tuple);
             const auto it = build_table_.find(key);
@@ -79,39 +82,35 @@ public:
     }
 
 private:
-    struct KeyTypeHash {
-        size_t operator()(const KeyType &key) const {
-            using FieldType = std::remove_cv_t<decltype(key.v0)>;
-            return std::hash<FieldType>()(key.v0);
-        }
-    };
-
-    struct KeyTypeEquals {
-        bool operator()(const KeyType &lhs, const KeyType &rhs) const {
-            return TupleToStdTuple(lhs) == TupleToStdTuple(rhs);
-        }
-    };
+    using KeyTypeHash = CompositeKeyHash<KeyType>;
+    using KeyTypeEquals = CompositeKeyEquals<KeyType>;
 
     LeftUpstream *const left_upstream_;
     RightUpstream *const right_upstream_;
-    std::unordered_map<KeyType, std::vector<RightValueType>, KeyTypeHash,
-                       KeyTypeEquals>
+    using RightValues =
+            std::vector<RightValueType,
+                        runtime::memory::TrackingAllocator<RightValueType>>;
+
+    std::unordered_map<KeyType, RightValues, KeyTypeHash, KeyTypeEquals,
+                       runtime::memory::TrackingAllocator<
+                               std::pair<const KeyType, RightValues>>>
             build_table_;
     LeftValueType last_left_upstream_;
     KeyType last_key_;
 };
 
 template <class Tuple, class KeyType, class LeftValueType, class RightValueType,
-          class LeftUpstream, class RightUpstream, class Function>
+          size_t kNumKeys, class LeftUpstream, class RightUpstream,
+          class Function>
 AntiJoinPredicatedOperator<LeftUpstream, RightUpstream, Tuple, KeyType,
-                           LeftValueType, RightValueType, Function>
+                           LeftValueType, RightValueType, kNumKeys, Function>
         INLINE makeAntiJoinPredicatedOperator(LeftUpstream *left_upstream,
                                               RightUpstream *right_upstream,
                                               Function func) {
     return AntiJoinPredicatedOperator<LeftUpstream, RightUpstream, Tuple,
                                       KeyType, LeftValueType, RightValueType,
-                                      Function>(left_upstream, right_upstream,
-                                                func);
+                                      kNumKeys, Function>(left_upstream,
+                                                          right_upstream, func);
 };
 
 #endif  // CODE_GEN_OPERATORS_ANTIJOINOPERATOR_PREDICATED_H
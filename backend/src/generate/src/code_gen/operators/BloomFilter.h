@@ -0,0 +1,85 @@
+#ifndef CODE_GEN_OPERATORS_BLOOMFILTER_H
+#define CODE_GEN_OPERATORS_BLOOMFILTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "CompositeKey.h"
+#include "Utils.h"
+
+/**
+ * Blocked Bloom filter over (possibly composite) keys given as std::tuple.
+ *
+ * Each key sets one bit in each of the eight 32-bit words of a single block
+ * of 256 bits, so inserting and probing touches only one cache line. The
+ * filter is sized for the number of keys passed to Reset with about 16 bits
+ * per key, which gives a false-positive rate of well below 1%.
+ */
+class BlockedBloomFilter {
+    static constexpr size_t kNumWordsPerBlock = 8;
+    static constexpr size_t kBitsPerKey = 16;
+    static constexpr size_t kBitsPerBlock = kNumWordsPerBlock * 32;
+
+    using Block = std::array<uint32_t, kNumWordsPerBlock>;
+
+public:
+    void Reset(const size_t num_keys) {
+        size_t num_blocks = 1;
+        while (num_blocks * kBitsPerBlock < num_keys * kBitsPerKey) {
+            num_blocks *= 2;
+        }
+        blocks_.assign(num_blocks, Block{});
+        block_mask_ = num_blocks - 1;
+    }
+
+    template <class... Ts>
+    INLINE void Insert(const std::tuple<Ts...> &key) {
+        const uint64_t hash = Hash(key);
+        auto &block = blocks_[(hash >> 32U) & block_mask_];
+        for (size_t i = 0; i < kNumWordsPerBlock; i++) {
+            block[i] |= BitOfWord(static_cast<uint32_t>(hash), i);
+        }
+    }
+
+    template <class... Ts>
+    [[nodiscard]] INLINE auto MayContain(const std::tuple<Ts...> &key) const
+            -> bool {
+        const uint64_t hash = Hash(key);
+        const auto &block = blocks_[(hash >> 32U) & block_mask_];
+        for (size_t i = 0; i < kNumWordsPerBlock; i++) {
+            const uint32_t bit = BitOfWord(static_cast<uint32_t>(hash), i);
+            if ((block[i] & bit) == 0) return false;
+        }
+        return true;
+    }
+
+private:
+    // Odd constants that derive eight independent bit positions from one hash
+    static constexpr std::array<uint32_t, kNumWordsPerBlock> kSalts = {
+            0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+            0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+    static INLINE auto BitOfWord(const uint32_t hash, const size_t word)
+            -> uint32_t {
+        return 1U << ((hash * kSalts[word]) >> 27U);
+    }
+
+    // Unlike in the hash tables, the hash needs to be well mixed: std::hash of
+    // integers is the identity, which would map dense keys to few bits
+    template <class... Ts>
+    static INLINE auto Hash(const std::tuple<Ts...> &key) -> uint64_t {
+        return MixHash(CombineHashes(key));
+    }
+
+    std::vector<Block> blocks_;
+    size_t block_mask_ = 0;
+};
+
+#endif  // CODE_GEN_OPERATORS_BLOOMFILTER_H
@@ -0,0 +1,101 @@
+#ifndef CODE_GEN_OPERATORS_BLOOMFILTEROPERATOR_H
+#define CODE_GEN_OPERATORS_BLOOMFILTEROPERATOR_H
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "BloomFilter.h"
+#include "Utils.h"
+#include "runtime/jit/operators/optional.hpp"
+
+/**
+ * Filters the tuples of the probe input (first upstream) by the keys of the
+ * build input (second upstream), i.e., the first kNumKeys fields of its
+ * tuples. The key of the probe input consists of the fields at kKeyPositions.
+ *
+ * This is the probe-side half of a join pushed down below the join: tuples
+ * whose key is outside the range of the build keys or not in a Bloom filter of
+ * them are dropped; all others, including some false positives, are kept.
+ */
+template <class ProbeUpstream, class BuildUpstream, class Tuple,
+          size_t kNumKeys, size_t... kKeyPositions>
+class BloomFilterOperator {
+    static_assert(sizeof...(kKeyPositions) == kNumKeys,
+                  "Probe and build key need to have the same number of fields");
+
+public:
+    BloomFilterOperator(ProbeUpstream *probe_upstream,
+                        BuildUpstream *build_upstream)
+        : probe_upstream_(probe_upstream), build_upstream_(build_upstream){};
+
+    void INLINE open() {
+        probe_upstream_->open();
+        build_upstream_->open();
+
+        // Collect keys of build side
+        std::vector<BuildKey> keys;
+        while (auto const ret = build_upstream_->next()) {
+            auto const tuple = TupleToStdTuple(ret.value());
+            keys.emplace_back(SplitTupleAt<kNumKeys>(tuple).first);
+        }
+
+        // Build filter and range
+        filter_.Reset(keys.size());
+        is_empty_ = keys.empty();
+        if (!is_empty_) {
+            min_key_ = *std::min_element(keys.begin(), keys.end());
+            max_key_ = *std::max_element(keys.begin(), keys.end());
+        }
+        for (auto const &key : keys) {
+            filter_.Insert(key);
+        }
+
+        build_upstream_->close();
+    }
+
+    Optional<Tuple> INLINE next() {
+        if (is_empty_) return {};
+
+        while (auto ret = probe_upstream_->next()) {
+            auto const tuple = TupleToStdTuple(ret.value());
+            auto const key = std::make_tuple(std::get<kKeyPositions>(tuple)...);
+            if (key < min_key_ || max_key_ < key) continue;
+            if (filter_.MayContain(key)) return ret;
+        }
+
+        return {};
+    }
+
+    void INLINE close() { probe_upstream_->close(); }
+
+private:
+    using BuildTuple = std::remove_cv_t<std::remove_reference_t<decltype(
+            std::declval<BuildUpstream>().next().value())>>;
+    using BuildKey = decltype(
+            SplitTupleAt<kNumKeys>(TupleToStdTuple(std::declval<BuildTuple>()))
+                    .first);
+
+    ProbeUpstream *const probe_upstream_;
+    BuildUpstream *const build_upstream_;
+
+    BlockedBloomFilter filter_;
+    bool is_empty_ = true;
+    BuildKey min_key_;
+    BuildKey max_key_;
+};
+
+template <class Tuple, size_t kNumKeys, size_t... kKeyPositions,
+          class ProbeUpstream, class BuildUpstream>
+BloomFilterOperator<ProbeUpstream, BuildUpstream, Tuple, kNumKeys,
+                    kKeyPositions...>
+        INLINE makeBloomFilterOperator(ProbeUpstream *probe_upstream,
+                                       BuildUpstream *build_upstream) {
+    return BloomFilterOperator<ProbeUpstream, BuildUpstream, Tuple, kNumKeys,
+                               kKeyPositions...>(probe_upstream,
+                                                 build_upstream);
+};
+
+#endif  // CODE_GEN_OPERATORS_BLOOMFILTEROPERATOR_H
@@ -86,16 +86,43 @@ public:
             columns_ = MakeColumns(input_tuple);
         }
 
-        const auto output_tuple = Lookup(current_index_);
-        const auto ret =
-                StdTupleToTuple(MakeResulTuple()(output_tuple, current_index_));
+        const auto ret = BuildResultTuple(current_index_);
         current_index_++;
         return ret;
     }
 
+    template <class Consumer>
+    INLINE void ForEach(Consumer &&consume) {
+        ScanRemaining(consume);
+        ForEachTuple(upstream_, [&](const auto &input) {
+            auto const input_tuple = TupleToStdTuple(input);
+
+            const auto num_elements = std::get<0>(input_tuple).shape[0];
+            current_index_ = std::get<0>(input_tuple).offsets[0];
+            last_index_ = current_index_ + num_elements;
+            columns_ = MakeColumns(input_tuple);
+            ScanRemaining(consume);
+        });
+    }
+
     INLINE void close() { upstream_->close(); }
 
 private:
+    INLINE Tuple BuildResultTuple(const size_t index) {
+        const auto output_tuple = Lookup(index);
+        return StdTupleToTuple(MakeResulTuple()(output_tuple, index));
+    }
+
+    // Consumes the remaining tuples of the current input columns
+    template <class Consumer>
+    INLINE void ScanRemaining(Consumer &consume) {
+        const size_t end = last_index_;
+        for (size_t i = current_index_; i < end; i++) {
+            consume(BuildResultTuple(i));
+        }
+        current_index_ = end;
+    }
+
     Upstream *const upstream_;
     size_t current_index_;
     size_t last_index_;
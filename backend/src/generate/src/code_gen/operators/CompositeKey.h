@@ -0,0 +1,108 @@
+#ifndef CODE_GEN_OPERATORS_COMPOSITEKEY_H
+#define CODE_GEN_OPERATORS_COMPOSITEKEY_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Utils.h"
+
+/**
+ * Hash function and equality for the (possibly composite) keys of the
+ * hash-based operators.
+ *
+ * Single-field keys are hashed with std::hash as before. Keys consisting only
+ * of integers that fit into 64 bits together are normalized, i.e., packed
+ * into one integer, which is then hashed like a single-field key. All other
+ * keys combine the hashes of their fields with CombineHashes.
+ */
+
+// Finalizer of MurmurHash3: every bit of the input affects every bit of the
+// result, unlike with std::hash of integers, which is the identity
+inline INLINE auto MixHash(uint64_t hash) -> uint64_t {
+    hash ^= hash >> 33U;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33U;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33U;
+    return hash;
+}
+
+// Combines the hashes of the given fields like boost::hash_combine, which
+// depends on the order of the fields. Each field hash is mixed first: with
+// the identity hashes of integers, a plain polynomial like 31 * h(a) + h(b)
+// maps (a, b) and (a + 1, b - 31) to the same value.
+template <class... Ts>
+inline INLINE auto CombineHashes(const std::tuple<Ts...> &fields) -> uint64_t {
+    constexpr uint64_t kGoldenRatio = 0x9e3779b97f4a7c15ULL;
+    uint64_t seed = 0;
+    std::apply(
+            [&](auto const &... field) {
+                ((seed ^= MixHash(std::hash<std::decay_t<decltype(field)>>()(
+                                  field)) +
+                          kGoldenRatio + (seed << 6U) + (seed >> 2U)),
+                 ...);
+            },
+            fields);
+    return seed;
+}
+
+template <class KeyType>
+struct CompositeKeyHash {
+private:
+    template <class... Ts>
+    static constexpr bool kIsPackable =
+            (std::is_integral_v<Ts> && ...) &&
+            (sizeof(Ts) + ... + 0) <= sizeof(uint64_t);
+
+    template <class T>
+    static INLINE auto ToUnsigned(const T value) -> uint64_t {
+        if constexpr (std::is_same_v<T, bool>) {
+            return value ? 1 : 0;
+        } else {
+            return static_cast<std::make_unsigned_t<T>>(value);
+        }
+    }
+
+    template <class... Ts, size_t... kIs>
+    static INLINE auto Pack(const std::tuple<Ts...> &t,
+                            std::index_sequence<kIs...> /*unused*/)
+            -> uint64_t {
+        uint64_t packed = 0;
+        ((packed = (packed << (8 * sizeof(Ts))) | ToUnsigned(std::get<kIs>(t))),
+         ...);
+        return packed;
+    }
+
+    template <class... Ts>
+    static INLINE auto Hash(const std::tuple<Ts...> &t) -> size_t {
+        constexpr size_t kNumFields = sizeof...(Ts);
+        if constexpr (kNumFields == 1) {
+            return std::hash<Ts...>()(std::get<0>(t));
+        } else if constexpr (kIsPackable<Ts...>) {
+            return std::hash<uint64_t>()(
+                    Pack(t, std::make_index_sequence<kNumFields>()));
+        } else {
+            return CombineHashes(t);
+        }
+    }
+
+public:
+    INLINE auto operator()(const KeyType &key) const -> size_t {
+        return Hash(TupleToStdTuple(key));
+    }
+};
+
+template <class KeyType>
+struct CompositeKeyEquals {
+    INLINE auto operator()(const KeyType &lhs, const KeyType &rhs) const
+            -> bool {
+        return TupleToStdTuple(lhs) == TupleToStdTuple(rhs);
+    }
+};
+
+#endif  // CODE_GEN_OPERATORS_COMPOSITEKEY_H
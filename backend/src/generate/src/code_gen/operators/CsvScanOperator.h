@@ -0,0 +1,60 @@
+#ifndef CODE_GEN_OPERATORS_CSVSCANOPERATOR_H
+#define CODE_GEN_OPERATORS_CSVSCANOPERATOR_H
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#include "TupleToValueOperator.h"
+#include "Utils.h"
+#include "runtime/jit/operators/csv_scan.hpp"
+#include "runtime/jit/operators/optional.hpp"
+
+template <class OutputTuple, class Upstream>
+class CsvScanOperator {
+public:
+    CsvScanOperator(Upstream* const upstream,
+                    std::vector<std::string>&& column_types,
+                    std::vector<int>&& col_ids, const char delimiter,
+                    const char quote, const bool has_header,
+                    const std::string& filesystem)
+        : upstream_(runtime::operators::MakeCsvScanOperator(
+                  std::make_unique<TupleToValueOperator<Upstream>>(upstream),
+                  column_types, col_ids, delimiter, quote, has_header,
+                  filesystem, NumAvailableThreads())) {}
+
+    INLINE void open() { upstream_->open(); }
+
+    INLINE Optional<OutputTuple> next() {
+        const auto input = upstream_->next();
+        return ValueToTuple<OutputTuple>(input);
+    }
+
+    INLINE void close() { upstream_->close(); }
+
+private:
+    // Slices scanned by the tasks of a parallel region must not start a thread
+    // per core each, so they only use the cores the region leaves idle
+    static auto NumAvailableThreads() -> size_t {
+        const int num_procs = omp_get_num_procs();
+        if (omp_in_parallel() == 0) return std::max(1, num_procs);
+        return std::max(1, num_procs - omp_get_num_threads());
+    }
+
+    std::unique_ptr<runtime::operators::ValueOperator> upstream_;
+};
+
+template <class OutputTuple, class Upstream>
+CsvScanOperator<OutputTuple, Upstream> makeCsvScanOperator(
+        Upstream* const upstream, std::vector<std::string>&& column_types,
+        std::vector<int>&& col_ids, const char delimiter, const char quote,
+        const bool has_header, const std::string& filesystem) {
+    return CsvScanOperator<OutputTuple, Upstream>(
+            upstream, std::move(column_types), std::move(col_ids), delimiter,
+            quote, has_header, filesystem);
+}
+
+#endif  // CODE_GEN_OPERATORS_CSVSCANOPERATOR_H
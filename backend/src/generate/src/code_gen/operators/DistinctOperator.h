@@ -0,0 +1,58 @@
+#ifndef CODE_GEN_OPERATORS_DISTINCTOPERATOR_H
+#define CODE_GEN_OPERATORS_DISTINCTOPERATOR_H
+
+#include <unordered_set>
+
+#include "CompositeKey.h"
+#include "Utils.h"
+#include "runtime/jit/memory/memory_tracker.hpp"
+#include "runtime/jit/operators/optional.hpp"
+
+/**
+ * Returns each distinct input tuple once, comparing all fields
+ *
+ * Unlike the emulation with ReduceByKey, the hash table does not hold any
+ * values and there is no function call per tuple.
+ *
+ * Result tuples are in an arbitrary order
+ */
+template <class Upstream, class Tuple>
+class DistinctOperator {
+public:
+    DistinctOperator(Upstream *const upstream) : upstream_(upstream) {}
+
+    void INLINE open() {
+        upstream_->open();
+        hash_set_.clear();
+        ForEachTuple(upstream_,
+                     [&](const Tuple &tuple) { hash_set_.insert(tuple); });
+        current_result_it_ = hash_set_.begin();
+    }
+
+    Optional<Tuple> INLINE next() {
+        if (current_result_it_ == hash_set_.end()) {
+            return {};
+        }
+        return *(current_result_it_++);
+    }
+
+    void INLINE close() { upstream_->close(); }
+
+private:
+    using TupleHash = CompositeKeyHash<Tuple>;
+    using TupleEquals = CompositeKeyEquals<Tuple>;
+
+    Upstream *const upstream_;
+    std::unordered_set<Tuple, TupleHash, TupleEquals,
+                       runtime::memory::TrackingAllocator<Tuple>>
+            hash_set_;
+    typename decltype(hash_set_)::iterator current_result_it_;
+};
+
+template <class Tuple, class Upstream>
+DistinctOperator<Upstream, Tuple> INLINE
+makeDistinctOperator(Upstream *const upstream) {
+    return DistinctOperator<Upstream, Tuple>(upstream);
+};
+
+#endif  // CODE_GEN_OPERATORS_DISTINCTOPERATOR_H
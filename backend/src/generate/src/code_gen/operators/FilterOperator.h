@@ -26,6 +26,13 @@ public:
         return {};
     }
 
+    template <class Consumer>
+    INLINE void ForEach(Consumer &&consume) {
+        ForEachTuple(upstream, [&](const auto &input) {
+            if (function(input)) consume(input);
+        });
+    }
+
     INLINE void open() { upstream->open(); }
 
     INLINE void close() { upstream->close(); }
@@ -0,0 +1,63 @@
+#ifndef CODE_GEN_OPERATORS_FLATMAPOPERATOR_H
+#define CODE_GEN_OPERATORS_FLATMAPOPERATOR_H
+
+#include "Utils.h"
+#include "runtime/jit/operators/optional.hpp"
+
+// Runs the generator on each upstream tuple and returns what it yields. The
+// generator is resumed in place for every call to next(), so no intermediate
+// result is materialized.
+template <class Upstream, class Tuple, class Generator>
+class FlatMapOperator {
+public:
+    FlatMapOperator(Upstream *const upstream, Generator generator)
+        : upstream_(upstream), generator_(generator) {}
+
+    INLINE void open() {
+        upstream_->open();
+        has_generator_ = false;
+    }
+
+    INLINE Optional<Tuple> next() {
+        while (true) {
+            if (has_generator_) {
+                Tuple ret;
+                if (generator_.next(&ret)) return ret;
+                has_generator_ = false;
+            }
+
+            auto input = upstream_->next();
+            if (!input) return {};
+            generator_.init(input.value());
+            has_generator_ = true;
+        }
+    }
+
+    template <class Consumer>
+    INLINE void ForEach(Consumer &&consume) {
+        Tuple ret;
+        if (has_generator_) {
+            while (generator_.next(&ret)) consume(ret);
+            has_generator_ = false;
+        }
+        ForEachTuple(upstream_, [&](const auto &input) {
+            generator_.init(input);
+            while (generator_.next(&ret)) consume(ret);
+        });
+    }
+
+    INLINE void close() { upstream_->close(); }
+
+private:
+    Upstream *const upstream_;
+    Generator generator_;
+    bool has_generator_ = false;
+};
+
+template <class Tuple, class Upstream, class Generator>
+FlatMapOperator<Upstream, Tuple, Generator> makeFlatMapOperator(
+        Upstream *const upstream, Generator generator) {
+    return FlatMapOperator<Upstream, Tuple, Generator>(upstream, generator);
+};
+
+#endif  // CODE_GEN_OPERATORS_FLATMAPOPERATOR_H
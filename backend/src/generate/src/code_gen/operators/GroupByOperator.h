@@ -1,62 +1,139 @@
 #ifndef CODE_GEN_OPERATORS_GROUP_BY_OPERATOR_H
 #define CODE_GEN_OPERATORS_GROUP_BY_OPERATOR_H
 
+#include <cassert>
+#include <cstdlib>
+
+#include <algorithm>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include <omp.h>
+
 #include "Utils.h"
 #include "runtime/jit/memory/free_ref_counter.hpp"
 #include "runtime/jit/memory/shared_pointer.hpp"
 #include "runtime/jit/operators/optional.hpp"
 
+/**
+ * Groups the input tuples by their first field using a counting sort.
+ *
+ * The input is buffered while dense group IDs are assigned. The buffer is then
+ * split into at most one morsel per thread; each morsel computes a histogram
+ * of its groups, a prefix sum over (group, morsel) yields the final position
+ * of every tuple, and the morsels scatter their tuples in parallel into one
+ * contiguous output region. The arrays produced by next() are zero-copy slices
+ * (via their offset) of that region, which they share ownership of.
+ *
+ * Result tuples are in order of first appearance of their key
+ */
 template <class Upstream, class Tuple>
 class GroupByOperator {
 public:
+    using KeyType = std::remove_cv_t<decltype(std::declval<Tuple>().v0)>;
     using OutputArray = decltype(std::declval<Tuple>().v1);
     using InnerTuple = typename std::remove_reference<decltype(
             std::declval<OutputArray>().data[0])>::type;
 
+    static constexpr size_t kMinMorselSize = 1U << 12U;
+
     GroupByOperator(Upstream *const upstream) : upstream_(upstream) {}
 
     INLINE void open() {
-        if (!result_.empty()) return;
+        current_group_ = 0;
+        if (is_materialized_) return;
+        is_materialized_ = true;
+
+        // Buffer the input and assign dense group IDs in order of appearance
+        std::unordered_map<KeyType, size_t> group_ids;
+        std::vector<InnerTuple> tuples;
+        std::vector<size_t> tuple_groups;
 
         upstream_->open();
+        ForEachTuple(upstream_, [&](const auto &input_tuple) {
+            auto const [it, is_new] =
+                    group_ids.emplace(input_tuple.v0, keys_.size());
+            if (is_new) keys_.emplace_back(input_tuple.v0);
+            tuple_groups.emplace_back(it->second);
+            tuples.emplace_back(InnerTuple{input_tuple.v1});
+        });
+        upstream_->close();
 
-        // Store tuples into a vector per partition
-        while (const auto ret = upstream_->next()) {
-            auto const input_tuple = ret.value();
-            result_[input_tuple.v0].emplace_back(InnerTuple{input_tuple.v1});
+        num_tuples_ = tuples.size();
+        const size_t num_groups = keys_.size();
+        group_offsets_.assign(num_groups + 1, 0);
+        if (num_tuples_ == 0) return;
+
+        // Split input into morsels, at most one per thread
+        const size_t max_num_morsels =
+                (num_tuples_ + kMinMorselSize - 1) / kMinMorselSize;
+        const size_t num_morsels = std::max<size_t>(
+                1, std::min<size_t>(max_num_morsels, omp_get_max_threads()));
+        const size_t morsel_size = (num_tuples_ + num_morsels - 1) / num_morsels;
+
+        // Per-morsel histograms, stored morsel-major
+        std::vector<size_t> positions(num_morsels * num_groups, 0);
+#pragma omp taskloop default(shared) grainsize(1)
+        for (size_t m = 0; m < num_morsels; m++) {
+            size_t *const histogram = positions.data() + m * num_groups;
+            const size_t end = std::min(num_tuples_, (m + 1) * morsel_size);
+            for (size_t i = m * morsel_size; i < end; i++) {
+                histogram[tuple_groups[i]]++;
+            }
         }
-        current_output_it_ = result_.begin();
 
-        upstream_->close();
+        // Exclusive prefix sum in group-major order: each group is contiguous
+        // and, within a group, each morsel writes after the previous ones
+        size_t sum = 0;
+        for (size_t g = 0; g < num_groups; g++) {
+            group_offsets_[g] = sum;
+            for (size_t m = 0; m < num_morsels; m++) {
+                auto &position = positions[m * num_groups + g];
+                const size_t count = position;
+                position = sum;
+                sum += count;
+            }
+        }
+        group_offsets_[num_groups] = sum;
+        assert(sum == num_tuples_);
+
+        // Allocate one output region for all groups
+        auto *const region = reinterpret_cast<InnerTuple *>(
+                malloc(sizeof(InnerTuple) * num_tuples_));
+        assert(region != nullptr);
+        auto *const ref_counter =
+                new runtime::memory::FreeRefCounter<InnerTuple>(region, 0,
+                                                                num_tuples_);
+        data_ = runtime::memory::SharedPointer<InnerTuple>(ref_counter);
+
+        // Scatter tuples into their final position
+#pragma omp taskloop default(shared) grainsize(1)
+        for (size_t m = 0; m < num_morsels; m++) {
+            size_t *const cursors = positions.data() + m * num_groups;
+            const size_t end = std::min(num_tuples_, (m + 1) * morsel_size);
+            for (size_t i = m * morsel_size; i < end; i++) {
+                new (region + cursors[tuple_groups[i]]++)
+                        InnerTuple(std::move(tuples[i]));
+            }
+        }
+        ref_counter->set_num_elements(num_tuples_);
     }
 
     INLINE Optional<Tuple> next() {
-        if (current_output_it_ == result_.end()) return {};
+        if (current_group_ == keys_.size()) return {};
 
-        auto &result_data = current_output_it_->second;
+        const size_t group = current_group_++;
 
-        // Convert the vector of the current partition into an array
+        // Return a slice of the shared output region
         Tuple output;
-        output.v0 = current_output_it_->first;
-        output.v1.offsets[0] = 0;
-        output.v1.outer_shape[0] = result_data.size();
-        output.v1.shape[0] = output.v1.outer_shape[0];
-        output.v1.data = runtime::memory::SharedPointer<InnerTuple>(
-                new runtime::memory::FreeRefCounter<InnerTuple>(
-                        malloc(sizeof(InnerTuple) * output.v1.outer_shape[0]),
-                        output.v1.outer_shape[0]));
-        assert(output.v1.outer_shape[0] == 0 ||
-               output.v1.data.get() != nullptr);
-
-        for (size_t i = 0; i < result_data.size(); i++) {
-            new (output.v1.data.get() + i)
-                    InnerTuple(std::move(result_data[i]));
-        }
-
-        current_output_it_++;
+        output.v0 = keys_[group];
+        output.v1.data = data_;
+        output.v1.outer_shape[0] = num_tuples_;
+        output.v1.offsets[0] = group_offsets_[group];
+        output.v1.shape[0] =
+                group_offsets_[group + 1] - group_offsets_[group];
 
         return output;
     }
@@ -65,8 +142,12 @@ public:
 
 private:
     Upstream *const upstream_;
-    std::unordered_map<long, std::vector<InnerTuple>> result_{};
-    typename decltype(result_)::iterator current_output_it_{};
+    bool is_materialized_ = false;
+    size_t num_tuples_ = 0;
+    std::vector<KeyType> keys_{};
+    std::vector<size_t> group_offsets_{};
+    runtime::memory::SharedPointer<InnerTuple> data_{};
+    size_t current_group_ = 0;
 };
 
 template <class Tuple, class Upstream>
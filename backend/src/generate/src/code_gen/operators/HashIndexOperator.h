@@ -0,0 +1,169 @@
+#ifndef CODE_GEN_OPERATORS_HASHINDEXOPERATOR_H
+#define CODE_GEN_OPERATORS_HASHINDEXOPERATOR_H
+
+#include <cassert>
+#include <cstdlib>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <omp.h>
+
+#include "CompositeKey.h"
+#include "Utils.h"
+#include "runtime/jit/memory/free_ref_counter.hpp"
+#include "runtime/jit/memory/shared_pointer.hpp"
+#include "runtime/jit/operators/optional.hpp"
+
+// Bucket of the given key in a hash index with the given number of buckets,
+// which needs to be a power of two. The hash is mixed such that strided keys
+// are spread over all buckets.
+template <class KeyType>
+INLINE auto ComputeHashIndexBucket(const KeyType &key,
+                                   const size_t num_buckets) -> size_t {
+    // Finalizer of MurmurHash3
+    uint64_t hash = CompositeKeyHash<KeyType>()(key);
+    hash ^= hash >> 33U;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33U;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33U;
+    return hash & (num_buckets - 1);
+}
+
+/**
+ * Builds a read-only hash index of the input tuples, which can be shared by
+ * several threads probing it (see IndexJoinOperator). Returns a single tuple
+ * of two arrays: the bucket offsets (with one more entry than buckets) and the
+ * input tuples ordered by bucket, i.e., the tuples of bucket b are at
+ * positions [offsets[b], offsets[b+1]).
+ *
+ * The input is read by one thread but the index is built in parallel: one task
+ * per morsel counts the tuples of each bucket and then scatters the tuples
+ * into their buckets, both using atomic increments on per-bucket counters.
+ * The index is built only once, even if the operator is opened several times.
+ */
+template <class Upstream, class OutputTuple, class KeyType, size_t kNumKeys>
+class HashIndexOperator {
+    using OffsetArray = decltype(std::declval<OutputTuple>().v0);
+    using Offset = std::remove_reference_t<decltype(
+            std::declval<OffsetArray>().data[0])>;
+    using TupleArray = decltype(std::declval<OutputTuple>().v1);
+    using InputTuple = std::remove_reference_t<decltype(
+            std::declval<TupleArray>().data[0])>;
+
+    static constexpr size_t kMorselSize = 1U << 14U;
+
+public:
+    explicit HashIndexOperator(Upstream *const upstream)
+        : upstream_(upstream) {}
+
+    INLINE void open() { has_returned_ = false; }
+
+    INLINE Optional<OutputTuple> next() {
+        if (has_returned_) return {};
+        has_returned_ = true;
+
+        if (!is_built_) {
+            Build();
+            is_built_ = true;
+        }
+
+        return index_;
+    }
+
+    INLINE void close() {}
+
+private:
+    void Build() {
+        std::vector<InputTuple> input;
+        upstream_->open();
+        ForEachTuple(upstream_,
+                     [&](const InputTuple &tuple) { input.push_back(tuple); });
+        upstream_->close();
+
+        const size_t num_tuples = input.size();
+        size_t num_buckets = 1;
+        while (num_buckets < num_tuples) num_buckets *= 2;
+
+        // Count tuples per bucket
+        const size_t num_morsels = (num_tuples + kMorselSize - 1) / kMorselSize;
+        std::vector<size_t> buckets(num_tuples);
+        std::unique_ptr<std::atomic<size_t>[]> cursors(
+                new std::atomic<size_t>[num_buckets]());
+#pragma omp taskloop default(shared) grainsize(1)
+        for (size_t m = 0; m < num_morsels; m++) {
+            const size_t end = std::min(num_tuples, (m + 1) * kMorselSize);
+            for (size_t i = m * kMorselSize; i < end; i++) {
+                auto const tuple = TupleToStdTuple(input[i]);
+                auto const key =
+                        StdTupleToTuple(SplitTupleAt<kNumKeys>(tuple).first);
+                buckets[i] = ComputeHashIndexBucket(key, num_buckets);
+                cursors[buckets[i]].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        // Compute bucket offsets and let cursors point to bucket starts
+        auto *const offsets = Allocate<Offset>(num_buckets + 1);
+        size_t offset = 0;
+        for (size_t b = 0; b < num_buckets; b++) {
+            const size_t count = cursors[b].load(std::memory_order_relaxed);
+            new (offsets + b) Offset{static_cast<long>(offset)};
+            cursors[b].store(offset, std::memory_order_relaxed);
+            offset += count;
+        }
+        new (offsets + num_buckets) Offset{static_cast<long>(offset)};
+
+        // Scatter tuples into their buckets
+        auto *const tuples = Allocate<InputTuple>(num_tuples);
+#pragma omp taskloop default(shared) grainsize(1)
+        for (size_t m = 0; m < num_morsels; m++) {
+            const size_t end = std::min(num_tuples, (m + 1) * kMorselSize);
+            for (size_t i = m * kMorselSize; i < end; i++) {
+                const size_t pos = cursors[buckets[i]].fetch_add(
+                        1, std::memory_order_relaxed);
+                new (tuples + pos) InputTuple(std::move(input[i]));
+            }
+        }
+
+        index_.v0 = MakeArray<OffsetArray>(offsets, num_buckets + 1);
+        index_.v1 = MakeArray<TupleArray>(tuples, num_tuples);
+    }
+
+    template <class T>
+    static T *Allocate(const size_t num_elements) {
+        auto *const region = reinterpret_cast<T *>(
+                malloc(sizeof(T) * std::max<size_t>(1, num_elements)));
+        assert(region != nullptr);
+        return region;
+    }
+
+    template <class Array, class T>
+    static Array MakeArray(T *const region, const size_t num_elements) {
+        Array array;
+        array.data = runtime::memory::SharedPointer<T>(
+                new runtime::memory::FreeRefCounter<T>(region, num_elements));
+        array.outer_shape[0] = num_elements;
+        array.offsets[0] = 0;
+        array.shape[0] = num_elements;
+        return array;
+    }
+
+    Upstream *const upstream_;
+    bool has_returned_ = false;
+    bool is_built_ = false;
+    OutputTuple index_;
+};
+
+template <class OutputTuple, class KeyType, size_t kNumKeys, class Upstream>
+HashIndexOperator<Upstream, OutputTuple, KeyType, kNumKeys>
+makeHashIndexOperator(Upstream *const upstream) {
+    return HashIndexOperator<Upstream, OutputTuple, KeyType, kNumKeys>(
+            upstream);
+}
+
+#endif  // CODE_GEN_OPERATORS_HASHINDEXOPERATOR_H
@@ -0,0 +1,277 @@
+#ifndef CODE_GEN_OPERATORS_HYBRIDHASH_H
+#define CODE_GEN_OPERATORS_HYBRIDHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "CompositeKey.h"
+#include "Utils.h"
+#include "runtime/jit/memory/spill_file.hpp"
+
+/**
+ * Building blocks of the hash-based operators that stay within a memory
+ * budget (hybrid hashing).
+ *
+ * The keys are divided into kFanout partitions by their hash. Once the hash
+ * table of an operator exceeds the budget, the operator writes the partition
+ * with the most entries to disk and sends all further tuples of that partition
+ * there as well, keeping the remaining partitions in memory. After the
+ * in-memory partitions are done, the operator processes each spilled one in
+ * the same way, using a different partitioning on the next level, such that
+ * partitions that still do not fit are divided further. From kMaxLevel on, the
+ * budget is ignored; this only happens if a handful of keys take more than
+ * the budget.
+ *
+ * Only tuples of trivially copyable fields can be spilled; operators on other
+ * tuples ignore the budget.
+ */
+namespace hybrid_hash {
+
+constexpr size_t kFanoutBits = 4;
+constexpr size_t kFanout = 1U << kFanoutBits;
+constexpr size_t kMaxLevel = 4;
+
+template <class StdTuple>
+struct IsSpillable : std::false_type {};
+
+template <class... Ts>
+struct IsSpillable<std::tuple<Ts...>>
+    : std::bool_constant<(std::is_trivially_copyable_v<Ts> && ...)> {};
+
+// Returns the partition of the key on the given level. The key hash is mixed
+// with the level and scrambled (with the finalizer of MurmurHash3), such that
+// the partitions do not depend on the low bits used by the hash table, nor on
+// the partitions of the previous levels.
+template <class KeyType>
+INLINE auto PartitionOf(const KeyType &key, const size_t level) -> size_t {
+    uint64_t hash = CompositeKeyHash<KeyType>()(key);
+    hash += (level + 1) * 0x9e3779b97f4a7c15ULL;
+    hash ^= hash >> 33U;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33U;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33U;
+    return hash >> (64 - kFanoutBits);
+}
+
+// Approximates the memory used by a node-based hash table, i.e., by
+// std::unordered_map and std::unordered_set
+template <class HashTable>
+auto EstimateBytes(const HashTable &table) -> size_t {
+    // Each node also has a pointer to the next one and the cached hash
+    constexpr size_t kNodeSize =
+            sizeof(typename HashTable::value_type) + 2 * sizeof(void *);
+    return table.size() * kNodeSize + table.bucket_count() * sizeof(void *);
+}
+
+// Shrinks the bucket array of the table to its current size. Erasing entries
+// never does that, so without it, the estimate above would stay above the
+// memory budget after spilling and make the operator spill every partition.
+template <class HashTable>
+void ShrinkBuckets(HashTable *const table) {
+    table->rehash(0);
+}
+
+/**
+ * Tuples written to a spill file in a columnar format: blocks of up to
+ * kBlockSize rows, each consisting of its number of rows and the values of
+ * one field after the other. Appended tuples are buffered until the block is
+ * full; reading the tuples back (in the order they were appended) flushes the
+ * last block.
+ */
+template <class StdTuple>
+class SpilledTuples {
+    static constexpr size_t kBlockSize = 1U << 12U;
+    static constexpr size_t kNumColumns = std::tuple_size_v<StdTuple>;
+    using IndexSequence = std::make_index_sequence<kNumColumns>;
+
+public:
+    explicit SpilledTuples(const std::string &directory) : file_(directory) {}
+
+    INLINE void Append(const StdTuple &tuple) {
+        if (rows_.empty()) rows_.reserve(kBlockSize);
+        rows_.push_back(tuple);
+        num_tuples_++;
+        if (rows_.size() == kBlockSize) WriteBlock();
+    }
+
+    [[nodiscard]] auto size() const -> size_t { return num_tuples_; }
+
+    void StartReading() {
+        if (!rows_.empty()) WriteBlock();
+        file_.Rewind();
+        read_pos_ = 0;
+    }
+
+    // Returns the next tuple or nullptr after the last one. The pointer is
+    // valid until the next call.
+    INLINE auto Read() -> const StdTuple * {
+        if (read_pos_ == rows_.size()) {
+            if (!ReadBlock()) return nullptr;
+            read_pos_ = 0;
+        }
+        return &rows_[read_pos_++];
+    }
+
+    template <class Consumer>
+    INLINE void ForEachRemaining(Consumer &&consume) {
+        while (auto const *const tuple = Read()) {
+            consume(*tuple);
+        }
+    }
+
+    template <class Consumer>
+    INLINE void ForEach(Consumer &&consume) {
+        StartReading();
+        ForEachRemaining(consume);
+    }
+
+private:
+    template <size_t I>
+    void WriteColumn() {
+        using Type = std::tuple_element_t<I, StdTuple>;
+        buffer_.resize(rows_.size() * sizeof(Type));
+        for (size_t j = 0; j < rows_.size(); j++) {
+            std::memcpy(buffer_.data() + j * sizeof(Type),
+                        &std::get<I>(rows_[j]), sizeof(Type));
+        }
+        file_.Write(buffer_.data(), buffer_.size());
+    }
+
+    template <size_t I>
+    void ReadColumn() {
+        using Type = std::tuple_element_t<I, StdTuple>;
+        buffer_.resize(rows_.size() * sizeof(Type));
+        if (!file_.Read(buffer_.data(), buffer_.size())) {
+            throw std::runtime_error("Truncated block in spill file");
+        }
+        for (size_t j = 0; j < rows_.size(); j++) {
+            std::memcpy(&std::get<I>(rows_[j]),
+                        buffer_.data() + j * sizeof(Type), sizeof(Type));
+        }
+    }
+
+    template <size_t... I>
+    void WriteColumns(std::index_sequence<I...> /*tag*/) {
+        (WriteColumn<I>(), ...);
+    }
+
+    template <size_t... I>
+    void ReadColumns(std::index_sequence<I...> /*tag*/) {
+        (ReadColumn<I>(), ...);
+    }
+
+    void WriteBlock() {
+        static_assert(IsSpillable<StdTuple>::value,
+                      "Only trivially copyable fields can be spilled");
+        const uint64_t num_rows = rows_.size();
+        file_.Write(&num_rows, sizeof(num_rows));
+        WriteColumns(IndexSequence());
+        rows_.clear();
+    }
+
+    auto ReadBlock() -> bool {
+        static_assert(IsSpillable<StdTuple>::value,
+                      "Only trivially copyable fields can be spilled");
+        uint64_t num_rows = 0;
+        if (!file_.Read(&num_rows, sizeof(num_rows))) return false;
+        rows_.resize(num_rows);
+        ReadColumns(IndexSequence());
+        return true;
+    }
+
+    runtime::memory::SpillFile file_;
+    size_t num_tuples_ = 0;
+    // Block being written or read
+    std::vector<StdTuple> rows_;
+    size_t read_pos_ = 0;
+    std::vector<char> buffer_;
+};
+
+/**
+ * Spill state of the partitions of one level: which partitions are spilled,
+ * the number of in-memory entries of the others, and the spill files of the
+ * former, one for each of the given tuple types (e.g., for each input of a
+ * join). Files are created on the first tuple written to them.
+ */
+template <class... StdTuples>
+class Partitions {
+public:
+    using Files = std::tuple<std::unique_ptr<SpilledTuples<StdTuples>>...>;
+    template <size_t I>
+    using File = SpilledTuples<
+            std::tuple_element_t<I, std::tuple<StdTuples...>>>;
+
+    explicit Partitions(const size_t level = 0) : level_(level) {}
+
+    [[nodiscard]] auto level() const -> size_t { return level_; }
+
+    // Whether tuples may be spilled on this level
+    [[nodiscard]] auto can_spill() const -> bool { return level_ < kMaxLevel; }
+
+    [[nodiscard]] INLINE auto is_spilled(const size_t partition) const
+            -> bool {
+        return is_spilled_[partition];
+    }
+
+    INLINE void AddEntries(const size_t partition, const size_t num_entries) {
+        num_entries_[partition] += num_entries;
+    }
+
+    // Marks the in-memory partition with the most entries as spilled and
+    // returns it, or returns kFanout if no partition has any entries
+    auto SpillLargest() -> size_t {
+        size_t largest = kFanout;
+        for (size_t i = 0; i < kFanout; i++) {
+            if (!is_spilled_[i] && num_entries_[i] > 0 &&
+                (largest == kFanout ||
+                 num_entries_[i] > num_entries_[largest])) {
+                largest = i;
+            }
+        }
+        if (largest != kFanout) {
+            is_spilled_[largest] = true;
+            num_entries_[largest] = 0;
+        }
+        return largest;
+    }
+
+    template <size_t I>
+    INLINE auto file(const size_t partition, const std::string &directory)
+            -> File<I> & {
+        auto &file = std::get<I>(files_[partition]);
+        if (file == nullptr) file = std::make_unique<File<I>>(directory);
+        return *file;
+    }
+
+    // Moves the files of the spilled partitions out of this level
+    auto TakeSpilledFiles() -> std::vector<Files> {
+        std::vector<Files> ret;
+        for (size_t i = 0; i < kFanout; i++) {
+            if (is_spilled_[i]) ret.emplace_back(std::move(files_[i]));
+            is_spilled_[i] = false;
+            num_entries_[i] = 0;
+        }
+        return ret;
+    }
+
+private:
+    size_t level_;
+    std::array<bool, kFanout> is_spilled_{};
+    std::array<size_t, kFanout> num_entries_{};
+    std::array<Files, kFanout> files_{};
+};
+
+}  // namespace hybrid_hash
+
+#endif  // CODE_GEN_OPERATORS_HYBRIDHASH_H
@@ -0,0 +1,111 @@
+#ifndef CODE_GEN_OPERATORS_INDEXJOINOPERATOR_H
+#define CODE_GEN_OPERATORS_INDEXJOINOPERATOR_H
+
+#include <cassert>
+
+#include <tuple>
+#include <utility>
+
+#include "HashIndexOperator.h"
+#include "Utils.h"
+#include "runtime/jit/operators/optional.hpp"
+
+/**
+ * For input tuples (K, V) and (K, W) returns (K, V, W)
+ * Returns every combination in case of repeating keys
+ *
+ * Like JoinOperator but the (K, V) tuples are given as hash index built by
+ * HashIndexOperator, i.e., the first upstream returns a single tuple with the
+ * index. The index is only read, so several instances of this operator (e.g.,
+ * running on different morsels of the right input) can share it.
+ * Keeps the right operator input ordered
+ */
+template <class IndexUpstream, class RightUpstream, class Tuple, class KeyType,
+          class LeftValueType, class RightValueType, size_t kNumKeys>
+class IndexJoinOperator {
+    using IndexTuple = std::remove_cv_t<std::remove_reference_t<decltype(
+            std::declval<IndexUpstream>().next().value())>>;
+
+public:
+    IndexJoinOperator(IndexUpstream *index_upstream,
+                      RightUpstream *right_upstream)
+        : index_upstream_(index_upstream), right_upstream_(right_upstream){};
+
+    void INLINE open() {
+        index_upstream_->open();
+        right_upstream_->open();
+
+        auto const ret = index_upstream_->next();
+        assert(ret);
+        index_ = ret.value();
+        num_buckets_ = index_.v0.shape[0] - 1;
+
+        match_pos_ = match_end_ = 0;
+    }
+
+    Optional<Tuple> INLINE next() {
+        while (true) {
+            // Produce the remaining matches of the current right tuple
+            while (match_pos_ < match_end_) {
+                auto const &left = index_.v1.data[index_.v1.offsets[0] +
+                                                  match_pos_++];
+                auto const [key_tuple, value_tuple] =
+                        SplitTupleAt<kNumKeys>(TupleToStdTuple(left));
+                if (key_tuple != TupleToStdTuple(right_key_)) continue;
+
+                // Concatenate fields using std::tuple
+                auto const right_tuple = TupleToStdTuple(right_value_);
+                auto const ret_tuple =
+                        std::tuple_cat(key_tuple, value_tuple, right_tuple);
+                return StdTupleToTuple(ret_tuple);
+            }
+
+            // Get the next right tuple and look up its bucket
+            const auto ret = right_upstream_->next();
+            if (!ret) return {};
+
+            auto const tuple = TupleToStdTuple(ret.value());
+            auto const [key_tuple, value_tuple] =
+                    SplitTupleAt<kNumKeys>(tuple);
+            right_key_ = StdTupleToTuple(key_tuple);
+            right_value_ = StdTupleToTuple(value_tuple);
+
+            const size_t bucket =
+                    ComputeHashIndexBucket(right_key_, num_buckets_);
+            auto const &offsets = index_.v0;
+            match_pos_ = offsets.data[offsets.offsets[0] + bucket].v0;
+            match_end_ = offsets.data[offsets.offsets[0] + bucket + 1].v0;
+        }
+    }
+
+    void INLINE close() {
+        index_upstream_->close();
+        right_upstream_->close();
+    }
+
+private:
+    IndexUpstream *const index_upstream_;
+    RightUpstream *const right_upstream_;
+
+    IndexTuple index_;
+    size_t num_buckets_ = 0;
+
+    // Current right tuple and range of its bucket still to check
+    KeyType right_key_;
+    RightValueType right_value_;
+    size_t match_pos_ = 0;
+    size_t match_end_ = 0;
+};
+
+template <class Tuple, class KeyType, class LeftValueType, class RightValueType,
+          size_t kNumKeys, class IndexUpstream, class RightUpstream>
+IndexJoinOperator<IndexUpstream, RightUpstream, Tuple, KeyType, LeftValueType,
+                  RightValueType, kNumKeys>
+        INLINE makeIndexJoinOperator(IndexUpstream *index_upstream,
+                                     RightUpstream *right_upstream) {
+    return IndexJoinOperator<IndexUpstream, RightUpstream, Tuple, KeyType,
+                             LeftValueType, RightValueType, kNumKeys>(
+            index_upstream, right_upstream);
+};
+
+#endif  // CODE_GEN_OPERATORS_INDEXJOINOPERATOR_H
@@ -1,12 +1,16 @@
 #ifndef CODE_GEN_OPERATORS_JOINOPERATOR_H
 #define CODE_GEN_OPERATORS_JOINOPERATOR_H
 
+#include <string>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "CompositeKey.h"
+#include "HybridHash.h"
 #include "Utils.h"
+#include "runtime/jit/memory/memory_tracker.hpp"
 #include "runtime/jit/operators/optional.hpp"
 
 /**
@@ -14,55 +18,83 @@
  * Returns every combination in case of repeating keys
  *
  * Current implementation builds map on the left input operator
- * Keeps the right operator input ordered
+ * Keeps the right operator input ordered unless partitions are spilled
+ *
+ * If the build table exceeds the memory budget (in bytes, 0 for none), the
+ * partitions that do not fit are spilled together with the right tuples
+ * probing them and joined after the in-memory ones, see HybridHash.h
  */
 template <class LeftUpstream, class RightUpstream, class Tuple, class KeyType,
           class LeftValueType, class RightValueType, size_t kNumKeys>
 class JoinOperator {
+    using StdKey = decltype(TupleToStdTuple(std::declval<KeyType>()));
+    using LeftStdTuple = decltype(std::tuple_cat(
+            std::declval<StdKey>(),
+            TupleToStdTuple(std::declval<LeftValueType>())));
+    using RightStdTuple = decltype(std::tuple_cat(
+            std::declval<StdKey>(),
+            TupleToStdTuple(std::declval<RightValueType>())));
+    using Partitions = hybrid_hash::Partitions<LeftStdTuple, RightStdTuple>;
+    static constexpr bool kCanSpill =
+            hybrid_hash::IsSpillable<LeftStdTuple>::value &&
+            hybrid_hash::IsSpillable<RightStdTuple>::value;
+
 public:
-    JoinOperator(LeftUpstream *left_upstream, RightUpstream *right_upstream)
-        : left_upstream_(left_upstream), right_upstream_(right_upstream){};
+    JoinOperator(LeftUpstream *left_upstream, RightUpstream *right_upstream,
+                 const size_t memory_budget = 0,
+                 std::string spill_directory = "")
+        : left_upstream_(left_upstream),
+          right_upstream_(right_upstream),
+          memory_budget_(kCanSpill ? memory_budget : 0),
+          spill_directory_(std::move(spill_directory)){};
 
     void INLINE open() {
         left_upstream_->open();
         right_upstream_->open();
 
-        // Build table already built
-        if (!build_table_.empty()) {
+        // Reset iterators of left matches
+        left_matches_it_ = left_matches_end_;
+
+        // Build table already built (and complete)
+        if (!build_table_.empty() && !has_spilled_) {
             return;
         }
 
-        // Build hash table from left upstream
-        while (auto const ret = left_upstream_->next()) {
-            auto const tuple = TupleToStdTuple(ret.value());
-            auto const [key, value] = SplitTupleParameter<kNumKeys>(tuple);
-            auto const [it, _] =
-                    build_table_.insert({StdTupleToTuple(key), {}});
-            it->second.emplace_back(StdTupleToTuple(value));
-        }
+        build_table_.clear();
+        num_build_values_ = 0;
+        has_spilled_ = false;
+        partitions_ = Partitions();
+        pending_.clear();
+        probe_files_ = {};
 
-        // Reset iterators of left matches
-        left_matches_it_ = left_matches_end_;
+        // Build hash table from left upstream
+        ForEachTuple(left_upstream_, [&](const auto &input) {
+            Build(TupleToStdTuple(input));
+        });
     }
 
     Optional<Tuple> INLINE next() {
         // If there are no matches from the left upstream left to produce
-        // results, we need a new tuple from the right upstream
+        // results, we need a new tuple from the right upstream (or from the
+        // spilled ones once it is exhausted)
         while (left_matches_it_ == left_matches_end_) {
-            const auto ret = right_upstream_->next();
-            if (!ret) return {};
+            const auto ret = NextRightTuple();
+            if (!ret) {
+                if (!BuildNextSpilledPartition()) return {};
+                continue;
+            }
 
-            auto const tuple = TupleToStdTuple(ret.value());
+            auto const &tuple = ret.value();
             auto const [key_tuple, value_tuple] =
-                    SplitTupleParameter<kNumKeys>(tuple);
+                    SplitTupleAt<kNumKeys>(tuple);
             auto const key = StdTupleToTuple(key_tuple);
-            auto const value = StdTupleToTuple(value_tuple);
+            if (SpillProbe(key, tuple)) continue;
 
             const auto it = build_table_.find(key);
             if (it != build_table_.end()) {
                 left_matches_it_ = it->second.begin();
                 left_matches_end_ = it->second.end();
-                last_right_upstream_ = value;
+                last_right_upstream_ = StdTupleToTuple(value_tuple);
                 last_key_ = key;
             }
         }
@@ -73,14 +105,47 @@ public:
         auto const left_value = *left_matches_it_;
         left_matches_it_++;
 
-        // Concatenate fields using std::tuple
-        auto const key_tuple = TupleToStdTuple(last_key_);
-        auto const left_tuple = TupleToStdTuple(left_value);
-        auto const right_tuple = TupleToStdTuple(last_right_upstream_);
-        auto const ret_tuple =
-                std::tuple_cat(key_tuple, left_tuple, right_tuple);
+        return BuildResultTuple(last_key_, left_value, last_right_upstream_);
+    }
 
-        return StdTupleToTuple(ret_tuple);
+    // Probes the build table with all remaining right tuples, producing all
+    // results of one right tuple before moving on to the next one, and then
+    // joins the spilled partitions
+    template <class Consumer>
+    INLINE void ForEach(Consumer &&consume) {
+        for (; left_matches_it_ != left_matches_end_; left_matches_it_++) {
+            consume(BuildResultTuple(last_key_, *left_matches_it_,
+                                     last_right_upstream_));
+        }
+
+        auto const probe = [&](const RightStdTuple &tuple) {
+            auto const [key_tuple, value_tuple] =
+                    SplitTupleAt<kNumKeys>(tuple);
+            auto const key = StdTupleToTuple(key_tuple);
+            if (SpillProbe(key, tuple)) return;
+
+            const auto it = build_table_.find(key);
+            if (it == build_table_.end()) return;
+
+            auto const value = StdTupleToTuple(value_tuple);
+            for (auto const &left_value : it->second) {
+                consume(BuildResultTuple(key, left_value, value));
+            }
+        };
+
+        if (std::get<1>(probe_files_) == nullptr) {
+            ForEachTuple(right_upstream_, [&](const auto &input) {
+                probe(TupleToStdTuple(input));
+            });
+        } else if constexpr (kCanSpill) {
+            std::get<1>(probe_files_)->ForEachRemaining(probe);
+        }
+
+        if constexpr (kCanSpill) {
+            while (BuildNextSpilledPartition()) {
+                std::get<1>(probe_files_)->ForEachRemaining(probe);
+            }
+        }
     }
 
     void INLINE close() {
@@ -89,53 +154,167 @@ public:
     }
 
 private:
-    template <std::size_t kN, std::size_t... kIs, std::size_t... kNs,
-              typename... Ts>
-    auto SplitTupleParameterImpl(std::index_sequence<kIs...>,
-                                 std::index_sequence<kNs...>,
-                                 std::tuple<Ts...> t) {
-        return std::make_pair(std::make_tuple(std::get<kIs>(t)...),
-                              std::make_tuple(std::get<kNs + kN>(t)...));
+    // Concatenates the fields using std::tuple
+    static INLINE Tuple BuildResultTuple(const KeyType &key,
+                                         const LeftValueType &left_value,
+                                         const RightValueType &right_value) {
+        auto const key_tuple = TupleToStdTuple(key);
+        auto const left_tuple = TupleToStdTuple(left_value);
+        auto const right_tuple = TupleToStdTuple(right_value);
+        return StdTupleToTuple(
+                std::tuple_cat(key_tuple, left_tuple, right_tuple));
     }
 
-    template <std::size_t kN, typename... Ts>
-    auto SplitTupleParameter(std::tuple<Ts...> t) {
-        return SplitTupleParameterImpl<kN>(
-                std::make_index_sequence<kN>(),
-                std::make_index_sequence<sizeof...(Ts) - kN>(), t);
+    INLINE void Build(const LeftStdTuple &tuple) {
+        auto const [key_tuple, value_tuple] = SplitTupleAt<kNumKeys>(tuple);
+        auto const key = StdTupleToTuple(key_tuple);
+        auto const value = StdTupleToTuple(value_tuple);
+
+        if (memory_budget_ == 0) {
+            auto const [it, _] = build_table_.insert({key, {}});
+            it->second.emplace_back(value);
+            return;
+        }
+
+        if constexpr (kCanSpill) {
+            const size_t partition =
+                    hybrid_hash::PartitionOf(key, partitions_.level());
+            if (partitions_.is_spilled(partition)) {
+                partitions_.template file<0>(partition, spill_directory_)
+                        .Append(tuple);
+                return;
+            }
+
+            auto const [it, _] = build_table_.insert({key, {}});
+            it->second.emplace_back(value);
+            num_build_values_++;
+            partitions_.AddEntries(partition, 1);
+            if (partitions_.can_spill() &&
+                hybrid_hash::EstimateBytes(build_table_) +
+                                num_build_values_ * sizeof(LeftValueType) >
+                        memory_budget_) {
+                SpillLargestPartition();
+            }
+        }
     }
 
-    struct KeyTypeHash {
-    private:
-        template <std::size_t... kIs, typename... Ts>
-        auto CallOperatorImpl(std::index_sequence<kIs...>,
-                              std::tuple<Ts...> t) const {
-            return (... ^ std::hash<Ts>()(std::get<kIs>(t)));
+    // Moves the left values of the largest partition into its spill file
+    void SpillLargestPartition() {
+        const size_t partition = partitions_.SpillLargest();
+        if (partition == hybrid_hash::kFanout) return;
+        has_spilled_ = true;
+
+        auto &file = partitions_.template file<0>(partition, spill_directory_);
+        for (auto it = build_table_.begin(); it != build_table_.end();) {
+            if (hybrid_hash::PartitionOf(it->first, partitions_.level()) ==
+                partition) {
+                auto const key_tuple = TupleToStdTuple(it->first);
+                for (auto const &value : it->second) {
+                    file.Append(std::tuple_cat(key_tuple,
+                                               TupleToStdTuple(value)));
+                }
+                num_build_values_ -= it->second.size();
+                it = build_table_.erase(it);
+            } else {
+                it++;
+            }
         }
+        hybrid_hash::ShrinkBuckets(&build_table_);
+    }
 
-    public:
-        size_t operator()(const KeyType &key) const {
-            auto key_tuple = TupleToStdTuple(key);
-            return CallOperatorImpl(std::make_index_sequence<kNumKeys>(),
-                                    key_tuple);
+    // Writes the right tuple into the spill file of its partition and returns
+    // true if that partition is spilled
+    INLINE auto SpillProbe(const KeyType &key, const RightStdTuple &tuple)
+            -> bool {
+        if constexpr (kCanSpill) {
+            if (memory_budget_ == 0) return false;
+            const size_t partition =
+                    hybrid_hash::PartitionOf(key, partitions_.level());
+            if (!partitions_.is_spilled(partition)) return false;
+            partitions_.template file<1>(partition, spill_directory_)
+                    .Append(tuple);
+            return true;
+        } else {
+            return false;
         }
-    };
+    }
 
-    struct KeyTypeEquals {
-        bool operator()(const KeyType &lhs, const KeyType &rhs) const {
-            return TupleToStdTuple(lhs) == TupleToStdTuple(rhs);
+    INLINE auto NextRightTuple() -> Optional<RightStdTuple> {
+        if (std::get<1>(probe_files_) == nullptr) {
+            if (auto const ret = right_upstream_->next()) {
+                return TupleToStdTuple(ret.value());
+            }
+            return {};
         }
-    };
+        if constexpr (kCanSpill) {
+            if (auto const *const tuple = std::get<1>(probe_files_)->Read()) {
+                return *tuple;
+            }
+        }
+        return {};
+    }
+
+    // Once all right tuples of the current level have been probed, replaces
+    // the build table with the left values of the next spilled partition and
+    // starts probing it with the right tuples of that partition. Returns false
+    // if there are no spilled partitions left.
+    auto BuildNextSpilledPartition() -> bool {
+        if constexpr (kCanSpill) {
+            const size_t next_level = partitions_.level() + 1;
+            for (auto &files : partitions_.TakeSpilledFiles()) {
+                // Without right tuples, the partition has no results
+                if (std::get<1>(files) == nullptr) continue;
+                pending_.emplace_back(std::move(files), next_level);
+            }
+            if (pending_.empty()) return false;
+
+            auto [files, level] = std::move(pending_.back());
+            pending_.pop_back();
+            build_table_.clear();
+            num_build_values_ = 0;
+            partitions_ = Partitions(level);
+            if (std::get<0>(files) != nullptr) {
+                std::get<0>(files)->ForEach(
+                        [&](const LeftStdTuple &tuple) { Build(tuple); });
+                std::get<0>(files).reset();
+            }
+
+            probe_files_ = std::move(files);
+            std::get<1>(probe_files_)->StartReading();
+            left_matches_it_ = left_matches_end_;
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    using KeyTypeHash = CompositeKeyHash<KeyType>;
+    using KeyTypeEquals = CompositeKeyEquals<KeyType>;
 
     LeftUpstream *const left_upstream_;
     RightUpstream *const right_upstream_;
-    std::unordered_map<KeyType, std::vector<LeftValueType>, KeyTypeHash,
-                       KeyTypeEquals>
+    using LeftValues =
+            std::vector<LeftValueType,
+                        runtime::memory::TrackingAllocator<LeftValueType>>;
+
+    std::unordered_map<KeyType, LeftValues, KeyTypeHash, KeyTypeEquals,
+                       runtime::memory::TrackingAllocator<
+                               std::pair<const KeyType, LeftValues>>>
             build_table_;
     RightValueType last_right_upstream_;
     KeyType last_key_;
-    typename std::vector<LeftValueType>::iterator left_matches_it_;
-    typename std::vector<LeftValueType>::iterator left_matches_end_;
+    typename LeftValues::iterator left_matches_it_;
+    typename LeftValues::iterator left_matches_end_;
+
+    const size_t memory_budget_;
+    const std::string spill_directory_;
+    size_t num_build_values_ = 0;
+    bool has_spilled_ = false;
+    Partitions partitions_;
+    // Spilled partitions still to be joined with their level
+    std::vector<std::pair<typename Partitions::Files, size_t>> pending_;
+    // Files of the spilled partition being joined, if any
+    typename Partitions::Files probe_files_;
 };
 
 template <class Tuple, class KeyType, class LeftValueType, class RightValueType,
@@ -143,10 +322,13 @@ template <class Tuple, class KeyType, class LeftValueType, class RightValueType,
 JoinOperator<LeftUpstream, RightUpstream, Tuple, KeyType, LeftValueType,
              RightValueType, kNumKeys>
         INLINE makeJoinOperator(LeftUpstream *left_upstream,
-                                RightUpstream *right_upstream) {
+                                RightUpstream *right_upstream,
+                                const size_t memory_budget = 0,
+                                std::string spill_directory = "") {
     return JoinOperator<LeftUpstream, RightUpstream, Tuple, KeyType,
                         LeftValueType, RightValueType, kNumKeys>(
-            left_upstream, right_upstream);
+            left_upstream, right_upstream, memory_budget,
+            std::move(spill_directory));
 };
 
 #endif  // CODE_GEN_OPERATORS_JOINOPERATOR_H
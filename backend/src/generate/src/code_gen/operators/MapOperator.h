@@ -23,6 +23,14 @@ public:
         return {};
     }
 
+    template <class Consumer>
+    INLINE void ForEach(Consumer &&consume) {
+        ForEachTuple(upstream_, [&](const auto &input) {
+            const Tuple ret = map_function_(input);
+            consume(ret);
+        });
+    }
+
     INLINE void close() { upstream_->close(); }
 
 private:
@@ -1,8 +1,16 @@
 #ifndef CODE_GEN_OPERATORS_MATERIALIZECOLUMNCHUNKSOPERATOR_H
 #define CODE_GEN_OPERATORS_MATERIALIZECOLUMNCHUNKSOPERATOR_H
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <new>
+
 #include "Utils.h"
-#include "runtime/jit/memory/default_ref_counter.hpp"
+#include "runtime/jit/memory/chunk_pool.hpp"
+#include "runtime/jit/memory/free_ref_counter.hpp"
 #include "runtime/jit/memory/shared_pointer.hpp"
 #include "runtime/jit/operators/optional.hpp"
 
@@ -14,81 +22,182 @@ class MaterializeColumnChunksOperator {
             decltype(TupleToStdTuple(std::declval<OutputTuple>()));
     using IndexSequence = std::make_index_sequence<sizeof...(InputTypes)>;
 
+    template <typename ElementType>
+    using ElementTuple = decltype(
+            StdTupleToTuple(std::declval<std::tuple<ElementType>>()));
+    using Columns = std::tuple<ElementTuple<InputTypes> *...>;
+
+    // Bounds of the number of rows per chunk. Small chunks increase the
+    // per-chunk overhead downstream, large ones do not fit into the cache
+    static constexpr size_t kMinChunkSize = 1ul << 12u;
+    static constexpr size_t kMaxChunkSize = 1ul << 16u;
+    static constexpr size_t kDefaultCacheSize = 1ul << 20u;
+    // Number of rows buffered before they are written into the columns
+    static constexpr size_t kBatchSize = 64;
+
 public:
     MaterializeColumnChunksOperator(Upstream *const upstream)
-        : upstream_(upstream), max_column_size_(1ul << 16u) {}
+        : upstream_(upstream), max_column_size_(ComputeChunkSize()) {}
 
-    INLINE void open() { upstream_->open(); }
+    INLINE void open() {
+        upstream_->open();
+        is_exhausted_ = false;
+    }
 
     INLINE Optional<OutputTuple> next() {
-        auto columns = MakeColumns(max_column_size_);
-        size_t column_size;
-        for (column_size = 0; column_size < max_column_size_; column_size++) {
-            const auto input = upstream_->next();
-            if (!input) break;
-            auto const row = TupleToStdTuple(input.value());
-            AssignRow(columns, row, column_size);
+        if (is_exhausted_) return {};
+
+        auto columns = AllocateColumns(max_column_size_);
+        size_t column_size = 0;
+        while (!is_exhausted_ && column_size < max_column_size_) {
+            const size_t batch_size =
+                    std::min(kBatchSize, max_column_size_ - column_size);
+            size_t num_rows;
+            for (num_rows = 0; num_rows < batch_size; num_rows++) {
+                const auto input = upstream_->next();
+                if (!input) {
+                    is_exhausted_ = true;
+                    break;
+                }
+                batch_[num_rows] = TupleToStdTuple(input.value());
+            }
+            TransposeBatch(columns, column_size, num_rows);
+            column_size += num_rows;
         }
+
         if (column_size == 0) {
+            ReleaseColumns(columns, max_column_size_);
             return {};
         }
-        SetSize(&columns, column_size);
-        return StdTupleToTuple(columns);
+
+        if (column_size == max_column_size_) {
+            return StdTupleToTuple(MakePooledArrays(columns, column_size));
+        }
+
+        // Release the unused tail of the last chunk
+        columns = ShrinkColumns(columns, column_size);
+        return StdTupleToTuple(MakeArrays(columns, column_size));
     }
 
     INLINE void close() { upstream_->close(); }
 
 private:
-    template <typename ElementType>
-    auto static MakeSharedPointer(const size_t num_elements) {
-        using ElementTuple = decltype(
-                StdTupleToTuple(std::declval<std::tuple<ElementType>>()));
-        return runtime::memory::SharedPointer<ElementTuple>(
-                new runtime::memory::DefaultRefCounter<ElementTuple[]>(
-                        new ElementTuple[num_elements]));
+    // Returns a number of rows such that one chunk of all columns takes about
+    // half of the L2 cache
+    auto static ComputeChunkSize() -> size_t {
+        constexpr size_t kRowSize = (sizeof(ElementTuple<InputTypes>) + ...);
+        const long l2_cache_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        const size_t cache_size = l2_cache_size > 0
+                                          ? static_cast<size_t>(l2_cache_size)
+                                          : kDefaultCacheSize;
+        return std::clamp(cache_size / 2 / kRowSize, kMinChunkSize,
+                          kMaxChunkSize);
+    }
+
+    // Allocates uninitialized columns from the chunk pool; elements are
+    // constructed when the rows are transposed into them
+    auto static AllocateColumns(const size_t num_rows) -> Columns {
+        return Columns{reinterpret_cast<ElementTuple<InputTypes> *>(
+                runtime::memory::AllocateChunk(
+                        sizeof(ElementTuple<InputTypes>) * num_rows))...};
     }
 
     template <std::size_t... I>
-    auto static MakeColumnsImpl(const size_t num_rows,
-                                std::index_sequence<I...> /*tag*/) {
-        return std::make_tuple(std::tuple_element_t<I, StdOutputTuple>{
-                MakeSharedPointer<std::tuple_element_t<I, StdInputTuple>>(
-                        num_rows),
-                num_rows, 0, num_rows}...);
+    void static ReleaseColumnsImpl(const Columns &columns,
+                                   const size_t num_rows,
+                                   std::index_sequence<I...> /*tag*/) {
+        (runtime::memory::ReleaseChunk(
+                 std::get<I>(columns),
+                 sizeof(ElementTuple<InputTypes>) * num_rows),
+         ...);
     }
 
-    auto static MakeColumns(const size_t num_rows) {
-        return MakeColumnsImpl(num_rows, IndexSequence());
+    void static ReleaseColumns(const Columns &columns, const size_t num_rows) {
+        ReleaseColumnsImpl(columns, num_rows, IndexSequence());
+    }
+
+    // Shrinks the given column to num_elements. The result does not go back
+    // to the pool since it has a different size than the pooled chunks
+    template <typename ElementType>
+    auto static ShrinkColumn(ElementType *const data, const size_t num_elements)
+            -> ElementType * {
+        auto *const ret = reinterpret_cast<ElementType *>(
+                realloc(data, sizeof(ElementType) * num_elements));
+        return ret == nullptr ? data : ret;
     }
 
     template <std::size_t... I>
-    void static INLINE AssignRowImpl(const StdOutputTuple &columns,
-                                     const StdInputTuple &row,
-                                     const size_t index,
-                                     std::index_sequence<I...>) {
-        ((std::get<I>(columns).data[index].v0 = std::get<I>(row)), ...);
+    auto static ShrinkColumnsImpl(const Columns &columns,
+                                  const size_t num_rows,
+                                  std::index_sequence<I...> /*tag*/)
+            -> Columns {
+        return Columns{ShrinkColumn(std::get<I>(columns), num_rows)...};
     }
 
-    void static INLINE AssignRow(const StdOutputTuple &columns,
-                                 const StdInputTuple &row, const size_t index) {
-        return AssignRowImpl(columns, row, index, IndexSequence());
+    auto static ShrinkColumns(const Columns &columns, const size_t num_rows)
+            -> Columns {
+        return ShrinkColumnsImpl(columns, num_rows, IndexSequence());
+    }
+
+    // Writes field I of the first num_rows buffered rows into the column
+    // starting at the given offset. The loop has no dependencies between its
+    // iterations, so the compiler turns it into vector loads and stores.
+    template <std::size_t I, typename ElementType>
+    void INLINE TransposeColumn(ElementType *const column, const size_t offset,
+                                const size_t num_rows) const {
+        for (size_t j = 0; j < num_rows; j++) {
+            new (column + offset + j) ElementType{std::get<I>(batch_[j])};
+        }
     }
 
     template <std::size_t... I>
-    void static INLINE SetSizeImpl(StdOutputTuple *const columns,
-                                   const size_t size,
-                                   std::index_sequence<I...>) {
-        ((std::get<I>(*columns).shape[0] = size), ...);
-        ((std::get<I>(*columns).outer_shape[0] = size), ...);
+    void INLINE TransposeBatchImpl(const Columns &columns, const size_t offset,
+                                   const size_t num_rows,
+                                   std::index_sequence<I...> /*tag*/) const {
+        (TransposeColumn<I>(std::get<I>(columns), offset, num_rows), ...);
+    }
+
+    void INLINE TransposeBatch(const Columns &columns, const size_t offset,
+                               const size_t num_rows) const {
+        TransposeBatchImpl(columns, offset, num_rows, IndexSequence());
     }
 
-    void static INLINE SetSize(StdOutputTuple *const columns,
-                               const size_t size) {
-        return SetSizeImpl(columns, size, IndexSequence());
+    // Wraps the columns into arrays whose buffers are freed with RefCounterType
+    template <template <typename> class RefCounterType, std::size_t... I>
+    auto static MakeArraysImpl(const Columns &columns, const size_t num_rows,
+                               std::index_sequence<I...> /*tag*/) {
+        return std::make_tuple(std::tuple_element_t<I, StdOutputTuple>{
+                runtime::memory::SharedPointer<ElementTuple<InputTypes>>(
+                        new RefCounterType<ElementTuple<InputTypes>>(
+                                std::get<I>(columns), num_rows)),
+                num_rows, 0, num_rows}...);
+    }
+
+    auto static MakeArrays(const Columns &columns, const size_t num_rows) {
+        return MakeArraysImpl<runtime::memory::FreeRefCounter>(
+                columns, num_rows, IndexSequence());
+    }
+
+    // Full chunks are returned to the pool once they are not used anymore
+    template <typename ElementType>
+    struct PooledRefCounter
+        : public runtime::memory::ChunkPoolRefCounter<ElementType> {
+        PooledRefCounter(void *const pointer, const size_t num_elements)
+            : runtime::memory::ChunkPoolRefCounter<ElementType>(
+                      pointer, num_elements,
+                      sizeof(ElementType) * num_elements) {}
+    };
+
+    auto static MakePooledArrays(const Columns &columns,
+                                 const size_t num_rows) {
+        return MakeArraysImpl<PooledRefCounter>(columns, num_rows,
+                                                IndexSequence());
     }
 
     Upstream *const upstream_;
     const size_t max_column_size_;
+    bool is_exhausted_ = false;
+    std::array<StdInputTuple, kBatchSize> batch_;
 };
 
 template <class OutputTuple, class Upstream, class... InputTypes>
@@ -31,7 +31,7 @@ public:
                 malloc(sizeof(InnerTuple) * allocated_size));
         size_t result_size = 0;
 
-        while (auto tuple = upstream_->next()) {
+        ForEachTuple(upstream_, [&](const auto &tuple) {
             if (allocated_size <= result_size) {
                 allocated_size *= 2;
                 result_ptr = reinterpret_cast<InnerTuple *>(realloc(
@@ -40,9 +40,9 @@ public:
                     throw std::runtime_error(
                             "Could not materialize: out of memory.");
             }
-            new (result_ptr + result_size) InnerTuple(tuple.value());
+            new (result_ptr + result_size) InnerTuple(tuple);
             result_size++;
-        }
+        });
 
         result_ptr = reinterpret_cast<InnerTuple *>(realloc(
                 result_ptr, sizeof(InnerTuple) * max(size_t(1), result_size)));
@@ -0,0 +1,158 @@
+#ifndef CODE_GEN_OPERATORS_MERGEJOINOPERATOR_H
+#define CODE_GEN_OPERATORS_MERGEJOINOPERATOR_H
+
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Utils.h"
+#include "runtime/jit/operators/optional.hpp"
+
+/**
+ * For input tuples (K, V) and (K, W) returns (K, V, W)
+ * Returns every combination in case of repeating keys
+ *
+ * Both inputs need to be sorted ascendingly on K. The operator streams
+ * through both inputs and only buffers the left tuples of the current key,
+ * i.e., it uses constant memory if the keys of the left input are unique.
+ * Like JoinOperator, the results are produced in the order of the right input
+ * (which, here, is also the order of K).
+ */
+template <class LeftUpstream, class RightUpstream, class Tuple, class KeyType,
+          class LeftValueType, class RightValueType, size_t kNumKeys>
+class MergeJoinOperator {
+public:
+    MergeJoinOperator(LeftUpstream *left_upstream,
+                      RightUpstream *right_upstream)
+        : left_upstream_(left_upstream), right_upstream_(right_upstream){};
+
+    void INLINE open() {
+        left_upstream_->open();
+        right_upstream_->open();
+
+        has_left_ = AdvanceLeft();
+        has_right_ = AdvanceRight();
+
+        left_matches_.clear();
+        left_matches_it_ = left_matches_.end();
+    }
+
+    Optional<Tuple> INLINE next() {
+        // If the current right tuple has no more matches on the left, we need
+        // a new right tuple
+        while (left_matches_it_ == left_matches_.end()) {
+            if (!left_matches_.empty()) {
+                // The next right tuple may have the same key, in which case
+                // it matches the same left tuples
+                has_right_ = AdvanceRight();
+                if (has_right_ && IsEqual(right_key_, matches_key_)) {
+                    left_matches_it_ = left_matches_.begin();
+                    break;
+                }
+                left_matches_.clear();
+                left_matches_it_ = left_matches_.end();
+            }
+
+            // Advance the smaller side until both sides have the same key
+            while (has_left_ && has_right_) {
+                if (IsLess(left_key_, right_key_)) {
+                    has_left_ = AdvanceLeft();
+                } else if (IsLess(right_key_, left_key_)) {
+                    has_right_ = AdvanceRight();
+                } else {
+                    break;
+                }
+            }
+
+            if (!has_left_ || !has_right_) return {};
+
+            // Buffer all left tuples with the current key
+            matches_key_ = left_key_;
+            do {
+                left_matches_.emplace_back(left_value_);
+                has_left_ = AdvanceLeft();
+            } while (has_left_ && IsEqual(left_key_, matches_key_));
+            left_matches_it_ = left_matches_.begin();
+        }
+
+        // At this point, we have a tuple from the right side with at least one
+        // match on the left --> produce the next result
+
+        auto const left_value = *left_matches_it_;
+        left_matches_it_++;
+
+        // Concatenate fields using std::tuple
+        auto const key_tuple = TupleToStdTuple(matches_key_);
+        auto const left_tuple = TupleToStdTuple(left_value);
+        auto const right_tuple = TupleToStdTuple(right_value_);
+        auto const ret_tuple =
+                std::tuple_cat(key_tuple, left_tuple, right_tuple);
+
+        return StdTupleToTuple(ret_tuple);
+    }
+
+    void INLINE close() {
+        left_upstream_->close();
+        right_upstream_->close();
+    }
+
+private:
+    INLINE auto AdvanceLeft() -> bool {
+        const auto ret = left_upstream_->next();
+        if (!ret) return false;
+        auto const [key_tuple, value_tuple] =
+                SplitTupleAt<kNumKeys>(TupleToStdTuple(ret.value()));
+        left_key_ = StdTupleToTuple(key_tuple);
+        left_value_ = StdTupleToTuple(value_tuple);
+        return true;
+    }
+
+    INLINE auto AdvanceRight() -> bool {
+        const auto ret = right_upstream_->next();
+        if (!ret) return false;
+        auto const [key_tuple, value_tuple] =
+                SplitTupleAt<kNumKeys>(TupleToStdTuple(ret.value()));
+        right_key_ = StdTupleToTuple(key_tuple);
+        right_value_ = StdTupleToTuple(value_tuple);
+        return true;
+    }
+
+    static INLINE auto IsLess(const KeyType &lhs, const KeyType &rhs)
+            -> bool {
+        return TupleToStdTuple(lhs) < TupleToStdTuple(rhs);
+    }
+
+    static INLINE auto IsEqual(const KeyType &lhs, const KeyType &rhs)
+            -> bool {
+        return TupleToStdTuple(lhs) == TupleToStdTuple(rhs);
+    }
+
+    LeftUpstream *const left_upstream_;
+    RightUpstream *const right_upstream_;
+
+    // Current tuple of each side
+    bool has_left_ = false;
+    KeyType left_key_;
+    LeftValueType left_value_;
+    bool has_right_ = false;
+    KeyType right_key_;
+    RightValueType right_value_;
+
+    // Left tuples matching the current right tuple
+    KeyType matches_key_;
+    std::vector<LeftValueType> left_matches_;
+    typename std::vector<LeftValueType>::iterator left_matches_it_;
+};
+
+template <class Tuple, class KeyType, class LeftValueType, class RightValueType,
+          size_t kNumKeys, class LeftUpstream, class RightUpstream>
+MergeJoinOperator<LeftUpstream, RightUpstream, Tuple, KeyType, LeftValueType,
+                  RightValueType, kNumKeys>
+        INLINE makeMergeJoinOperator(LeftUpstream *left_upstream,
+                                     RightUpstream *right_upstream) {
+    return MergeJoinOperator<LeftUpstream, RightUpstream, Tuple, KeyType,
+                             LeftValueType, RightValueType, kNumKeys>(
+            left_upstream, right_upstream);
+};
+
+#endif  // CODE_GEN_OPERATORS_MERGEJOINOPERATOR_H
@@ -2,26 +2,68 @@
 #define CODE_GEN_OPERATORS_PARALLELMAPOMPOPERATOR_H
 
 #include <cassert>
+#include <cstddef>
 
+#include <atomic>
 #include <list>
 #include <mutex>
+#include <type_traits>
+#include <vector>
 
 #include <omp.h>
 
 #include "Utils.h"
+#include "runtime/jit/memory/memory_tracker.hpp"
+#include "runtime/jit/memory/numa.hpp"
 #include "runtime/jit/operators/optional.hpp"
 
-template <class OutputTuple, class InnerPlanFunctor, class Upstream>
+/**
+ * Runs the inner plan on each input tuple in a separate task
+ *
+ * In the NUMA-aware mode (with workers pinned to their cores), every input
+ * tuple gets a home node: the node of its partition if the inputs are the
+ * groups of partitions (see PartitionOperator), and the next node in turns
+ * otherwise. One task per worker then processes the tuples of its own node
+ * before helping out with those of the other nodes, such that the data of a
+ * partition is processed where it has been placed and the buffers allocated by
+ * the inner plan are local to their worker.
+ *
+ * The partition IDs are usually projected away before the parallel map. For
+ * partitioned inputs, the operator can thus consume the tuples with the
+ * partition ID in v0 and apply the projection to them itself.
+ */
+struct IdentityProjection {
+    template <class Tuple>
+    INLINE auto operator()(const Tuple &tuple) const -> const Tuple & {
+        return tuple;
+    }
+};
+
+template <class OutputTuple, class InnerPlanFunctor, class Upstream,
+          bool kNumaAware = false, bool kPartitionedInput = false,
+          class Projection = IdentityProjection>
 class ParallelMapOmpOperator {
+    using UpstreamTuple = std::decay_t<decltype(
+            std::declval<Upstream &>().next().value())>;
+    using InputTuple = std::decay_t<decltype(
+            std::declval<Projection &>()(std::declval<UpstreamTuple>()))>;
+
 public:
     ParallelMapOmpOperator(Upstream *const upstream,
-                           const InnerPlanFunctor &inner_plan)
-        : upstream_(upstream), inner_plan_(inner_plan) {}
+                           const InnerPlanFunctor &inner_plan,
+                           const Projection &project = Projection())
+        : upstream_(upstream), inner_plan_(inner_plan), project_(project) {}
 
     INLINE void open() { result_it_ = results_.begin(); }
 
     INLINE Optional<OutputTuple> next() {
-        if (results_.empty()) MaterializeUpstream();
+        if (results_.empty()) {
+            if constexpr (kNumaAware) {
+                MaterializeUpstreamOnHomeNodes();
+            } else {
+                MaterializeUpstream();
+            }
+        }
         while (result_it_ != results_.end()) {
             auto const ret = *(result_it_++);
             if (ret) return ret;
@@ -36,6 +78,8 @@ private:
         upstream_->open();
 
         std::mutex lock;
+        // Tasks may run on other threads, which account to the same query
+        auto const query = runtime::memory::CurrentQueryMemory();
         while (const auto ret = upstream_->next()) {
             Optional<OutputTuple> *thread_result_out;
             {
@@ -43,9 +87,10 @@ private:
                 results_.emplace_back();
                 thread_result_out = &(results_.back());
             }
-#pragma omp task shared(results_, lock)
+#pragma omp task shared(results_, lock, query)
             {
-                const auto input_tuple = ret.value();
+                const runtime::memory::QueryScope scope(query);
+                const InputTuple input_tuple = project_(ret.value());
                 auto const thread_result = inner_plan_(input_tuple);
 
                 {
@@ -60,18 +105,76 @@ private:
         result_it_ = results_.begin();
     }
 
+    void MaterializeUpstreamOnHomeNodes() {
+        struct Morsel {
+            InputTuple input;
+            Optional<OutputTuple> *result;
+        };
+
+        const size_t num_nodes = runtime::memory::NumNumaNodes();
+        std::vector<std::vector<Morsel>> queues(num_nodes);
+
+        upstream_->open();
+        size_t num_inputs = 0;
+        while (auto const ret = upstream_->next()) {
+            const auto &input = ret.value();
+            results_.emplace_back();
+            queues[HomeNode(input, num_inputs++)].push_back(
+                    {project_(input), &results_.back()});
+        }
+        upstream_->close();
+
+        // Morsels are claimed through one cursor per node
+        std::vector<std::atomic<size_t>> cursors(num_nodes);
+        auto const query = runtime::memory::CurrentQueryMemory();
+        for (int w = 0; w < omp_get_num_threads(); w++) {
+#pragma omp task shared(queues, cursors, query)
+            {
+                const runtime::memory::QueryScope scope(query);
+                const size_t home = runtime::memory::CurrentNumaNode();
+                for (size_t n = 0; n < num_nodes; n++) {
+                    const size_t node = (home + n) % num_nodes;
+                    auto &queue = queues[node];
+                    for (size_t j = cursors[node]++; j < queue.size();
+                         j = cursors[node]++) {
+                        *queue[j].result = inner_plan_(queue[j].input);
+                    }
+                }
+            }
+        }
+#pragma omp taskwait
+
+        result_it_ = results_.begin();
+    }
+
+    static INLINE auto HomeNode(const UpstreamTuple &input, const size_t index)
+            -> size_t {
+        if constexpr (kPartitionedInput) {
+            return runtime::memory::HomeNodeOfPartition(
+                    static_cast<size_t>(input.v0));
+        } else {
+            return index % runtime::memory::NumNumaNodes();
+        }
+    }
+
     Upstream *const upstream_;
     const InnerPlanFunctor &inner_plan_;
+    Projection project_;
     std::list<Optional<OutputTuple>> results_{};
     typename decltype(results_)::iterator result_it_{};
 };
 
-template <class OutputTuple, class InnerPlanFunctor, class Upstream>
-ParallelMapOmpOperator<OutputTuple, InnerPlanFunctor, Upstream>
+template <class OutputTuple, bool kNumaAware = false,
+          bool kPartitionedInput = false, class InnerPlanFunctor,
+          class Upstream, class Projection = IdentityProjection>
+ParallelMapOmpOperator<OutputTuple, InnerPlanFunctor, Upstream, kNumaAware,
+                       kPartitionedInput, Projection>
 makeParallelMapOmpOperator(Upstream *const upstream,
-                           const InnerPlanFunctor &inner_plan) {
-    return ParallelMapOmpOperator<OutputTuple, InnerPlanFunctor, Upstream>(
-            upstream, inner_plan);
+                           const InnerPlanFunctor &inner_plan,
+                           const Projection &project = Projection()) {
+    return ParallelMapOmpOperator<OutputTuple, InnerPlanFunctor, Upstream,
+                                  kNumaAware, kPartitionedInput, Projection>(
+            upstream, inner_plan, project);
 };
 
 #endif  // CODE_GEN_OPERATORS_PARALLELMAPOMPOPERATOR_H
@@ -1,25 +1,84 @@
 #ifndef CODE_GEN_OPERATORS_PARTITION_OPERATOR_H
 #define CODE_GEN_OPERATORS_PARTITION_OPERATOR_H
 
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
 #include <list>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <omp.h>
+
 #include "Utils.h"
 #include "runtime/jit/memory/free_ref_counter.hpp"
+#include "runtime/jit/memory/munmap_ref_counter.hpp"
+#include "runtime/jit/memory/numa.hpp"
 #include "runtime/jit/memory/shared_pointer.hpp"
 #include "runtime/jit/operators/murmur_hash2.hpp"
 #include "runtime/jit/operators/optional.hpp"
 
+/**
+ * Partitions the input tuples into fanout partitions by the hash of their
+ * first kNumKeys fields. Produces one (partition index, array) tuple per
+ * partition.
+ *
+ * In the default (one-pass) mode, tuples are staged in a cache-line-sized
+ * write-combining buffer per partition, which is flushed into blocks of
+ * kBlockCapacity tuples with non-temporal stores. This keeps the working set
+ * of high fanouts small and avoids polluting the cache with output data.
+ *
+ * In the two-pass mode, the input is buffered and split into morsels; the
+ * morsels compute histograms, a prefix sum yields the exact position of every
+ * tuple, and the morsels scatter their tuples in parallel into one contiguous
+ * output region. Each partition is then a slice (by offset) of that region.
+ *
+ * In the broadcast mode, every tuple belongs to every partition: the input is
+ * materialized once and all partitions share the resulting array.
+ *
+ * In the NUMA-aware mode, the data of each partition is placed on its home
+ * node (see HomeNodeOfPartition), where the consuming parallel map processes
+ * it, such that the partitions are read locally after being written once.
+ * The buffers are mapped freshly, such that their pages are placed when they
+ * are first written. In the two-pass mode, each page of the region goes to the
+ * home node of the partition that its first byte belongs to.
+ */
 template <class MainUpstream, class ConfUpstream, class Tuple,
-          const size_t kSeed>
+          const size_t kSeed, const size_t kNumKeys = 1,
+          const bool kTwoPass = false, const bool kBroadcast = false,
+          const bool kNumaAware = false>
 class PartitionOperator {
 public:
     using InnerArray = decltype(std::declval<Tuple>().v1);
     using InnerTuple = typename std::remove_reference<decltype(
             std::declval<InnerArray>().data[0])>::type;
+    using BlockRefCounter = std::conditional_t<
+            kNumaAware, runtime::memory::MunmapRefCounter<InnerTuple>,
+            runtime::memory::FreeRefCounter<InnerTuple>>;
 
     static constexpr size_t kBlockCapacity = 4096;
+    static constexpr size_t kCacheLineSize = 64;
+    static constexpr size_t kMinMorselSize = 1U << 12U;
+
+    // Write-combining buffers are only used for tuples that can be copied as
+    // a sequence of 8-byte words and of which at least one fits a cache line
+    static constexpr bool kUseWriteCombining =
+            std::is_trivially_copyable_v<InnerTuple> &&
+            sizeof(InnerTuple) % sizeof(int64_t) == 0 &&
+            sizeof(InnerTuple) <= kCacheLineSize;
+    static constexpr size_t kBufferCapacity =
+            std::max<size_t>(1, kCacheLineSize / sizeof(InnerTuple));
+    static_assert(kBlockCapacity % kBufferCapacity == 0,
+                  "Blocks must hold a whole number of buffers.");
 
     PartitionOperator(MainUpstream *const main_upstream,
                       ConfUpstream *const conf_upstream)
@@ -32,68 +91,312 @@ public:
         assert(!conf_upstream_->next());
         conf_upstream_->close();
 
+        partitions_.clear();
+
         // Partition data from main upstream
         main_upstream_->open();
+        if constexpr (kBroadcast) {
+            PartitionBroadcast();
+        } else if constexpr (kTwoPass) {
+            PartitionTwoPass();
+        } else {
+            PartitionOnePass();
+        }
+        main_upstream_->close();
 
-        partitions_.clear();
+        output_it_ = partitions_.begin();
+    }
 
-        std::vector<InnerArray> current_partition_blocks(fanout_);
-        for (auto &b : current_partition_blocks) {
-            b.data = runtime::memory::SharedPointer<InnerTuple>(
-                    new runtime::memory::FreeRefCounter<InnerTuple>(
-                            malloc(sizeof(InnerTuple) * kBlockCapacity),
-                            kBlockCapacity));
-            b.outer_shape[0] = 0;
-            b.shape[0] = 0;
-            b.offsets[0] = 0;
+    INLINE Optional<Tuple> next() {
+        if (output_it_ == partitions_.end()) return {};
+        return *(output_it_++);
+    }
+
+    INLINE void close() {}
+
+private:
+    struct alignas(kCacheLineSize) WriteBuffer {
+        alignas(kCacheLineSize) unsigned char
+                data[kBufferCapacity * sizeof(InnerTuple)];
+        size_t num_tuples = 0;
+    };
+
+    template <size_t... I>
+    static INLINE auto HashKeys(const InnerTuple &tuple,
+                                std::index_sequence<I...> /*unused*/)
+            -> unsigned int {
+        auto const std_tuple = TupleToStdTuple(tuple);
+        unsigned int hash = kSeed;
+        ((hash = runtime::operators::MurmurHash2::Hash(
+                  &std::get<I>(std_tuple), sizeof(std::get<I>(std_tuple)),
+                  hash)),
+         ...);
+        return hash;
+    }
+
+    // Maps the hash of the partition key to [0, fanout) without a division
+    INLINE auto ComputePartition(const InnerTuple &tuple) const -> size_t {
+        const uint64_t hash =
+                HashKeys(tuple, std::make_index_sequence<kNumKeys>());
+        return (hash * fanout_) >> 32U;
+    }
+
+    // Copies num_bytes from src to dst, bypassing the cache if possible
+    static INLINE void StreamingCopy(void *const dst, const void *const src,
+                                     const size_t num_bytes) {
+#if defined(__x86_64__)
+        auto *const dst_words = reinterpret_cast<long long *>(dst);
+        const auto *const src_words =
+                reinterpret_cast<const long long *>(src);
+        for (size_t i = 0; i < num_bytes / sizeof(long long); i++) {
+            _mm_stream_si64(dst_words + i, src_words[i]);
         }
+#else
+        memcpy(dst, src, num_bytes);
+#endif
+    }
 
-        while (auto const ret = main_upstream_->next()) {
-            const auto input_tuple = ret.value();
-            const long idx = runtime::operators::MurmurHash2::Hash(
-                                     &input_tuple.v0,
-                                     sizeof(decltype(input_tuple.v0)), kSeed) %
-                             fanout_;
-            auto &current_block = current_partition_blocks[idx];
-            if (current_block.outer_shape[0] >= kBlockCapacity) {
-                current_block.shape[0] = current_block.outer_shape[0];
-                partitions_.push_back(Tuple{idx, current_block});
-                current_block.data = runtime::memory::SharedPointer<InnerTuple>(
-                        new runtime::memory::FreeRefCounter<InnerTuple>(
-                                malloc(sizeof(InnerTuple) * kBlockCapacity),
-                                kBlockCapacity));
-                current_block.outer_shape[0] = 0;
-                current_block.shape[0] = 0;
-                current_block.offsets[0] = 0;
+    static auto AllocateBlock(const size_t idx) -> InnerArray {
+        const size_t num_bytes = sizeof(InnerTuple) * kBlockCapacity;
+        void *const pointer =
+                kNumaAware ? runtime::memory::AllocateOnNode(
+                                     num_bytes,
+                                     runtime::memory::HomeNodeOfPartition(idx))
+                           : malloc(num_bytes);
+
+        // The tuples are constructed later, see SetNumElements
+        InnerArray block;
+        block.data = runtime::memory::SharedPointer<InnerTuple>(
+                new BlockRefCounter(pointer, 0, kBlockCapacity));
+        block.outer_shape[0] = 0;
+        block.shape[0] = 0;
+        block.offsets[0] = 0;
+        return block;
+    }
+
+    // Makes the block destroy the tuples it has received so far
+    static void SetNumElements(InnerArray *const block) {
+        auto const rc =
+                dynamic_cast<BlockRefCounter *>(block->data.ref_counter());
+        assert(rc != nullptr);
+        rc->set_num_elements(block->outer_shape[0]);
+    }
+
+    // Binds each page of the region to the home node of the partition that
+    // its first byte belongs to, with one call per run of pages on one node
+    void BindRegion(InnerTuple *const region, const size_t num_bytes,
+                    const std::vector<size_t> &partition_offsets) const {
+        auto *const bytes = reinterpret_cast<char *>(region);
+        const size_t page_size = runtime::memory::PageSize();
+        size_t p = 0;
+        size_t run_begin = 0;
+        size_t run_node = 0;
+        for (size_t page = 0; page < num_bytes; page += page_size) {
+            // Skip the partitions that end before the page
+            while (p + 1 < fanout_ &&
+                   partition_offsets[p + 1] * sizeof(InnerTuple) <= page) {
+                p++;
+            }
+            const size_t node = runtime::memory::HomeNodeOfPartition(p);
+            if (page != 0 && node != run_node) {
+                runtime::memory::BindToNode(bytes + run_begin,
+                                            page - run_begin, run_node);
+                run_begin = page;
+            }
+            run_node = node;
+        }
+        runtime::memory::BindToNode(bytes + run_begin, num_bytes - run_begin,
+                                    run_node);
+    }
+
+    void EmitFullBlock(const size_t idx, InnerArray *const block) {
+        block->shape[0] = block->outer_shape[0];
+        SetNumElements(block);
+        partitions_.push_back(Tuple{static_cast<long>(idx), *block});
+        *block = AllocateBlock(idx);
+    }
+
+    void FlushBuffer(const size_t idx, WriteBuffer *const buffer,
+                     InnerArray *const block) {
+        if (block->outer_shape[0] + buffer->num_tuples > kBlockCapacity) {
+            EmitFullBlock(idx, block);
+        }
+        StreamingCopy(block->data.get() + block->outer_shape[0], buffer->data,
+                      buffer->num_tuples * sizeof(InnerTuple));
+        block->outer_shape[0] += buffer->num_tuples;
+        buffer->num_tuples = 0;
+    }
+
+    // Appends the input to the current block of its partition, emitting the
+    // blocks that are full
+    void FillBlocks(std::vector<InnerArray> *const blocks) {
+        auto &current_partition_blocks = *blocks;
+        if constexpr (kUseWriteCombining) {
+            std::vector<WriteBuffer> buffers(fanout_);
+
+            while (auto const ret = main_upstream_->next()) {
+                const auto &input_tuple = ret.value();
+                const size_t idx = ComputePartition(input_tuple);
+                auto &buffer = buffers[idx];
+                memcpy(buffer.data + buffer.num_tuples * sizeof(InnerTuple),
+                       &input_tuple, sizeof(InnerTuple));
+                if (++buffer.num_tuples == kBufferCapacity) {
+                    FlushBuffer(idx, &buffer, &current_partition_blocks[idx]);
+                }
+            }
+
+            for (size_t i = 0; i < fanout_; i++) {
+                FlushBuffer(i, &buffers[i], &current_partition_blocks[i]);
+            }
+
+#if defined(__x86_64__)
+            // Make streaming stores visible to subsequent (regular) loads
+            _mm_sfence();
+#endif
+        } else {
+            while (auto const ret = main_upstream_->next()) {
+                const auto input_tuple = ret.value();
+                const size_t idx = ComputePartition(input_tuple);
+                auto &current_block = current_partition_blocks[idx];
+                if (current_block.outer_shape[0] >= kBlockCapacity) {
+                    EmitFullBlock(idx, &current_block);
+                }
+                new (current_block.data.get() + current_block.outer_shape[0]++)
+                        InnerTuple(input_tuple);
             }
-            new (current_block.data.get() + current_block.outer_shape[0]++)
-                    InnerTuple(input_tuple);
+        }
+    }
+
+    void PartitionOnePass() {
+        std::vector<InnerArray> current_partition_blocks(fanout_);
+        for (size_t i = 0; i < fanout_; i++) {
+            current_partition_blocks[i] = AllocateBlock(i);
+        }
+
+        try {
+            FillBlocks(&current_partition_blocks);
+        } catch (...) {
+            // E.g., if the query is aborted, only destroy received tuples
+            for (auto &block : current_partition_blocks) SetNumElements(&block);
+            throw;
         }
 
         for (size_t i = 0; i < current_partition_blocks.size(); i++) {
             auto &current_block = current_partition_blocks[i];
             current_block.shape[0] = current_block.outer_shape[0];
-            auto const rc =
-                    dynamic_cast<runtime::memory::FreeRefCounter<InnerTuple> *>(
-                            current_block.data.ref_counter());
-            assert(rc != nullptr);
-            rc->set_num_elements(current_block.outer_shape[0]);
+            SetNumElements(&current_block);
             partitions_.push_back(Tuple{static_cast<long>(i), current_block});
         }
+    }
+
+    void PartitionTwoPass() {
+        // Buffer the input and compute the partition of each tuple
+        std::vector<InnerTuple> tuples;
+        std::vector<uint32_t> tuple_partitions;
+        while (auto const ret = main_upstream_->next()) {
+            tuple_partitions.emplace_back(ComputePartition(ret.value()));
+            tuples.emplace_back(ret.value());
+        }
 
-        output_it_ = partitions_.begin();
+        const size_t num_tuples = tuples.size();
 
-        main_upstream_->close();
-    }
+        // Split input into morsels, at most one per thread
+        const size_t max_num_morsels =
+                (num_tuples + kMinMorselSize - 1) / kMinMorselSize;
+        const size_t num_morsels = std::max<size_t>(
+                1, std::min<size_t>(max_num_morsels, omp_get_max_threads()));
+        const size_t morsel_size = (num_tuples + num_morsels - 1) / num_morsels;
 
-    INLINE Optional<Tuple> next() {
-        if (output_it_ == partitions_.end()) return {};
-        return *(output_it_++);
+        // Per-morsel histograms, stored morsel-major
+        std::vector<size_t> positions(num_morsels * fanout_, 0);
+#pragma omp taskloop default(shared) grainsize(1)
+        for (size_t m = 0; m < num_morsels; m++) {
+            size_t *const histogram = positions.data() + m * fanout_;
+            const size_t end = std::min(num_tuples, (m + 1) * morsel_size);
+            for (size_t i = m * morsel_size; i < end; i++) {
+                histogram[tuple_partitions[i]]++;
+            }
+        }
+
+        // Exclusive prefix sum in partition-major order
+        std::vector<size_t> partition_offsets(fanout_ + 1);
+        size_t sum = 0;
+        for (size_t p = 0; p < fanout_; p++) {
+            partition_offsets[p] = sum;
+            for (size_t m = 0; m < num_morsels; m++) {
+                auto &position = positions[m * fanout_ + p];
+                const size_t count = position;
+                position = sum;
+                sum += count;
+            }
+        }
+        partition_offsets[fanout_] = sum;
+        assert(sum == num_tuples);
+
+        // Allocate one exactly-sized region for all partitions
+        const size_t capacity = std::max<size_t>(1, num_tuples);
+        const size_t num_bytes = sizeof(InnerTuple) * capacity;
+        auto *const region = reinterpret_cast<InnerTuple *>(
+                kNumaAware ? runtime::memory::MapPages(num_bytes)
+                           : malloc(num_bytes));
+        assert(region != nullptr);
+
+        // Place the pages of the region before they are first touched
+        if constexpr (kNumaAware) {
+            BindRegion(region, num_bytes, partition_offsets);
+        }
+        auto *const ref_counter = new BlockRefCounter(region, 0, capacity);
+        const runtime::memory::SharedPointer<InnerTuple> data(ref_counter);
+
+        // Scatter tuples into their final position
+#pragma omp taskloop default(shared) grainsize(1)
+        for (size_t m = 0; m < num_morsels; m++) {
+            size_t *const cursors = positions.data() + m * fanout_;
+            const size_t end = std::min(num_tuples, (m + 1) * morsel_size);
+            for (size_t i = m * morsel_size; i < end; i++) {
+                new (region + cursors[tuple_partitions[i]]++)
+                        InnerTuple(std::move(tuples[i]));
+            }
+        }
+        ref_counter->set_num_elements(num_tuples);
+
+        for (size_t p = 0; p < fanout_; p++) {
+            InnerArray partition;
+            partition.data = data;
+            partition.outer_shape[0] = num_tuples;
+            partition.offsets[0] = partition_offsets[p];
+            partition.shape[0] = partition_offsets[p + 1] - partition_offsets[p];
+            partitions_.push_back(Tuple{static_cast<long>(p), partition});
+        }
     }
 
-    INLINE void close() {}
+    void PartitionBroadcast() {
+        std::vector<InnerTuple> tuples;
+        while (auto const ret = main_upstream_->next()) {
+            tuples.emplace_back(ret.value());
+        }
+
+        const size_t num_tuples = tuples.size();
+        auto *const region = reinterpret_cast<InnerTuple *>(
+                malloc(sizeof(InnerTuple) * std::max<size_t>(1, num_tuples)));
+        assert(region != nullptr);
+        for (size_t i = 0; i < num_tuples; i++) {
+            new (region + i) InnerTuple(std::move(tuples[i]));
+        }
+
+        InnerArray array;
+        array.data = runtime::memory::SharedPointer<InnerTuple>(
+                new runtime::memory::FreeRefCounter<InnerTuple>(region,
+                                                                num_tuples));
+        array.outer_shape[0] = num_tuples;
+        array.offsets[0] = 0;
+        array.shape[0] = num_tuples;
+
+        for (size_t p = 0; p < fanout_; p++) {
+            partitions_.push_back(Tuple{static_cast<long>(p), array});
+        }
+    }
 
-private:
     MainUpstream *const main_upstream_;
     ConfUpstream *const conf_upstream_;
     size_t fanout_;
@@ -101,12 +404,16 @@ private:
     typename std::list<Tuple>::iterator output_it_;
 };
 
-template <class Tuple, const size_t kSeed, class MainUpstream,
+template <class Tuple, const size_t kSeed, const size_t kNumKeys = 1,
+          const bool kTwoPass = false, const bool kBroadcast = false,
+          const bool kNumaAware = false, class MainUpstream,
           class ConfUpstream>
-PartitionOperator<MainUpstream, ConfUpstream, Tuple, kSeed>
+PartitionOperator<MainUpstream, ConfUpstream, Tuple, kSeed, kNumKeys, kTwoPass,
+                  kBroadcast, kNumaAware>
 makePartitionOperator(MainUpstream *const main_upstream,
                       ConfUpstream *const conf_upstream) {
-    return PartitionOperator<MainUpstream, ConfUpstream, Tuple, kSeed>(
+    return PartitionOperator<MainUpstream, ConfUpstream, Tuple, kSeed,
+                             kNumKeys, kTwoPass, kBroadcast, kNumaAware>(
             main_upstream, conf_upstream);
 };
 
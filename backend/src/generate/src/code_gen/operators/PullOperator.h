@@ -0,0 +1,28 @@
+#ifndef CODE_GEN_OPERATORS_PULLOPERATOR_H
+#define CODE_GEN_OPERATORS_PULLOPERATOR_H
+
+#include "Utils.h"
+#include "runtime/jit/operators/optional.hpp"
+
+// Forwards the tuples of the upstream operator but hides its ForEach, such
+// that the consumer pulls them with next(). Inserted between all operators if
+// push-based execution is disabled.
+template <class Upstream, class Tuple>
+class PullOperator {
+public:
+    PullOperator(Upstream *const upstream) : upstream_(upstream) {}
+
+    INLINE void open() { upstream_->open(); }
+    INLINE Optional<Tuple> next() { return upstream_->next(); }
+    INLINE void close() { upstream_->close(); }
+
+private:
+    Upstream *const upstream_;
+};
+
+template <class Tuple, class Upstream>
+PullOperator<Upstream, Tuple> makePullOperator(Upstream *const upstream) {
+    return PullOperator<Upstream, Tuple>(upstream);
+};
+
+#endif  // CODE_GEN_OPERATORS_PULLOPERATOR_H
@@ -5,16 +5,29 @@
 #ifndef CODE_GEN_OPERATORS_RANGESOURCEOPERATOR_H
 #define CODE_GEN_OPERATORS_RANGESOURCEOPERATOR_H
 
-#include <iostream>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
 
 #include "Utils.h"
 #include "runtime/jit/operators/optional.hpp"
 
+/**
+ * Produces the values of [from, to) with the given step (which may be
+ * negative) like Python's range.
+ *
+ * The number of values is computed once in open() such that next() is a
+ * counted loop (one decrement and one addition per value) whose trip count
+ * the compiler can see after inlining. ForEach() is the batch form of the
+ * same loop for consumers that can be driven by a callback.
+ */
 template <class Upstream, class Tuple>
 class RangeSourceOperator {
 public:
     typedef decltype(Tuple().v0) ValueType;
 
+    static constexpr size_t kUnrollFactor = 4;
+
     RangeSourceOperator(Upstream *const upstream) : upstream(upstream) {}
 
     void open() {
@@ -23,12 +36,12 @@ public:
         const auto ret = upstream->next();
 
         if (!ret) {
-            current = to;
+            remaining = 0;
         } else {
             const auto input_tuple = ret.value();
             current = input_tuple.v0;
-            to = input_tuple.v1;
             step = input_tuple.v2;
+            remaining = ComputeCount(current, input_tuple.v1, step);
         }
 
         upstream->close();
@@ -37,18 +50,65 @@ public:
     void close() {}
 
     INLINE Optional<Tuple> next() {
-        if (current < to) {
-            current += step;
-            return Tuple{current - step};
+        if (remaining == 0) return {};
+        remaining--;
+        const ValueType value = current;
+        current += step;
+        return Tuple{value};
+    }
+
+    // Calls consume(Tuple) for all remaining values
+    template <class Consumer>
+    INLINE void ForEach(Consumer &&consume) {
+        const size_t n = remaining;
+        const ValueType first = current;
+        remaining = 0;
+        current += ValueType(n) * step;
+
+        // Specialize unit stride such that the step is a constant there
+        if (step == 1) {
+            UnrolledLoop(first, ValueType(1), n, consume);
+        } else {
+            UnrolledLoop(first, step, n, consume);
+        }
+    }
+
+    // Number of values of the range [from, to) with the given step
+    static size_t ComputeCount(const ValueType from,
+                                         const ValueType to,
+                                         const ValueType step) {
+        if constexpr (std::is_integral_v<ValueType>) {
+            if (step > 0 && from < to) return (to - from + step - 1) / step;
+            if (step < 0 && from > to) return (from - to - step - 1) / -step;
+            return 0;
+        } else {
+            const auto count = std::ceil((to - from) / step);
+            return count > 0 ? size_t(count) : 0;
         }
-        return {};
     }
 
 private:
+    // Counted loop, unrolled by kUnrollFactor, with one addition per value
+    template <class Consumer>
+    static INLINE void UnrolledLoop(ValueType value, const ValueType step,
+                                    const size_t n, Consumer &consume) {
+        size_t i = 0;
+        for (; i + kUnrollFactor <= n; i += kUnrollFactor) {
+            for (size_t j = 0; j < kUnrollFactor; j++) {
+                consume(Tuple{value});
+                value += step;
+            }
+        }
+        for (; i < n; i++) {
+            consume(Tuple{value});
+            value += step;
+        }
+    }
+
     Upstream *const upstream;
     ValueType current{};
-    ValueType to{};
     ValueType step{};
+    size_t remaining{};
 };
 
 template <class Tuple, class Upstream>
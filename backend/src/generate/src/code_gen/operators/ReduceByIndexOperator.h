@@ -5,85 +5,113 @@
 #ifndef CODE_GEN_OPERATORS_REDUCEBYINDEXOPERATOR_H
 #define CODE_GEN_OPERATORS_REDUCEBYINDEXOPERATOR_H
 
-#include <iostream>
+#include <cstdint>
 #include <limits>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "Utils.h"
 #include "runtime/jit/operators/optional.hpp"
 
 /**
- * Groups up the input tuples by an integer key in a vector and reduces the vals
- * Binary function must be associative, commutative
+ * Groups up the input tuples by an integer key in a dense array and reduces
+ * the vals. Binary function must be associative, commutative
  * The return type of the function must be the same as its arguments
  *
- * Result tuples are in an arbitrary order
+ * Presence of a slot is tracked in a byte array (rather than in a
+ * std::vector<bool>) such that updates and the final scan do not need any bit
+ * manipulation. The key range is validated once per tuple; the array accesses
+ * themselves are unchecked.
+ *
+ * Result tuples are sorted by key
  */
 template <class Upstream, class Tuple, class KeyType, class ValueType,
           class Function>
 class ReduceByIndexOperator {
-    const int64_t lo_;
-    const int64_t hi_;
-
-    std::vector<ValueType> inner_vector_;
-    std::vector<bool> presence_vector_;
-
-    typename std::vector<ValueType>::iterator iter_values_;
-    typename std::vector<bool>::iterator iter_presence_;
+    using KeyElement =
+            std::remove_cv_t<std::remove_reference_t<decltype(
+                    std::declval<KeyType>().v0)>>;
 
 public:
-    Upstream *const upstream_;
-    Function func_;
-
-    ReduceByIndexOperator(Upstream *upstream, Function func, int64_t lo,
-                          int64_t hi)
+    ReduceByIndexOperator(Upstream *const upstream, const Function &func,
+                          const int64_t lo, const int64_t hi)
         : upstream_(upstream),
           func_(func),
           lo_(lo),
           hi_(hi),
-          inner_vector_(hi - lo + 1),
-          presence_vector_(hi - lo + 1, false){};
+          size_(RangeSize(lo, hi)),
+          values_(size_),
+          presence_(size_, 0) {}
 
     Optional<Tuple> INLINE next() {
-        // Find the first non-NULL element
-        while (iter_values_ != inner_vector_.end()) {
-            if (*iter_presence_) {
-                const auto res = TupleToStdTuple(*iter_values_);
-                const auto old_key = std::make_tuple(
-                        iter_values_ - inner_vector_.begin() + lo_);
-
-                ++iter_presence_;
-                ++iter_values_;
-
-                return StdTupleToTuple(std::tuple_cat(old_key, res));
-            }
-
-            ++iter_values_;
-            ++iter_presence_;
+        // Find the next present slot
+        const uint8_t *const presence = presence_.data();
+        while (current_pos_ < size_ && presence[current_pos_] == 0) {
+            current_pos_++;
         }
-
-        return {};
+        if (current_pos_ == size_) return {};
+
+        const auto pos = current_pos_++;
+        const auto key_tuple =
+                std::make_tuple(static_cast<KeyElement>(static_cast<int64_t>(
+                        static_cast<uint64_t>(lo_) + pos)));
+        const auto value_tuple = TupleToStdTuple(values_[pos]);
+        return StdTupleToTuple(std::tuple_cat(key_tuple, value_tuple));
     }
 
     void INLINE open() {
+        ValueType *const values = values_.data();
+        uint8_t *const presence = presence_.data();
+
         upstream_->open();
-        while (const auto ret = upstream_->next()) {
-            const auto tuple = TupleToStdTuple(ret.value());
+        ForEachTuple(upstream_, [&](const auto &input) {
+            const auto tuple = TupleToStdTuple(input);
             const auto [key_tuple, value_tuple] = SplitTuple(tuple);
-            const auto key = StdTupleToTuple(key_tuple).v0 - lo_;
+            const auto key = static_cast<int64_t>(std::get<0>(key_tuple));
             const auto val = StdTupleToTuple(value_tuple);
 
+            // Single unsigned comparison covers both ends of the range
+            const uint64_t pos =
+                    static_cast<uint64_t>(key) - static_cast<uint64_t>(lo_);
+            if (pos >= size_) {
+                throw std::out_of_range(
+                        "ReduceByIndex: key " + std::to_string(key) +
+                        " outside of range [" + std::to_string(lo_) + ", " +
+                        std::to_string(hi_) + "]");
+            }
+
             // Further compute the result, and mark this entry as present
-            inner_vector_.at(key) = presence_vector_.at(key)
-                                            ? func_(inner_vector_.at(key), val)
-                                            : val;
-            presence_vector_.at(key) = true;
-        }
-        iter_values_ = inner_vector_.begin();
-        iter_presence_ = presence_vector_.begin();
+            values[pos] = presence[pos] != 0 ? func_(values[pos], val) : val;
+            presence[pos] = 1;
+        });
+        current_pos_ = 0;
     }
 
     void INLINE close() { upstream_->close(); }
+
+private:
+    // Number of slots of [lo, hi], computed without signed overflow
+    static auto RangeSize(const int64_t lo, const int64_t hi) -> uint64_t {
+        const uint64_t range =
+                static_cast<uint64_t>(hi) - static_cast<uint64_t>(lo);
+        if (hi < lo || range == std::numeric_limits<uint64_t>::max()) {
+            throw std::length_error("ReduceByIndex: invalid key range [" +
+                                    std::to_string(lo) + ", " +
+                                    std::to_string(hi) + "]");
+        }
+        return range + 1;
+    }
+
+    Upstream *const upstream_;
+    Function func_;
+    const int64_t lo_;
+    const int64_t hi_;
+    const uint64_t size_;
+
+    std::vector<ValueType> values_;
+    std::vector<uint8_t> presence_;
+    uint64_t current_pos_ = 0;
 };
 
 template <class Tuple, class KeyType, class ValueType, int64_t lo, int64_t hi,
@@ -95,6 +123,7 @@ makeReduceByIndexOperator(Upstream *upstream, Function func) {
 
     static_assert(std::numeric_limits<KeyElement>::is_integer,
                   "The keys  must have an integer type.");
+    static_assert(lo <= hi, "The index range must not be empty.");
 
     return ReduceByIndexOperator<Upstream, Tuple, KeyType, ValueType, Function>(
             upstream, func, lo, hi);
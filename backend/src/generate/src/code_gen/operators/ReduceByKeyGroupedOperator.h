@@ -6,8 +6,10 @@
 #define CODE_GEN_OPERATORS_REDUCEBYKEYGROUPEDOPERATOR_H
 
 #include <iostream>
+#include <tuple>
 #include <unordered_map>
 
+#include "CompositeKey.h"
 #include "Utils.h"
 #include "runtime/jit/operators/optional.hpp"
 
@@ -21,7 +23,7 @@
  *
  */
 template <class Upstream, class Tuple, class KeyType, class ValueType,
-          class Function>
+          size_t kNumKeys, class Function>
 class ReduceByKeyGroupedOperator {
 public:
     Upstream *upstream;
@@ -36,7 +38,7 @@ public:
             ValueType res = getValue(lastTuple);
             while ((lastTuple = upstream->next())) {
                 auto candKey = getKey(lastTuple);
-                if (candKey.v0 != key.v0) {
+                if (!KeyTypeEquals()(candKey, key)) {
                     break;
                 }
                 res = func(res, getValue(lastTuple));
@@ -54,31 +56,38 @@ public:
     void INLINE close() { upstream->close(); }
 
 private:
+    using KeyTypeEquals = CompositeKeyEquals<KeyType>;
+
     Optional<Tuple> lastTuple;
 
-    INLINE static constexpr KeyType getKey(const Tuple &t) {
-        return *(const_cast<KeyType *>((KeyType *)(&t)));
+    // The key and value structs are not necessarily laid out like the
+    // corresponding fields of the tuple (due to padding), so we go through
+    // std::tuple to split and concatenate them
+    INLINE static KeyType getKey(const Tuple &t) {
+        auto const [key_tuple, _] = SplitTupleAt<kNumKeys>(TupleToStdTuple(t));
+        return StdTupleToTuple(key_tuple);
     }
 
-    INLINE static constexpr ValueType getValue(const Tuple &t) {
-        return *((ValueType *)(((char *)&t) + sizeof(KeyType)));
+    INLINE static ValueType getValue(const Tuple &t) {
+        auto const [_, value_tuple] =
+                SplitTupleAt<kNumKeys>(TupleToStdTuple(t));
+        return StdTupleToTuple(value_tuple);
     }
 
     INLINE static Tuple buildResult(const KeyType &key, const ValueType &val) {
-        Tuple res;
-        char *resp = (char *)&res;
-        *((KeyType *)resp) = key;
-        *((ValueType *)(resp + sizeof(KeyType))) = val;
-        return res;
+        return StdTupleToTuple(
+                std::tuple_cat(TupleToStdTuple(key), TupleToStdTuple(val)));
     }
 };
 
-template <class Tuple, class KeyType, class ValueType, class Upstream,
-          class Function>
-ReduceByKeyGroupedOperator<Upstream, Tuple, KeyType, ValueType, Function> INLINE
-makeReduceByKeyGroupedOperator(Upstream *upstream, Function func) {
+template <class Tuple, class KeyType, class ValueType, size_t kNumKeys,
+          class Upstream, class Function>
+ReduceByKeyGroupedOperator<Upstream, Tuple, KeyType, ValueType, kNumKeys,
+                           Function>
+        INLINE makeReduceByKeyGroupedOperator(Upstream *upstream,
+                                              Function func) {
     return ReduceByKeyGroupedOperator<Upstream, Tuple, KeyType, ValueType,
-                                      Function>(upstream, func);
+                                      kNumKeys, Function>(upstream, func);
 };
 
 #endif  // CODE_GEN_OPERATORS_REDUCEBYKEYGROUPEDOPERATOR_H
@@ -2,9 +2,15 @@
 #define CODE_GEN_OPERATORS_REDUCEBYKEYOPERATOR_H
 
 #include <iostream>
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "CompositeKey.h"
+#include "HybridHash.h"
 #include "Utils.h"
+#include "runtime/jit/memory/memory_tracker.hpp"
 #include "runtime/jit/operators/optional.hpp"
 
 /**
@@ -14,17 +20,29 @@
  *
  * Result tuples are in an arbitrary order
  *
+ * If the hash table exceeds the memory budget (in bytes, 0 for none), the
+ * partitions that do not fit are spilled as (partial) aggregates and reduced
+ * after the in-memory ones, see HybridHash.h
  */
 template <class Upstream, class Tuple, class KeyType, class ValueType,
-          class Function>
+          size_t kNumKeys, class Function>
 class ReduceByKeyOperator {
+    using StdTuple = decltype(TupleToStdTuple(std::declval<Tuple>()));
+    using Partitions = hybrid_hash::Partitions<StdTuple>;
+    static constexpr bool kCanSpill = hybrid_hash::IsSpillable<StdTuple>::value;
+
 public:
-    ReduceByKeyOperator(Upstream *const upstream, const Function &func)
-        : upstream_(upstream), func_(func){};
+    ReduceByKeyOperator(Upstream *const upstream, const Function &func,
+                        const size_t memory_budget = 0,
+                        std::string spill_directory = "")
+        : upstream_(upstream),
+          func_(func),
+          memory_budget_(kCanSpill ? memory_budget : 0),
+          spill_directory_(std::move(spill_directory)){};
 
     Optional<Tuple> INLINE next() {
-        if (current_result_it_ == hash_table_.end()) {
-            return {};
+        while (current_result_it_ == hash_table_.end()) {
+            if (!ReduceNextSpilledPartition()) return {};
         }
         const auto &res = *(current_result_it_++);
         const auto key_tuple = TupleToStdTuple(res.first);
@@ -34,50 +52,125 @@ public:
 
     void INLINE open() {
         upstream_->open();
-        while (const auto ret = upstream_->next()) {
-            auto const tuple = TupleToStdTuple(ret.value());
-            auto const [key_tuple, value_tuple] = SplitTuple(tuple);
-            auto const key = StdTupleToTuple(key_tuple);
-            auto const value = StdTupleToTuple(value_tuple);
-
-            const auto [it, is_new] = hash_table_.emplace(key, value);
-            if (!is_new) {
-                const auto &aggregate = it->second;
-                it->second = func_(aggregate, value);
-            }
-        }
+        hash_table_.clear();
+        partitions_ = Partitions();
+        pending_.clear();
+        ForEachTuple(upstream_, [&](const auto &input) {
+            Insert(TupleToStdTuple(input));
+        });
         current_result_it_ = hash_table_.begin();
     }
 
     void INLINE close() { upstream_->close(); }
 
 private:
-    struct KeyTypeHash {
-        size_t operator()(const KeyType &key) const {
-            using FieldType = std::remove_cv_t<decltype(key.v0)>;
-            return std::hash<FieldType>()(key.v0);
+    using KeyTypeHash = CompositeKeyHash<KeyType>;
+    using KeyTypeEquals = CompositeKeyEquals<KeyType>;
+
+    INLINE void Insert(const StdTuple &tuple) {
+        auto const [key_tuple, value_tuple] = SplitTupleAt<kNumKeys>(tuple);
+        auto const key = StdTupleToTuple(key_tuple);
+        auto const value = StdTupleToTuple(value_tuple);
+
+        if (memory_budget_ == 0) {
+            Reduce(key, value);
+            return;
+        }
+
+        if constexpr (kCanSpill) {
+            const size_t partition =
+                    hybrid_hash::PartitionOf(key, partitions_.level());
+            if (partitions_.is_spilled(partition)) {
+                partitions_.template file<0>(partition, spill_directory_)
+                        .Append(tuple);
+                return;
+            }
+
+            if (!Reduce(key, value)) return;
+            partitions_.AddEntries(partition, 1);
+            if (partitions_.can_spill() &&
+                hybrid_hash::EstimateBytes(hash_table_) > memory_budget_) {
+                SpillLargestPartition();
+            }
         }
-    };
+    }
 
-    struct KeyTypeEquals {
-        bool operator()(const KeyType &lhs, const KeyType &rhs) const {
-            return TupleToStdTuple(lhs) == TupleToStdTuple(rhs);
+    // Returns whether the key is new
+    INLINE auto Reduce(const KeyType &key, const ValueType &value) -> bool {
+        const auto [it, is_new] = hash_table_.emplace(key, value);
+        if (!is_new) {
+            const auto &aggregate = it->second;
+            it->second = func_(aggregate, value);
         }
-    };
+        return is_new;
+    }
+
+    // Moves the aggregates of the largest partition into its spill file
+    void SpillLargestPartition() {
+        const size_t partition = partitions_.SpillLargest();
+        if (partition == hybrid_hash::kFanout) return;
+
+        auto &file = partitions_.template file<0>(partition, spill_directory_);
+        for (auto it = hash_table_.begin(); it != hash_table_.end();) {
+            if (hybrid_hash::PartitionOf(it->first, partitions_.level()) ==
+                partition) {
+                file.Append(std::tuple_cat(TupleToStdTuple(it->first),
+                                           TupleToStdTuple(it->second)));
+                it = hash_table_.erase(it);
+            } else {
+                it++;
+            }
+        }
+        hybrid_hash::ShrinkBuckets(&hash_table_);
+    }
+
+    // Replaces the hash table with the reduced tuples of the next spilled
+    // partition and returns false if there is none
+    auto ReduceNextSpilledPartition() -> bool {
+        if constexpr (kCanSpill) {
+            const size_t next_level = partitions_.level() + 1;
+            for (auto &files : partitions_.TakeSpilledFiles()) {
+                pending_.emplace_back(std::move(files), next_level);
+            }
+            if (pending_.empty()) return false;
+
+            auto [files, level] = std::move(pending_.back());
+            pending_.pop_back();
+            hash_table_.clear();
+            partitions_ = Partitions(level);
+            std::get<0>(files)->ForEach(
+                    [&](const StdTuple &tuple) { Insert(tuple); });
+            current_result_it_ = hash_table_.begin();
+            return true;
+        } else {
+            return false;
+        }
+    }
 
     Upstream *const upstream_;
     Function func_;
-    std::unordered_map<KeyType, ValueType, KeyTypeHash, KeyTypeEquals>
+    std::unordered_map<KeyType, ValueType, KeyTypeHash, KeyTypeEquals,
+                       runtime::memory::TrackingAllocator<
+                               std::pair<const KeyType, ValueType>>>
             hash_table_;
     typename decltype(hash_table_)::iterator current_result_it_;
+
+    const size_t memory_budget_;
+    const std::string spill_directory_;
+    Partitions partitions_;
+    // Spilled partitions still to be reduced with their level
+    std::vector<std::pair<typename Partitions::Files, size_t>> pending_;
 };
 
-template <class Tuple, class KeyType, class ValueType, class Upstream,
-          class Function>
-ReduceByKeyOperator<Upstream, Tuple, KeyType, ValueType, Function> INLINE
-makeReduceByKeyOperator(Upstream *upstream, Function func) {
-    return ReduceByKeyOperator<Upstream, Tuple, KeyType, ValueType, Function>(
-            upstream, func);
+template <class Tuple, class KeyType, class ValueType, size_t kNumKeys,
+          class Upstream, class Function>
+ReduceByKeyOperator<Upstream, Tuple, KeyType, ValueType, kNumKeys, Function>
+        INLINE makeReduceByKeyOperator(Upstream *upstream, Function func,
+                                       const size_t memory_budget = 0,
+                                       std::string spill_directory = "") {
+    return ReduceByKeyOperator<Upstream, Tuple, KeyType, ValueType, kNumKeys,
+                               Function>(upstream, func, memory_budget,
+                                         std::move(spill_directory));
 };
 
 #endif  // CODE_GEN_OPERATORS_REDUCEBYKEYOPERATOR_H
@@ -32,9 +32,8 @@ public:
         }
 
         Tuple acc = ret;
-        while (auto ret = upstream_->next()) {
-            acc = function_(acc, ret);
-        }
+        ForEachTuple(upstream_,
+                     [&](const Tuple &tuple) { acc = function_(acc, tuple); });
 
         upstream_->close();
 
@@ -40,11 +40,23 @@ public:
             values_ = input.data;
         }
 
-        const Tuple r = BuildResultTuple();
+        const Tuple r = BuildResultTuple(current_index_);
         current_index_++;
         return r;
     }
 
+    template <class Consumer>
+    INLINE void ForEach(Consumer &&consume) {
+        ScanRemaining(consume);
+        ForEachTuple(upstream_, [&](const auto &input_tuple) {
+            const auto input = input_tuple.v0;
+            current_index_ = input.offsets[0];
+            last_index_ = current_index_ + input.shape[0];
+            values_ = input.data;
+            ScanRemaining(consume);
+        });
+    }
+
     INLINE void close() { upstream_->close(); }
 
 private:
@@ -53,11 +65,21 @@ private:
     size_t last_index_;
     InputDataPtr values_;
 
-    INLINE Tuple BuildResultTuple() {
-        auto const input_tuple = values_[current_index_];
+    // Consumes the remaining tuples of the current input array
+    template <class Consumer>
+    INLINE void ScanRemaining(Consumer &consume) {
+        const size_t end = last_index_;
+        for (size_t i = current_index_; i < end; i++) {
+            consume(BuildResultTuple(i));
+        }
+        current_index_ = end;
+    }
+
+    INLINE Tuple BuildResultTuple(const size_t index) {
+        auto const input_tuple = values_[index];
         if constexpr (kAddIndex) {
             auto const std_input_tuple = TupleToStdTuple(input_tuple);
-            std::tuple<long> std_index_tuple{current_index_};
+            std::tuple<long> std_index_tuple{index};
             auto const ret_tuple =
                     std::tuple_cat(std_index_tuple, std_input_tuple);
             return StdTupleToTuple(ret_tuple);
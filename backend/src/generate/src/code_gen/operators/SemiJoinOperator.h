@@ -1,56 +1,88 @@
 #ifndef CODE_GEN_OPERATORS_SEMIJOINOPERATOR_H
 #define CODE_GEN_OPERATORS_SEMIJOINOPERATOR_H
 
+#include <string>
 #include <tuple>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "CompositeKey.h"
+#include "HybridHash.h"
 #include "Utils.h"
+#include "runtime/jit/memory/memory_tracker.hpp"
 #include "runtime/jit/operators/optional.hpp"
 
 /**
- * For input tuples (K, V) and (K, W) returns (K, V)
+ * For input tuples (K, V) and (K, W) returns the (K, V) for which there is a
+ * (K, W) with the same key or, as anti-join (kAnti), for which there is none
  *
  * Current implementation builds map on the right input operator
- * Keeps the left operator input ordered
+ * Keeps the left operator input ordered unless partitions are spilled
+ *
+ * If the build table exceeds the memory budget (in bytes, 0 for none), the
+ * keys of the partitions that do not fit are spilled together with the left
+ * tuples probing them and processed after the in-memory ones, see
+ * HybridHash.h
  */
 template <class LeftUpstream, class RightUpstream, class Tuple, class KeyType,
-          class LeftValueType>
+          class LeftValueType, size_t kNumKeys, bool kAnti = false>
 class SemiJoinOperator {
+    using StdKey = decltype(TupleToStdTuple(std::declval<KeyType>()));
+    using LeftStdTuple = decltype(TupleToStdTuple(std::declval<Tuple>()));
+    using Partitions = hybrid_hash::Partitions<StdKey, LeftStdTuple>;
+    static constexpr bool kCanSpill =
+            hybrid_hash::IsSpillable<StdKey>::value &&
+            hybrid_hash::IsSpillable<LeftStdTuple>::value;
+
 public:
-    SemiJoinOperator(LeftUpstream *left_upstream, RightUpstream *right_upstream)
-        : left_upstream_(left_upstream), right_upstream_(right_upstream){};
+    SemiJoinOperator(LeftUpstream *left_upstream, RightUpstream *right_upstream,
+                     const size_t memory_budget = 0,
+                     std::string spill_directory = "")
+        : left_upstream_(left_upstream),
+          right_upstream_(right_upstream),
+          memory_budget_(kCanSpill ? memory_budget : 0),
+          spill_directory_(std::move(spill_directory)){};
 
     void INLINE open() {
         left_upstream_->open();
         right_upstream_->open();
 
-        // Build table already built
-        if (!build_table_.empty()) {
+        // Build table already built (and complete)
+        if (!build_table_.empty() && !has_spilled_) {
             return;
         }
 
+        build_table_.clear();
+        has_spilled_ = false;
+        partitions_ = Partitions();
+        pending_.clear();
+        probe_files_ = {};
+
         // Build hash table from right upstream
         while (auto const ret = right_upstream_->next()) {
             auto const tuple = TupleToStdTuple(ret.value());
-            auto const [key, value] = SplitTuple(tuple);
-            build_table_.insert({StdTupleToTuple(key)});
+            auto const [key, value] = SplitTupleAt<kNumKeys>(tuple);
+            Build(key);
         }
     }
 
     Optional<Tuple> INLINE next() {
-        while (auto ret = left_upstream_->next()) {
-            auto const tuple = TupleToStdTuple(ret.value());
-            auto const [key_tuple, _] = SplitTuple(tuple);
-            auto const key = StdTupleToTuple(key_tuple);
-            const auto it = build_table_.find(key);
-            if (it != build_table_.end()) {
-                return ret.value();
+        while (true) {
+            auto const ret = NextLeftTuple();
+            if (!ret) {
+                if (!BuildNextSpilledPartition()) return {};
+                continue;
             }
-        }
 
-        return {};
+            auto const &tuple = ret.value();
+            auto const [key_tuple, _] = SplitTupleAt<kNumKeys>(tuple);
+            auto const key = StdTupleToTuple(key_tuple);
+            if (SpillProbe(key, tuple)) continue;
+
+            const bool has_match = build_table_.find(key) != build_table_.end();
+            if (has_match != kAnti) return StdTupleToTuple(tuple);
+        }
     }
 
     void INLINE close() {
@@ -59,33 +91,166 @@ public:
     }
 
 private:
-    struct KeyTypeHash {
-        size_t operator()(const KeyType &key) const {
-            using FieldType = std::remove_cv_t<decltype(key.v0)>;
-            return std::hash<FieldType>()(key.v0);
+    INLINE void Build(const StdKey &key_tuple) {
+        auto const key = StdTupleToTuple(key_tuple);
+
+        if (memory_budget_ == 0) {
+            build_table_.insert(key);
+            return;
         }
-    };
 
-    struct KeyTypeEquals {
-        bool operator()(const KeyType &lhs, const KeyType &rhs) const {
-            return TupleToStdTuple(lhs) == TupleToStdTuple(rhs);
+        if constexpr (kCanSpill) {
+            const size_t partition =
+                    hybrid_hash::PartitionOf(key, partitions_.level());
+            if (partitions_.is_spilled(partition)) {
+                partitions_.template file<0>(partition, spill_directory_)
+                        .Append(key_tuple);
+                return;
+            }
+
+            if (!build_table_.insert(key).second) return;
+            partitions_.AddEntries(partition, 1);
+            if (partitions_.can_spill() &&
+                hybrid_hash::EstimateBytes(build_table_) > memory_budget_) {
+                SpillLargestPartition();
+            }
         }
-    };
+    }
+
+    // Moves the keys of the largest partition into its spill file
+    void SpillLargestPartition() {
+        const size_t partition = partitions_.SpillLargest();
+        if (partition == hybrid_hash::kFanout) return;
+        has_spilled_ = true;
+
+        auto &file = partitions_.template file<0>(partition, spill_directory_);
+        for (auto it = build_table_.begin(); it != build_table_.end();) {
+            if (hybrid_hash::PartitionOf(*it, partitions_.level()) ==
+                partition) {
+                file.Append(TupleToStdTuple(*it));
+                it = build_table_.erase(it);
+            } else {
+                it++;
+            }
+        }
+        hybrid_hash::ShrinkBuckets(&build_table_);
+    }
+
+    // Writes the left tuple into the spill file of its partition and returns
+    // true if that partition is spilled
+    INLINE auto SpillProbe(const KeyType &key, const LeftStdTuple &tuple)
+            -> bool {
+        if constexpr (kCanSpill) {
+            if (memory_budget_ == 0) return false;
+            const size_t partition =
+                    hybrid_hash::PartitionOf(key, partitions_.level());
+            if (!partitions_.is_spilled(partition)) return false;
+            partitions_.template file<1>(partition, spill_directory_)
+                    .Append(tuple);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    INLINE auto NextLeftTuple() -> Optional<LeftStdTuple> {
+        if (std::get<1>(probe_files_) == nullptr) {
+            if (auto const ret = left_upstream_->next()) {
+                return TupleToStdTuple(ret.value());
+            }
+            return {};
+        }
+        if constexpr (kCanSpill) {
+            if (auto const *const tuple = std::get<1>(probe_files_)->Read()) {
+                return *tuple;
+            }
+        }
+        return {};
+    }
+
+    // Once all left tuples of the current level have been probed, replaces
+    // the build table with the keys of the next spilled partition and starts
+    // probing it with the left tuples of that partition. Returns false if
+    // there are no spilled partitions left.
+    auto BuildNextSpilledPartition() -> bool {
+        if constexpr (kCanSpill) {
+            const size_t next_level = partitions_.level() + 1;
+            for (auto &files : partitions_.TakeSpilledFiles()) {
+                // Without left tuples, the partition has no results
+                if (std::get<1>(files) == nullptr) continue;
+                pending_.emplace_back(std::move(files), next_level);
+            }
+            if (pending_.empty()) return false;
+
+            auto [files, level] = std::move(pending_.back());
+            pending_.pop_back();
+            build_table_.clear();
+            partitions_ = Partitions(level);
+            std::get<0>(files)->ForEach(
+                    [&](const StdKey &key_tuple) { Build(key_tuple); });
+            std::get<0>(files).reset();
+
+            probe_files_ = std::move(files);
+            std::get<1>(probe_files_)->StartReading();
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    using KeyTypeHash = CompositeKeyHash<KeyType>;
+    using KeyTypeEquals = CompositeKeyEquals<KeyType>;
 
     LeftUpstream *const left_upstream_;
     RightUpstream *const right_upstream_;
-    std::unordered_set<KeyType, KeyTypeHash, KeyTypeEquals> build_table_;
+    std::unordered_set<KeyType, KeyTypeHash, KeyTypeEquals,
+                       runtime::memory::TrackingAllocator<KeyType>>
+            build_table_;
     LeftValueType last_left_upstream_;
     KeyType last_key_;
+
+    const size_t memory_budget_;
+    const std::string spill_directory_;
+    bool has_spilled_ = false;
+    Partitions partitions_;
+    // Spilled partitions still to be processed with their level
+    std::vector<std::pair<typename Partitions::Files, size_t>> pending_;
+    // Files of the spilled partition being processed, if any
+    typename Partitions::Files probe_files_;
 };
 
-template <class Tuple, class KeyType, class LeftValueType, class LeftUpstream,
-          class RightUpstream>
-SemiJoinOperator<LeftUpstream, RightUpstream, Tuple, KeyType, LeftValueType>
+template <class Tuple, class KeyType, class LeftValueType, size_t kNumKeys,
+          class LeftUpstream, class RightUpstream>
+SemiJoinOperator<LeftUpstream, RightUpstream, Tuple, KeyType, LeftValueType,
+                 kNumKeys>
         INLINE makeSemiJoinOperator(LeftUpstream *left_upstream,
-                                    RightUpstream *right_upstream) {
+                                    RightUpstream *right_upstream,
+                                    const size_t memory_budget = 0,
+                                    std::string spill_directory = "") {
     return SemiJoinOperator<LeftUpstream, RightUpstream, Tuple, KeyType,
-                            LeftValueType>(left_upstream, right_upstream);
+                            LeftValueType, kNumKeys>(
+            left_upstream, right_upstream, memory_budget,
+            std::move(spill_directory));
+};
+
+template <class LeftUpstream, class RightUpstream, class Tuple, class KeyType,
+          class LeftValueType, size_t kNumKeys>
+using AntiJoinOperator = SemiJoinOperator<LeftUpstream, RightUpstream, Tuple,
+                                          KeyType, LeftValueType, kNumKeys,
+                                          /*kAnti=*/true>;
+
+template <class Tuple, class KeyType, class LeftValueType, size_t kNumKeys,
+          class LeftUpstream, class RightUpstream>
+AntiJoinOperator<LeftUpstream, RightUpstream, Tuple, KeyType, LeftValueType,
+                 kNumKeys>
+        INLINE makeAntiJoinOperator(LeftUpstream *left_upstream,
+                                    RightUpstream *right_upstream,
+                                    const size_t memory_budget = 0,
+                                    std::string spill_directory = "") {
+    return AntiJoinOperator<LeftUpstream, RightUpstream, Tuple, KeyType,
+                            LeftValueType, kNumKeys>(
+            left_upstream, right_upstream, memory_budget,
+            std::move(spill_directory));
 };
 
 #endif  // CODE_GEN_OPERATORS_SEMIJOINOPERATOR_H
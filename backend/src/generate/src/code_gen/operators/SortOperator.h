@@ -15,9 +15,8 @@ public:
 
     INLINE void open() {
         upstream_->open();
-        while (auto const ret = upstream_->next()) {
-            container_.push_back(ret.value());
-        }
+        ForEachTuple(upstream_,
+                     [&](const Tuple& tuple) { container_.push_back(tuple); });
         std::sort(container_.begin(), container_.end(), SmallerComparator());
         result_it_ = container_.begin();
     }
@@ -0,0 +1,98 @@
+#ifndef CODE_GEN_OPERATORS_SORTEDDISTINCTOPERATOR_H
+#define CODE_GEN_OPERATORS_SORTEDDISTINCTOPERATOR_H
+
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+
+#include "CompositeKey.h"
+#include "Utils.h"
+#include "runtime/jit/operators/optional.hpp"
+
+/**
+ * Returns each distinct input tuple once, comparing all fields
+ *
+ * This implementation assumes that the input is sorted (or at least grouped)
+ * on the first field, so duplicates can only occur within a run of equal
+ * first fields. It thus only remembers the tuples of the current run and, for
+ * single-field tuples, only the previous tuple.
+ *
+ * Keeps the order of the input
+ */
+template <class Upstream, class Tuple>
+class SortedDistinctOperator {
+public:
+    SortedDistinctOperator(Upstream *const upstream) : upstream_(upstream) {}
+
+    void INLINE open() {
+        upstream_->open();
+        has_run_ = false;
+        run_tuples_.clear();
+    }
+
+    Optional<Tuple> INLINE next() {
+        while (auto const ret = upstream_->next()) {
+            if (IsNew(ret.value())) return ret;
+        }
+        return {};
+    }
+
+    template <class Consumer>
+    INLINE void ForEach(Consumer &&consume) {
+        ForEachTuple(upstream_, [&](const Tuple &tuple) {
+            if (IsNew(tuple)) consume(tuple);
+        });
+    }
+
+    void INLINE close() { upstream_->close(); }
+
+private:
+    using TupleHash = CompositeKeyHash<Tuple>;
+    using TupleEquals = CompositeKeyEquals<Tuple>;
+    using RunKey = std::decay_t<decltype(std::declval<Tuple>().v0)>;
+
+    static constexpr size_t kNumFields = std::tuple_size_v<
+            decltype(TupleToStdTuple(std::declval<Tuple>()))>;
+
+    // A long run leaves many buckets behind, which clear() would visit for
+    // each of the following runs, so the set is replaced instead
+    static constexpr size_t kMaxRetainedBuckets = 64;
+
+    INLINE auto IsNew(const Tuple &tuple) -> bool {
+        if (!has_run_ || !(tuple.v0 == run_key_)) {
+            has_run_ = true;
+            run_key_ = tuple.v0;
+            if constexpr (kNumFields > 1) {
+                StartRun(tuple);
+            }
+            return true;
+        }
+        if constexpr (kNumFields == 1) {
+            return false;
+        } else {
+            return run_tuples_.insert(tuple).second;
+        }
+    }
+
+    void StartRun(const Tuple &tuple) {
+        if (run_tuples_.bucket_count() > kMaxRetainedBuckets) {
+            run_tuples_ = decltype(run_tuples_)();
+        } else {
+            run_tuples_.clear();
+        }
+        run_tuples_.insert(tuple);
+    }
+
+    Upstream *const upstream_;
+    bool has_run_ = false;
+    RunKey run_key_{};
+    std::unordered_set<Tuple, TupleHash, TupleEquals> run_tuples_;
+};
+
+template <class Tuple, class Upstream>
+SortedDistinctOperator<Upstream, Tuple> INLINE
+makeSortedDistinctOperator(Upstream *const upstream) {
+    return SortedDistinctOperator<Upstream, Tuple>(upstream);
+};
+
+#endif  // CODE_GEN_OPERATORS_SORTEDDISTINCTOPERATOR_H
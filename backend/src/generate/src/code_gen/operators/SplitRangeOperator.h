@@ -1,33 +1,57 @@
 #ifndef CODE_GEN_OPERATORS_SPLITRANGEOPERATOR_H
 #define CODE_GEN_OPERATORS_SPLITRANGEOPERATOR_H
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
 #include <omp.h>
 
+#include "RangeSourceOperator.h"
 #include "Utils.h"
 #include "runtime/jit/operators/optional.hpp"
 
-template <class OutputTuple, class MainUpstream, class DopUpstream>
+/**
+ * Splits each input range into slices.
+ *
+ * With kMorselSize == 0, produces exactly as many equally-sized slices as the
+ * degree of parallelism. Otherwise, produces slices of about kMorselSize
+ * values (but at least one and at most kMaxMorselsPerWorker per worker), such
+ * that work can be balanced dynamically.
+ */
+template <class OutputTuple, class MainUpstream, class DopUpstream,
+          size_t kMorselSize = 0>
 class SplitRangeOperator {
 public:
     typedef decltype(OutputTuple().v0) ValueType;
 
+    static constexpr size_t kMaxMorselsPerWorker = 8;
+
 private:
     static constexpr ValueType ComputeStartIndex(const ValueType start,
-                                                 const ValueType end,
                                                  const ValueType step,
+                                                 const size_t count,
                                                  const size_t slice_num,
                                                  const size_t num_slices) {
-        return start +
-               (slice_num * size_t((end - start) / step) / num_slices) * step;
+        return start + ValueType(slice_num * count / num_slices) * step;
     }
 
     static constexpr ValueType ComputeEndIndex(const ValueType start,
                                                const ValueType end,
                                                const ValueType step,
+                                               const size_t count,
                                                const size_t slice_num,
                                                const size_t num_slices) {
         if (slice_num + 1 == num_slices) return end;
-        return ComputeStartIndex(start, end, step, slice_num + 1, num_slices);
+        return ComputeStartIndex(start, step, count, slice_num + 1,
+                                 num_slices);
+    }
+
+    auto ComputeNumSlices(const size_t count) const -> size_t {
+        if (kMorselSize == 0) return dop_;
+        const size_t num_morsels = (count + kMorselSize - 1) / kMorselSize;
+        return std::clamp<size_t>(num_morsels, dop_,
+                                  dop_ * kMaxMorselsPerWorker);
     }
 
 public:
@@ -37,12 +61,14 @@ public:
 
     void open() {
         dop_upstream_->open();
-        num_slices_ = dop_upstream_->next().value().v0;
+        dop_ = dop_upstream_->next().value().v0;
         assert(!dop_upstream_->next());
         dop_upstream_->close();
+        assert(dop_ > 0);
 
         main_upstream_->open();
-        current_slice_num_ = num_slices_;
+        num_slices_ = 0;
+        current_slice_num_ = 0;
     }
 
     INLINE Optional<OutputTuple> next() {
@@ -51,6 +77,11 @@ public:
             if (!ret) return {};
 
             current_tuple_ = ret.value();
+            current_count_ = RangeSourceOperator<
+                    MainUpstream, OutputTuple>::ComputeCount(current_tuple_.v0,
+                                                             current_tuple_.v1,
+                                                             current_tuple_.v2);
+            num_slices_ = ComputeNumSlices(current_count_);
             current_slice_num_ = 0;
         }
 
@@ -58,12 +89,12 @@ public:
         const auto to = current_tuple_.v1;
         const auto step = current_tuple_.v2;
 
-        const auto ret =
-                OutputTuple{ComputeStartIndex(from, to, step,
-                                              current_slice_num_, num_slices_),
-                            ComputeEndIndex(from, to, step, current_slice_num_,
-                                            num_slices_),
-                            step};
+        const auto ret = OutputTuple{
+                ComputeStartIndex(from, step, current_count_,
+                                  current_slice_num_, num_slices_),
+                ComputeEndIndex(from, to, step, current_count_,
+                                current_slice_num_, num_slices_),
+                step};
 
         current_slice_num_++;
         return ret;
@@ -74,16 +105,19 @@ public:
 private:
     MainUpstream *const main_upstream_;
     DopUpstream *const dop_upstream_;
-    size_t num_slices_;
+    size_t dop_{};
+    size_t num_slices_{};
     OutputTuple current_tuple_{};
+    size_t current_count_{};
     size_t current_slice_num_{};
 };
 
-template <class OutputTuple, class MainUpstream, class DopUpstream>
+template <class OutputTuple, size_t kMorselSize = 0, class MainUpstream,
+          class DopUpstream>
 auto makeSplitRangeOperator(MainUpstream *const main_upstream,
                             DopUpstream *const dop_upstream) {
-    return SplitRangeOperator<OutputTuple, MainUpstream, DopUpstream>(
-            main_upstream, dop_upstream);
+    return SplitRangeOperator<OutputTuple, MainUpstream, DopUpstream,
+                              kMorselSize>(main_upstream, dop_upstream);
 };
 
 #endif  // CODE_GEN_OPERATORS_SPLITRANGEOPERATOR_H
@@ -0,0 +1,199 @@
+#ifndef CODE_GEN_OPERATORS_SPLITSKEWEDPARTITIONSOPERATOR_H
+#define CODE_GEN_OPERATORS_SPLITSKEWEDPARTITIONSOPERATOR_H
+
+#include <cassert>
+#include <cstdlib>
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <omp.h>
+
+#include "Utils.h"
+#include "runtime/jit/memory/free_ref_counter.hpp"
+#include "runtime/jit/memory/shared_pointer.hpp"
+#include "runtime/jit/operators/optional.hpp"
+
+// Balances the work units of a partitioned join. Each input tuple consists of
+// the groups of both join sides of one partition, i.e., two arrays of
+// one-field (block) tuples as produced by GroupBy. Partitions that are much larger than average
+// (typically because of heavy-hitter keys) are split into several work units:
+// the larger side is cut into slices of roughly average size and the smaller
+// side is replicated to each of them, which preserves the result of the join.
+template <class Upstream, class Tuple>
+class SplitSkewedPartitionsOperator {
+    // Partitions larger than this factor times the average are split
+    static constexpr size_t kSkewFactor = 2;
+    // Partitions smaller than this are never split
+    static constexpr size_t kMinSplitSize = 1U << 12U;
+
+public:
+    explicit SplitSkewedPartitionsOperator(Upstream* const upstream)
+        : upstream_(upstream) {}
+
+    INLINE void open() {
+        upstream_->open();
+
+        std::vector<Tuple> partitions;
+        std::vector<size_t> left_sizes;
+        std::vector<size_t> right_sizes;
+        size_t total_size = 0;
+        while (auto const ret = upstream_->next()) {
+            const Tuple& partition = ret.value();
+            left_sizes.push_back(CountTuples(partition.v0));
+            right_sizes.push_back(CountTuples(partition.v1));
+            total_size += left_sizes.back() + right_sizes.back();
+            partitions.push_back(partition);
+        }
+
+        work_units_.clear();
+        work_units_.reserve(partitions.size());
+
+        const size_t mean_size =
+                total_size / std::max<size_t>(1, partitions.size());
+        const size_t slice_size = std::max(kMinSplitSize, mean_size);
+        const size_t threshold =
+                std::max(kMinSplitSize, kSkewFactor * mean_size);
+        const size_t max_num_slices = std::max(1, omp_get_max_threads());
+
+        for (size_t i = 0; i < partitions.size(); i++) {
+            auto& partition = partitions[i];
+            const size_t left_size = left_sizes[i];
+            const size_t right_size = right_sizes[i];
+
+            if (left_size + right_size <= threshold) {
+                work_units_.push_back(std::move(partition));
+                continue;
+            }
+
+            const size_t larger_size = std::max(left_size, right_size);
+            const size_t num_slices =
+                    std::min(max_num_slices,
+                             (larger_size + slice_size - 1) / slice_size);
+
+            if (num_slices <= 1) {
+                work_units_.push_back(std::move(partition));
+                continue;
+            }
+
+            if (left_size >= right_size) {
+                auto slices = SplitGroups(partition.v0, left_size, num_slices);
+                for (auto& slice : slices) {
+                    work_units_.push_back(
+                            Tuple{std::move(slice), partition.v1});
+                }
+            } else {
+                auto slices = SplitGroups(partition.v1, right_size, num_slices);
+                for (auto& slice : slices) {
+                    work_units_.push_back(
+                            Tuple{partition.v0, std::move(slice)});
+                }
+            }
+        }
+
+        output_it_ = work_units_.begin();
+    }
+
+    INLINE Optional<Tuple> next() {
+        if (output_it_ != work_units_.end()) {
+            return *output_it_++;
+        }
+        return {};
+    }
+
+    INLINE void close() {
+        work_units_.clear();
+        upstream_->close();
+    }
+
+private:
+    template <class Groups>
+    static size_t CountTuples(const Groups& groups) {
+        size_t num_tuples = 0;
+        for (size_t i = 0; i < groups.shape[0]; i++) {
+            num_tuples += groups.data[groups.offsets[0] + i].v0.shape[0];
+        }
+        return num_tuples;
+    }
+
+    // Cuts the blocks of the given groups into num_slices sets of blocks with
+    // (almost) equal number of tuples. The blocks are not copied; only their
+    // offsets and shapes are adjusted.
+    template <class Groups>
+    static std::vector<Groups> SplitGroups(const Groups& groups,
+                                           const size_t num_tuples,
+                                           const size_t num_slices) {
+        using Group = std::remove_cv_t<
+                std::remove_reference_t<decltype(groups.data[0])>>;
+
+        std::vector<Groups> slices;
+        slices.reserve(num_slices);
+
+        size_t group_idx = 0;
+        size_t pos_in_group = 0;
+        for (size_t s = 0; s < num_slices; s++) {
+            const size_t begin = num_tuples * s / num_slices;
+            const size_t end = num_tuples * (s + 1) / num_slices;
+            size_t remaining = end - begin;
+
+            std::vector<Group> parts;
+            while (remaining > 0) {
+                assert(group_idx < groups.shape[0]);
+                const Group& group = groups.data[groups.offsets[0] + group_idx];
+                const size_t num_taken =
+                        std::min(group.v0.shape[0] - pos_in_group, remaining);
+
+                if (num_taken > 0) {
+                    Group part = group;
+                    part.v0.offsets[0] += pos_in_group;
+                    part.v0.shape[0] = num_taken;
+                    parts.push_back(std::move(part));
+                }
+
+                remaining -= num_taken;
+                pos_in_group += num_taken;
+                if (pos_in_group == group.v0.shape[0]) {
+                    group_idx++;
+                    pos_in_group = 0;
+                }
+            }
+
+            slices.push_back(MakeGroups<Groups>(std::move(parts)));
+        }
+
+        return slices;
+    }
+
+    template <class Groups, class Group>
+    static Groups MakeGroups(std::vector<Group> parts) {
+        const size_t num_parts = parts.size();
+        auto* const region = reinterpret_cast<Group*>(
+                malloc(sizeof(Group) * std::max<size_t>(1, num_parts)));
+        assert(region != nullptr);
+        for (size_t i = 0; i < num_parts; i++) {
+            new (region + i) Group(std::move(parts[i]));
+        }
+
+        Groups groups;
+        groups.data = runtime::memory::SharedPointer<Group>(
+                new runtime::memory::FreeRefCounter<Group>(region, num_parts));
+        groups.outer_shape[0] = num_parts;
+        groups.offsets[0] = 0;
+        groups.shape[0] = num_parts;
+        return groups;
+    }
+
+    Upstream* const upstream_;
+    std::vector<Tuple> work_units_;
+    typename std::vector<Tuple>::iterator output_it_;
+};
+
+template <class Tuple, class Upstream>
+SplitSkewedPartitionsOperator<Upstream, Tuple>
+makeSplitSkewedPartitionsOperator(Upstream* const upstream) {
+    return SplitSkewedPartitionsOperator<Upstream, Tuple>(upstream);
+}
+
+#endif  // CODE_GEN_OPERATORS_SPLITSKEWEDPARTITIONSOPERATOR_H
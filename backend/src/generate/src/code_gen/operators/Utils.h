@@ -2,6 +2,9 @@
 #define CPP_UTILS_H
 
 #include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include "runtime/jit/operators/optional.hpp"
 #include "runtime/jit/values/value.hpp"
@@ -26,17 +29,77 @@ auto constexpr max(T x, U y) ->
     return x > y ? x : y;
 }
 
-template <typename StdTuple, std::size_t... Indexes>
-static auto SplitTupleImpl(const StdTuple tuple,
-                           std::index_sequence<Indexes...> /*indexes*/) {
-    return std::make_pair(std::make_tuple(std::get<0>(tuple)),
-                          std::make_tuple(std::get<Indexes + 1>(tuple)...));
+// Splits the given tuple into its first kNumKeys fields and the remaining ones
+template <std::size_t kNumKeys, typename StdTuple, std::size_t... KeyIndexes,
+          std::size_t... ValueIndexes>
+static auto SplitTupleAtImpl(
+        const StdTuple tuple, std::index_sequence<KeyIndexes...> /*keys*/,
+        std::index_sequence<ValueIndexes...> /*values*/) {
+    return std::make_pair(
+            std::make_tuple(std::get<KeyIndexes>(tuple)...),
+            std::make_tuple(std::get<ValueIndexes + kNumKeys>(tuple)...));
+}
+
+template <std::size_t kNumKeys, typename... Types>
+static auto SplitTupleAt(const std::tuple<Types...> tuple) {
+    static_assert(kNumKeys <= sizeof...(Types), "Key is larger than tuple.");
+    return SplitTupleAtImpl<kNumKeys>(
+            tuple, std::make_index_sequence<kNumKeys>(),
+            std::make_index_sequence<sizeof...(Types) - kNumKeys>());
 }
 
 template <typename... Types>
 static auto SplitTuple(const std::tuple<Types...> tuple) {
-    return SplitTupleImpl(tuple,
-                          std::make_index_sequence<sizeof...(Types) - 1u>());
+    return SplitTupleAt<1>(tuple);
+}
+
+/*
+ * Push-based (produce/consume) execution
+ *
+ * Besides open()/next()/close(), operators can implement
+ *
+ *     template <class Consumer>
+ *     void ForEach(Consumer &&consume);
+ *
+ * which calls consume(tuple) for all remaining tuples of the open operator.
+ * Operators that stream their input implement it by calling ForEachTuple on
+ * their upstream with a consumer that processes one tuple and passes the
+ * result on. After inlining, a pipeline from its source up to the operator
+ * that drives it thus becomes a single loop without an Optional per tuple
+ * and operator. Pipelines with an operator without ForEach are pulled with
+ * next() from that operator on.
+ */
+namespace detail {
+
+struct AnyConsumer {
+    template <class Tuple>
+    void operator()(const Tuple & /*tuple*/) const {}
+};
+
+template <class Operator, class = void>
+struct HasForEach : std::false_type {};
+
+template <class Operator>
+using ForEachResult =
+        decltype(std::declval<Operator &>().ForEach(AnyConsumer()));
+
+template <class Operator>
+struct HasForEach<Operator, std::void_t<ForEachResult<Operator>>>
+    : std::true_type {};
+
+}  // namespace detail
+
+// Calls consume(tuple) for all remaining tuples of the given open operator,
+// pushing them with its ForEach if it has one and pulling them otherwise
+template <class Operator, class Consumer>
+INLINE void ForEachTuple(Operator *const op, Consumer &&consume) {
+    if constexpr (detail::HasForEach<Operator>::value) {
+        op->ForEach(consume);
+    } else {
+        while (auto const ret = op->next()) {
+            consume(ret.value());
+        }
+    }
 }
 
 #endif  // CPP_UTILS_H
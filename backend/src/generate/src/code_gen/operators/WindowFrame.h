@@ -0,0 +1,78 @@
+#ifndef CODE_GEN_OPERATORS_WINDOWFRAME_H
+#define CODE_GEN_OPERATORS_WINDOWFRAME_H
+
+#include <cstddef>
+
+#include <vector>
+
+#include "Utils.h"
+
+/**
+ * Aggregate of the values in a window frame, i.e., of the last kFrameSize
+ * values added to it, or of all of them if kFrameSize is zero.
+ *
+ * The binary function must be associative but not necessarily commutative or
+ * invertible; it always combines the values in the order they were added.
+ *
+ * Sliding frames use the two-stacks algorithm: new values are pushed onto the
+ * back stack, whose aggregate is updated with each of them, and the oldest
+ * value is popped from the front stack, each entry of which holds the
+ * aggregate of itself and all entries below it. When the front stack runs
+ * empty, the back stack is flipped onto it. Each value is thus combined at
+ * most three times, so the cost per value does not depend on the frame size.
+ */
+template <class ValueType, size_t kFrameSize>
+class WindowFrame {
+public:
+    // Adds the given value and returns the aggregate of the frame ending with
+    // it
+    template <class Function>
+    INLINE auto Add(const Function &func, const ValueType &value)
+            -> ValueType {
+        if constexpr (kFrameSize == 0) {
+            aggregate_ = is_empty_ ? value : func(aggregate_, value);
+            is_empty_ = false;
+            return aggregate_;
+        } else {
+            if (front_.size() + back_.size() == kFrameSize) {
+                if (front_.empty()) Flip(func);
+                front_.pop_back();
+            }
+
+            back_aggregate_ =
+                    back_.empty() ? value : func(back_aggregate_, value);
+            back_.push_back(value);
+
+            if (front_.empty()) return back_aggregate_;
+            return func(front_.back(), back_aggregate_);
+        }
+    }
+
+    void Clear() {
+        is_empty_ = true;
+        front_.clear();
+        back_.clear();
+    }
+
+private:
+    // Moves the values of the back stack onto the front stack, such that the
+    // oldest value ends up on top
+    template <class Function>
+    void Flip(const Function &func) {
+        for (auto it = back_.rbegin(); it != back_.rend(); it++) {
+            front_.push_back(front_.empty() ? *it : func(*it, front_.back()));
+        }
+        back_.clear();
+    }
+
+    // Running frames
+    bool is_empty_ = true;
+    ValueType aggregate_{};
+
+    // Sliding frames
+    std::vector<ValueType> front_;
+    std::vector<ValueType> back_;
+    ValueType back_aggregate_{};
+};
+
+#endif  // CODE_GEN_OPERATORS_WINDOWFRAME_H
@@ -0,0 +1,94 @@
+#ifndef CODE_GEN_OPERATORS_WINDOWGROUPEDOPERATOR_H
+#define CODE_GEN_OPERATORS_WINDOWGROUPEDOPERATOR_H
+
+#include <tuple>
+#include <utility>
+
+#include "Utils.h"
+#include "WindowFrame.h"
+#include "runtime/jit/operators/optional.hpp"
+
+/**
+ * Appends to each input tuple the aggregate of the values in its window
+ * frame, i.e., of the fields after the first kNumKeys ones of the last
+ * kFrameSize tuples of its partition up to and including itself (or of all
+ * previous tuples of the partition if kFrameSize is zero)
+ *
+ * Binary function must be associative
+ * The return type of the function must be the same as its arguments
+ *
+ * This implementation assumes that the key columns are grouped, such that it
+ * only needs to keep the frame of the current partition, and works in linear
+ * time. Without key columns, the whole input forms one partition.
+ *
+ * Keeps the order of the input
+ */
+template <class Upstream, class Tuple, class ValueType, size_t kNumKeys,
+          size_t kFrameSize, class Function>
+class WindowGroupedOperator {
+public:
+    WindowGroupedOperator(Upstream *const upstream, const Function &func)
+        : upstream_(upstream), func_(func) {}
+
+    void INLINE open() {
+        upstream_->open();
+        has_key_ = false;
+        frame_.Clear();
+    }
+
+    Optional<Tuple> INLINE next() {
+        if (auto const input = upstream_->next()) {
+            return Process(input.value());
+        }
+        return {};
+    }
+
+    template <class Consumer>
+    INLINE void ForEach(Consumer &&consume) {
+        ForEachTuple(upstream_, [&](const InputTuple &input) {
+            consume(Process(input));
+        });
+    }
+
+    void INLINE close() { upstream_->close(); }
+
+private:
+    using InputTuple = decltype(std::declval<Upstream>().next().value());
+    using StdKeyTuple = decltype(
+            SplitTupleAt<kNumKeys>(TupleToStdTuple(std::declval<InputTuple>()))
+                    .first);
+
+    INLINE auto Process(const InputTuple &input) -> Tuple {
+        auto const tuple = TupleToStdTuple(input);
+        auto const [key_tuple, value_tuple] = SplitTupleAt<kNumKeys>(tuple);
+
+        if (!has_key_ || !(key_tuple == key_)) {
+            has_key_ = true;
+            key_ = key_tuple;
+            frame_.Clear();
+        }
+
+        const ValueType value = StdTupleToTuple(value_tuple);
+        auto const aggregate = frame_.Add(func_, value);
+        return StdTupleToTuple(
+                std::tuple_cat(tuple, TupleToStdTuple(aggregate)));
+    }
+
+    Upstream *const upstream_;
+    Function func_;
+    bool has_key_ = false;
+    StdKeyTuple key_{};
+    WindowFrame<ValueType, kFrameSize> frame_;
+};
+
+template <class Tuple, class ValueType, size_t kNumKeys, size_t kFrameSize,
+          class Upstream, class Function>
+WindowGroupedOperator<Upstream, Tuple, ValueType, kNumKeys, kFrameSize,
+                      Function>
+        INLINE makeWindowGroupedOperator(Upstream *const upstream,
+                                         Function func) {
+    return WindowGroupedOperator<Upstream, Tuple, ValueType, kNumKeys,
+                                 kFrameSize, Function>(upstream, func);
+};
+
+#endif  // CODE_GEN_OPERATORS_WINDOWGROUPEDOPERATOR_H
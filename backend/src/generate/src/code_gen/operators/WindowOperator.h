@@ -0,0 +1,94 @@
+#ifndef CODE_GEN_OPERATORS_WINDOWOPERATOR_H
+#define CODE_GEN_OPERATORS_WINDOWOPERATOR_H
+
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include "CompositeKey.h"
+#include "Utils.h"
+#include "WindowFrame.h"
+#include "runtime/jit/memory/memory_tracker.hpp"
+#include "runtime/jit/operators/optional.hpp"
+
+/**
+ * Appends to each input tuple the aggregate of the values in its window
+ * frame, i.e., of the fields after the first kNumKeys ones of the last
+ * kFrameSize tuples with the same key up to and including itself (or of all
+ * previous tuples with the same key if kFrameSize is zero)
+ *
+ * Binary function must be associative
+ * The return type of the function must be the same as its arguments
+ *
+ * This implementation keeps the frames of all keys in a hash table, so it
+ * does not make any assumptions about the order of the input. The frame of a
+ * key follows the order in which its tuples arrive.
+ *
+ * Keeps the order of the input
+ */
+template <class Upstream, class Tuple, class KeyType, class ValueType,
+          size_t kNumKeys, size_t kFrameSize, class Function>
+class WindowOperator {
+    static_assert(kNumKeys > 0, "Use WindowGroupedOperator without keys.");
+
+public:
+    WindowOperator(Upstream *const upstream, const Function &func)
+        : upstream_(upstream), func_(func) {}
+
+    void INLINE open() {
+        upstream_->open();
+        frames_.clear();
+    }
+
+    Optional<Tuple> INLINE next() {
+        if (auto const input = upstream_->next()) {
+            return Process(input.value());
+        }
+        return {};
+    }
+
+    template <class Consumer>
+    INLINE void ForEach(Consumer &&consume) {
+        ForEachTuple(upstream_, [&](const InputTuple &input) {
+            consume(Process(input));
+        });
+    }
+
+    void INLINE close() { upstream_->close(); }
+
+private:
+    using InputTuple = decltype(std::declval<Upstream>().next().value());
+    using KeyTypeHash = CompositeKeyHash<KeyType>;
+    using KeyTypeEquals = CompositeKeyEquals<KeyType>;
+
+    INLINE auto Process(const InputTuple &input) -> Tuple {
+        auto const tuple = TupleToStdTuple(input);
+        auto const [key_tuple, value_tuple] = SplitTupleAt<kNumKeys>(tuple);
+        const KeyType key = StdTupleToTuple(key_tuple);
+        const ValueType value = StdTupleToTuple(value_tuple);
+
+        auto const aggregate = frames_[key].Add(func_, value);
+        return StdTupleToTuple(
+                std::tuple_cat(tuple, TupleToStdTuple(aggregate)));
+    }
+
+    Upstream *const upstream_;
+    Function func_;
+    using Frame = WindowFrame<ValueType, kFrameSize>;
+
+    std::unordered_map<KeyType, Frame, KeyTypeHash, KeyTypeEquals,
+                       runtime::memory::TrackingAllocator<
+                               std::pair<const KeyType, Frame>>>
+            frames_;
+};
+
+template <class Tuple, class KeyType, class ValueType, size_t kNumKeys,
+          size_t kFrameSize, class Upstream, class Function>
+WindowOperator<Upstream, Tuple, KeyType, ValueType, kNumKeys, kFrameSize,
+               Function>
+        INLINE makeWindowOperator(Upstream *const upstream, Function func) {
+    return WindowOperator<Upstream, Tuple, KeyType, ValueType, kNumKeys,
+                          kFrameSize, Function>(upstream, func);
+};
+
+#endif  // CODE_GEN_OPERATORS_WINDOWOPERATOR_H
@@ -269,11 +269,17 @@ void Function::AddInlineAttribute() {
     auto *const function = module_->getFunction(kEntryFunctionName);
     assert(function != nullptr);
     function->addFnAttr(llvm::Attribute::AlwaysInline);
+
+    if (auto *const next_function =
+                module_->getFunction(kGeneratorNextFunctionName)) {
+        next_function->addFnAttr(llvm::Attribute::AlwaysInline);
+    }
 }
 
 void Function::AdjustLinkage() {
     for (auto &function : *module_) {
         if (function.getName() == kEntryFunctionName) continue;
+        if (function.getName() == kGeneratorNextFunctionName) continue;
         // function declarations must be external or extern_weak
         // https://llvm.org/docs/LangRef.html#linkage-types
         if (function.isDeclaration()) continue;
@@ -24,6 +24,14 @@ public:
         }
     }
 
+    void operator()(DAGBloomFilter *const op) const {
+        auto &input_fields = dag_->predecessor(op, 0)->tuple->fields;
+        for (size_t i = 0; i < op->tuple->fields.size(); i++) {
+            input_fields[i]->attribute_id()->AddField(
+                    op->tuple->fields[i].get());
+        }
+    }
+
     void operator()(DAGCartesian *const op) const {
         auto &left_input_fields = dag_->predecessor(op, 0)->tuple->fields;
         auto &right_input_fields = dag_->predecessor(op, 1)->tuple->fields;
@@ -39,28 +47,9 @@ public:
         }
     }
 
-    void operator()(DAGJoin *const op) const {
-        auto *left = dag_->predecessor(op, 0);
-        auto *right = dag_->predecessor(op, 1);
-
-        // remap left input's key attribute_id to right input's one
-        left->tuple->fields[0]->attribute_id()->MoveFields(
-                right->tuple->fields[0]->attribute_id());
-
-        auto &left_input_fields = dag_->predecessor(op, 0)->tuple->fields;
-        auto &right_input_fields = dag_->predecessor(op, 1)->tuple->fields;
-
-        for (size_t i = 0; i < left_input_fields.size(); i++) {
-            left_input_fields[i]->attribute_id()->AddField(
-                    op->tuple->fields[i].get());
-        }
+    void operator()(DAGDistinct *const op) const { HandlePassThrough(op); }
 
-        for (size_t i = op->num_keys; i < right_input_fields.size(); i++) {
-            auto &field = op->tuple->fields[i + left_input_fields.size() -
-                                            op->num_keys];
-            right_input_fields[i]->attribute_id()->AddField(field.get());
-        }
-    }
+    void operator()(DAGJoin *const op) const { HandleJoin(op); }
 
     void operator()(DAGMap *const op) const {
         llvm_helpers::Function parser(op->llvm_ir);
@@ -75,19 +64,72 @@ public:
         }
     }
 
+    void operator()(DAGMergeJoin *const op) const { HandleJoin(op); }
+
     void operator()(DAGReduceByKey *const op) const {
         auto &input_fields = dag_->predecessor(op)->tuple->fields;
-        input_fields[0]->attribute_id()->AddField(op->tuple->fields[0].get());
+        for (size_t i = 0; i < op->num_keys; i++) {
+            input_fields[i]->attribute_id()->AddField(
+                    op->tuple->fields[i].get());
+        }
     }
 
     void operator()(DAGReduceByKeyGrouped *const op) const {
         auto &input_fields = dag_->predecessor(op)->tuple->fields;
-        input_fields[0]->attribute_id()->AddField(op->tuple->fields[0].get());
+        for (size_t i = 0; i < op->num_keys; i++) {
+            input_fields[i]->attribute_id()->AddField(
+                    op->tuple->fields[i].get());
+        }
+    }
+
+    void operator()(DAGSortedDistinct *const op) const {
+        HandlePassThrough(op);
+    }
+
+    void operator()(DAGWindow *const op) const { HandlePassThrough(op); }
+
+    void operator()(DAGWindowGrouped *const op) const {
+        HandlePassThrough(op);
     }
 
     void operator()(DAGOperator *const /*op*/) const {}
 
 private:
+    // The first output fields are copies of the corresponding input fields
+    void HandlePassThrough(DAGOperator *const op) const {
+        auto &input_fields = dag_->predecessor(op)->tuple->fields;
+        for (size_t i = 0; i < input_fields.size(); i++) {
+            input_fields[i]->attribute_id()->AddField(
+                    op->tuple->fields[i].get());
+        }
+    }
+
+    template <class JoinType>
+    void HandleJoin(JoinType *const op) const {
+        auto *left = dag_->predecessor(op, 0);
+        auto *right = dag_->predecessor(op, 1);
+
+        // remap left input's key attribute_ids to right input's ones
+        for (int i = 0; i < op->num_keys; i++) {
+            left->tuple->fields[i]->attribute_id()->MoveFields(
+                    right->tuple->fields[i]->attribute_id());
+        }
+
+        auto &left_input_fields = dag_->predecessor(op, 0)->tuple->fields;
+        auto &right_input_fields = dag_->predecessor(op, 1)->tuple->fields;
+
+        for (size_t i = 0; i < left_input_fields.size(); i++) {
+            left_input_fields[i]->attribute_id()->AddField(
+                    op->tuple->fields[i].get());
+        }
+
+        for (size_t i = op->num_keys; i < right_input_fields.size(); i++) {
+            auto &field = op->tuple->fields[i + left_input_fields.size() -
+                                            op->num_keys];
+            right_input_fields[i]->attribute_id()->AddField(field.get());
+        }
+    }
+
     const DAG *const dag_;
 };
 
@@ -107,8 +149,42 @@ public:
         }
     }
 
+    void operator()(DAGApproxCountDistinct *const op) const {
+        for (auto const &field : dag_->predecessor(op)->tuple->fields) {
+            op->read_set.insert(field->attribute_id());
+        }
+    }
+
+    void operator()(DAGBloomFilter *const op) const {
+        for (const auto pos : op->key_positions) {
+            op->read_set.insert(op->tuple->fields[pos]->attribute_id());
+        }
+    }
+
+    void operator()(DAGDistinct *const op) const {
+        for (auto const &field : op->tuple->fields) {
+            op->read_set.insert(field->attribute_id());
+        }
+    }
+
     void operator()(DAGJoin *const op) const {
-        op->read_set.insert(op->tuple->fields[0]->attribute_id());
+        for (int i = 0; i < op->num_keys; i++) {
+            op->read_set.insert(op->tuple->fields[i]->attribute_id());
+        }
+    }
+
+    void operator()(DAGMergeJoin *const op) const {
+        for (int i = 0; i < op->num_keys; i++) {
+            op->read_set.insert(op->tuple->fields[i]->attribute_id());
+        }
+    }
+
+    void operator()(DAGFlatMap *const op) const {
+        // The generator stores its arguments in its state, so they cannot be
+        // tracked through the IR
+        for (auto const &field : dag_->predecessor(op)->tuple->fields) {
+            op->read_set.insert(field->attribute_id());
+        }
     }
 
     void operator()(DAGMap *const op) const {
@@ -139,6 +215,24 @@ public:
         }
     }
 
+    void operator()(DAGSortedDistinct *const op) const {
+        for (auto const &field : op->tuple->fields) {
+            op->read_set.insert(field->attribute_id());
+        }
+    }
+
+    void operator()(DAGWindow *const op) const {
+        for (auto const &field : dag_->predecessor(op)->tuple->fields) {
+            op->read_set.insert(field->attribute_id());
+        }
+    }
+
+    void operator()(DAGWindowGrouped *const op) const {
+        for (auto const &field : dag_->predecessor(op)->tuple->fields) {
+            op->read_set.insert(field->attribute_id());
+        }
+    }
+
     void operator()(DAGOperator *const /*op*/) const {}
 
 private:
@@ -0,0 +1,146 @@
+#include "bloom_filter_join.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include <boost/mpl/list.hpp>
+#include <polymorphic_value.h>
+
+#include "dag/dag.hpp"
+#include "dag/operators/all_operator_definitions.hpp"
+#include "dag/utils/type_traits.hpp"
+#include "utils/visitor.hpp"
+
+using dag::utils::IsInstanceOf;
+
+struct FilteredJoin {
+    DAGOperator *op;
+    int build_port;
+    int probe_port;
+    size_t num_keys;
+};
+
+struct CollectJoinsVisitor
+    : public Visitor<CollectJoinsVisitor, DAGOperator,
+                     boost::mpl::list<DAGJoin, DAGSemiJoin>> {
+    // Join builds on the left and probes with the right input
+    void operator()(DAGJoin *op) {
+        if (!op->broadcast.empty()) return;
+        joins_.push_back({op, 0, 1, static_cast<size_t>(op->num_keys)});
+    }
+
+    // SemiJoin builds on the right and probes with the left input
+    void operator()(DAGSemiJoin *op) {
+        joins_.push_back({op, 1, 0, op->num_keys});
+    }
+
+    std::vector<FilteredJoin> joins_;
+};
+
+namespace {
+
+// Returns whether filtering the input of op by the given key attributes
+// filters its output in the same way. This holds for operators that only drop
+// or combine tuples without aggregating over them as well as for ReduceByKey
+// if the key attributes are among its keys. Everything else, e.g., Window or
+// Reduce, computes its output from tuples with other keys.
+auto CommutesWithKeyFilter(
+        const DAGOperator *const op,
+        const std::vector<const dag::AttributeId *> &key_attributes) -> bool {
+    if (IsInstanceOf<DAGFilter, DAGMap, DAGProjection, DAGJoin, DAGCartesian,
+                     DAGDistinct>(op)) {
+        return true;
+    }
+
+    if (const auto *const reduce_op = dynamic_cast<const DAGReduceByKey *>(op)) {
+        auto const &fields = reduce_op->tuple->fields;
+        const auto keys_end = fields.begin() + reduce_op->num_keys;
+        return std::all_of(
+                key_attributes.begin(), key_attributes.end(), [&](auto a) {
+                    return std::any_of(
+                            fields.begin(), keys_end, [&](auto const &f) {
+                                return *(f->attribute_id()) == *a;
+                            });
+                });
+    }
+
+    return false;
+}
+
+}  // namespace
+
+namespace optimize {
+
+void BloomFilterJoin::Run(DAG *const dag,
+                          const std::string & /*config*/) const {
+    CollectJoinsVisitor visitor;
+    for (auto *const op : dag->operators()) {
+        visitor.Visit(op);
+    }
+
+    for (auto const &join : visitor.joins_) {
+        const auto build_flow = dag->in_flow(join.op, join.build_port);
+        auto *const probe_op = dag->predecessor(join.op, join.probe_port);
+
+        std::vector<const dag::AttributeId *> key_attributes;
+        for (size_t i = 0; i < join.num_keys; i++) {
+            key_attributes.push_back(
+                    probe_op->tuple->fields[i]->attribute_id().get());
+        }
+
+        auto const has_keys = [&](const DAGOperator *const op) {
+            return std::all_of(key_attributes.begin(), key_attributes.end(),
+                               [&](auto a) { return op->HasInOutput(a); });
+        };
+
+        // Go as far down the probe side as the key can go. We only move the
+        // filter below operators that commute with it and follow inputs that
+        // are not consumed by anyone else (which would otherwise see
+        // filtered input) and that provide the key as the only input
+        if (dag->out_degree(probe_op) != 1) continue;
+        DAGOperator *tip = probe_op;
+        while (CommutesWithKeyFilter(tip, key_attributes)) {
+            DAGOperator *next_tip = nullptr;
+            size_t num_candidates = 0;
+            for (auto const flow : dag->in_flows(tip)) {
+                if (has_keys(flow.source.op)) {
+                    next_tip = flow.source.op;
+                    num_candidates++;
+                }
+            }
+            if (num_candidates != 1 || dag->out_degree(next_tip) != 1) break;
+            tip = next_tip;
+        }
+
+        // Filtering right before the join does not save anything
+        if (tip == probe_op) continue;
+
+        // Insert filter after the tip
+        auto *const filter_op = new DAGBloomFilter();
+        filter_op->num_keys = join.num_keys;
+        for (auto const *const attribute : key_attributes) {
+            auto const &fields = tip->tuple->fields;
+            auto const it = std::find_if(
+                    fields.begin(), fields.end(), [&](auto const &f) {
+                        return *(f->attribute_id()) == *attribute;
+                    });
+            assert(it != fields.end());
+            filter_op->key_positions.push_back(it - fields.begin());
+        }
+        filter_op->tuple =
+                isocpp_p0201::make_polymorphic_value<dag::collection::Tuple>(
+                        *tip->tuple);
+        dag->AddOperator(filter_op);
+
+        const auto out_flow = dag->out_flow(tip);
+        dag->RemoveFlow(out_flow);
+
+        dag->AddFlow(tip, 0, filter_op, 0);
+        dag->AddFlow(build_flow.source.op, build_flow.source.port, filter_op,
+                     1);
+        dag->AddFlow(filter_op, 0, out_flow.target.op, out_flow.target.port);
+    }
+}
+
+}  // namespace optimize
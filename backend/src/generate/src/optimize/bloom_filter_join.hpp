@@ -0,0 +1,20 @@
+#ifndef OPTIMIZE_BLOOM_FILTER_JOIN_HPP
+#define OPTIMIZE_BLOOM_FILTER_JOIN_HPP
+
+#include "dag_transformation.hpp"
+
+namespace optimize {
+
+// Filters the probe side of joins by a Bloom filter of the build side as early
+// as possible, i.e., below the operators that preserve the join key
+class BloomFilterJoin : public DagTransformation {
+public:
+    void Run(DAG *dag, const std::string &config) const override;
+    [[nodiscard]] auto name() const -> std::string override {
+        return "bloom_filter_join";
+    }
+};
+
+}  // namespace optimize
+
+#endif  // OPTIMIZE_BLOOM_FILTER_JOIN_HPP
@@ -7,15 +7,19 @@
 #include "add_always_inline.hpp"
 #include "assert_correct_open_next_close.hpp"
 #include "attribute_id_tracking.hpp"
+#include "bloom_filter_join.hpp"
 #include "canonicalize.hpp"
 #include "code_gen.hpp"
 #include "compile_inner_plans.hpp"
 #include "create_pipelines.hpp"
+#include "dense_reduce_by_key.hpp"
 #include "determine_sortedness.hpp"
 #include "exchange_s3.hpp"
 #include "exchange_tcp.hpp"
 #include "grouped_reduce_by_key.hpp"
+#include "grouped_window.hpp"
 #include "materialize_multiple_reads.hpp"
+#include "merge_join.hpp"
 #include "parallelize.hpp"
 #include "parallelize_concurrent.hpp"
 #include "parallelize_concurrent_single_inout.hpp"
@@ -23,6 +27,7 @@
 #include "parallelize_omp.hpp"
 #include "parallelize_process.hpp"
 #include "simple_predicate_move_around.hpp"
+#include "sorted_distinct.hpp"
 #include "two_level_exchange.hpp"
 #include "type_inference.hpp"
 #include "verify.hpp"
@@ -40,15 +45,19 @@ void LoadDagTransformations() {
 
     RegisterDefault(std::make_unique<AssertCorrectOpenNextClose>());
     RegisterDefault(std::make_unique<AttributeIdTracking>());
+    RegisterDefault(std::make_unique<BloomFilterJoin>());
     RegisterDefault(std::make_unique<Canonicalize>());
     RegisterDefault(std::make_unique<CodeGen>());
     RegisterDefault(std::make_unique<CompileInnerPlans>());
     RegisterDefault(std::make_unique<CreatePipelines>());
+    RegisterDefault(std::make_unique<DenseReduceByKey>());
     RegisterDefault(std::make_unique<DetermineSortedness>());
     RegisterDefault(std::make_unique<ExchangeS3>());
     RegisterDefault(std::make_unique<ExchangeTcp>());
     RegisterDefault(std::make_unique<GroupedReduceByKey>());
+    RegisterDefault(std::make_unique<GroupedWindow>());
     RegisterDefault(std::make_unique<MaterializeMultipleReads>());
+    RegisterDefault(std::make_unique<MergeJoin>());
     RegisterDefault(std::make_unique<Parallelize>());
     RegisterDefault(std::make_unique<ParallelizeConcurrent>());
     RegisterDefault(std::make_unique<ParallelizeConcurrentSingleInout>());
@@ -56,6 +65,7 @@ void LoadDagTransformations() {
     RegisterDefault(std::make_unique<ParallelizeOmp>());
     RegisterDefault(std::make_unique<ParallelizeProcess>());
     RegisterDefault(std::make_unique<SimplePredicateMoveAround>());
+    RegisterDefault(std::make_unique<SortedDistinct>());
     RegisterDefault(std::make_unique<TwoLevelExchange>());
     RegisterDefault(std::make_unique<TypeInference>());
     RegisterDefault(std::make_unique<Verify>());
@@ -0,0 +1,103 @@
+#include "dense_reduce_by_key.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <boost/mpl/list.hpp>
+#include <nlohmann/json.hpp>
+#include <polymorphic_value.h>
+
+#include "dag/dag.hpp"
+#include "dag/operators/all_operator_definitions.hpp"
+#include "dag/type/atomic.hpp"
+#include "dag/type/tuple.hpp"
+#include "utils/visitor.hpp"
+
+namespace {
+
+// Range of the keys of the given operator if it is known to be small enough
+// for a dense array, i.e., has at most max_range distinct values
+auto ComputeDenseKeyRange(const DAGReduceByKey *const op,
+                          const uint64_t max_range)
+        -> std::optional<std::pair<int64_t, int64_t>> {
+    if (op->num_keys != 1) return {};
+
+    const auto *const key_type = dynamic_cast<const dag::type::Atomic *>(
+            op->tuple->type->field_types[0]);
+    if (key_type == nullptr) return {};
+
+    std::optional<std::pair<int64_t, int64_t>> range;
+    if (key_type->type == "bool") {
+        range.emplace(0, 1);
+    } else if ((key_type->type == "int" || key_type->type == "long") &&
+               op->key_range) {
+        range = op->key_range;
+    }
+
+    if (!range || range->first > range->second) return {};
+    // Subtract in unsigned arithmetic since wide ranges overflow int64_t;
+    // ranges that are too large stay with the hash-based operator
+    const uint64_t size = static_cast<uint64_t>(range->second) -
+                          static_cast<uint64_t>(range->first);
+    if (size >= max_range) return {};
+
+    return range;
+}
+
+}  // namespace
+
+struct CollectDenseReduceByKeyVisitor
+    : public Visitor<CollectDenseReduceByKeyVisitor, DAGOperator,
+                     boost::mpl::list<DAGReduceByKey>> {
+    explicit CollectDenseReduceByKeyVisitor(const uint64_t max_range)
+        : max_range_(max_range) {}
+    void operator()(DAGReduceByKey *op) {
+        if (const auto range = ComputeDenseKeyRange(op, max_range_)) {
+            reduce_by_keys_.emplace_back(op, range.value());
+        }
+    }
+    std::vector<std::pair<DAGReduceByKey *, std::pair<int64_t, int64_t>>>
+            reduce_by_keys_;
+    const uint64_t max_range_;
+};
+
+namespace optimize {
+
+void DenseReduceByKey::Run(DAG *const dag, const std::string &config) const {
+    auto const jconfig = nlohmann::json::parse(config).flatten();
+    auto const max_range = jconfig.value("/max-range", uint64_t{1} << 20U);
+
+    CollectDenseReduceByKeyVisitor visitor(max_range);
+    for (auto *const op : dag->operators()) {
+        visitor.Visit(op);
+    }
+
+    for (auto const &[op, range] : visitor.reduce_by_keys_) {
+        std::unique_ptr<DAGReduceByIndex> new_op_ptr(new DAGReduceByIndex());
+        auto *const new_op = new_op_ptr.get();
+
+        new_op->tuple =
+                isocpp_p0201::make_polymorphic_value<dag::collection::Tuple>(
+                        *op->tuple);
+        new_op->llvm_ir = op->llvm_ir;
+        new_op->min = range.first;
+        new_op->max = range.second;
+
+        dag->AddOperator(new_op_ptr.release());
+
+        const auto out_flow = dag->out_flow(op);
+        const auto in_flow = dag->in_flow(op);
+
+        dag->RemoveFlow(out_flow);
+        dag->RemoveFlow(in_flow);
+
+        dag->AddFlow(new_op, 0, out_flow.target.op, out_flow.target.port);
+        dag->AddFlow(in_flow.source.op, in_flow.source.port, new_op, 0);
+
+        dag->RemoveOperator(op);
+    }
+}
+
+}  // namespace optimize
@@ -0,0 +1,18 @@
+#ifndef OPTIMIZE_DENSE_REDUCE_BY_KEY_HPP
+#define OPTIMIZE_DENSE_REDUCE_BY_KEY_HPP
+
+#include "dag_transformation.hpp"
+
+namespace optimize {
+
+class DenseReduceByKey : public DagTransformation {
+public:
+    void Run(DAG *dag, const std::string &config) const override;
+    [[nodiscard]] auto name() const -> std::string override {
+        return "dense_reduce_by_key";
+    }
+};
+
+}  // namespace optimize
+
+#endif  // OPTIMIZE_DENSE_REDUCE_BY_KEY_HPP
@@ -16,6 +16,13 @@ class DetermineSortednessVisitor
 public:
     explicit DetermineSortednessVisitor(const DAG *const dag) : dag_(dag) {}
 
+    void operator()(DAGBloomFilter *op) const {
+        auto const &input_fields = dag_->predecessor(op, 0)->tuple->fields;
+        for (size_t i = 0; i < op->tuple->fields.size(); i++) {
+            op->tuple->fields[i]->CopyProperties(*input_fields[i]);
+        }
+    }
+
     void operator()(DAGCartesian *op) const {
         const auto &left_fields = dag_->predecessor(op, 0)->tuple->fields;
         const auto &right_fields = dag_->predecessor(op, 1)->tuple->fields;
@@ -45,6 +52,13 @@ public:
         }
     }
 
+    void operator()(DAGDistinct *op) const {
+        // Only the combination of several fields is unique
+        if (op->tuple->fields.size() == 1) {
+            op->tuple->fields[0]->AddProperty(FL_UNIQUE);
+        }
+    }
+
     void operator()(DAGFilter *op) const {
         auto const &input_fields = dag_->predecessor(op)->tuple->fields;
         for (size_t i = 0; i < op->tuple->fields.size(); i++) {
@@ -52,37 +66,7 @@ public:
         }
     }
 
-    void operator()(DAGJoin *op) const {
-        const auto &left_fields = dag_->predecessor(op, 0)->tuple->fields;
-        const auto &right_fields = dag_->predecessor(op, 1)->tuple->fields;
-
-        const bool is_left_unique =
-                left_fields[0]->properties().count(FL_UNIQUE) > 0;
-        const bool is_right_unique =
-                right_fields[0]->properties().count(FL_UNIQUE) > 0;
-
-        if (is_left_unique && is_right_unique) {
-            for (size_t i = 0; i < left_fields.size(); i++) {
-                if (left_fields[i]->properties().count(FL_UNIQUE) > 0) {
-                    auto &field = op->tuple->fields[i];
-                    field->AddProperty(FL_UNIQUE);
-                }
-            }
-            for (size_t i = 1; i < right_fields.size(); i++) {
-                if (right_fields[i]->properties().count(FL_UNIQUE) > 0) {
-                    auto &field = op->tuple->fields[i + left_fields.size() - 1];
-                    field->AddProperty(FL_UNIQUE);
-                }
-            }
-        } else if (is_right_unique) {
-            for (size_t i = 1; i < right_fields.size(); i++) {
-                if (right_fields[i]->properties().count(FL_UNIQUE) > 0) {
-                    auto &field = op->tuple->fields[i + left_fields.size() - 1];
-                    field->AddProperty(FL_GROUPED);
-                }
-            }
-        }
-    }
+    void operator()(DAGJoin *op) const { HandleJoin(op); }
 
     void operator()(DAGMap *op) const {
         auto const &input_fields = dag_->predecessor(op)->tuple->fields;
@@ -99,6 +83,13 @@ public:
         }
     }
 
+    void operator()(DAGMergeJoin *op) const {
+        HandleJoin(op);
+
+        // Results are produced in the order of the keys
+        op->tuple->fields[0]->AddProperty(FL_SORTED);
+    }
+
     void operator()(DAGRange *op) const {
         for (const auto &field : op->tuple->fields) {
             field->AddProperty(FL_UNIQUE);
@@ -106,19 +97,94 @@ public:
         }
     }
 
-    void operator()(DAGReduceByKey *op) const {
+    void operator()(DAGReduceByIndex *op) const {
         op->tuple->fields[0]->AddProperty(FL_UNIQUE);
+        op->tuple->fields[0]->AddProperty(FL_SORTED);
+    }
+
+    void operator()(DAGReduceByKey *op) const {
+        // Only the combination of several key fields is unique
+        if (op->num_keys == 1) {
+            op->tuple->fields[0]->AddProperty(FL_UNIQUE);
+        }
     }
 
     void operator()(DAGReduceByKeyGrouped *op) const {
         auto const &input_fields = dag_->predecessor(op)->tuple->fields;
         op->tuple->fields[0]->CopyProperties(*input_fields[0]);
-        op->tuple->fields[0]->AddProperty(FL_UNIQUE);
+        if (op->num_keys == 1) {
+            op->tuple->fields[0]->AddProperty(FL_UNIQUE);
+        }
     }
 
+    void operator()(DAGSort *op) const {
+        auto const &input_fields = dag_->predecessor(op)->tuple->fields;
+        op->tuple->fields[0]->CopyProperties(*input_fields[0]);
+        op->tuple->fields[0]->AddProperty(FL_SORTED);
+    }
+
+    void operator()(DAGSortedDistinct *op) const {
+        // Removing tuples keeps the order of the remaining ones
+        auto const &input_fields = dag_->predecessor(op)->tuple->fields;
+        for (size_t i = 0; i < op->tuple->fields.size(); i++) {
+            op->tuple->fields[i]->CopyProperties(*input_fields[i]);
+        }
+        if (op->tuple->fields.size() == 1) {
+            op->tuple->fields[0]->AddProperty(FL_UNIQUE);
+        }
+    }
+
+    void operator()(DAGWindow *op) const { HandleWindow(op); }
+
+    void operator()(DAGWindowGrouped *op) const { HandleWindow(op); }
+
     void operator()(DAGOperator * /*op*/) const {}
 
 private:
+    // Appending the aggregates keeps the order of the input tuples
+    void HandleWindow(DAGOperator *op) const {
+        auto const &input_fields = dag_->predecessor(op)->tuple->fields;
+        for (size_t i = 0; i < input_fields.size(); i++) {
+            op->tuple->fields[i]->CopyProperties(*input_fields[i]);
+        }
+    }
+
+    template <class JoinType>
+    void HandleJoin(JoinType *op) const {
+        const auto &left_fields = dag_->predecessor(op, 0)->tuple->fields;
+        const auto &right_fields = dag_->predecessor(op, 1)->tuple->fields;
+        const size_t num_keys = op->num_keys;
+
+        const bool is_left_unique =
+                left_fields[0]->properties().count(FL_UNIQUE) > 0;
+        const bool is_right_unique =
+                right_fields[0]->properties().count(FL_UNIQUE) > 0;
+
+        if (is_left_unique && is_right_unique) {
+            for (size_t i = 0; i < left_fields.size(); i++) {
+                if (left_fields[i]->properties().count(FL_UNIQUE) > 0) {
+                    auto &field = op->tuple->fields[i];
+                    field->AddProperty(FL_UNIQUE);
+                }
+            }
+            for (size_t i = num_keys; i < right_fields.size(); i++) {
+                if (right_fields[i]->properties().count(FL_UNIQUE) > 0) {
+                    auto &field = op->tuple->fields[i + left_fields.size() -
+                                                    num_keys];
+                    field->AddProperty(FL_UNIQUE);
+                }
+            }
+        } else if (is_right_unique) {
+            for (size_t i = num_keys; i < right_fields.size(); i++) {
+                if (right_fields[i]->properties().count(FL_UNIQUE) > 0) {
+                    auto &field = op->tuple->fields[i + left_fields.size() -
+                                                    num_keys];
+                    field->AddProperty(FL_GROUPED);
+                }
+            }
+        }
+    }
+
     const DAG *const dag_;
 };
 
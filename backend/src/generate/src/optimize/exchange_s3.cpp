@@ -16,6 +16,7 @@
 #include "dag/type/atomic.hpp"
 #include "dag/type/tuple.hpp"
 #include "dag/utils/type_traits.hpp"
+#include "optimize/utils.hpp"
 
 using dag::utils::IsInstanceOf;
 
@@ -43,6 +44,8 @@ void ExchangeS3::Run(DAG *const dag, const std::string & /*config*/) const {
             new_op->level_num = 0;
         }
 
+        ReplaceBroadcastsWithExchanges(pop_inner_dag);
+
         // Replace each DAGPartitionedExchange with a sequence including a
         // DAGExchangeS3 operator
         std::vector<DAGPartitionedExchange *> partitioned_exchange_operators;
@@ -62,9 +65,8 @@ void ExchangeS3::Run(DAG *const dag, const std::string & /*config*/) const {
             auto *const partition_op = new DAGPartition();
             dag->AddOperator(partition_op);
 
-            static const std::array<size_t, 2> kSeeds = {0x7a9b42ad54aa7fec,
-                                                         0x2b3ed088aad124d1};
-            partition_op->seed = kSeeds.at(op->level_num);
+            partition_op->seed = ExchangeLevelSeed(op->level_num);
+            partition_op->broadcast = op->broadcast;
 
             // Create degree-of-parallelism operator
             auto *const part_dop_op = new DAGConstantTuple();
@@ -16,6 +16,7 @@
 #include "dag/type/atomic.hpp"
 #include "dag/type/tuple.hpp"
 #include "dag/utils/type_traits.hpp"
+#include "optimize/utils.hpp"
 
 using dag::utils::IsInstanceOf;
 
@@ -43,8 +44,10 @@ void ExchangeTcp::Run(DAG *const dag, const std::string & /*config*/) const {
             new_op->level_num = 0;
         }
 
+        ReplaceBroadcastsWithExchanges(pop_inner_dag);
+
         // Replace each DAGPartitionedExchange with a sequence including a
-        // DAGExchangeS3 operator
+        // DAGExchangeTcp operator
         std::vector<DAGPartitionedExchange *> partitioned_exchange_operators;
         for (auto *const op : pop_inner_dag->operators()) {
             if (IsInstanceOf<DAGPartitionedExchange>(op)) {
@@ -61,6 +64,12 @@ void ExchangeTcp::Run(DAG *const dag, const std::string & /*config*/) const {
             // Create new operators in outer DAG
             auto *const partition_op = new DAGPartition();
             dag->AddOperator(partition_op);
+            partition_op->broadcast = op->broadcast;
+
+            // Levels after the first need independent hash functions
+            if (op->level_num > 0) {
+                partition_op->seed = ExchangeLevelSeed(op->level_num);
+            }
 
             // Create degree-of-parallelism operator
             auto *const part_dop_op = new DAGConstantTuple();
@@ -12,6 +12,10 @@ struct CollectReduceByKeyVisitor
                      boost::mpl::list<DAGReduceByKey>> {
     explicit CollectReduceByKeyVisitor(const DAG *const dag) : dag_(dag) {}
     void operator()(DAGReduceByKey *op) {
+        // Grouping on the first field does not imply grouping on composite
+        // keys, and we do not track the latter
+        if (op->num_keys != 1) return;
+
         auto *const pred = dag_->predecessor(op);
         if (pred->tuple->fields[0]->properties().count(
                     dag::collection::FL_GROUPED) > 0) {
@@ -40,6 +44,7 @@ void GroupedReduceByKey::Run(DAG *const dag,
                 isocpp_p0201::make_polymorphic_value<dag::collection::Tuple>(
                         *op->tuple);
         new_op->llvm_ir = op->llvm_ir;
+        new_op->num_keys = op->num_keys;
 
         dag->AddOperator(new_op_ptr.release());
 
@@ -0,0 +1,65 @@
+#include "grouped_window.hpp"
+
+#include <boost/mpl/list.hpp>
+#include <polymorphic_value.h>
+
+#include "dag/dag.hpp"
+#include "dag/operators/all_operator_definitions.hpp"
+#include "utils/visitor.hpp"
+
+struct CollectWindowVisitor
+    : public Visitor<CollectWindowVisitor, DAGOperator,
+                     boost::mpl::list<DAGWindow>> {
+    explicit CollectWindowVisitor(const DAG *const dag) : dag_(dag) {}
+    void operator()(DAGWindow *op) {
+        // Grouping on the first field does not imply grouping on composite
+        // keys, and we do not track the latter. Without keys, the code
+        // generation uses the grouped variant anyways.
+        if (op->num_keys != 1) return;
+
+        auto const &properties =
+                dag_->predecessor(op)->tuple->fields[0]->properties();
+        if (properties.count(dag::collection::FL_SORTED) > 0 ||
+            properties.count(dag::collection::FL_GROUPED) > 0) {
+            windows_.emplace_back(op);
+        }
+    }
+    std::vector<DAGWindow *> windows_;
+    const DAG *const dag_;
+};
+
+namespace optimize {
+
+void GroupedWindow::Run(DAG *const dag, const std::string & /*config*/) const {
+    CollectWindowVisitor visitor(dag);
+    for (auto *const op : dag->operators()) {
+        visitor.Visit(op);
+    }
+
+    for (auto *const op : visitor.windows_) {
+        std::unique_ptr<DAGWindowGrouped> new_op_ptr(new DAGWindowGrouped());
+        auto *const new_op = new_op_ptr.get();
+
+        new_op->tuple =
+                isocpp_p0201::make_polymorphic_value<dag::collection::Tuple>(
+                        *op->tuple);
+        new_op->llvm_ir = op->llvm_ir;
+        new_op->num_keys = op->num_keys;
+        new_op->frame_size = op->frame_size;
+
+        dag->AddOperator(new_op_ptr.release());
+
+        const auto out_flow = dag->out_flow(op);
+        const auto in_flow = dag->in_flow(op);
+
+        dag->RemoveFlow(out_flow);
+        dag->RemoveFlow(in_flow);
+
+        dag->AddFlow(new_op, 0, out_flow.target.op, out_flow.target.port);
+        dag->AddFlow(in_flow.source.op, in_flow.source.port, new_op, 0);
+
+        dag->RemoveOperator(op);
+    }
+}
+
+}  // namespace optimize
@@ -0,0 +1,20 @@
+#ifndef OPTIMIZE_GROUPED_WINDOW_HPP
+#define OPTIMIZE_GROUPED_WINDOW_HPP
+
+#include "dag_transformation.hpp"
+
+namespace optimize {
+
+// Replaces Window operators whose input is sorted or grouped on the key with
+// WindowGrouped operators, which only keep the frame of the current key
+class GroupedWindow : public DagTransformation {
+public:
+    void Run(DAG *dag, const std::string &config) const override;
+    [[nodiscard]] auto name() const -> std::string override {
+        return "grouped_window";
+    }
+};
+
+}  // namespace optimize
+
+#endif  // OPTIMIZE_GROUPED_WINDOW_HPP
@@ -0,0 +1,73 @@
+#include "merge_join.hpp"
+
+#include <boost/mpl/list.hpp>
+#include <polymorphic_value.h>
+
+#include "dag/dag.hpp"
+#include "dag/operators/all_operator_definitions.hpp"
+#include "utils/visitor.hpp"
+
+struct CollectJoinVisitor
+    : public Visitor<CollectJoinVisitor, DAGOperator,
+                     boost::mpl::list<DAGJoin>> {
+    explicit CollectJoinVisitor(const DAG *const dag) : dag_(dag) {}
+    void operator()(DAGJoin *op) {
+        // Sortedness on the first field does not imply sortedness on
+        // composite keys, and we do not track the latter
+        if (op->num_keys != 1) return;
+
+        // Broadcast joins are meant to be partitioned later on
+        if (!op->broadcast.empty()) return;
+
+        auto const is_sorted = [&](const int port) {
+            auto *const pred = dag_->predecessor(op, port);
+            return pred->tuple->fields[0]->properties().count(
+                           dag::collection::FL_SORTED) > 0;
+        };
+
+        if (is_sorted(0) && is_sorted(1)) {
+            joins_.emplace_back(op);
+        }
+    }
+    std::vector<DAGJoin *> joins_;
+    const DAG *const dag_;
+};
+
+namespace optimize {
+
+void MergeJoin::Run(DAG *const dag, const std::string & /*config*/) const {
+    CollectJoinVisitor visitor(dag);
+    for (auto *const op : dag->operators()) {
+        visitor.Visit(op);
+    }
+
+    for (auto *const op : visitor.joins_) {
+        std::unique_ptr<DAGMergeJoin> new_op_ptr(new DAGMergeJoin());
+        auto *const new_op = new_op_ptr.get();
+
+        new_op->tuple =
+                isocpp_p0201::make_polymorphic_value<dag::collection::Tuple>(
+                        *op->tuple);
+        new_op->num_keys = op->num_keys;
+
+        dag->AddOperator(new_op_ptr.release());
+
+        const auto out_flow = dag->out_flow(op);
+        const auto left_in_flow = dag->in_flow(op, 0);
+        const auto right_in_flow = dag->in_flow(op, 1);
+
+        dag->RemoveFlow(out_flow);
+        dag->RemoveFlow(left_in_flow);
+        dag->RemoveFlow(right_in_flow);
+
+        dag->AddFlow(new_op, 0, out_flow.target.op, out_flow.target.port);
+        dag->AddFlow(left_in_flow.source.op, left_in_flow.source.port, new_op,
+                     0);
+        dag->AddFlow(right_in_flow.source.op, right_in_flow.source.port,
+                     new_op, 1);
+
+        dag->RemoveOperator(op);
+    }
+}
+
+}  // namespace optimize
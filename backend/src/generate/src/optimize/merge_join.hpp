@@ -0,0 +1,19 @@
+#ifndef OPTIMIZE_MERGE_JOIN_HPP
+#define OPTIMIZE_MERGE_JOIN_HPP
+
+#include "dag_transformation.hpp"
+
+namespace optimize {
+
+// Replaces joins whose inputs are both sorted on the key with merge joins
+class MergeJoin : public DagTransformation {
+public:
+    void Run(DAG *dag, const std::string &config) const override;
+    [[nodiscard]] auto name() const -> std::string override {
+        return "merge_join";
+    }
+};
+
+}  // namespace optimize
+
+#endif  // OPTIMIZE_MERGE_JOIN_HPP
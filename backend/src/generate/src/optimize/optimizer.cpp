@@ -33,6 +33,8 @@ void Optimizer::Run(DAG *const dag) {
 
     if (config.value("/optimization-level", 0) >= 2) {
         config.emplace("/optimizations/grouped-reduce-by-key/active", true);
+        config.emplace("/optimizations/grouped-window/active", true);
+        config.emplace("/optimizations/dense-reduce-by-key/active", true);
         config.emplace("/optimizations/simple-predicate-move-around/active",
                        true);
     }
@@ -76,8 +78,29 @@ void Optimizer::Run(DAG *const dag) {
     transformations.emplace_back("verify");
 #endif  // DEBUG
 
+    // Filter probe sides of joins by the keys of their build sides. This is
+    // only done in non-distributed plans, where the build side is complete.
+    // The build side is then consumed twice, so it needs to be materialized.
+    const bool use_bloom_filter_join =
+            config.value("/optimizations/bloom-filter-join/active", false) &&
+            config.value("/target", "singlecore") == "singlecore";
+    if (use_bloom_filter_join) {
+        transformations.emplace_back("attribute_id_tracking");
+#ifndef DEBUG
+        transformations.emplace_back("type_check");
+        transformations.emplace_back("verify");
+#endif  // DEBUG
+
+        transformations.emplace_back("bloom_filter_join");
+        transformations.emplace_back("type_inference");
+#ifndef DEBUG
+        transformations.emplace_back("verify");
+#endif  // DEBUG
+    }
+
     // Materialize results that are consumed multiple times
-    if (config.value("/optimizations/materialize-multiple-reads/active",
+    if (use_bloom_filter_join ||
+        config.value("/optimizations/materialize-multiple-reads/active",
                      false)) {
         transformations.emplace_back("materialize_multiple_reads");
         transformations.emplace_back("type_inference");
@@ -102,6 +125,15 @@ void Optimizer::Run(DAG *const dag) {
 #endif  // DEBUG
     }
 
+    // Replace ReduceByKey on small, dense key ranges with ReduceByIndex
+    if (config.value("/optimizations/dense-reduce-by-key/active", false)) {
+        transformations.emplace_back("dense_reduce_by_key");
+#ifndef DEBUG
+        transformations.emplace_back("type_check");
+        transformations.emplace_back("verify");
+#endif  // DEBUG
+    }
+
     // Run target-specific optimization passes
     auto const target = config.value("/target", "singlecore");
     if (target == "omp") {
@@ -201,8 +233,17 @@ void Optimizer::Run(DAG *const dag) {
         throw std::invalid_argument("Unknown target: '" + target + "'");
     }
 
-    // Replace GroupByKey with grouped variant
-    if (config.value("/optimizations/grouped-reduce-by-key/active", false)) {
+    // Replace operators with variants exploiting the sortedness of inputs
+    const bool use_grouped_reduce_by_key =
+            config.value("/optimizations/grouped-reduce-by-key/active", false);
+    const bool use_merge_join =
+            config.value("/optimizations/merge-join/active", false);
+    const bool use_sorted_distinct =
+            config.value("/optimizations/sorted-distinct/active", false);
+    const bool use_grouped_window =
+            config.value("/optimizations/grouped-window/active", false);
+    if (use_grouped_reduce_by_key || use_merge_join || use_sorted_distinct ||
+        use_grouped_window) {
         transformations.emplace_back("attribute_id_tracking");
 #ifndef DEBUG
         transformations.emplace_back("type_check");
@@ -214,7 +255,10 @@ void Optimizer::Run(DAG *const dag) {
         transformations.emplace_back("type_check");
         transformations.emplace_back("verify");
 #endif  // DEBUG
+    }
 
+    // Replace GroupByKey with grouped variant
+    if (use_grouped_reduce_by_key) {
         transformations.emplace_back("grouped_reduce_by_key");
 #ifndef DEBUG
         transformations.emplace_back("type_check");
@@ -222,6 +266,33 @@ void Optimizer::Run(DAG *const dag) {
 #endif  // DEBUG
     }
 
+    // Replace Join with merge join if both inputs are sorted on the key
+    if (use_merge_join) {
+        transformations.emplace_back("merge_join");
+#ifndef DEBUG
+        transformations.emplace_back("type_check");
+        transformations.emplace_back("verify");
+#endif  // DEBUG
+    }
+
+    // Replace Distinct with sort-based variant if input is sorted
+    if (use_sorted_distinct) {
+        transformations.emplace_back("sorted_distinct");
+#ifndef DEBUG
+        transformations.emplace_back("type_check");
+        transformations.emplace_back("verify");
+#endif  // DEBUG
+    }
+
+    // Replace Window with variant keeping only the frame of the current key
+    if (use_grouped_window) {
+        transformations.emplace_back("grouped_window");
+#ifndef DEBUG
+        transformations.emplace_back("type_check");
+        transformations.emplace_back("verify");
+#endif  // DEBUG
+    }
+
     // Add alwaysinline attribute to UDFs
     if (config.value("/optimizations/add-always-inline/active", false)) {
         transformations.emplace_back("add_always_inline");
@@ -3,6 +3,7 @@
 #include <queue>
 
 #include <boost/mpl/list.hpp>
+#include <nlohmann/json.hpp>
 #include <polymorphic_value.h>
 
 #include "dag/collection/tuple.hpp"
@@ -82,7 +83,128 @@ auto StartParallelMap(DAG *const dag, DAGOperator *const source_op)
     return pop;
 }
 
-void Parallelize::Run(DAG *const dag, const std::string & /*config*/) const {
+// Number of fields produced by the given operator. The operators created by
+// this pass do not have types yet, so their number is derived from the inputs.
+auto NumOutputFields(const DAG *const dag, const DAGOperator *const op)
+        -> size_t {
+    if (const auto *const proj_op = dynamic_cast<const DAGProjection *>(op)) {
+        return proj_op->positions.size();
+    }
+    if (IsInstanceOf<DAGSplitColumnData,  //
+                     DAGSplitRange,       //
+                     DAGSplitRowData,     //
+                     DAGSplitSkewedPartitions>(op)) {
+        return NumOutputFields(dag, dag->predecessor(op, 0));
+    }
+    if (IsInstanceOf<DAGCartesian>(op)) {
+        return NumOutputFields(dag, dag->predecessor(op, 0)) +
+               NumOutputFields(dag, dag->predecessor(op, 1));
+    }
+    if (IsInstanceOf<DAGGroupBy, DAGHashIndex>(op)) {
+        return 2;
+    }
+    return op->tuple->type->field_types.size();
+}
+
+// Ends the given parallel map with the given pre-aggregation operator and a
+// partitioning on the first num_keys fields. The aggregation operator after
+// the parallel map is moved into a new parallel map over the partitions,
+// which is returned.
+auto PartitionIntoNextParallelMap(DAG *const dag, DAGParallelMap *const op,
+                                  DAGOperator *const pre_aggregation_op,
+                                  const size_t num_keys,
+                                  const bool two_pass_partitioning)
+        -> DAGParallelMap * {
+    auto *const inner_dag = dag->inner_dag(op);
+    auto *const red_op = dag->successor(op);
+    auto *const next_op = dag->successor(red_op);
+
+    auto const inner_flow = dag->out_flow(op);
+    auto const out_flow = dag->out_flow(red_op);
+
+    // Bypass original aggregation in outer DAG
+    dag->RemoveFlow(inner_flow);
+    dag->RemoveFlow(out_flow);
+    dag->AddFlow(op, next_op, out_flow.target.port);
+
+    inner_dag->AddOperator(pre_aggregation_op);
+
+    // Partition by group key
+    auto *const part_op = new DAGPartition();
+    inner_dag->AddOperator(part_op);
+    part_op->two_pass = two_pass_partitioning;
+    part_op->num_keys = num_keys;
+
+    // Create degree-of-parallelism operator
+    auto *const dop_op = new DAGConstantTuple();
+    inner_dag->AddOperator(dop_op);
+    dop_op->values.emplace_back("$DOP");
+    dop_op->tuple =
+            isocpp_p0201::make_polymorphic_value<dag::collection::Tuple>(
+                    dag::type::Tuple::MakeTuple(
+                            {dag::type::Atomic::MakeAtomic("long")}));
+
+    // End this parallel operator
+    inner_dag->AddFlow(inner_dag->output().op, pre_aggregation_op);
+    inner_dag->AddFlow(pre_aggregation_op, part_op, 0);
+    inner_dag->AddFlow(dop_op, part_op, 1);
+    inner_dag->set_output(part_op);
+
+    // GroupBy operator after the first parallel map
+    auto *const ex_op = new DAGGroupBy();
+    dag->AddOperator(ex_op);
+
+    auto *const proj_op = new DAGProjection();
+    dag->AddOperator(proj_op);
+    proj_op->positions = {1};
+
+    // Next parallel map (for post aggregation)
+    auto *const next_pop = new DAGParallelMap();
+    dag->AddOperator(next_pop);
+    dag->set_inner_dag(next_pop, new DAG());
+    auto *const next_inner_dag = dag->inner_dag(next_pop);
+
+    // Reconnect outer level
+    auto const outer_out_flow = dag->out_flow(op);
+    dag->RemoveFlow(outer_out_flow);
+    dag->AddFlow(op, ex_op);
+    dag->AddFlow(ex_op, proj_op);
+    dag->AddFlow(proj_op, next_pop);
+    dag->AddFlow(next_pop, outer_out_flow.target.op,
+                 outer_out_flow.target.port);
+
+    // Start next parallel map
+    auto *const next_param_op = new DAGParameterLookup();
+    next_inner_dag->AddOperator(next_param_op);
+
+    // Scan operators for (1) partitioning and (2) groupby
+    auto *const scan_op1 = new DAGRowScan();
+    next_inner_dag->AddOperator(scan_op1);
+
+    auto *const scan_op2 = new DAGRowScan();
+    next_inner_dag->AddOperator(scan_op2);
+
+    // Original aggregation as post-aggregation operator
+    dag->MoveOperator(next_inner_dag, red_op);
+
+    // Connect new operators in next inner DAG
+    next_inner_dag->set_input(next_param_op);
+    next_inner_dag->AddFlow(next_param_op, scan_op1);
+    next_inner_dag->AddFlow(scan_op1, scan_op2);
+    next_inner_dag->AddFlow(scan_op2, red_op);
+    next_inner_dag->set_output(red_op);
+
+    return next_pop;
+}
+
+void Parallelize::Run(DAG *const dag, const std::string &config) const {
+    auto const jconfig = nlohmann::json::parse(config).flatten();
+    const bool two_pass_partitioning =
+            jconfig.value("/two-pass-partitioning", false);
+    const bool split_skewed_partitions =
+            jconfig.value("/split-skewed-partitions", false);
+    const bool shared_hash_join = jconfig.value("/shared-hash-join", false);
+
     // Collect all source operators
     CollectSourcesVisitor source_collector;
     dag::utils::ApplyInReverseTopologicalOrder(dag, source_collector.functor());
@@ -115,7 +237,9 @@ void Parallelize::Run(DAG *const dag, const std::string & /*config*/) const {
         do {
             if (dag->out_degree(op) != 1) break;
             if (IsInstanceOf<DAGFilter,       //
+                             DAGFlatMap,      //
                              DAGMap,          //
+                             DAGCsvScan,      //
                              DAGParquetScan,  //
                              DAGColumnScan>(dag->successor(op))) {
                 assert(dag->in_degree(op) == 1);
@@ -153,97 +277,69 @@ void Parallelize::Run(DAG *const dag, const std::string & /*config*/) const {
 
                 break;
             }
+            if (IsInstanceOf<DAGReduceByIndex>(dag->successor(op))) {
+                auto *const red_op =
+                        dynamic_cast<DAGReduceByIndex *>(dag->successor(op));
+
+                // Thread-local pre-reduction into a dense array; the original
+                // operator after the parallel map merges the partial arrays
+                auto *const pre_reduction_op = new DAGReduceByIndex();
+                inner_dag->AddOperator(pre_reduction_op);
+                pre_reduction_op->llvm_ir = red_op->llvm_ir;
+                pre_reduction_op->min = red_op->min;
+                pre_reduction_op->max = red_op->max;
+
+                inner_dag->AddFlow(inner_dag->output().op, pre_reduction_op);
+                inner_dag->set_output(pre_reduction_op);
+
+                break;
+            }
             if (IsInstanceOf<DAGReduceByKey>(dag->successor(op)) ||
                 IsInstanceOf<DAGReduceByKeyGrouped>(dag->successor(op))) {
                 auto *const red_op = dag->successor(op);
-                auto *const next_op = dag->successor(red_op);
-
-                auto const inner_flow = dag->out_flow(op);
-                auto const out_flow = dag->out_flow(red_op);
-
-                // Bypass original reduce in outer DAG
-                dag->RemoveFlow(inner_flow);
-                dag->RemoveFlow(out_flow);
-                dag->AddFlow(op, next_op, out_flow.target.port);
 
                 // Pre-reduce operator
                 DAGOperator *pre_reduction_op{};
+                size_t num_keys = 1;
                 if (IsInstanceOf<DAGReduceByKey>(red_op)) {
-                    auto const vpr =
-                            inner_dag->AddOperator(new DAGReduceByKey());
-                    pre_reduction_op = inner_dag->to_operator(vpr);
+                    auto *const red_by_key_op =
+                            dynamic_cast<DAGReduceByKey *>(red_op);
+                    auto *const new_op = new DAGReduceByKey();
+                    new_op->key_range = red_by_key_op->key_range;
+                    new_op->num_keys = num_keys = red_by_key_op->num_keys;
+                    pre_reduction_op = new_op;
                 } else {
                     assert(IsInstanceOf<DAGReduceByKeyGrouped>(red_op));
-                    auto const vpr =
-                            inner_dag->AddOperator(new DAGReduceByKeyGrouped());
-                    pre_reduction_op = inner_dag->to_operator(vpr);
+                    auto *const new_op = new DAGReduceByKeyGrouped();
+                    new_op->num_keys = num_keys =
+                            dynamic_cast<DAGReduceByKeyGrouped *>(red_op)
+                                    ->num_keys;
+                    pre_reduction_op = new_op;
                 }
                 pre_reduction_op->llvm_ir = red_op->llvm_ir;
 
-                // Partition by group key
-                auto *const part_op = new DAGPartition();
-                inner_dag->AddOperator(part_op);
-
-                // Create degree-of-parallelism operator
-                auto *const dop_op = new DAGConstantTuple();
-                inner_dag->AddOperator(dop_op);
-                dop_op->values.emplace_back("$DOP");
-                dop_op->tuple = isocpp_p0201::make_polymorphic_value<
-                        dag::collection::Tuple>(dag::type::Tuple::MakeTuple(
-                        {dag::type::Atomic::MakeAtomic("long")}));
-
-                // End this parallel operator
-                inner_dag->AddFlow(inner_dag->output().op, pre_reduction_op);
-                inner_dag->AddFlow(pre_reduction_op, part_op, 0);
-                inner_dag->AddFlow(dop_op, part_op, 1);
-                inner_dag->set_output(part_op);
-
-                // GroupBy operator after the first parallel map
-                auto *const ex_op = new DAGGroupBy();
-                dag->AddOperator(ex_op);
-
-                auto *const proj_op = new DAGProjection();
-                dag->AddOperator(proj_op);
-                proj_op->positions = {1};
-
-                // Next parallel map (for post reduction)
-                auto *const next_pop = new DAGParallelMap();
-                dag->AddOperator(next_pop);
-                dag->set_inner_dag(next_pop, new DAG());
-                auto *const next_inner_dag = dag->inner_dag(next_pop);
-
-                // Reconnect outer level
-                auto const outer_out_flow = dag->out_flow(op);
-                dag->RemoveFlow(outer_out_flow);
-                dag->AddFlow(op, ex_op);
-                dag->AddFlow(ex_op, proj_op);
-                dag->AddFlow(proj_op, next_pop);
-                dag->AddFlow(next_pop, outer_out_flow.target.op,
-                             outer_out_flow.target.port);
-
-                // Start next parallel map
-                auto *const next_param_op = new DAGParameterLookup();
-                next_inner_dag->AddOperator(next_param_op);
-
-                // Scan operators for (1) partitioning and (2) groupby
-                auto *const scan_op1 = new DAGRowScan();
-                next_inner_dag->AddOperator(scan_op1);
-
-                auto *const scan_op2 = new DAGRowScan();
-                next_inner_dag->AddOperator(scan_op2);
+                // Remember the next parallel map such that it can be extended
+                parallelize_operators.push(PartitionIntoNextParallelMap(
+                        dag, op, pre_reduction_op, num_keys,
+                        two_pass_partitioning));
 
-                // Original reduce as post-reduce operator
-                dag->MoveOperator(next_inner_dag, red_op);
+                break;
+            }
+            if (IsInstanceOf<DAGDistinct>(dag->successor(op))) {
+                auto *const distinct_op = dag->successor(op);
 
-                // Connect new operators in next inner DAG
-                next_inner_dag->set_input(next_param_op);
-                next_inner_dag->AddFlow(next_param_op, scan_op1);
-                next_inner_dag->AddFlow(scan_op1, scan_op2);
-                next_inner_dag->AddFlow(scan_op2, red_op);
-                next_inner_dag->set_output(red_op);
+                // Thread-local pre-aggregation removes the duplicates within
+                // each chunk; the partitions of the remaining tuples are then
+                // disjoint, so the original operator removes the rest of the
+                // duplicates of each partition in parallel
+                auto *const pre_distinct_op = new DAGDistinct();
+                const size_t num_fields =
+                        distinct_op->tuple->type->field_types.size();
 
                 // Remember the next parallel map such that it can be extended
-                parallelize_operators.push(next_pop);
+                parallelize_operators.push(PartitionIntoNextParallelMap(
+                        dag, op, pre_distinct_op, num_fields,
+                        two_pass_partitioning));
 
                 break;
             }
@@ -340,6 +436,94 @@ void Parallelize::Run(DAG *const dag, const std::string & /*config*/) const {
 
                 continue;
             }
+            if (shared_hash_join && IsInstanceOf<DAGJoin>(dag->successor(op))) {
+                auto *const join_op =
+                        reinterpret_cast<DAGJoin *>(dag->successor(op));
+
+                // The build side (left) ends its parallel map here; the join
+                // is moved into the parallel map of the probe side (right)
+                const auto probe_in_flow = dag->out_flow(op);
+                if (probe_in_flow.target.port == 0) break;
+
+                assert(dag->in_degree(op) == 1);
+                const auto parallel_in_flow = dag->in_flow(op);
+                const auto build_in_flow = dag->in_flow(join_op, 0);
+                const auto out_flow = dag->out_flow(join_op);
+
+                const size_t num_chunk_fields =
+                        NumOutputFields(dag, parallel_in_flow.source.op);
+
+                // (1) Build one hash index of the build side in parallel and
+                // attach it to each chunk of the probe side
+
+                auto *const index_op = new DAGHashIndex();
+                dag->AddOperator(index_op);
+                index_op->num_keys = join_op->num_keys;
+
+                auto *const cartesian_op = new DAGCartesian();
+                dag->AddOperator(cartesian_op);
+
+                // Outer flows
+                dag->RemoveFlow(parallel_in_flow);
+                dag->RemoveFlow(probe_in_flow);
+                dag->RemoveFlow(build_in_flow);
+                dag->RemoveFlow(out_flow);
+                dag->AddFlow(build_in_flow.source, index_op, 0);
+                dag->AddFlow(index_op, cartesian_op, 0);
+                dag->AddFlow(parallel_in_flow.source, cartesian_op, 1);
+                dag->AddFlow(cartesian_op, parallel_in_flow.target);
+                dag->AddFlow(op, out_flow.target);
+
+                // (2) Probe the shared index in the parallel map
+
+                // Remember existing inputs of inner DAG
+                std::multimap<int, DAG::FlowTip> existing_inputs;
+                for (const auto &input : inner_dag->inputs()) {
+                    existing_inputs.insert(input);
+                }
+
+                auto *const index_param_op = new DAGParameterLookup();
+                inner_dag->AddOperator(index_param_op);
+
+                auto *const index_proj_op = new DAGProjection();
+                inner_dag->AddOperator(index_proj_op);
+                index_proj_op->positions = {0, 1};
+
+                auto *const inner_join_op = new DAGIndexJoin();
+                inner_dag->AddOperator(inner_join_op);
+                inner_join_op->num_keys = join_op->num_keys;
+
+                inner_dag->AddFlow(index_param_op, index_proj_op);
+                inner_dag->AddFlow(index_proj_op, inner_join_op, 0);
+                inner_dag->AddFlow(inner_dag->output(), inner_join_op, 1);
+
+                inner_dag->set_input(0, index_param_op);
+                inner_dag->set_output(inner_join_op);
+
+                // Connect existing inputs again, projecting away the index
+                for (const auto &input : existing_inputs) {
+                    assert(input.first == 0);
+
+                    auto *const chunk_param_op = input.second.op;
+                    auto const chunk_out_flow =
+                            inner_dag->out_flow(chunk_param_op);
+
+                    auto *const chunk_proj_op = new DAGProjection();
+                    inner_dag->AddOperator(chunk_proj_op);
+                    for (size_t i = 0; i < num_chunk_fields; i++) {
+                        chunk_proj_op->positions.emplace_back(2 + i);
+                    }
+
+                    inner_dag->RemoveFlow(chunk_out_flow);
+                    inner_dag->AddFlow(chunk_param_op, chunk_proj_op);
+                    inner_dag->AddFlow(chunk_proj_op, chunk_out_flow.target);
+                    inner_dag->add_input(0, chunk_param_op);
+                }
+
+                dag->RemoveOperator(join_op);
+
+                continue;
+            }
             if (IsInstanceOf<DAGJoin>(dag->successor(op))) {
                 auto *const join_op =
                         reinterpret_cast<DAGJoin *>(dag->successor(op));
@@ -355,6 +539,8 @@ void Parallelize::Run(DAG *const dag, const std::string & /*config*/) const {
                 // Partition this side's input by join key
                 auto *const this_part_op = new DAGPartition();
                 inner_dag->AddOperator(this_part_op);
+                this_part_op->two_pass = two_pass_partitioning;
+                this_part_op->num_keys = join_op->num_keys;
 
                 // Create degree-of-parallelism operator
                 auto *const this_dop_op = new DAGConstantTuple();
@@ -378,6 +564,8 @@ void Parallelize::Run(DAG *const dag, const std::string & /*config*/) const {
                 // Partition other side's input by join key
                 auto *const other_part_op = new DAGPartition();
                 dag->AddOperator(other_part_op);
+                other_part_op->two_pass = two_pass_partitioning;
+                other_part_op->num_keys = join_op->num_keys;
 
                 // Create degree-of-parallelism operator
                 auto *const other_dop_op = new DAGConstantTuple();
@@ -422,7 +610,15 @@ void Parallelize::Run(DAG *const dag, const std::string & /*config*/) const {
                 dag->RemoveFlow(out_flow);
 
                 dag->AddFlow(join_op, proj_op);
-                dag->AddFlow(proj_op, next_pop);
+                if (split_skewed_partitions) {
+                    // Split partitions with heavy hitters into several tasks
+                    auto *const split_op = new DAGSplitSkewedPartitions();
+                    dag->AddOperator(split_op);
+                    dag->AddFlow(proj_op, split_op);
+                    dag->AddFlow(split_op, next_pop);
+                } else {
+                    dag->AddFlow(proj_op, next_pop);
+                }
                 dag->AddFlow(next_pop, out_flow.target.op,
                              out_flow.target.port);
 
@@ -1,5 +1,6 @@
 #include "parallelize_concurrent.hpp"
 
+#include <optional>
 #include <vector>
 
 #include <boost/range/algorithm/copy.hpp>
@@ -147,7 +148,12 @@ public:
     }
 
 private:
-    auto HandleJoin(DAGOperator *const op) const -> DAGConcurrentExecute * {
+    // Partitions both inputs by key; if broadcast_port is given, replicates
+    // the input on that port to all workers instead and keeps the other input
+    // where it is
+    auto HandleJoin(DAGOperator *const op,
+                    const std::optional<int> broadcast_port = {}) const
+            -> DAGConcurrentExecute * {
         auto *const left_pred_op = dag_->predecessor(op, 0);
         auto *const right_pred_op = dag_->predecessor(op, 1);
         auto *const next_op = dag_->successor(op);
@@ -171,22 +177,35 @@ private:
         inner_dag->AddOperator(right_param_op);
         inner_dag->set_input(1, right_param_op);
 
-        // Add exchange operators
-        auto *const left_exchange_op = new DAGExchange();
-        inner_dag->AddOperator(left_exchange_op);
-        inner_dag->AddFlow(left_param_op, left_exchange_op);
-
-        auto *const right_exchange_op = new DAGExchange();
-        inner_dag->AddOperator(right_exchange_op);
-        inner_dag->AddFlow(right_param_op, right_exchange_op);
+        // Add exchange or broadcast operators
+        DAGOperator *left_input_op = left_param_op;
+        DAGOperator *right_input_op = right_param_op;
+        if (!broadcast_port) {
+            left_input_op = new DAGExchange();
+            inner_dag->AddOperator(left_input_op);
+            inner_dag->AddFlow(left_param_op, left_input_op);
+
+            right_input_op = new DAGExchange();
+            inner_dag->AddOperator(right_input_op);
+            inner_dag->AddFlow(right_param_op, right_input_op);
+        } else if (broadcast_port.value() == 0) {
+            left_input_op = new DAGBroadcast();
+            inner_dag->AddOperator(left_input_op);
+            inner_dag->AddFlow(left_param_op, left_input_op);
+        } else {
+            assert(broadcast_port.value() == 1);
+            right_input_op = new DAGBroadcast();
+            inner_dag->AddOperator(right_input_op);
+            inner_dag->AddFlow(right_param_op, right_input_op);
+        }
 
         // Move seed operator into parallelize operator
         dag_->RemoveFlow(left_in_flow);
         dag_->RemoveFlow(right_in_flow);
         dag_->RemoveFlow(out_flow);
         dag_->MoveOperator(inner_dag, op);
-        inner_dag->AddFlow(left_exchange_op, op, 0);
-        inner_dag->AddFlow(right_exchange_op, op, 1);
+        inner_dag->AddFlow(left_input_op, op, 0);
+        inner_dag->AddFlow(right_input_op, op, 1);
         inner_dag->set_output(op);
 
         // Connect parallelize operator with old successor and predecessors
@@ -207,6 +226,9 @@ public:
     }
 
     auto operator()(DAGJoin *const op) -> DAGConcurrentExecute * {
+        // Each worker joins its part of one input with all of the other one
+        if (op->broadcast == "left") return HandleJoin(op, 0);
+        if (op->broadcast == "right") return HandleJoin(op, 1);
         return HandleJoin(op);
     }
 
@@ -323,6 +345,7 @@ public:
         auto post_red_op_ptr = std::make_unique<DAGReduceByKey>();
         auto *const post_red_op = post_red_op_ptr.get();
         post_red_op->llvm_ir = op->llvm_ir;
+        post_red_op->num_keys = op->num_keys;
         inner_dag->AddOperator(post_red_op_ptr.release());
         inner_dag->AddFlow(exchange_op, post_red_op);
         inner_dag->set_output(post_red_op);
@@ -420,6 +443,8 @@ void ExpandConcurrentExecutor(DAG *const dag, DAGConcurrentExecute *const pop) {
 
         if (IsInstanceOf<DAGFilter,                //
                          DAGColumnScan,            //
+                         DAGCsvScan,               //
+                         DAGFlatMap,               //
                          DAGMap,                   //
                          DAGMaterializeRowVector,  //
                          DAGParquetScan>(successor)) {
@@ -724,7 +749,8 @@ void ParallelizeConcurrent::Run(DAG *const dag,
 
         candidate_ops.push_back(inner_dag->output().op);
 
-        while (IsInstanceOf<DAGFilter,  //
+        while (IsInstanceOf<DAGFilter,   //
+                            DAGFlatMap,  //
                             DAGMap>(candidate_ops.back())) {
             candidate_flows.push_back(inner_dag->in_flow(candidate_ops.back()));
             candidate_ops.push_back(
@@ -12,10 +12,13 @@
 #include <polymorphic_value.h>
 
 #include "dag/dag.hpp"
-#include "dag/operators/filter.hpp"
+#include "dag/operators/all_operator_definitions.hpp"
+#include "dag/utils/type_traits.hpp"
 #include "llvm_helpers/function.hpp"
 #include "utils/visitor.hpp"
 
+using dag::utils::IsInstanceOf;
+
 struct CollectFiltersVisitor
     : public Visitor<CollectFiltersVisitor, DAGOperator,
                      boost::mpl::list<DAGFilter>> {
@@ -23,6 +26,16 @@ struct CollectFiltersVisitor
     std::vector<DAGFilter *> filters_;
 };
 
+namespace {
+
+// Windows pass their input fields through, but their aggregates depend on all
+// input tuples, so filters must not move across them in either direction
+auto IsFilterBarrier(const DAGOperator *const op) -> bool {
+    return IsInstanceOf<DAGWindow, DAGWindowGrouped>(op);
+}
+
+}  // namespace
+
 namespace optimize {
 
 void SimplePredicateMoveAround::Run(DAG *const dag,
@@ -38,6 +51,7 @@ void SimplePredicateMoveAround::Run(DAG *const dag,
         // Go as high up as the filter could go
         DAGOperator *tip = filter;
         while (dag->out_degree(tip) == 1 &&
+               !IsFilterBarrier(dag->successor(tip)) &&
                std::all_of(filter->read_set.begin(), filter->read_set.end(),
                            [&](auto c) {
                                return dag->successor(tip)->HasInOutput(c.get());
@@ -58,6 +72,7 @@ void SimplePredicateMoveAround::Run(DAG *const dag,
                 auto *const pred = flow.source.op;
                 if (currentOp->name() != "row_scan" &&
                     currentOp->name() != "range_source" &&
+                    !IsFilterBarrier(currentOp) &&
                     std::all_of(filter->read_set.begin(),
                                 filter->read_set.end(), [&](auto c) {
                                     return pred->HasInOutput(c.get());
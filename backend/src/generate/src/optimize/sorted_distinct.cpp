@@ -0,0 +1,59 @@
+#include "sorted_distinct.hpp"
+
+#include <boost/mpl/list.hpp>
+#include <polymorphic_value.h>
+
+#include "dag/dag.hpp"
+#include "dag/operators/all_operator_definitions.hpp"
+#include "utils/visitor.hpp"
+
+struct CollectDistinctVisitor
+    : public Visitor<CollectDistinctVisitor, DAGOperator,
+                     boost::mpl::list<DAGDistinct>> {
+    explicit CollectDistinctVisitor(const DAG *const dag) : dag_(dag) {}
+    void operator()(DAGDistinct *op) {
+        // Duplicates are adjacent to each other as soon as equal values of
+        // the first field are, so grouping is sufficient
+        auto const &properties =
+                dag_->predecessor(op)->tuple->fields[0]->properties();
+        if (properties.count(dag::collection::FL_SORTED) > 0 ||
+            properties.count(dag::collection::FL_GROUPED) > 0) {
+            distincts_.emplace_back(op);
+        }
+    }
+    std::vector<DAGDistinct *> distincts_;
+    const DAG *const dag_;
+};
+
+namespace optimize {
+
+void SortedDistinct::Run(DAG *const dag, const std::string & /*config*/) const {
+    CollectDistinctVisitor visitor(dag);
+    for (auto *const op : dag->operators()) {
+        visitor.Visit(op);
+    }
+
+    for (auto *const op : visitor.distincts_) {
+        std::unique_ptr<DAGSortedDistinct> new_op_ptr(new DAGSortedDistinct());
+        auto *const new_op = new_op_ptr.get();
+
+        new_op->tuple =
+                isocpp_p0201::make_polymorphic_value<dag::collection::Tuple>(
+                        *op->tuple);
+
+        dag->AddOperator(new_op_ptr.release());
+
+        const auto out_flow = dag->out_flow(op);
+        const auto in_flow = dag->in_flow(op);
+
+        dag->RemoveFlow(out_flow);
+        dag->RemoveFlow(in_flow);
+
+        dag->AddFlow(new_op, 0, out_flow.target.op, out_flow.target.port);
+        dag->AddFlow(in_flow.source.op, in_flow.source.port, new_op, 0);
+
+        dag->RemoveOperator(op);
+    }
+}
+
+}  // namespace optimize
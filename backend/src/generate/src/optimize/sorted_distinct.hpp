@@ -0,0 +1,20 @@
+#ifndef OPTIMIZE_SORTED_DISTINCT_HPP
+#define OPTIMIZE_SORTED_DISTINCT_HPP
+
+#include "dag_transformation.hpp"
+
+namespace optimize {
+
+// Replaces Distinct operators whose input is sorted or grouped on the first
+// field with SortedDistinct operators
+class SortedDistinct : public DagTransformation {
+public:
+    void Run(DAG *dag, const std::string &config) const override;
+    [[nodiscard]] auto name() const -> std::string override {
+        return "sorted_distinct";
+    }
+};
+
+}  // namespace optimize
+
+#endif  // OPTIMIZE_SORTED_DISTINCT_HPP
@@ -8,6 +8,7 @@
 #include <boost/format.hpp>
 #include <boost/range/algorithm/copy.hpp>
 #include <boost/range/irange.hpp>
+#include <nlohmann/json.hpp>
 
 #include "dag/collection/tuple.hpp"
 #include "dag/dag.hpp"
@@ -16,13 +17,26 @@
 #include "dag/type/atomic.hpp"
 #include "dag/type/tuple.hpp"
 #include "dag/utils/type_traits.hpp"
+#include "runtime/jit/operators/exchange_levels.hpp"
 
 using dag::utils::IsInstanceOf;
 
 namespace optimize {
 
-void TwoLevelExchange::Run(DAG *const dag,
-                           const std::string & /*config*/) const {
+void TwoLevelExchange::Run(DAG *const dag, const std::string &config) const {
+    // Determine number of levels: explicitly configured, derived from the
+    // expected number of workers with the cost model, or two by default
+    constexpr size_t kMaxNumLevels = 4;
+    auto const jconfig = nlohmann::json::parse(config).flatten();
+    size_t num_levels = jconfig.value("/num-levels", size_t{2});
+    if (jconfig.count("/num-levels") == 0 &&
+        jconfig.count("/num-workers") > 0) {
+        num_levels = runtime::operators::ComputeExchangeNumLevels(
+                jconfig.at("/num-workers").get<size_t>(), kMaxNumLevels);
+    }
+
+    if (num_levels <= 1) return;
+
     for (auto *const candidate_pop : dag->operators()) {
         if (!IsInstanceOf<DAGConcurrentExecute>(candidate_pop)) continue;
         auto *const pop = dynamic_cast<DAGConcurrentExecute *>(candidate_pop);
@@ -41,25 +55,26 @@ void TwoLevelExchange::Run(DAG *const dag,
             auto const in_flow = dag->in_flow(op);
             auto const out_flow = dag->out_flow(op);
 
-            // Add partitioned exchange operators
-            auto *const level0_exchange_op = new DAGPartitionedExchange();
-            dag->AddOperator(level0_exchange_op);
-            level0_exchange_op->num_levels = 2;
-            level0_exchange_op->level_num = 0;
-
-            auto *const level1_exchange_op = new DAGPartitionedExchange();
-            dag->AddOperator(level1_exchange_op);
-            level1_exchange_op->num_levels = 2;
-            level1_exchange_op->level_num = 1;
+            // Add one partitioned exchange operator per level
+            std::vector<DAGPartitionedExchange *> level_exchange_ops;
+            for (size_t level_num = 0; level_num < num_levels; level_num++) {
+                auto *const level_exchange_op = new DAGPartitionedExchange();
+                dag->AddOperator(level_exchange_op);
+                level_exchange_op->num_levels = num_levels;
+                level_exchange_op->level_num = level_num;
+                level_exchange_ops.push_back(level_exchange_op);
+            }
 
             // Reconnect DAG
             dag->RemoveFlow(in_flow);
             dag->RemoveFlow(out_flow);
             dag->RemoveOperator(op);
 
-            dag->AddFlow(in_flow.source, level0_exchange_op);
-            dag->AddFlow(level0_exchange_op, level1_exchange_op);
-            dag->AddFlow(level1_exchange_op, out_flow.target);
+            dag->AddFlow(in_flow.source, level_exchange_ops.front());
+            for (size_t i = 1; i < num_levels; i++) {
+                dag->AddFlow(level_exchange_ops[i - 1], level_exchange_ops[i]);
+            }
+            dag->AddFlow(level_exchange_ops.back(), out_flow.target);
         }
     }
 }
@@ -5,6 +5,11 @@
 
 namespace optimize {
 
+/*
+ * Replaces each exchange with a hierarchy of partitioned exchanges. Despite
+ * its name, the number of levels can be configured ("num-levels") or derived
+ * from the expected number of workers ("num-workers"); it defaults to two.
+ */
 class TwoLevelExchange : public DagTransformation {
 public:
     void Run(DAG *dag, const std::string &config) const override;
@@ -1,6 +1,7 @@
 #include "type_inference.hpp"
 
 #include <stdexcept>
+#include <string>
 
 #include <boost/format.hpp>
 #include <boost/range/algorithm/copy.hpp>
@@ -31,7 +32,30 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
         explicit TypeInferenceVisitor(const DAG *const dag) : dag_(dag) {}
 
     private:
-        auto HandleAntiJoin(const DAGOperator *const op) const
+        // Checks that the first num_keys fields of the given input exist and
+        // are Atomic
+        static void CheckKeyFields(const Tuple *const input_type,
+                                   const size_t num_keys,
+                                   const std::string &input_name) {
+            if (num_keys < 1 || num_keys > input_type->field_types.size()) {
+                throw std::invalid_argument(
+                        "Invalid number of key fields of " + input_name +
+                        ": " + std::to_string(num_keys));
+            }
+
+            for (size_t i = 0; i < num_keys; i++) {
+                const auto *const key_type = input_type->field_types[i];
+                if (dynamic_cast<const dag::type::Atomic *>(key_type) ==
+                    nullptr) {
+                    throw std::invalid_argument("Each key field of " +
+                                                input_name + " must be Atomic");
+                }
+            }
+        }
+
+        auto HandleKeyFilteringJoin(const DAGOperator *const op,
+                                    const size_t num_keys,
+                                    const std::string &name) const
                 -> const Tuple * {
             const auto *const left_input_type =
                     dag_->predecessor(op, 0)->tuple->type;
@@ -39,43 +63,122 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
                     dag_->predecessor(op, 1)->tuple->type;
 
             if (left_input_type->field_types.empty()) {
-                throw std::invalid_argument(
-                        "Left anti-join input cannot be empty tuple");
+                throw std::invalid_argument("Left " + name +
+                                            " input cannot be empty tuple");
             }
 
             if (right_input_type->field_types.empty()) {
+                throw std::invalid_argument("Right " + name +
+                                            " input cannot be empty tuple");
+            }
+
+            CheckKeyFields(left_input_type, num_keys, "left input of " + name);
+            CheckKeyFields(right_input_type, num_keys,
+                           "right input of " + name);
+
+            return left_input_type;
+        }
+
+        auto HandleJoin(const DAGOperator *const op, const int num_keys) const
+                -> const Tuple * {
+            const auto *const left_input_type =
+                    dag_->predecessor(op, 0)->tuple->type;
+            const auto *const right_input_type =
+                    dag_->predecessor(op, 1)->tuple->type;
+            return ComputeJoinType(left_input_type, right_input_type,
+                                   num_keys);
+        }
+
+        // Appends the types of the value fields, which hold the aggregates
+        auto HandleWindow(const DAGOperator *const op, const size_t num_keys,
+                          const std::string &name) const -> const Tuple * {
+            const auto *const input_type = dag_->predecessor(op)->tuple->type;
+            auto const &input_fields = input_type->field_types;
+
+            if (num_keys > 0) {
+                CheckKeyFields(input_type, num_keys, name);
+            }
+
+            if (num_keys >= input_fields.size()) {
                 throw std::invalid_argument(
-                        "Right anti-join input cannot be empty tuple");
+                        "Input of " + name +
+                        " needs at least one field besides the keys");
             }
 
-            const auto *const left_key_type = left_input_type->field_types[0];
-            const auto *const right_key_type = right_input_type->field_types[0];
+            auto output_fields = input_fields;
+            output_fields.insert(output_fields.end(),
+                                 input_fields.begin() + num_keys,
+                                 input_fields.end());
 
-            if (dynamic_cast<const dag::type::Atomic *>(left_key_type) ==
-                nullptr) {
+            return Tuple::MakeTuple(output_fields);
+        }
+
+        static auto ComputeJoinType(const Tuple *const left_input_type,
+                                    const Tuple *const right_input_type,
+                                    const int num_keys) -> const Tuple * {
+            if (left_input_type->field_types.empty()) {
                 throw std::invalid_argument(
-                        "First field of left input of anti-join must be "
-                        "Atomic");
+                        "Left join input cannot be empty tuple");
             }
 
-            if (dynamic_cast<const dag::type::Atomic *>(right_key_type) ==
-                nullptr) {
+            if (right_input_type->field_types.empty()) {
                 throw std::invalid_argument(
-                        "First field of right input of anti-join must be "
-                        "Atomic");
+                        "Right join input cannot be empty tuple");
             }
 
-            return left_input_type;
+            for (int i = 0; i < num_keys; ++i) {
+                const auto *const left_key_type =
+                        left_input_type->field_types[i];
+                const auto *const right_key_type =
+                        right_input_type->field_types[i];
+
+                if (dynamic_cast<const dag::type::Atomic *>(left_key_type) ==
+                    nullptr) {
+                    throw std::invalid_argument(
+                            "Each key of left input of Join must be Atomic");
+                }
+
+                if (dynamic_cast<const dag::type::Atomic *>(right_key_type) ==
+                    nullptr) {
+                    throw std::invalid_argument(
+                            "Each key of right input of Join must be "
+                            "Atomic");
+                }
+            }
+
+            auto output_fields = left_input_type->field_types;
+            output_fields.insert(
+                    output_fields.end(),
+                    right_input_type->field_types.begin() + num_keys,
+                    right_input_type->field_types.end());
+
+            return Tuple::MakeTuple(output_fields);
         }
 
     public:
         auto operator()(const DAGAntiJoin *const op) const -> const Tuple * {
-            return HandleAntiJoin(op);
+            return HandleKeyFilteringJoin(op, op->num_keys, "anti-join");
         }
 
         auto operator()(const DAGAntiJoinPredicated *const op) const
                 -> const Tuple * {
-            return HandleAntiJoin(op);
+            return HandleKeyFilteringJoin(op, op->num_keys, "anti-join");
+        }
+
+        auto operator()(const DAGApproxCountDistinct *const op) const
+                -> const Tuple * {
+            const auto *const input_type = dag_->predecessor(op)->tuple->type;
+            CheckKeyFields(input_type, input_type->field_types.size(),
+                           "ApproxCountDistinct");
+
+            if (op->precision < 4 || op->precision > 18) {
+                throw std::invalid_argument(
+                        "Precision of ApproxCountDistinct must be between 4 "
+                        "and 18, found: " +
+                        std::to_string(op->precision));
+            }
+
+            return Tuple::MakeTuple({Atomic::MakeAtomic("long")});
         }
 
         auto operator()(const DAGAssertCorrectOpenNextClose *const op) const
@@ -83,6 +186,39 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
             return dag_->predecessor(op)->tuple->type;
         }
 
+        auto operator()(const DAGBloomFilter *const op) const
+                -> const Tuple * {
+            const auto *const probe_input_type =
+                    dag_->predecessor(op, 0)->tuple->type;
+            const auto *const build_input_type =
+                    dag_->predecessor(op, 1)->tuple->type;
+
+            CheckKeyFields(build_input_type, op->num_keys,
+                           "build input of BloomFilter");
+
+            if (op->key_positions.size() != op->num_keys) {
+                throw std::invalid_argument(
+                        "BloomFilter needs one key position per key field");
+            }
+
+            for (size_t i = 0; i < op->num_keys; i++) {
+                const auto pos = op->key_positions[i];
+                if (pos >= probe_input_type->field_types.size()) {
+                    throw std::invalid_argument(
+                            "Invalid key position of BloomFilter: " +
+                            std::to_string(pos));
+                }
+                if (probe_input_type->field_types[pos] !=
+                    build_input_type->field_types[i]) {
+                    throw std::invalid_argument(
+                            "Key fields of both inputs of BloomFilter must "
+                            "have the same types");
+                }
+            }
+
+            return probe_input_type;
+        }
+
         auto operator()(const DAGBroadcast *const op) const -> const Tuple * {
             return dag_->predecessor(op)->tuple->type;
         }
@@ -217,6 +353,44 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
             return op->tuple->type;
         }
 
+        auto operator()(const DAGCsvScan *const op) const -> const Tuple * {
+            CheckSliceInputType(dag_->predecessor(op)->tuple->type, "CsvScan");
+
+            const auto *const output_type = op->tuple->type;
+            if (output_type->field_types.size() != op->column_indexes.size()) {
+                throw std::invalid_argument(
+                        "CsvScan needs one output field per column.");
+            }
+            for (const auto *const field_type : output_type->field_types) {
+                const auto *const array_type =
+                        dynamic_cast<const Array *>(field_type);
+                const Atomic *item_type = nullptr;
+                if (array_type != nullptr &&
+                    array_type->tuple_type->field_types.size() == 1) {
+                    item_type = dynamic_cast<const Atomic *>(
+                            array_type->tuple_type->field_types[0]);
+                }
+                if (item_type == nullptr ||
+                    (item_type->type != "int" && item_type->type != "long" &&
+                     item_type->type != "float" &&
+                     item_type->type != "double")) {
+                    throw std::invalid_argument(
+                            "Output fields of CsvScan need to be arrays of "
+                            "int, long, float, or double, found: " +
+                            field_type->to_string());
+                }
+            }
+
+            return output_type;
+        }
+
+        auto operator()(const DAGDistinct *const op) const -> const Tuple * {
+            const auto *const input_type = dag_->predecessor(op)->tuple->type;
+            CheckKeyFields(input_type, input_type->field_types.size(),
+                           "Distinct");
+            return input_type;
+        }
+
         auto operator()(const DAGEnsureSingleTuple *const op) const
                 -> const Tuple * {
             return dag_->predecessor(op)->tuple->type;
@@ -266,17 +440,17 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
 
         auto operator()(const DAGGroupBy *const op) const -> const Tuple * {
             const auto *const input_type = dag_->predecessor(op)->tuple->type;
-            const auto *const partition_id_type = input_type->field_types[0];
+            const auto *const key_type = input_type->field_types[0];
 
-            if (partition_id_type != Atomic::MakeAtomic("long")) {
+            if (dynamic_cast<const Atomic *>(key_type) == nullptr) {
                 throw std::invalid_argument(
-                        "First field of GroupBy must be 'long'");
+                        "First field of GroupBy must be Atomic");
             }
             const auto *const element_type =
                     Tuple::MakeTuple({input_type->field_types[1]});
 
             return Tuple::MakeTuple(
-                    {partition_id_type,
+                    {key_type,
                      Array::MakeArray(element_type, ArrayLayout::kC, 1)});
         }
 
@@ -284,6 +458,14 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
             return dag_->predecessor(op)->tuple->type;
         }
 
+        auto operator()(const DAGFlatMap *const op) const -> const Tuple * {
+            if (op->state_size == 0) {
+                throw std::invalid_argument(
+                        "FlatMap must have a generator state.");
+            }
+            return op->tuple->type;
+        }
+
         auto operator()(const DAGExpandPattern *const op) const
                 -> const Tuple * {
             const auto *const left_input_type =
@@ -325,49 +507,40 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
             return Tuple::MakeTuple({Atomic::MakeAtomic("std::string")});
         }
 
-        auto operator()(const DAGJoin *const op) const -> const Tuple * {
-            const auto *const left_input_type =
+        auto operator()(const DAGHashIndex *const op) const -> const Tuple * {
+            const auto *const input_type = dag_->predecessor(op)->tuple->type;
+
+            CheckKeyFields(input_type, op->num_keys, "HashIndex");
+
+            const auto *const offset_type =
+                    Tuple::MakeTuple({Atomic::MakeAtomic("long")});
+            return Tuple::MakeTuple(
+                    {Array::MakeArray(offset_type, ArrayLayout::kC, 1),
+                     Array::MakeArray(input_type, ArrayLayout::kC, 1)});
+        }
+
+        auto operator()(const DAGIndexJoin *const op) const -> const Tuple * {
+            const auto *const index_type =
                     dag_->predecessor(op, 0)->tuple->type;
             const auto *const right_input_type =
                     dag_->predecessor(op, 1)->tuple->type;
 
-            if (left_input_type->field_types.empty()) {
-                throw std::invalid_argument(
-                        "Left join input cannot be empty tuple");
-            }
-
-            if (right_input_type->field_types.empty()) {
+            const auto *const tuples_type =
+                    index_type->field_types.size() == 2
+                            ? dynamic_cast<const Array *>(
+                                      index_type->field_types[1])
+                            : nullptr;
+            if (tuples_type == nullptr) {
                 throw std::invalid_argument(
-                        "Right join input cannot be empty tuple");
+                        "Left input of IndexJoin must be a hash index");
             }
 
-            for (int i = 0; i < op->num_keys; ++i) {
-                const auto *const left_key_type =
-                        left_input_type->field_types[i];
-                const auto *const right_key_type =
-                        right_input_type->field_types[i];
-
-                if (dynamic_cast<const dag::type::Atomic *>(left_key_type) ==
-                    nullptr) {
-                    throw std::invalid_argument(
-                            "Each key of left input of Join must be Atomic");
-                }
-
-                if (dynamic_cast<const dag::type::Atomic *>(right_key_type) ==
-                    nullptr) {
-                    throw std::invalid_argument(
-                            "Each key of right input of Join must be "
-                            "Atomic");
-                }
-            }
-
-            auto output_fields = left_input_type->field_types;
-            output_fields.insert(
-                    output_fields.end(),
-                    right_input_type->field_types.begin() + op->num_keys,
-                    right_input_type->field_types.end());
+            return ComputeJoinType(tuples_type->tuple_type, right_input_type,
+                                   op->num_keys);
+        }
 
-            return Tuple::MakeTuple(output_fields);
+        auto operator()(const DAGJoin *const op) const -> const Tuple * {
+            return HandleJoin(op, op->num_keys);
         }
 
         auto operator()(const DAGMap *const op) const -> const Tuple * {
@@ -452,6 +625,10 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
                     {Array::MakeArray(element_type, ArrayLayout::kC, 1)});
         }
 
+        auto operator()(const DAGMergeJoin *const op) const -> const Tuple * {
+            return HandleJoin(op, op->num_keys);
+        }
+
         auto operator()(const DAGNestedMap *const op) const -> const Tuple * {
             assert(dag_->has_inner_dag(op));
             auto *const inner_dag = dag_->inner_dag(op);
@@ -477,12 +654,21 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
         }
 
         auto operator()(const DAGParquetScan *const op) const -> const Tuple * {
-            const auto *const input_type = dag_->predecessor(op)->tuple->type;
+            CheckSliceInputType(dag_->predecessor(op)->tuple->type,
+                                "ParquetScan");
+            return op->tuple->type;
+        }
+
+        // Checks that the input of a file scan consists of slice descriptors
+        // (file_path, slice_from, slice_to, num_slices)
+        static void CheckSliceInputType(const Tuple *const input_type,
+                                        const std::string &op_name) {
             auto const &input_field_types = input_type->field_types;
 
             if (input_field_types.size() != 4) {
                 throw std::invalid_argument(
-                        "Input of ParquetScan needs to have 4 fields "
+                        "Input of " + op_name +
+                        " needs to have 4 fields "
                         "(file_path, slice_from, slice_to, num_slices).");
             }
 
@@ -490,22 +676,19 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
                     dynamic_cast<const Atomic *>(input_field_types.at(0));
             if (file_path_field_type == nullptr ||
                 file_path_field_type->type != "std::string") {
-                throw std::invalid_argument(
-                        "file_path input of ParquetScan needs to be "
-                        "'std::string'.");
+                throw std::invalid_argument("file_path input of " + op_name +
+                                            " needs to be 'std::string'.");
             }
 
             for (size_t i = 1; i < input_field_types.size(); i++) {
                 const auto *const atomic_type =
                         dynamic_cast<const Atomic *>(input_field_types.at(i));
                 if (atomic_type == nullptr || atomic_type->type != "long") {
-                    throw std::invalid_argument(
-                            "Slice descriptor inputs of ParquetScan need to be "
-                            "'long'.");
+                    throw std::invalid_argument("Slice descriptor inputs of " +
+                                                op_name +
+                                                " need to be 'long'.");
                 }
             }
-
-            return op->tuple->type;
         }
 
         auto operator()(const DAGPartition *const op) const -> const Tuple * {
@@ -523,6 +706,14 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
             const auto *const element_type =
                     dag_->predecessor(op, 0)->tuple->type;
 
+            if (op->num_keys < 1 ||
+                op->num_keys > element_type->field_types.size()) {
+                throw std::invalid_argument(
+                        "Partition must have between one and the number of "
+                        "input fields many keys, found: " +
+                        std::to_string(op->num_keys));
+            }
+
             return Tuple::MakeTuple(
                     {Atomic::MakeAtomic("long"),
                      Array::MakeArray(element_type, ArrayLayout::kC, 1)});
@@ -598,11 +789,16 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
 
         auto operator()(const DAGReduceByKey *const op) const -> const Tuple * {
             const auto *const input_type = dag_->predecessor(op)->tuple->type;
-            const auto *const key_type = input_type->field_types[0];
+            CheckKeyFields(input_type, op->num_keys, "ReduceByKey");
 
-            if (dynamic_cast<const dag::type::Atomic *>(key_type) == nullptr) {
+            if (op->key_range && op->num_keys != 1) {
                 throw std::invalid_argument(
-                        "First field of ReduceByKey must be Atomic");
+                        "Key range of ReduceByKey requires a single key field");
+            }
+
+            if (op->key_range && op->key_range->first > op->key_range->second) {
+                throw std::invalid_argument(
+                        "Key range of ReduceByKey must not be empty");
             }
 
             return input_type;
@@ -611,12 +807,7 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
         auto operator()(const DAGReduceByKeyGrouped *const op) const
                 -> const Tuple * {
             const auto *const input_type = dag_->predecessor(op)->tuple->type;
-            const auto *const key_type = input_type->field_types[0];
-
-            if (dynamic_cast<const dag::type::Atomic *>(key_type) == nullptr) {
-                throw std::invalid_argument(
-                        "First field of ReduceByKeyGrouped must be Atomic");
-            }
+            CheckKeyFields(input_type, op->num_keys, "ReduceByKeyGrouped");
 
             return input_type;
         }
@@ -631,42 +822,16 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
                         "First field of ReduceByIndex must be Atomic");
             }
 
-            return input_type;
-        }
-
-        auto operator()(const DAGSemiJoin *const op) const -> const Tuple * {
-            const auto *const left_input_type =
-                    dag_->predecessor(op, 0)->tuple->type;
-            const auto *const right_input_type =
-                    dag_->predecessor(op, 1)->tuple->type;
-
-            if (left_input_type->field_types.empty()) {
-                throw std::invalid_argument(
-                        "Left semijoin input cannot be empty tuple");
-            }
-
-            if (right_input_type->field_types.empty()) {
+            if (op->min > op->max) {
                 throw std::invalid_argument(
-                        "Right semijoin input cannot be empty tuple");
+                        "Index range of ReduceByIndex must not be empty");
             }
 
-            const auto *const left_key_type = left_input_type->field_types[0];
-            const auto *const right_key_type = right_input_type->field_types[0];
-
-            if (dynamic_cast<const dag::type::Atomic *>(left_key_type) ==
-                nullptr) {
-                throw std::invalid_argument(
-                        "First field of left input of SemiJoin must be Atomic");
-            }
-
-            if (dynamic_cast<const dag::type::Atomic *>(right_key_type) ==
-                nullptr) {
-                throw std::invalid_argument(
-                        "First field of right input of SemiJoin must be "
-                        "Atomic");
-            }
+            return input_type;
+        }
 
-            return left_input_type;
+        auto operator()(const DAGSemiJoin *const op) const -> const Tuple * {
+            return HandleKeyFilteringJoin(op, op->num_keys, "semijoin");
         }
 
         auto operator()(const DAGSplitColumnData *const op) const
@@ -679,6 +844,23 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
             return dag_->predecessor(op, 0)->tuple->type;
         }
 
+        auto operator()(const DAGSplitSkewedPartitions *const op) const
+                -> const Tuple * {
+            const auto *const input_type = dag_->predecessor(op)->tuple->type;
+
+            if (input_type->field_types.size() != 2 ||
+                dynamic_cast<const dag::type::Array *>(
+                        input_type->field_types[0]) == nullptr ||
+                dynamic_cast<const dag::type::Array *>(
+                        input_type->field_types[1]) == nullptr) {
+                throw std::invalid_argument(
+                        "Input of SplitSkewedPartitions must consist of two "
+                        "arrays of partition groups");
+            }
+
+            return input_type;
+        }
+
         auto operator()(const DAGSplitRange *const op) const -> const Tuple * {
             return dag_->predecessor(op, 0)->tuple->type;
         }
@@ -687,10 +869,27 @@ auto ComputeOutputType(const DAG *const dag, const DAGOperator *const op)
             return dag_->predecessor(op)->tuple->type;
         }
 
+        auto operator()(const DAGSortedDistinct *const op) const
+                -> const Tuple * {
+            const auto *const input_type = dag_->predecessor(op)->tuple->type;
+            CheckKeyFields(input_type, input_type->field_types.size(),
+                           "SortedDistinct");
+            return input_type;
+        }
+
         auto operator()(const DAGTopK *const op) const -> const Tuple * {
             return dag_->predecessor(op)->tuple->type;
         }
 
+        auto operator()(const DAGWindow *const op) const -> const Tuple * {
+            return HandleWindow(op, op->num_keys, "Window");
+        }
+
+        auto operator()(const DAGWindowGrouped *const op) const
+                -> const Tuple * {
+            return HandleWindow(op, op->num_keys, "WindowGrouped");
+        }
+
         auto operator()(const DAGZip *const op) const -> const Tuple * {
             std::vector<const FieldType *> output_field_types;
             for (size_t i = 0; i < op->num_in_ports(); i++) {
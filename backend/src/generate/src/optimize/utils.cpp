@@ -1,13 +1,20 @@
 #include "utils.hpp"
 
+#include <array>
+#include <vector>
+
 #include <boost/mpl/list.hpp>
 
+#include "dag/dag.hpp"
+#include "dag/operators/broadcast.hpp"
 #include "dag/operators/column_scan.hpp"
+#include "dag/operators/partitioned_exchange.hpp"
 #include "dag/operators/range.hpp"
 #include "dag/operators/row_scan.hpp"
 #include "dag/operators/split_column_data.hpp"
 #include "dag/operators/split_range.hpp"
 #include "dag/operators/split_row_data.hpp"
+#include "dag/utils/type_traits.hpp"
 #include "utils/visitor.hpp"
 
 namespace optimize {
@@ -35,4 +42,33 @@ auto MakeSplitOperator(const DAGOperator *const op) -> DAGOperator * {
     return MakeSplitOperatorVisitor().Visit(op);
 }
 
+auto ExchangeLevelSeed(const size_t level_num) -> size_t {
+    static const std::array<size_t, 2> kSeeds = {0x7a9b42ad54aa7fec,
+                                                 0x2b3ed088aad124d1};
+    if (level_num < kSeeds.size()) return kSeeds.at(level_num);
+
+    // Derive further seeds with the finalizer of SplitMix64
+    size_t seed = kSeeds.back() + level_num * 0x9e3779b97f4a7c15;
+    seed = (seed ^ (seed >> 30U)) * 0xbf58476d1ce4e5b9;
+    seed = (seed ^ (seed >> 27U)) * 0x94d049bb133111eb;
+    return seed ^ (seed >> 31U);
+}
+
+void ReplaceBroadcastsWithExchanges(DAG *const dag) {
+    std::vector<DAGBroadcast *> broadcast_operators;
+    for (auto *const op : dag->operators()) {
+        if (dag::utils::IsInstanceOf<DAGBroadcast>(op)) {
+            broadcast_operators.push_back(dynamic_cast<DAGBroadcast *>(op));
+        }
+    }
+    for (auto *const op : broadcast_operators) {
+        auto *const new_op = new DAGPartitionedExchange();
+        new_op->tuple = op->tuple;
+        dag->ReplaceOperator(op, new_op);
+        new_op->num_levels = 1;
+        new_op->level_num = 0;
+        new_op->broadcast = true;
+    }
+}
+
 }  // namespace optimize
@@ -1,12 +1,24 @@
 #ifndef OPTIMIZE_UTILS_HPP
 #define OPTIMIZE_UTILS_HPP
 
+#include <cstddef>
+
+class DAG;
 class DAGOperator;
 
 namespace optimize {
 
 auto MakeSplitOperator(const DAGOperator *op) -> DAGOperator *;
 
+// Seed of the hash function that partitions the data in the given level of a
+// hierarchical exchange; different levels need independent hash functions
+auto ExchangeLevelSeed(size_t level_num) -> size_t;
+
+// Replaces each DAGBroadcast of the given (inner) DAG, i.e., each one that is
+// not applied to an input of the concurrent executor, with a
+// DAGPartitionedExchange that replicates its input to all workers
+void ReplaceBroadcastsWithExchanges(DAG *dag);
+
 }  // namespace optimize
 
 #endif  // OPTIMIZE_UTILS_HPP
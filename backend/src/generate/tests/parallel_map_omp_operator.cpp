@@ -0,0 +1,98 @@
+#define CATCH_CONFIG_MAIN
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "ParallelMapOmpOperator.h"
+#include "runtime/jit/memory/numa.hpp"
+#include "runtime/jit/operators/optional.hpp"
+
+namespace {
+
+// Groups of a partition, i.e., partition ID and payload
+struct GroupTuple {
+    int64_t v0;
+    int64_t v1;
+};
+
+struct PayloadTuple {
+    int64_t v0;
+};
+
+class VectorOperator {
+public:
+    explicit VectorOperator(std::vector<GroupTuple> tuples)
+        : tuples_(std::move(tuples)) {}
+
+    void open() { pos_ = 0; }
+    auto next() -> Optional<GroupTuple> {
+        if (pos_ == tuples_.size()) return {};
+        return tuples_[pos_++];
+    }
+    void close() {}
+
+private:
+    std::vector<GroupTuple> tuples_;
+    size_t pos_ = 0;
+};
+
+struct ProjectPayload {
+    auto operator()(const GroupTuple &t) -> PayloadTuple {
+        return PayloadTuple{t.v1};
+    }
+};
+
+}  // namespace
+
+TEST_CASE("Partitions are processed on their home nodes", "") {
+    const std::vector<int64_t> partition_ids = {5, 2, 7, 0, 3, 6, 1, 4};
+
+    // Run on a pinned thread outside of a parallel region, such that the one
+    // worker processes the queues of the nodes in turns and deterministically
+    std::thread thread([&] {
+        const runtime::memory::WorkerPinningScope pinning(0);
+
+        std::vector<GroupTuple> groups;
+        for (auto const id : partition_ids) groups.push_back({id, 10 * id});
+        VectorOperator upstream(groups);
+
+        std::vector<int64_t> processed;
+        auto const inner_plan = [&](const PayloadTuple &t) {
+            processed.push_back(t.v0 / 10);
+            return PayloadTuple{t.v0 + 1};
+        };
+
+        auto op = makeParallelMapOmpOperator<PayloadTuple, true, true>(
+                &upstream, inner_plan, ProjectPayload());
+        op.open();
+        std::vector<int64_t> results;
+        while (auto const ret = op.next()) results.push_back(ret.value().v0);
+        op.close();
+
+        // Results keep the order of the inputs
+        REQUIRE(results.size() == partition_ids.size());
+        for (size_t i = 0; i < partition_ids.size(); i++) {
+            REQUIRE(results[i] == 10 * partition_ids[i] + 1);
+        }
+
+        // Partitions are processed node by node, starting with the own one
+        const size_t num_nodes = runtime::memory::NumNumaNodes();
+        const size_t home = runtime::memory::CurrentNumaNode();
+        std::vector<int64_t> expected;
+        for (size_t n = 0; n < num_nodes; n++) {
+            for (auto const id : partition_ids) {
+                if (runtime::memory::HomeNodeOfPartition(id) ==
+                    (home + n) % num_nodes) {
+                    expected.push_back(id);
+                }
+            }
+        }
+        REQUIRE(processed == expected);
+    });
+    thread.join();
+}
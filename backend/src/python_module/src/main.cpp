@@ -1,8 +1,11 @@
 #include <pybind11/embed.h>
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 
 #include "generate/generate_executable.hpp"
 #include "runtime/execute_plan.hpp"
+#include "runtime/memory/memory_tracker.hpp"
+#include "runtime/memory/result_cache.hpp"
 #include "runtime/memory/values.hpp"
 
 namespace py = pybind11;
@@ -47,6 +50,42 @@ PYBIND11_MODULE(jitq_backend, m) {
         Free memory of result
     )pbdoc");
 
+    m.def("ConfigureResultCache", runtime::memory::ConfigureResultCache,
+          py::call_guard<py::gil_scoped_release>(),  //
+          R"pbdoc(
+        Set memory budget and spill directory of result cache
+    )pbdoc");
+
+    m.def("StoreCachedResult", runtime::memory::StoreCachedResult,
+          py::call_guard<py::gil_scoped_release>(),  //
+          R"pbdoc(
+        Store result in result cache
+    )pbdoc");
+
+    m.def("LookUpCachedResult", runtime::memory::LookUpCachedResult,
+          py::call_guard<py::gil_scoped_release>(),  //
+          R"pbdoc(
+        Look up result in result cache
+    )pbdoc");
+
+    m.def("ClearResultCache", runtime::memory::ClearResultCache,
+          py::call_guard<py::gil_scoped_release>(),  //
+          R"pbdoc(
+        Remove all results from result cache
+    )pbdoc");
+
+    m.def("ConfigureMemoryTracker", runtime::memory::ConfigureMemoryTracker,
+          py::call_guard<py::gil_scoped_release>(),  //
+          R"pbdoc(
+        Set process-wide memory limit and admission threshold of queries
+    )pbdoc");
+
+    m.def("GetMemoryUsage", runtime::memory::GetMemoryUsage,
+          py::call_guard<py::gil_scoped_release>(),  //
+          R"pbdoc(
+        Get current and peak memory usage of process and queries as JSON
+    )pbdoc");
+
 #ifdef VERSION_INFO
     m.attr("__version__") = VERSION_INFO;
 #else
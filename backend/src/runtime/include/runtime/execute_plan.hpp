@@ -1,17 +1,26 @@
 #ifndef RUNTIME_EXECUTE_PLAN_HPP
 #define RUNTIME_EXECUTE_PLAN_HPP
 
+#include <functional>
 #include <memory>
 #include <string>
 
 #include "dag/dag.hpp"
+#include "runtime/jit/values/json_parsing.hpp"
 
 namespace runtime {
 
+using PlanFunction =
+        runtime::values::VectorOfValues(runtime::values::VectorOfValues);
+using PlanFunctor = std::function<PlanFunction>;
+
 auto RegisterPlan(std::unique_ptr<const DAG> dag) -> size_t;
 
 auto DumpDag(size_t plan_id) -> std::string;
 
+// Loads the library of the given compiled DAG and returns its plan function
+auto LoadPlan(const DAG* dag) -> PlanFunctor;
+
 auto ExecutePlan(const DAG* dag, const std::string& inputs_str) -> std::string;
 auto ExecutePlan(size_t plan_id, const std::string& inputs_str) -> std::string;
 
@@ -0,0 +1,68 @@
+#ifndef RUNTIME_JIT_MEMORY_CHUNK_POOL_HPP
+#define RUNTIME_JIT_MEMORY_CHUNK_POOL_HPP
+
+#include <cstddef>
+
+#include "memory_tracker.hpp"
+#include "shared_pointer.hpp"
+
+namespace runtime {
+namespace memory {
+
+// Returns an uninitialized buffer of the given size that can be released with
+// free. Reuses a buffer of the same size returned with ReleaseChunk if there
+// is one, which avoids the page faults of freshly allocated memory.
+auto AllocateChunk(std::size_t num_bytes) -> void*;
+
+// Returns a buffer of the given size to the pool or frees it if the pool is
+// full.
+void ReleaseChunk(void* chunk, std::size_t num_bytes);
+
+// Frees all buffers held by the pool
+void ClearChunkPool();
+
+template <typename T>
+struct ChunkPoolRefCounter : public RefCounter {
+    explicit ChunkPoolRefCounter(void* const pointer,
+                                 const std::size_t num_elements,
+                                 const std::size_t num_bytes)
+        : RefCounter(pointer),
+          num_elements_(num_elements),
+          num_bytes_(num_bytes) {
+        // Like FreeRefCounter, release the chunk if it exceeds the limit
+        try {
+            tracked_bytes_.Resize(num_bytes);
+        } catch (...) {
+            Release();
+            throw;
+        }
+    }
+
+    ChunkPoolRefCounter(const ChunkPoolRefCounter& other) = delete;
+    ChunkPoolRefCounter(ChunkPoolRefCounter&& other) = delete;
+    auto operator=(const ChunkPoolRefCounter& other)
+            -> ChunkPoolRefCounter& = delete;
+    auto operator=(ChunkPoolRefCounter&& other)
+            -> ChunkPoolRefCounter& = delete;
+
+protected:
+    ~ChunkPoolRefCounter() override { Release(); }
+
+private:
+    void Release() {
+        auto* const t_ptr = reinterpret_cast<T*>(pointer());
+        for (std::size_t i = 0; i < num_elements_; i++) {
+            t_ptr[i].~T();
+        }
+        ReleaseChunk(pointer(), num_bytes_);
+    }
+
+    const std::size_t num_elements_;
+    const std::size_t num_bytes_;
+    TrackedBytes tracked_bytes_;
+};
+
+}  // namespace memory
+}  // namespace runtime
+
+#endif  // RUNTIME_JIT_MEMORY_CHUNK_POOL_HPP
@@ -1,6 +1,10 @@
 #ifndef RUNTIME_JIT_MEMORY_FREE_REF_COUNTER_HPP
 #define RUNTIME_JIT_MEMORY_FREE_REF_COUNTER_HPP
 
+#include <cassert>
+#include <cstdlib>
+
+#include "memory_tracker.hpp"
 #include "shared_pointer.hpp"
 
 namespace runtime {
@@ -8,23 +12,46 @@ namespace memory {
 
 template <typename T>
 struct FreeRefCounter : public RefCounter {
+    // Takes ownership of a buffer with room for capacity elements, the first
+    // num_elements of which are constructed. Buffers that are filled after
+    // creating their ref counter start with num_elements = 0 and are updated
+    // with set_num_elements, such that only constructed elements are
+    // destroyed. The capacity is accounted for even if that exceeds the
+    // memory limit, in which case the buffer is released before throwing.
     explicit FreeRefCounter(void* const pointer, const std::size_t num_elements)
-        : RefCounter(pointer), num_elements_(num_elements) {}
+        : FreeRefCounter(pointer, num_elements, num_elements) {}
+
+    FreeRefCounter(void* const pointer, const std::size_t num_elements,
+                   const std::size_t capacity)
+        : RefCounter(pointer), num_elements_(num_elements), capacity_(capacity) {
+        assert(num_elements <= capacity);
+        try {
+            tracked_bytes_.Resize(capacity * sizeof(T));
+        } catch (...) {
+            Free();
+            throw;
+        }
+    }
 
-    FreeRefCounter(const FreeRefCounter& other) = default;
+    FreeRefCounter(const FreeRefCounter& other) = delete;
     FreeRefCounter(FreeRefCounter&& other) = delete;
-    auto operator=(const FreeRefCounter& other) -> FreeRefCounter& = default;
+    auto operator=(const FreeRefCounter& other) -> FreeRefCounter& = delete;
     auto operator=(FreeRefCounter&& other) -> FreeRefCounter& = delete;
 
     [[nodiscard]] auto num_elements() const -> std::size_t {
-        return num_elements;
+        return num_elements_;
     }
+    // Sets the number of constructed elements (at most the capacity)
     void set_num_elements(const std::size_t num_elements) {
+        assert(num_elements <= capacity_);
         num_elements_ = num_elements;
     }
 
 protected:
-    ~FreeRefCounter() override {
+    ~FreeRefCounter() override { Free(); }
+
+private:
+    void Free() {
         auto* const t_ptr = reinterpret_cast<T*>(pointer());
         for (std::size_t i = 0; i < num_elements_; i++) {
             t_ptr[i].~T();
@@ -32,8 +59,9 @@ protected:
         free(pointer());
     }
 
-private:
     std::size_t num_elements_;
+    const std::size_t capacity_;
+    TrackedBytes tracked_bytes_;
 };
 
 }  // namespace memory
@@ -0,0 +1,146 @@
+#ifndef RUNTIME_JIT_MEMORY_MEMORY_TRACKER_HPP
+#define RUNTIME_JIT_MEMORY_MEMORY_TRACKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace runtime {
+namespace memory {
+
+// Thrown if an allocation would exceed the process-wide memory limit
+class MemoryLimitExceeded : public std::bad_alloc {
+public:
+    [[nodiscard]] auto what() const noexcept -> const char* override {
+        return "Process-wide memory limit exceeded";
+    }
+};
+
+// Memory used by one query, or by the process outside of queries: the
+// runtime buffers, Arrow allocations and operator hash tables allocated while
+// it runs and not freed yet. All of it counts towards the process-wide limit.
+class QueryMemory {
+public:
+    explicit QueryMemory(std::size_t id) : id_(id) {}
+
+    [[nodiscard]] auto id() const -> std::size_t { return id_; }
+    [[nodiscard]] auto current_bytes() const -> int64_t {
+        return current_bytes_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] auto peak_bytes() const -> int64_t {
+        return peak_bytes_.load(std::memory_order_relaxed);
+    }
+
+    // Accounts for num_bytes more or throws MemoryLimitExceeded (without
+    // accounting for anything) if they do not fit into the limit
+    void Allocate(std::size_t num_bytes);
+    void Release(std::size_t num_bytes);
+
+private:
+    const std::size_t id_;
+    std::atomic<int64_t> current_bytes_{0};
+    std::atomic<int64_t> peak_bytes_{0};
+};
+
+// Returns the query of the calling thread or the one of the process if the
+// thread does not work on any query
+auto CurrentQueryMemory() -> const std::shared_ptr<QueryMemory>&;
+
+// Makes the given query the one of the calling thread until the scope ends.
+// Worker threads of a query open one for each piece of work they take over.
+class QueryScope {
+public:
+    explicit QueryScope(std::shared_ptr<QueryMemory> query);
+    QueryScope(const QueryScope& other) = delete;
+    QueryScope(QueryScope&& other) = delete;
+    auto operator=(const QueryScope& other) -> QueryScope& = delete;
+    auto operator=(QueryScope&& other) -> QueryScope& = delete;
+    ~QueryScope();
+
+private:
+    std::shared_ptr<QueryMemory> previous_;
+};
+
+// Accounts for small allocations, e.g., of the nodes of hash tables, to the
+// given query. Each thread reserves memory from its current query in batches,
+// so most calls for that query do not touch any shared state. Memory of other
+// queries, e.g., freed by a thread that works on another query by now, is
+// accounted to them directly.
+void TrackAllocation(QueryMemory* query, std::size_t num_bytes);
+void TrackRelease(QueryMemory* query, std::size_t num_bytes);
+
+// STL allocator accounting with TrackAllocation and TrackRelease to the query
+// that is current when the allocator, i.e., usually its container, is created,
+// no matter which thread frees the memory. Containers must not outlive it.
+template <class T>
+class TrackingAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    TrackingAllocator() noexcept : query_(CurrentQueryMemory().get()) {}
+    template <class U>
+    // NOLINTNEXTLINE(google-explicit-constructor, hicpp-explicit-conversions)
+    TrackingAllocator(const TrackingAllocator<U>& other) noexcept
+        : query_(other.query()) {}
+
+    auto allocate(const std::size_t n) -> T* {
+        TrackAllocation(query_, n * sizeof(T));
+        try {
+            return std::allocator<T>().allocate(n);
+        } catch (...) {
+            TrackRelease(query_, n * sizeof(T));
+            throw;
+        }
+    }
+
+    void deallocate(T* const pointer, const std::size_t n) noexcept {
+        std::allocator<T>().deallocate(pointer, n);
+        TrackRelease(query_, n * sizeof(T));
+    }
+
+    [[nodiscard]] auto query() const -> QueryMemory* { return query_; }
+
+    template <class U>
+    auto operator==(const TrackingAllocator<U>& other) const -> bool {
+        return query_ == other.query();
+    }
+    template <class U>
+    auto operator!=(const TrackingAllocator<U>& other) const -> bool {
+        return query_ != other.query();
+    }
+
+private:
+    QueryMemory* query_;
+};
+
+// Size of one buffer accounted to the query that was current when the
+// accounting started until the object is destroyed, so buffers handed out
+// with the result of a query keep counting towards it
+class TrackedBytes {
+public:
+    TrackedBytes() = default;
+    TrackedBytes(const TrackedBytes& other) = delete;
+    TrackedBytes(TrackedBytes&& other) = delete;
+    auto operator=(const TrackedBytes& other) -> TrackedBytes& = delete;
+    auto operator=(TrackedBytes&& other) -> TrackedBytes& = delete;
+    ~TrackedBytes() { Resize(0); }
+
+    // Changes the accounted size. Throws MemoryLimitExceeded (keeping the
+    // previous size) if the new size does not fit into the limit.
+    void Resize(std::size_t num_bytes);
+
+private:
+    std::shared_ptr<QueryMemory> query_;
+    std::size_t num_bytes_ = 0;
+};
+
+}  // namespace memory
+}  // namespace runtime
+
+#endif  // RUNTIME_JIT_MEMORY_MEMORY_TRACKER_HPP
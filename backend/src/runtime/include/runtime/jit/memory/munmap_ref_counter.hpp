@@ -0,0 +1,64 @@
+#ifndef RUNTIME_JIT_MEMORY_MUNMAP_REF_COUNTER_HPP
+#define RUNTIME_JIT_MEMORY_MUNMAP_REF_COUNTER_HPP
+
+#include <cassert>
+#include <cstddef>
+
+#include "memory_tracker.hpp"
+#include "numa.hpp"
+#include "shared_pointer.hpp"
+
+namespace runtime {
+namespace memory {
+
+// Like FreeRefCounter for buffers from MapPages, whose capacity determines the
+// size of the mapping to release
+template <typename T>
+struct MunmapRefCounter : public RefCounter {
+    MunmapRefCounter(void* const pointer, const std::size_t num_elements,
+                     const std::size_t capacity)
+        : RefCounter(pointer), num_elements_(num_elements), capacity_(capacity) {
+        assert(num_elements <= capacity);
+        try {
+            tracked_bytes_.Resize(capacity * sizeof(T));
+        } catch (...) {
+            Free();
+            throw;
+        }
+    }
+
+    MunmapRefCounter(const MunmapRefCounter& other) = delete;
+    MunmapRefCounter(MunmapRefCounter&& other) = delete;
+    auto operator=(const MunmapRefCounter& other) -> MunmapRefCounter& = delete;
+    auto operator=(MunmapRefCounter&& other) -> MunmapRefCounter& = delete;
+
+    [[nodiscard]] auto num_elements() const -> std::size_t {
+        return num_elements_;
+    }
+    // Sets the number of constructed elements (at most the capacity)
+    void set_num_elements(const std::size_t num_elements) {
+        assert(num_elements <= capacity_);
+        num_elements_ = num_elements;
+    }
+
+protected:
+    ~MunmapRefCounter() override { Free(); }
+
+private:
+    void Free() {
+        auto* const t_ptr = reinterpret_cast<T*>(pointer());
+        for (std::size_t i = 0; i < num_elements_; i++) {
+            t_ptr[i].~T();
+        }
+        UnmapPages(pointer(), capacity_ * sizeof(T));
+    }
+
+    std::size_t num_elements_;
+    const std::size_t capacity_;
+    TrackedBytes tracked_bytes_;
+};
+
+}  // namespace memory
+}  // namespace runtime
+
+#endif  // RUNTIME_JIT_MEMORY_MUNMAP_REF_COUNTER_HPP
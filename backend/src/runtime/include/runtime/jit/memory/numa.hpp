@@ -0,0 +1,73 @@
+#ifndef RUNTIME_JIT_MEMORY_NUMA_HPP
+#define RUNTIME_JIT_MEMORY_NUMA_HPP
+
+#include <sched.h>
+
+#include <cstddef>
+
+namespace runtime {
+namespace memory {
+
+/*
+ * Placement of worker threads and buffers on the NUMA nodes of the machine.
+ * Nodes are numbered densely from 0 in the order of their IDs; only nodes with
+ * CPUs the process may run on count. The topology is read once from sysfs; if
+ * it is not available, the machine is treated as a single node and all
+ * functions below become no-ops.
+ */
+
+auto NumNumaNodes() -> std::size_t;
+
+// Returns the node of the CPU the calling thread currently runs on
+auto CurrentNumaNode() -> std::size_t;
+
+// Pins the calling thread to one CPU such that consecutive workers are spread
+// over the nodes round-robin, i.e., worker i runs on node i % NumNumaNodes().
+// Returns that node.
+auto PinWorkerThread(std::size_t worker) -> std::size_t;
+
+// Pins the calling thread with PinWorkerThread until the scope ends and then
+// restores its previous affinity, such that threads not owned by the runtime,
+// e.g., the one calling into a plan, are left as they were.
+class WorkerPinningScope {
+public:
+    explicit WorkerPinningScope(std::size_t worker);
+    WorkerPinningScope(const WorkerPinningScope &other) = delete;
+    WorkerPinningScope(WorkerPinningScope &&other) = delete;
+    auto operator=(const WorkerPinningScope &other)
+            -> WorkerPinningScope & = delete;
+    auto operator=(WorkerPinningScope &&other)
+            -> WorkerPinningScope & = delete;
+    ~WorkerPinningScope();
+
+private:
+    cpu_set_t previous_{};
+    bool has_previous_;
+};
+
+// Node on which partition (or group) with the given index is placed and
+// processed, such that producers and consumers of partitions agree
+inline auto HomeNodeOfPartition(const std::size_t partition) -> std::size_t {
+    return partition % NumNumaNodes();
+}
+
+// Size of the pages by which buffers are placed on nodes
+auto PageSize() -> std::size_t;
+
+// Maps num_bytes of fresh anonymous memory, none of whose pages is touched
+// yet, such that BindToNode determines where they are placed. UnmapPages
+// releases them together with their placement. Returns nullptr on failure.
+auto MapPages(std::size_t num_bytes) -> void *;
+void UnmapPages(void *pointer, std::size_t num_bytes);
+
+// Asks the kernel to place all pages overlapping the given range on the given
+// node when they are first touched (best effort)
+void BindToNode(void *pointer, std::size_t num_bytes, std::size_t node);
+
+// MapPages followed by BindToNode of the whole buffer
+auto AllocateOnNode(std::size_t num_bytes, std::size_t node) -> void *;
+
+}  // namespace memory
+}  // namespace runtime
+
+#endif  // RUNTIME_JIT_MEMORY_NUMA_HPP
@@ -0,0 +1,51 @@
+#ifndef RUNTIME_JIT_MEMORY_SPILL_FILE_HPP
+#define RUNTIME_JIT_MEMORY_SPILL_FILE_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+namespace runtime {
+namespace memory {
+
+// Temporary file on local disk to which operators write the data that does not
+// fit into their memory budget. The file is unlinked right after creation, so
+// it disappears once it is closed, even if the process crashes. Written data
+// can be read back after a call to Rewind; writing again appends to the end.
+// All errors are reported with std::runtime_error.
+class SpillFile {
+public:
+    // Creates the file in the given directory or in TMPDIR (or /tmp if that is
+    // not set) if the directory is empty
+    explicit SpillFile(const std::string &directory);
+
+    SpillFile(const SpillFile &other) = delete;
+    SpillFile(SpillFile &&other) = delete;
+    auto operator=(const SpillFile &other) -> SpillFile & = delete;
+    auto operator=(SpillFile &&other) -> SpillFile & = delete;
+
+    ~SpillFile();
+
+    void Write(const void *data, std::size_t num_bytes);
+
+    // Moves the read position to the beginning of the file
+    void Rewind();
+
+    // Reads num_bytes at the read position into data and returns true, or
+    // returns false if the end of the file has been reached before
+    auto Read(void *data, std::size_t num_bytes) -> bool;
+
+    // Total number of bytes written to the file
+    [[nodiscard]] auto num_bytes() const -> std::size_t { return num_bytes_; }
+
+private:
+    std::FILE *file_;
+    std::string path_;
+    std::size_t num_bytes_ = 0;
+    bool is_reading_ = false;
+};
+
+}  // namespace memory
+}  // namespace runtime
+
+#endif  // RUNTIME_JIT_MEMORY_SPILL_FILE_HPP
@@ -0,0 +1,44 @@
+#ifndef RUNTIME_JIT_OPERATORS_CSV_SCAN_HPP
+#define RUNTIME_JIT_OPERATORS_CSV_SCAN_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "runtime/jit/operators/value_operator.hpp"
+
+namespace runtime::operators {
+
+/*
+ * Returns the number of quote characters in [begin, end).
+ */
+auto CountCsvQuotes(const char* begin, const char* end, char quote) -> size_t;
+
+/*
+ * Returns the first line break in [begin, end) that is not inside of a quoted
+ * field, or end if there is none. in_quotes is the quoting state at begin and
+ * is updated to the state at the returned position.
+ */
+auto FindCsvRecordEnd(const char* begin, const char* end, char quote,
+                      bool* in_quotes) -> const char*;
+
+/*
+ * Returns an operator that reads the CSV file of each upstream tuple
+ * (file_path, slice_from, slice_to, num_slices) and produces tuples of column
+ * arrays as ParquetScan. A file is sliced into byte ranges; each slice reads
+ * the records that start in its range. Quoted fields may contain delimiters
+ * and line breaks, except that the first line break after the start of a
+ * slice is assumed not to be quoted. Each slice is parsed in parallel with
+ * up to max_num_threads threads (including the calling one).
+ */
+auto MakeCsvScanOperator(std::unique_ptr<ValueOperator> upstream,
+                         const std::vector<std::string>& column_types,
+                         const std::vector<int>& col_ids, char delimiter,
+                         char quote, bool has_header,
+                         const std::string& filesystem,
+                         size_t max_num_threads) -> ValueOperator*;
+
+}  // namespace runtime::operators
+
+#endif  // RUNTIME_JIT_OPERATORS_CSV_SCAN_HPP
@@ -0,0 +1,55 @@
+#ifndef RUNTIME_JIT_OPERATORS_EXCHANGE_LEVELS_HPP
+#define RUNTIME_JIT_OPERATORS_EXCHANGE_LEVELS_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace runtime::operators {
+
+/*
+ * Hierarchical exchanges arrange the workers in a grid with one dimension per
+ * level; the product of the sizes ("fanouts") of all dimensions is exactly the
+ * number of workers. In level l, each worker exchanges data with the workers
+ * that differ from it only in dimension (num_levels - 1 - l). After the last
+ * level, all tuples of a partition have arrived at the same worker.
+ *
+ * The cost model trades off the number of requests of each level (one write
+ * and one read per group member and worker) against a fixed cost per level
+ * (latency, synchronization, and moving the whole data volume once more).
+ */
+struct ExchangeCostModel {
+    double request_cost = 0.01;  // Seconds per request issued by one worker
+    double level_cost = 0.5;     // Seconds per level
+
+    [[nodiscard]] auto Cost(const std::vector<size_t> &fanouts) const
+            -> double;
+};
+
+/*
+ * Returns the fanouts of the num_levels levels of an exchange among
+ * num_workers workers that minimize the cost; fanouts are sorted ascendingly.
+ * Levels get a fanout of 1 if num_workers does not have enough factors.
+ */
+auto ComputeExchangeLevelFanouts(size_t num_levels, size_t num_workers,
+                                 const ExchangeCostModel &cost_model = {})
+        -> std::vector<size_t>;
+
+/*
+ * Returns the number of levels (at most max_num_levels) that minimizes the
+ * cost of an exchange among num_workers workers.
+ */
+auto ComputeExchangeNumLevels(size_t num_workers, size_t max_num_levels,
+                              const ExchangeCostModel &cost_model = {})
+        -> size_t;
+
+/*
+ * Returns the IDs of the workers that exchange data with the given worker in
+ * the given level (including itself), ordered by their position in the group.
+ */
+auto ComputeExchangeGroupMembers(size_t num_levels, size_t level_num,
+                                 size_t num_workers, size_t worker_id)
+        -> std::vector<size_t>;
+
+}  // namespace runtime::operators
+
+#endif  // RUNTIME_JIT_OPERATORS_EXCHANGE_LEVELS_HPP
@@ -0,0 +1,53 @@
+#ifndef RUNTIME_MEMORY_MEMORY_TRACKER_HPP
+#define RUNTIME_MEMORY_MEMORY_TRACKER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "runtime/jit/memory/memory_tracker.hpp"
+
+namespace runtime {
+namespace memory {
+
+/*
+ * Process-wide memory accounting of the queries (see QueryMemory) with
+ * admission control. If the memory in use exceeds a configurable fraction of
+ * the limit, new queries wait in the order they arrived until enough memory
+ * has been freed or no other query runs anymore.
+ */
+
+// Sets the memory limit (in bytes, 0 for none) and the fraction of it up to
+// which new queries are admitted right away
+void ConfigureMemoryTracker(size_t limit, double admission_threshold);
+
+// Returns current and peak usage of the process and of the running queries,
+// the number of waiting queries, and the usage of the last query that
+// finished on the calling thread as JSON
+auto GetMemoryUsage() -> std::string;
+
+// Admits a new query, waiting if memory is short, and makes it the current
+// query of the calling thread for the lifetime of the object
+class AdmittedQuery {
+public:
+    AdmittedQuery();
+    AdmittedQuery(const AdmittedQuery& other) = delete;
+    AdmittedQuery(AdmittedQuery&& other) = delete;
+    auto operator=(const AdmittedQuery& other) -> AdmittedQuery& = delete;
+    auto operator=(AdmittedQuery&& other) -> AdmittedQuery& = delete;
+    ~AdmittedQuery();
+
+    [[nodiscard]] auto memory() const -> const std::shared_ptr<QueryMemory>& {
+        return memory_;
+    }
+
+private:
+    std::shared_ptr<QueryMemory> memory_;
+    std::optional<QueryScope> scope_;
+};
+
+}  // namespace memory
+}  // namespace runtime
+
+#endif  // RUNTIME_MEMORY_MEMORY_TRACKER_HPP
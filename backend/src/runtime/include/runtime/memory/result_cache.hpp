@@ -0,0 +1,40 @@
+#ifndef RUNTIME_MEMORY_RESULT_CACHE_HPP
+#define RUNTIME_MEMORY_RESULT_CACHE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace runtime {
+namespace memory {
+
+/*
+ * Cache of query results shared by all queries of the process. Results are in
+ * the format returned by ExecutePlan and consist of tuples of arrays, whose
+ * buffers are kept alive by the cache. If the cached results exceed the memory
+ * budget, the least recently used ones are spilled to the spill directory if
+ * one is configured and dropped otherwise.
+ */
+
+// Sets the memory budget (in bytes) and the spill directory (empty for none),
+// evicting results if necessary
+void ConfigureResultCache(size_t budget, const std::string &spill_directory);
+
+// Stores the result under the given key, replacing any previous one.
+// item_sizes holds the element size of each array of the result in the order
+// in which they appear in the values.
+void StoreCachedResult(const std::string &key, const std::string &values,
+                       const std::vector<size_t> &item_sizes);
+
+// Returns the result stored under the given key or an empty string if there is
+// none. As for ExecutePlan, the caller owns one reference to the buffers of
+// the result.
+auto LookUpCachedResult(const std::string &key) -> std::string;
+
+// Removes all results, including spilled ones
+void ClearResultCache();
+
+}  // namespace memory
+}  // namespace runtime
+
+#endif  // RUNTIME_MEMORY_RESULT_CACHE_HPP
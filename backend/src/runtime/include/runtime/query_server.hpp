@@ -0,0 +1,23 @@
+#ifndef RUNTIME_QUERY_SERVER_HPP
+#define RUNTIME_QUERY_SERVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace runtime {
+
+/*
+ * Runs a server that executes compiled DAGs (in the format of DumpDag)
+ * submitted over TCP and streams their results back as Arrow IPC streams with
+ * record batches of at most batch_size rows. Up to max_num_plans compiled
+ * plans and the metadata of Parquet files are kept across requests. Requests
+ * larger than max_request_size bytes are rejected. Does not return.
+ */
+void RunQueryServer(const std::string& address, uint16_t port,
+                    size_t batch_size, size_t max_request_size,
+                    size_t max_num_plans);
+
+}  // namespace runtime
+
+#endif  // RUNTIME_QUERY_SERVER_HPP
@@ -14,16 +14,13 @@
 #include "dag/dag.hpp"
 #include "dag/operators/compiled_pipeline.hpp"
 #include "runtime/jit/values/json_parsing.hpp"
+#include "runtime/memory/memory_tracker.hpp"
 #include "runtime/memory/values.hpp"
 #include "utils/lib_path.hpp"
 #include "utils/registry.hpp"
 
 namespace runtime {
 
-using PlanFunction =
-        runtime::values::VectorOfValues(runtime::values::VectorOfValues);
-using PlanFunctor = std::function<PlanFunction>;
-
 struct Plan {
     std::unique_ptr<const DAG> dag;
     std::optional<PlanFunctor> functor;
@@ -65,6 +62,9 @@ void LoadPlan(const size_t plan_id) {
 
 auto ExecutePlan(const PlanFunctor& functor, const std::string& inputs_str)
         -> std::string {
+    // Waits if memory is short and accounts all allocations to the query
+    const runtime::memory::AdmittedQuery query;
+
     const auto inputs =
             runtime::values::ConvertFromJsonString(inputs_str.c_str());
     const auto ret = functor(inputs);
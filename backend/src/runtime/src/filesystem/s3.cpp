@@ -17,6 +17,7 @@
 
 #include "aws/aws.hpp"
 #include "aws/s3.hpp"
+#include "memory/arrow_memory_pool.hpp"
 
 using boost::format;
 
@@ -32,7 +33,7 @@ public:
           key_(std::move(key)),
           s3_client_(std::move(s3_client)),
           file_size_(-1),
-          pool_(arrow::default_memory_pool()) {
+          pool_(memory::TrackingArrowMemoryPool()) {
         if (bucket_.empty()) {
             throw std::runtime_error("Path has empty bucket.");
         }
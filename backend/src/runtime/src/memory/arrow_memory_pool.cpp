@@ -0,0 +1,107 @@
+#include "memory/arrow_memory_pool.hpp"
+
+#include <cstdint>
+
+#include <memory>
+#include <new>
+#include <string>
+
+#include <arrow/memory_pool.h>
+#include <arrow/status.h>
+
+#include "runtime/jit/memory/memory_tracker.hpp"
+
+namespace runtime::memory {
+
+namespace {
+
+// Keeps the query of each allocation in a header in front of it, such that
+// it is accounted to the right query even if it is freed by another thread
+class TrackingMemoryPool : public arrow::MemoryPool {
+    using Owner = std::shared_ptr<QueryMemory>;
+
+    // Keeps the alignment of the wrapped pool
+    static constexpr int64_t kHeaderSize = 64;
+    static_assert(sizeof(Owner) <= kHeaderSize);
+
+public:
+    explicit TrackingMemoryPool(arrow::MemoryPool *const pool) : pool_(pool) {}
+
+    auto Allocate(const int64_t size, uint8_t **const out)
+            -> arrow::Status override {
+        const auto &query = CurrentQueryMemory();
+        try {
+            query->Allocate(size);
+        } catch (const MemoryLimitExceeded &e) {
+            return arrow::Status::OutOfMemory(e.what());
+        }
+
+        uint8_t *header = nullptr;
+        auto status = pool_->Allocate(size + kHeaderSize, &header);
+        if (!status.ok()) {
+            query->Release(size);
+            return status;
+        }
+        new (header) Owner(query);
+        *out = header + kHeaderSize;
+        return arrow::Status::OK();
+    }
+
+    auto Reallocate(const int64_t old_size, const int64_t new_size,
+                    uint8_t **const ptr) -> arrow::Status override {
+        uint8_t *header = *ptr - kHeaderSize;
+        // Copy the owner since the header may move
+        const Owner owner = *reinterpret_cast<Owner *>(header);
+        if (new_size > old_size) {
+            try {
+                owner->Allocate(new_size - old_size);
+            } catch (const MemoryLimitExceeded &e) {
+                return arrow::Status::OutOfMemory(e.what());
+            }
+        }
+
+        auto status = pool_->Reallocate(old_size + kHeaderSize,
+                                        new_size + kHeaderSize, &header);
+        if (!status.ok()) {
+            if (new_size > old_size) owner->Release(new_size - old_size);
+            return status;
+        }
+        if (new_size < old_size) owner->Release(old_size - new_size);
+        *ptr = header + kHeaderSize;
+        return arrow::Status::OK();
+    }
+
+    void Free(uint8_t *const buffer, const int64_t size) override {
+        uint8_t *const header = buffer - kHeaderSize;
+        auto *const owner = reinterpret_cast<Owner *>(header);
+        (*owner)->Release(size);
+        owner->~Owner();
+        pool_->Free(header, size + kHeaderSize);
+    }
+
+    void ReleaseUnused() override { pool_->ReleaseUnused(); }
+
+    [[nodiscard]] auto bytes_allocated() const -> int64_t override {
+        return pool_->bytes_allocated();
+    }
+
+    [[nodiscard]] auto max_memory() const -> int64_t override {
+        return pool_->max_memory();
+    }
+
+    [[nodiscard]] auto backend_name() const -> std::string override {
+        return "tracking-" + pool_->backend_name();
+    }
+
+private:
+    arrow::MemoryPool *const pool_;
+};
+
+}  // namespace
+
+auto TrackingArrowMemoryPool() -> arrow::MemoryPool * {
+    static TrackingMemoryPool pool(arrow::default_memory_pool());
+    return &pool;
+}
+
+}  // namespace runtime::memory
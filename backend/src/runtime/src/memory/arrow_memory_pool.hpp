@@ -0,0 +1,17 @@
+#ifndef MEMORY_ARROW_MEMORY_POOL_HPP
+#define MEMORY_ARROW_MEMORY_POOL_HPP
+
+#include <arrow/memory_pool.h>
+
+namespace runtime {
+namespace memory {
+
+// Returns Arrow's default memory pool wrapped such that its allocations are
+// accounted to the current query (see QueryMemory). Allocations beyond the
+// memory limit fail with Status::OutOfMemory.
+auto TrackingArrowMemoryPool() -> arrow::MemoryPool *;
+
+}  // namespace memory
+}  // namespace runtime
+
+#endif  // MEMORY_ARROW_MEMORY_POOL_HPP
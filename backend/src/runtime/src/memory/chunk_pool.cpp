@@ -0,0 +1,92 @@
+#include "runtime/jit/memory/chunk_pool.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace runtime::memory {
+
+namespace {
+
+class ChunkPool {
+public:
+    static auto instance() -> ChunkPool * {
+        static ChunkPool pool;
+        return &pool;
+    }
+
+    ChunkPool(const ChunkPool &other) = delete;
+    ChunkPool(ChunkPool &&other) = delete;
+    auto operator=(const ChunkPool &other) -> ChunkPool & = delete;
+    auto operator=(ChunkPool &&other) -> ChunkPool & = delete;
+
+    ~ChunkPool() { Clear(); }
+
+    auto Allocate(const size_t num_bytes) -> void * {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto const it = chunks_.find(num_bytes);
+            if (it != chunks_.end() && !it->second.empty()) {
+                void *const chunk = it->second.back();
+                it->second.pop_back();
+                pooled_bytes_ -= num_bytes;
+                return chunk;
+            }
+        }
+
+        void *const chunk = malloc(num_bytes);
+        if (chunk == nullptr) throw std::bad_alloc();
+        return chunk;
+    }
+
+    void Release(void *const chunk, const size_t num_bytes) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pooled_bytes_ + num_bytes <= kMaxPooledBytes) {
+                chunks_[num_bytes].push_back(chunk);
+                pooled_bytes_ += num_bytes;
+                return;
+            }
+        }
+        free(chunk);
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &[num_bytes, chunks] : chunks_) {
+            for (void *const chunk : chunks) {
+                free(chunk);
+            }
+        }
+        chunks_.clear();
+        pooled_bytes_ = 0;
+    }
+
+private:
+    // Upper bound of the memory held by released chunks
+    static constexpr size_t kMaxPooledBytes = 1UL << 26U;
+
+    ChunkPool() = default;
+
+    std::mutex mutex_;
+    size_t pooled_bytes_ = 0;
+    std::unordered_map<size_t, std::vector<void *>> chunks_{};
+};
+
+}  // namespace
+
+auto AllocateChunk(const size_t num_bytes) -> void * {
+    return ChunkPool::instance()->Allocate(num_bytes);
+}
+
+void ReleaseChunk(void *const chunk, const size_t num_bytes) {
+    ChunkPool::instance()->Release(chunk, num_bytes);
+}
+
+void ClearChunkPool() { ChunkPool::instance()->Clear(); }
+
+}  // namespace runtime::memory
@@ -0,0 +1,285 @@
+#include "runtime/memory/memory_tracker.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "runtime/jit/memory/memory_tracker.hpp"
+
+namespace runtime::memory {
+
+namespace {
+
+void UpdatePeak(std::atomic<int64_t>* const peak, const int64_t value) {
+    int64_t old_peak = peak->load(std::memory_order_relaxed);
+    while (value > old_peak &&
+           !peak->compare_exchange_weak(old_peak, value,
+                                        std::memory_order_relaxed)) {
+    }
+}
+
+class MemoryTracker {
+public:
+    static auto instance() -> MemoryTracker* {
+        static MemoryTracker tracker;
+        return &tracker;
+    }
+
+    MemoryTracker(const MemoryTracker& other) = delete;
+    MemoryTracker(MemoryTracker&& other) = delete;
+    auto operator=(const MemoryTracker& other) -> MemoryTracker& = delete;
+    auto operator=(MemoryTracker&& other) -> MemoryTracker& = delete;
+    ~MemoryTracker() = default;
+
+    auto TryAllocate(const int64_t num_bytes) -> bool {
+        const auto limit = limit_.load(std::memory_order_relaxed);
+        const int64_t current =
+                current_bytes_.fetch_add(num_bytes, std::memory_order_relaxed) +
+                num_bytes;
+        if (limit != 0 && current > limit) {
+            current_bytes_.fetch_sub(num_bytes, std::memory_order_relaxed);
+            return false;
+        }
+        UpdatePeak(&peak_bytes_, current);
+        return true;
+    }
+
+    void Release(const int64_t num_bytes) {
+        current_bytes_.fetch_sub(num_bytes, std::memory_order_relaxed);
+    }
+
+    void Configure(const size_t limit, const double admission_threshold) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        limit_ = static_cast<int64_t>(limit);
+        admission_threshold_ = admission_threshold;
+        admission_changed_.notify_all();
+    }
+
+    // Waits until all earlier queries have been admitted and the process has
+    // room for another one
+    auto Admit() -> std::shared_ptr<QueryMemory> {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const size_t ticket = next_ticket_++;
+        while (ticket != serving_ticket_ || !HasRoom()) {
+            // Freed memory does not notify, so check again from time to time
+            admission_changed_.wait_for(lock, kPollInterval);
+        }
+        serving_ticket_++;
+
+        running_.emplace_back(std::make_shared<QueryMemory>(next_query_id_++));
+        admission_changed_.notify_all();
+        return running_.back();
+    }
+
+    void Finish(const std::shared_ptr<QueryMemory>& query) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_.erase(std::find(running_.begin(), running_.end(), query));
+        admission_changed_.notify_all();
+    }
+
+    auto Usage() -> nlohmann::json {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto queries = nlohmann::json::array();
+        for (auto const& query : running_) {
+            queries.push_back({{"id", query->id()},
+                               {"current_bytes", query->current_bytes()},
+                               {"peak_bytes", query->peak_bytes()}});
+        }
+        return {{"current_bytes", current_bytes_.load()},
+                {"peak_bytes", peak_bytes_.load()},
+                {"limit", limit_.load()},
+                {"queries", queries},
+                {"num_waiting", next_ticket_ - serving_ticket_}};
+    }
+
+private:
+    static constexpr std::chrono::milliseconds kPollInterval{10};
+
+    MemoryTracker() = default;
+
+    [[nodiscard]] auto HasRoom() const -> bool {
+        const auto limit = limit_.load(std::memory_order_relaxed);
+        return running_.empty() || limit == 0 ||
+               static_cast<double>(current_bytes_.load()) <
+                       admission_threshold_ * static_cast<double>(limit);
+    }
+
+    std::atomic<int64_t> current_bytes_{0};
+    std::atomic<int64_t> peak_bytes_{0};
+    std::atomic<int64_t> limit_{0};
+
+    std::mutex mutex_;
+    std::condition_variable admission_changed_;
+    double admission_threshold_ = 1.0;
+    size_t next_ticket_ = 0;
+    size_t serving_ticket_ = 0;
+    size_t next_query_id_ = 1;
+    std::vector<std::shared_ptr<QueryMemory>> running_;
+};
+
+// Memory each thread reserves from its query at once
+constexpr int64_t kReservationSize = 1L << 20U;
+
+struct Reservation {
+    QueryMemory* query = nullptr;
+    int64_t num_bytes = 0;
+
+    // Threads return what is left of their reservation when they exit
+    Reservation() = default;
+    Reservation(const Reservation& other) = default;
+    auto operator=(const Reservation& other) -> Reservation& = default;
+    ~Reservation() {
+        if (query != nullptr && num_bytes > 0) query->Release(num_bytes);
+    }
+};
+
+thread_local std::shared_ptr<QueryMemory> current_query;
+thread_local Reservation reservation;
+
+struct LastQuery {
+    size_t id = 0;
+    int64_t peak_bytes = 0;
+};
+thread_local LastQuery last_query;
+
+auto ProcessMemory() -> const std::shared_ptr<QueryMemory>& {
+    static const auto process_memory = std::make_shared<QueryMemory>(0);
+    return process_memory;
+}
+
+// Returns the reservation of the calling thread to its query
+void FlushReservation() {
+    if (reservation.query != nullptr && reservation.num_bytes > 0) {
+        reservation.query->Release(reservation.num_bytes);
+    }
+    reservation.query = nullptr;
+    reservation.num_bytes = 0;
+}
+
+}  // namespace
+
+void QueryMemory::Allocate(const size_t num_bytes) {
+    const auto n = static_cast<int64_t>(num_bytes);
+    if (!MemoryTracker::instance()->TryAllocate(n)) {
+        throw MemoryLimitExceeded();
+    }
+    const int64_t current =
+            current_bytes_.fetch_add(n, std::memory_order_relaxed) + n;
+    UpdatePeak(&peak_bytes_, current);
+}
+
+void QueryMemory::Release(const size_t num_bytes) {
+    const auto n = static_cast<int64_t>(num_bytes);
+    current_bytes_.fetch_sub(n, std::memory_order_relaxed);
+    MemoryTracker::instance()->Release(n);
+}
+
+auto CurrentQueryMemory() -> const std::shared_ptr<QueryMemory>& {
+    return current_query != nullptr ? current_query : ProcessMemory();
+}
+
+QueryScope::QueryScope(std::shared_ptr<QueryMemory> query) {
+    FlushReservation();
+    previous_ = std::move(current_query);
+    current_query = std::move(query);
+}
+
+QueryScope::~QueryScope() {
+    FlushReservation();
+    current_query = std::move(previous_);
+}
+
+void TrackAllocation(QueryMemory* const query, const size_t num_bytes) {
+    // Reservations are only taken from the current query of the thread, so
+    // they end with its QueryScope
+    if (query != CurrentQueryMemory().get()) {
+        query->Allocate(num_bytes);
+        return;
+    }
+
+    const auto n = static_cast<int64_t>(num_bytes);
+    if (reservation.query != query) {
+        FlushReservation();
+        reservation.query = query;
+    }
+    if (reservation.num_bytes >= n) {
+        reservation.num_bytes -= n;
+        return;
+    }
+
+    // Reserve a full batch unless only the missing bytes fit
+    const int64_t missing = n - reservation.num_bytes;
+    const int64_t batch = std::max(missing, kReservationSize);
+    try {
+        query->Allocate(batch);
+        reservation.num_bytes += batch;
+    } catch (const MemoryLimitExceeded&) {
+        if (batch == missing) throw;
+        query->Allocate(missing);
+        reservation.num_bytes += missing;
+    }
+    reservation.num_bytes -= n;
+}
+
+void TrackRelease(QueryMemory* const query, const size_t num_bytes) {
+    if (query != CurrentQueryMemory().get()) {
+        query->Release(num_bytes);
+        return;
+    }
+
+    if (reservation.query != query) {
+        FlushReservation();
+        reservation.query = query;
+    }
+    reservation.num_bytes += static_cast<int64_t>(num_bytes);
+    if (reservation.num_bytes > 2 * kReservationSize) {
+        query->Release(reservation.num_bytes - kReservationSize);
+        reservation.num_bytes = kReservationSize;
+    }
+}
+
+void TrackedBytes::Resize(const size_t num_bytes) {
+    if (num_bytes > num_bytes_) {
+        if (query_ == nullptr) query_ = CurrentQueryMemory();
+        query_->Allocate(num_bytes - num_bytes_);
+    } else if (num_bytes < num_bytes_) {
+        query_->Release(num_bytes_ - num_bytes);
+    }
+    num_bytes_ = num_bytes;
+}
+
+void ConfigureMemoryTracker(const size_t limit,
+                            const double admission_threshold) {
+    MemoryTracker::instance()->Configure(limit, admission_threshold);
+}
+
+auto GetMemoryUsage() -> std::string {
+    auto usage = MemoryTracker::instance()->Usage();
+    usage["last_query"] = {{"id", last_query.id},
+                           {"peak_bytes", last_query.peak_bytes}};
+    return usage.dump();
+}
+
+AdmittedQuery::AdmittedQuery()
+    : memory_(MemoryTracker::instance()->Admit()) {
+    scope_.emplace(memory_);
+}
+
+AdmittedQuery::~AdmittedQuery() {
+    scope_.reset();
+    last_query = {memory_->id(), memory_->peak_bytes()};
+    MemoryTracker::instance()->Finish(memory_);
+}
+
+}  // namespace runtime::memory
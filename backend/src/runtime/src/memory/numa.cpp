@@ -0,0 +1,206 @@
+#include "runtime/jit/memory/numa.hpp"
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace runtime::memory {
+
+namespace {
+
+// Memory policy of mbind(2), see linux/mempolicy.h
+constexpr int kMpolPreferred = 1;
+constexpr size_t kMaxNodeId = 1024;
+constexpr size_t kBitsPerWord = 8 * sizeof(unsigned long);  // NOLINT
+
+// Parses lists like "0-3,8,10-11" as used in sysfs
+auto ParseList(const std::string &list) -> std::vector<size_t> {
+    std::vector<size_t> values;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        const auto dash = range.find('-');
+        const size_t first = std::stoul(range.substr(0, dash));
+        const size_t last = dash == std::string::npos
+                                    ? first
+                                    : std::stoul(range.substr(dash + 1));
+        for (size_t i = first; i <= last; i++) values.push_back(i);
+    }
+    return values;
+}
+
+auto ReadList(const std::string &path) -> std::vector<size_t> {
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line)) return {};
+    return ParseList(line);
+}
+
+class Topology {
+public:
+    static auto instance() -> const Topology & {
+        static const Topology topology;
+        return topology;
+    }
+
+    [[nodiscard]] auto num_nodes() const -> size_t { return node_ids_.size(); }
+    [[nodiscard]] auto node_id(const size_t node) const -> size_t {
+        return node_ids_[node];
+    }
+    [[nodiscard]] auto node_of_cpu(const size_t cpu) const -> size_t {
+        return cpu < cpu_nodes_.size() ? cpu_nodes_[cpu] : 0;
+    }
+    [[nodiscard]] auto worker_cpus() const -> const std::vector<size_t> & {
+        return worker_cpus_;
+    }
+
+private:
+    Topology() {
+        // CPUs the process may run on, e.g., restricted by taskset or cgroups
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        const bool has_allowed =
+                sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+        auto const is_allowed = [&](const size_t cpu) {
+            return !has_allowed ||
+                   (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed));
+        };
+
+        const std::string base = "/sys/devices/system/node/";
+        std::vector<std::vector<size_t>> node_cpus;
+        for (auto const id : ReadList(base + "online")) {
+            std::vector<size_t> cpus;
+            for (auto const cpu : ReadList(base + "node" + std::to_string(id) +
+                                           "/cpulist")) {
+                if (is_allowed(cpu)) cpus.push_back(cpu);
+            }
+            if (cpus.empty() || id >= kMaxNodeId) continue;
+            node_ids_.push_back(id);
+            node_cpus.emplace_back(std::move(cpus));
+        }
+
+        // Without topology information, all allowed CPUs form one node
+        if (node_ids_.empty()) {
+            std::vector<size_t> cpus;
+            for (size_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (has_allowed && CPU_ISSET(cpu, &allowed)) {
+                    cpus.push_back(cpu);
+                }
+            }
+            node_ids_.push_back(0);
+            node_cpus.emplace_back(std::move(cpus));
+        }
+
+        for (size_t node = 0; node < node_cpus.size(); node++) {
+            for (auto const cpu : node_cpus[node]) {
+                if (cpu >= cpu_nodes_.size()) cpu_nodes_.resize(cpu + 1, 0);
+                cpu_nodes_[cpu] = node;
+            }
+        }
+
+        // Take the CPUs of the nodes in turns
+        for (size_t i = 0;; i++) {
+            bool has_more = false;
+            for (auto const &cpus : node_cpus) {
+                if (i >= cpus.size()) continue;
+                worker_cpus_.push_back(cpus[i]);
+                has_more = true;
+            }
+            if (!has_more) break;
+        }
+    }
+
+    std::vector<size_t> node_ids_;
+    std::vector<size_t> cpu_nodes_;
+    std::vector<size_t> worker_cpus_;
+};
+
+}  // namespace
+
+auto NumNumaNodes() -> size_t { return Topology::instance().num_nodes(); }
+
+auto CurrentNumaNode() -> size_t {
+    auto const &topology = Topology::instance();
+    if (topology.num_nodes() == 1) return 0;
+    const int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : topology.node_of_cpu(cpu);
+}
+
+auto PinWorkerThread(const size_t worker) -> size_t {
+    auto const &topology = Topology::instance();
+    auto const &cpus = topology.worker_cpus();
+    if (cpus.empty()) return 0;
+
+    // Workers beyond the number of CPUs share them (and keep the pattern)
+    const size_t cpu = cpus[worker % cpus.size()];
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+    return topology.node_of_cpu(cpu);
+}
+
+WorkerPinningScope::WorkerPinningScope(const size_t worker)
+    : has_previous_(sched_getaffinity(0, sizeof(previous_), &previous_) == 0) {
+    PinWorkerThread(worker);
+}
+
+WorkerPinningScope::~WorkerPinningScope() {
+    if (has_previous_) sched_setaffinity(0, sizeof(previous_), &previous_);
+}
+
+auto PageSize() -> size_t {
+    static const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+auto MapPages(const size_t num_bytes) -> void * {
+    void *const pointer = mmap(nullptr, std::max<size_t>(1, num_bytes),
+                               PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return pointer == MAP_FAILED ? nullptr : pointer;
+}
+
+void UnmapPages(void *const pointer, const size_t num_bytes) {
+    munmap(pointer, std::max<size_t>(1, num_bytes));
+}
+
+void BindToNode(void *const pointer, const size_t num_bytes,
+                const size_t node) {
+    auto const &topology = Topology::instance();
+    if (topology.num_nodes() == 1 || node >= topology.num_nodes()) return;
+    if (num_bytes == 0) return;
+
+    const uintptr_t page_size = PageSize();
+    const auto begin = reinterpret_cast<uintptr_t>(pointer);
+    const uintptr_t first_page = begin / page_size * page_size;
+    const uintptr_t end_page =
+            (begin + num_bytes + page_size - 1) / page_size * page_size;
+
+    const size_t id = topology.node_id(node);
+    unsigned long mask[kMaxNodeId / kBitsPerWord] = {};  // NOLINT
+    mask[id / kBitsPerWord] = 1UL << (id % kBitsPerWord);
+
+    // Failures only cost locality, e.g., if the kernel lacks NUMA support
+    syscall(SYS_mbind, first_page, end_page - first_page, kMpolPreferred,
+            mask, kMaxNodeId + 1, 0U);
+}
+
+auto AllocateOnNode(const size_t num_bytes, const size_t node) -> void * {
+    void *const pointer = MapPages(num_bytes);
+    if (pointer != nullptr) BindToNode(pointer, num_bytes, node);
+    return pointer;
+}
+
+}  // namespace runtime::memory
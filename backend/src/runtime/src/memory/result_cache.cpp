@@ -0,0 +1,270 @@
+#include "runtime/memory/result_cache.hpp"
+
+#include <cstddef>
+
+#include <fstream>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/mpl/list.hpp>
+
+#include "runtime/jit/memory/default_ref_counter.hpp"
+#include "runtime/jit/memory/shared_pointer.hpp"
+#include "runtime/jit/values/array.hpp"
+#include "runtime/jit/values/json_parsing.hpp"
+#include "runtime/jit/values/tuple.hpp"
+#include "runtime/jit/values/value.hpp"
+#include "runtime/memory/values.hpp"
+#include "utils/visitor.hpp"
+
+namespace runtime::memory {
+
+namespace {
+
+using ArrayFunction = std::function<void(values::Array *)>;
+
+class ForEachArrayVisitor
+    : public Visitor<ForEachArrayVisitor, values::Value,
+                     boost::mpl::list<       //
+                             values::Tuple,  //
+                             values::Array   //
+                             >::type> {
+public:
+    explicit ForEachArrayVisitor(ArrayFunction function)
+        : function_(std::move(function)) {}
+
+    void operator()(values::Array *const v) { function_(v); }
+
+    void operator()(values::Tuple *const v) {
+        for (const auto &f : v->fields) {
+            Visit(f.get());
+        }
+    }
+
+private:
+    ArrayFunction function_;
+};
+
+// Calls the function on each array of the values and its position
+void ForEachArray(
+        const values::VectorOfValues &values,
+        const std::function<void(values::Array *, size_t)> &function) {
+    size_t i = 0;
+    ForEachArrayVisitor visitor(
+            [&](values::Array *const array) { function(array, i++); });
+    for (auto const &v : values) {
+        visitor.Visit(v.get());
+    }
+}
+
+// Size of the buffer of the given array
+auto NumBytes(const values::Array &array, const size_t item_size) -> size_t {
+    return std::accumulate(array.outer_shape.begin(), array.outer_shape.end(),
+                           item_size, std::multiplies<>());
+}
+
+class ResultCache {
+public:
+    static auto instance() -> ResultCache * {
+        static ResultCache cache;
+        return &cache;
+    }
+
+    void Configure(const size_t budget, const std::string &spill_directory) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budget_ = budget;
+        spill_directory_ = spill_directory;
+        if (!spill_directory_.empty()) {
+            boost::filesystem::create_directories(spill_directory_);
+        }
+        Evict(nullptr);
+    }
+
+    void Store(const std::string &key, values::VectorOfValues values,
+               std::vector<size_t> item_sizes) {
+        size_t num_bytes = 0;
+        ForEachArray(values, [&](values::Array *const array, const size_t i) {
+            if (i >= item_sizes.size()) {
+                throw std::invalid_argument(
+                        "Missing item size of array of cached result.");
+            }
+            num_bytes += NumBytes(*array, item_sizes[i]);
+        });
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        Erase(key);
+
+        lru_.push_front(key);
+        auto *const entry = &entries_[key];
+        entry->values = std::move(values);
+        entry->item_sizes = std::move(item_sizes);
+        entry->num_bytes = num_bytes;
+        entry->lru_position = lru_.begin();
+        resident_bytes_ += num_bytes;
+
+        Evict(entry);
+    }
+
+    // Returns the result in the format of LookUpCachedResult
+    auto LookUp(const std::string &key) -> std::string {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto const it = entries_.find(key);
+        if (it == entries_.end()) return "";
+        auto *const entry = &it->second;
+
+        lru_.splice(lru_.begin(), lru_, entry->lru_position);
+        if (entry->is_spilled) {
+            Reload(entry);
+            Evict(entry);
+        }
+
+        // Hand out one reference like ExecutePlan. This happens while holding
+        // the lock since spilling modifies the values of the entry.
+        Increment(entry->values);
+        return values::ConvertToJsonString(entry->values);
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (!lru_.empty()) {
+            Erase(lru_.front());
+        }
+    }
+
+private:
+    struct Entry {
+        // Arrays do not hold a buffer while the entry is spilled
+        values::VectorOfValues values;
+        std::vector<size_t> item_sizes;
+        size_t num_bytes = 0;
+        bool is_spilled = false;
+        // Written when the entry is spilled for the first time
+        boost::filesystem::path spill_file{};
+        std::list<std::string>::iterator lru_position;
+    };
+
+    ResultCache() = default;
+
+    // Evicts least recently used entries other than keep until the resident
+    // entries fit into the budget. The kept entry, i.e., the one that is
+    // currently used, may exceed the budget on its own
+    void Evict(const Entry *const keep) {
+        for (auto it = lru_.rbegin();
+             resident_bytes_ > budget_ && it != lru_.rend();) {
+            auto *const entry = &entries_.at(*it);
+            if (entry == keep || entry->is_spilled) {
+                it++;
+                continue;
+            }
+
+            if (spill_directory_.empty()) {
+                // Erasing invalidates the iterator
+                auto const key = *it;
+                it++;
+                Erase(key);
+                continue;
+            }
+
+            Spill(entry);
+            it++;
+        }
+    }
+
+    void Spill(Entry *const entry) {
+        if (entry->spill_file.empty()) {
+            auto const path = spill_directory_ /
+                              ("result_cache_" +
+                               std::to_string(next_spill_id_++) + ".bin");
+            std::ofstream file(path.string(), std::ios::binary);
+            ForEachArray(entry->values,
+                         [&](values::Array *const array, const size_t i) {
+                             file.write(array->data.get(),
+                                        NumBytes(*array, entry->item_sizes[i]));
+                         });
+            if (!file) {
+                throw std::runtime_error("Could not spill cached result to " +
+                                         path.string());
+            }
+            entry->spill_file = path;
+        }
+
+        ForEachArray(entry->values,
+                     [](values::Array *const array, size_t /*i*/) {
+                         array->data = SharedPointer<char>();
+                     });
+        entry->is_spilled = true;
+        resident_bytes_ -= entry->num_bytes;
+    }
+
+    void Reload(Entry *const entry) {
+        std::ifstream file(entry->spill_file.string(), std::ios::binary);
+        ForEachArray(entry->values, [&](values::Array *const array,
+                                        const size_t i) {
+            auto const num_bytes = NumBytes(*array, entry->item_sizes[i]);
+            // Not initialized: overwritten with the contents of the file
+            auto *const buffer = new char[num_bytes];
+            array->data = SharedPointer<char>(
+                    // NOLINTNEXTLINE(modernize-avoid-c-arrays)
+                    new DefaultRefCounter<char[]>(buffer));
+            file.read(buffer, num_bytes);
+        });
+        if (!file) {
+            throw std::runtime_error("Could not reload cached result from " +
+                                     entry->spill_file.string());
+        }
+
+        entry->is_spilled = false;
+        resident_bytes_ += entry->num_bytes;
+    }
+
+    void Erase(const std::string &key) {
+        auto const it = entries_.find(key);
+        if (it == entries_.end()) return;
+        auto *const entry = &it->second;
+
+        if (!entry->is_spilled) resident_bytes_ -= entry->num_bytes;
+        if (!entry->spill_file.empty()) {
+            boost::system::error_code error;
+            boost::filesystem::remove(entry->spill_file, error);
+        }
+        lru_.erase(entry->lru_position);
+        entries_.erase(it);
+    }
+
+    std::mutex mutex_;
+    size_t budget_ = 1UL << 32U;
+    boost::filesystem::path spill_directory_{};
+    size_t resident_bytes_ = 0;
+    size_t next_spill_id_ = 0;
+    std::unordered_map<std::string, Entry> entries_{};
+    std::list<std::string> lru_{};  // Most recently used first
+};
+
+}  // namespace
+
+void ConfigureResultCache(const size_t budget,
+                          const std::string &spill_directory) {
+    ResultCache::instance()->Configure(budget, spill_directory);
+}
+
+void StoreCachedResult(const std::string &key, const std::string &values,
+                       const std::vector<size_t> &item_sizes) {
+    ResultCache::instance()->Store(
+            key, values::ConvertFromJsonString(values.c_str()), item_sizes);
+}
+
+auto LookUpCachedResult(const std::string &key) -> std::string {
+    return ResultCache::instance()->LookUp(key);
+}
+
+void ClearResultCache() { ResultCache::instance()->Clear(); }
+
+}  // namespace runtime::memory
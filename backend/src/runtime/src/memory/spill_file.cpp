@@ -0,0 +1,87 @@
+#include "runtime/jit/memory/spill_file.hpp"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace runtime::memory {
+
+namespace {
+
+auto DescribeError(const std::string &message, const std::string &path)
+        -> std::string {
+    return message + " " + path + ": " + std::strerror(errno);
+}
+
+}  // namespace
+
+SpillFile::SpillFile(const std::string &directory) {
+    std::string dir = directory;
+    if (dir.empty()) {
+        const char *const tmp_dir = std::getenv("TMPDIR");
+        dir = tmp_dir != nullptr && tmp_dir[0] != '\0' ? tmp_dir : "/tmp";
+    }
+
+    path_ = dir + "/jitq-spill-XXXXXX";
+    std::vector<char> path(path_.begin(), path_.end());
+    path.push_back('\0');
+    const int fd = mkstemp(path.data());
+    if (fd == -1) {
+        throw std::runtime_error(
+                DescribeError("Could not create spill file in", dir));
+    }
+    path_ = path.data();
+
+    // Nobody else needs to find the file, so it can go right away
+    unlink(path_.c_str());
+
+    file_ = fdopen(fd, "w+b");
+    if (file_ == nullptr) {
+        close(fd);
+        throw std::runtime_error(DescribeError("Could not open", path_));
+    }
+}
+
+SpillFile::~SpillFile() { std::fclose(file_); }
+
+void SpillFile::Write(const void *const data, const std::size_t num_bytes) {
+    if (is_reading_) {
+        if (std::fseek(file_, 0, SEEK_END) != 0) {
+            throw std::runtime_error(DescribeError("Could not seek in", path_));
+        }
+        is_reading_ = false;
+    }
+    if (std::fwrite(data, 1, num_bytes, file_) != num_bytes) {
+        throw std::runtime_error(DescribeError("Could not write to", path_));
+    }
+    num_bytes_ += num_bytes;
+}
+
+void SpillFile::Rewind() {
+    if (std::fflush(file_) != 0 || std::fseek(file_, 0, SEEK_SET) != 0) {
+        throw std::runtime_error(DescribeError("Could not rewind", path_));
+    }
+    is_reading_ = true;
+}
+
+auto SpillFile::Read(void *const data, const std::size_t num_bytes) -> bool {
+    if (!is_reading_) Rewind();
+    const std::size_t num_read = std::fread(data, 1, num_bytes, file_);
+    if (num_read == num_bytes) return true;
+    if (std::ferror(file_) != 0) {
+        throw std::runtime_error(DescribeError("Could not read from", path_));
+    }
+    if (num_read != 0) {
+        throw std::runtime_error("Truncated spill file " + path_);
+    }
+    return false;
+}
+
+}  // namespace runtime::memory
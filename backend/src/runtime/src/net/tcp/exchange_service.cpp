@@ -102,18 +102,35 @@ ExchangeService::~ExchangeService() {
     print(tag(), ": IO thread returned.");
 }
 
-void ExchangeService::StartExchange(const size_t exchange_id) {
+auto ExchangeService::GetOrCreateExchange(const size_t exchange_id)
+        -> std::shared_ptr<Exchange> {
     std::shared_ptr<Exchange> exchange(
             new Exchange{.source_ = std::make_unique<SourceChannel>(4),
                          .num_remaining_receivers_ = num_hosts()});
 
-    auto const has_emplaced =
-            emplace_exchange(exchange_id, std::move(exchange));
+    auto const has_emplaced = emplace_exchange(exchange_id, exchange);
 
     if (has_emplaced) {
         print(tag(), ": [", exchange_id, "] Just started...");
-    } else {
-        print(tag(), ": [", exchange_id, "] Had already started...");
+        return exchange;
+    }
+    print(tag(), ": [", exchange_id, "] Had already started...");
+    return this->exchange(exchange_id);
+}
+
+void ExchangeService::StartExchange(const size_t exchange_id,
+                                    const size_t num_senders) {
+    assert(num_senders <= num_hosts());
+    auto const exchange = GetOrCreateExchange(exchange_id);
+
+    // Do not wait for kEndStream from hosts outside of the exchange group
+    auto const num_non_senders = num_hosts() - num_senders;
+    if (num_non_senders > 0 &&
+        exchange->num_remaining_receivers_.fetch_sub(num_non_senders) ==
+                num_non_senders) {
+        print(tag(), ": [", exchange_id,
+              "] Received message from all other sides. Closing channel...");
+        exchange->source_->close();
     }
 }
 
@@ -199,8 +216,7 @@ void ExchangeService::RunReceiver(const std::unique_ptr<tcp::socket> socket) {
               "] Will receive message of size ", header.message_length_);
 
         auto const exchange_id = header.exchange_id_;
-        StartExchange(exchange_id);
-        auto const &exchange = this->exchange(exchange_id);
+        auto const exchange = GetOrCreateExchange(exchange_id);
         auto const &source = exchange->source_;
 
         // Handle end-of-stream
@@ -33,9 +33,10 @@ public:
     ~ExchangeService();
 
     /*
-     * Register a new exchange through its ID.
+     * Register a new exchange through its ID. The exchange ends once the given
+     * number of remote hosts have sent kEndStream.
      */
-    void StartExchange(size_t exchange_id);
+    void StartExchange(size_t exchange_id, size_t num_senders);
 
     /*
      * Finish the exchange with the given ID.
@@ -87,6 +88,13 @@ private:
         std::atomic<size_t> num_remaining_receivers_;
     };
 
+    /*
+     * Returns the exchange with the given ID, creating it if necessary. New
+     * exchanges expect kEndStream from all hosts until StartExchange sets the
+     * actual number of senders.
+     */
+    auto GetOrCreateExchange(size_t exchange_id) -> std::shared_ptr<Exchange>;
+
     /*
      * Runs the boost::asio IO service.
      */
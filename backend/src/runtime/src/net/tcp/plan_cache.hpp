@@ -0,0 +1,101 @@
+#ifndef NET_TCP_PLAN_CACHE_HPP
+#define NET_TCP_PLAN_CACHE_HPP
+
+#include <cstddef>
+
+#include <exception>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace runtime::net::tcp {
+
+/*
+ * Cache of loaded plans by key that holds at most max_size plans, evicting the
+ * least recently used one. Plans are loaded outside of the lock, so requests
+ * for other plans are not blocked by a long compilation; concurrent requests
+ * for the same plan wait for the first one to load it. Plans that fail to load
+ * are not kept, such that they can be retried. Evicted plans stay alive until
+ * their last user releases them.
+ */
+template <class Plan>
+class PlanCache {
+public:
+    using PlanPtr = std::shared_ptr<const Plan>;
+
+    explicit PlanCache(const size_t max_size) : max_size_(max_size) {}
+
+    template <class Loader>
+    auto LookUpOrLoad(const std::string &key, Loader &&load) -> PlanPtr {
+        std::shared_ptr<Entry> entry;
+        bool is_loader = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto const it = entries_.find(key);
+            if (it != entries_.end()) {
+                entry = it->second;
+                recency_.splice(recency_.begin(), recency_, entry->recency_it);
+            } else {
+                entry = std::make_shared<Entry>();
+                entry->future = entry->promise.get_future().share();
+                recency_.push_front(key);
+                entry->recency_it = recency_.begin();
+                entries_.emplace(key, entry);
+                is_loader = true;
+                EvictLeastRecentlyUsed();
+            }
+        }
+
+        if (is_loader) {
+            try {
+                entry->promise.set_value(load());
+            } catch (...) {
+                entry->promise.set_exception(std::current_exception());
+                Remove(key, entry);
+            }
+        }
+
+        return entry->future.get();
+    }
+
+    [[nodiscard]] auto size() const -> size_t {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+private:
+    struct Entry {
+        std::promise<PlanPtr> promise;
+        std::shared_future<PlanPtr> future;
+        std::list<std::string>::iterator recency_it;
+    };
+
+    void EvictLeastRecentlyUsed() {
+        while (entries_.size() > max_size_ && !recency_.empty()) {
+            entries_.erase(recency_.back());
+            recency_.pop_back();
+        }
+    }
+
+    void Remove(const std::string &key, const std::shared_ptr<Entry> &entry) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto const it = entries_.find(key);
+        if (it == entries_.end() || it->second != entry) return;
+        recency_.erase(entry->recency_it);
+        entries_.erase(it);
+    }
+
+    const size_t max_size_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Entry>> entries_;
+    // Keys from most to least recently used
+    std::list<std::string> recency_;
+};
+
+}  // namespace runtime::net::tcp
+
+#endif  // NET_TCP_PLAN_CACHE_HPP
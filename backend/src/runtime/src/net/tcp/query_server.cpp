@@ -0,0 +1,194 @@
+#include "query_server.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <arrow/buffer.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/result.h>
+#include <arrow/status.h>
+#include <boost/asio.hpp>
+#include <nlohmann/json.hpp>
+
+#include "dag/collection/tuple.hpp"
+#include "dag/operators/operator.hpp"
+#include "operators/arrow_helpers.hpp"
+#include "operators/parquet_scan_impl.hpp"
+#include "operators/result_to_record_batch.hpp"
+#include "runtime/execute_plan.hpp"
+#include "runtime/jit/values/json_parsing.hpp"
+#include "runtime/query_server.hpp"
+
+namespace runtime {
+
+void RunQueryServer(const std::string& address, const uint16_t port,
+                    const size_t batch_size, const size_t max_request_size,
+                    const size_t max_num_plans) {
+    operators::SetParquetMetaDataCacheEnabled(true);
+    net::tcp::QueryServer server(address, port, batch_size, max_request_size,
+                                 max_num_plans);
+    server.Run();
+}
+
+}  // namespace runtime
+
+namespace runtime::net::tcp {
+
+using boost::asio::ip::tcp;
+
+namespace {
+
+// Arrow output stream writing to a socket. Writes block while the client does
+// not consume the data, which throttles the producer of the stream.
+class SocketOutputStream : public arrow::io::OutputStream {
+public:
+    explicit SocketOutputStream(tcp::socket* const socket) : socket_(socket) {}
+
+    auto Close() -> arrow::Status override {
+        is_closed_ = true;
+        return arrow::Status::OK();
+    }
+
+    [[nodiscard]] auto closed() const -> bool override { return is_closed_; }
+
+    [[nodiscard]] auto Tell() const -> arrow::Result<int64_t> override {
+        return position_;
+    }
+
+    using arrow::io::OutputStream::Write;
+    auto Write(const void* const data, const int64_t nbytes)
+            -> arrow::Status override {
+        boost::system::error_code error;
+        boost::asio::write(*socket_, boost::asio::buffer(data, nbytes), error);
+        if (error) return arrow::Status::IOError(error.message());
+        position_ += nbytes;
+        return arrow::Status::OK();
+    }
+
+private:
+    tcp::socket* const socket_;
+    int64_t position_ = 0;
+    bool is_closed_ = false;
+};
+
+void SendMessage(tcp::socket* const socket, const std::string& message) {
+    const uint64_t length = message.size();
+    boost::asio::write(*socket, boost::asio::buffer(&length, sizeof(length)));
+    boost::asio::write(*socket, boost::asio::buffer(message));
+}
+
+}  // namespace
+
+QueryServer::QueryServer(const std::string& address, const uint16_t port,
+                         const size_t batch_size, const size_t max_request_size,
+                         const size_t max_num_plans)
+    : batch_size_(batch_size),
+      max_request_size_(max_request_size),
+      acceptor_(io_service_,
+                tcp::endpoint(boost::asio::ip::make_address(address), port)),
+      plans_(max_num_plans) {}
+
+void QueryServer::Run() {
+    std::cerr << "Listening on " << acceptor_.local_endpoint() << std::endl;
+    while (true) {
+        tcp::socket socket(io_service_);
+        acceptor_.accept(socket);
+        std::thread([this, s = std::move(socket)]() mutable {
+            HandleConnection(std::move(s));
+        }).detach();
+    }
+}
+
+void QueryServer::HandleConnection(tcp::socket socket) {
+    try {
+        while (true) {
+            uint64_t length = 0;
+            boost::system::error_code error;
+            boost::asio::read(socket,
+                              boost::asio::buffer(&length, sizeof(length)),
+                              error);
+            if (error == boost::asio::error::eof) return;
+            if (error) throw boost::system::system_error(error);
+
+            // Do not allocate arbitrary amounts of memory for a client
+            if (length > max_request_size_) {
+                SendMessage(&socket,
+                            nlohmann::json{
+                                    {"status", "error"},
+                                    {"message",
+                                     "Request of " + std::to_string(length) +
+                                             " bytes exceeds maximum size of " +
+                                             std::to_string(max_request_size_) +
+                                             " bytes"}}
+                                    .dump());
+                return;
+            }
+
+            std::string request(length, '\0');
+            boost::asio::read(socket, boost::asio::buffer(&request[0], length));
+
+            HandleRequest(&socket, request);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Closing connection: " << e.what() << std::endl;
+    }
+}
+
+void QueryServer::HandleRequest(tcp::socket* const socket,
+                                const std::string& request) {
+    // Keeps the plan (and its output type) alive while streaming, even if it
+    // is evicted from the cache in the meantime
+    std::shared_ptr<const LoadedPlan> plan;
+    std::unique_ptr<operators::ResultToRecordBatches> batches;
+    try {
+        auto const request_json = nlohmann::json::parse(request);
+        plan = LookUpOrLoadPlan(request_json.at("dag"));
+        auto const inputs =
+                request_json.value("inputs", nlohmann::json::array()).dump();
+        auto const result =
+                plan->functor(values::ConvertFromJsonString(inputs.c_str()));
+        assert(result.size() == 1);
+        batches = std::make_unique<operators::ResultToRecordBatches>(
+                result.at(0), plan->output_type, batch_size_);
+    } catch (const std::exception& e) {
+        SendMessage(socket,
+                    nlohmann::json{{"status", "error"}, {"message", e.what()}}
+                            .dump());
+        return;
+    }
+
+    // From here on, errors leave the stream incomplete, so the connection
+    // needs to be closed
+    SendMessage(socket, nlohmann::json{{"status", "ok"}}.dump());
+
+    SocketOutputStream stream(socket);
+    auto const writer =
+            arrow::ipc::MakeStreamWriter(&stream, batches->schema());
+    operators::ThrowIfNotOK(writer);
+    while (auto const batch = batches->next()) {
+        operators::ThrowIfNotOK((*writer)->WriteRecordBatch(*batch.value()));
+    }
+    operators::ThrowIfNotOK((*writer)->Close());
+}
+
+auto QueryServer::LookUpOrLoadPlan(const nlohmann::json& dag_json)
+        -> std::shared_ptr<const LoadedPlan> {
+    auto const dag_str = dag_json.dump();
+    return plans_.LookUpOrLoad(dag_str, [&]() {
+        std::unique_ptr<const DAG> dag(ParseDag(dag_str));
+        auto functor = LoadPlan(dag.get());
+        const auto* const output_type = dag->output().op->tuple->type;
+        return std::make_shared<const LoadedPlan>(LoadedPlan{
+                std::move(dag), std::move(functor), output_type});
+    });
+}
+
+}  // namespace runtime::net::tcp
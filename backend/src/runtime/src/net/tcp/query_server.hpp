@@ -0,0 +1,86 @@
+#ifndef NET_TCP_QUERY_SERVER_HPP
+#define NET_TCP_QUERY_SERVER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <nlohmann/json.hpp>
+
+#include "dag/dag.hpp"
+#include "dag/type/tuple.hpp"
+#include "plan_cache.hpp"
+#include "runtime/execute_plan.hpp"
+
+namespace runtime::net::tcp {
+
+class QueryServer {
+public:
+    QueryServer(const std::string& address, uint16_t port, size_t batch_size,
+                size_t max_request_size, size_t max_num_plans);
+    QueryServer(const QueryServer& other) = delete;
+    QueryServer(QueryServer&& other) noexcept = delete;
+    auto operator=(const QueryServer& other) -> QueryServer& = delete;
+    // cppcheck-suppress operatorEq  // false positive
+    auto operator=(QueryServer&& other) noexcept -> QueryServer& = delete;
+
+    ~QueryServer() = default;
+
+    /*
+     * Accepts connections forever, each of which is handled by a new thread.
+     */
+    void Run();
+
+private:
+    /*
+     * Wire format
+     *
+     * Each request consists of its length (as uint64_t in host byte order)
+     * followed by a JSON object {"dag": <DAG>, "inputs": <inputs>}, where the
+     * inputs are in the format read by the runner. Each response consists of
+     * a header in the same format, {"status": "ok"} or {"status": "error",
+     * "message": <message>}, followed, if ok, by an Arrow IPC stream with the
+     * result. A connection can send any number of requests one after another.
+     * Requests exceeding the maximum size are answered with an error, after
+     * which the connection is closed.
+     */
+    struct LoadedPlan {
+        std::unique_ptr<const DAG> dag;
+        PlanFunctor functor;
+        const dag::type::Tuple* output_type;
+    };
+
+    /*
+     * Returns the plan of the given DAG, loading it on first use.
+     */
+    auto LookUpOrLoadPlan(const nlohmann::json& dag_json)
+            -> std::shared_ptr<const LoadedPlan>;
+
+    /*
+     * Reads requests from the socket and answers them until the client closes
+     * the connection or a result cannot be streamed.
+     */
+    void HandleConnection(boost::asio::ip::tcp::socket socket);
+
+    /*
+     * Executes the given request and sends the response. Errors of the plan are
+     * sent to the client; errors while streaming the result are thrown, after
+     * which the connection cannot be used anymore.
+     */
+    void HandleRequest(boost::asio::ip::tcp::socket* socket,
+                       const std::string& request);
+
+    const size_t batch_size_;
+    const size_t max_request_size_;
+    boost::asio::io_service io_service_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+
+    // Plans by (normalized) JSON of their DAG
+    PlanCache<LoadedPlan> plans_;
+};
+
+}  // namespace runtime::net::tcp
+
+#endif  // NET_TCP_QUERY_SERVER_HPP
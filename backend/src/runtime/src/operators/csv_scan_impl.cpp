@@ -0,0 +1,503 @@
+#include "csv_scan_impl.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <future>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "arrow_helpers.hpp"
+#include "filesystem/filesystem.hpp"
+#include "runtime/jit/memory/default_ref_counter.hpp"
+#include "runtime/jit/memory/shared_pointer.hpp"
+#include "runtime/jit/values/atomics.hpp"
+#include "runtime/jit/values/none.hpp"
+#include "runtime/jit/values/tuple.hpp"
+
+namespace runtime::operators {
+
+auto MakeCsvScanOperator(std::unique_ptr<ValueOperator> upstream,
+                         const std::vector<std::string>& column_types,
+                         const std::vector<int>& col_ids, const char delimiter,
+                         const char quote, const bool has_header,
+                         const std::string& filesystem,
+                         const size_t max_num_threads) -> ValueOperator* {
+    return new CsvScanOperatorImpl(
+            std::move(upstream), filesystem::MakeFilesystem(filesystem),
+            column_types, col_ids, delimiter, quote, has_header,
+            max_num_threads);
+}
+
+namespace {
+
+auto CountChar(const char* const begin, const char* const end, const char c)
+        -> size_t {
+    size_t count = 0;
+    const char* p = begin;
+#ifdef __SSE2__
+    const __m128i pattern = _mm_set1_epi8(c);
+    for (; end - p >= static_cast<ptrdiff_t>(sizeof(__m128i));
+         p += sizeof(__m128i)) {
+        const __m128i block =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const auto mask = static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern)));
+        count += __builtin_popcount(mask);
+    }
+#endif
+    for (; p < end; p++) {
+        count += static_cast<size_t>(*p == c);
+    }
+    return count;
+}
+
+// Runs function(i) for i in [0, num_tasks) with one thread per task
+template <typename Function>
+auto RunInParallel(const size_t num_tasks, const Function& function)
+        -> std::vector<decltype(function(size_t()))> {
+    using Result = decltype(function(size_t()));
+    std::vector<std::future<Result>> futures;
+    futures.reserve(num_tasks);
+    for (size_t i = 1; i < num_tasks; i++) {
+        futures.push_back(std::async(std::launch::async, function, i));
+    }
+    std::vector<Result> results;
+    results.reserve(num_tasks);
+    results.push_back(function(0));
+    for (auto& future : futures) {
+        results.push_back(future.get());
+    }
+    return results;
+}
+
+template <typename T>
+auto ParseNumber(const char* begin, const char* end) -> T {
+    while (begin < end && *begin == ' ') begin++;
+    while (end > begin && *(end - 1) == ' ') end--;
+
+    T value{};
+    bool is_valid = false;
+    if constexpr (std::is_integral_v<T>) {
+        auto const [ptr, ec] = std::from_chars(begin, end, value);
+        is_valid = begin != end && ec == std::errc() && ptr == end;
+    } else {
+        // strtod needs a null-terminated string
+        std::array<char, 64> str{};
+        const size_t length = end - begin;
+        if (length > 0 && length < str.size()) {
+            std::memcpy(str.data(), begin, length);
+            char* str_end = nullptr;
+            if constexpr (std::is_same_v<T, float>) {
+                value = std::strtof(str.data(), &str_end);
+            } else {
+                value = std::strtod(str.data(), &str_end);
+            }
+            is_valid = str_end == str.data() + length;
+        }
+    }
+
+    if (!is_valid) {
+        throw std::runtime_error("Could not parse value '" +
+                                 std::string(begin, end) + "' in CSV file.");
+    }
+    return value;
+}
+
+template <typename T>
+auto AllocateArray(const size_t capacity, char** const data)
+        -> std::shared_ptr<values::Array> {
+    // Not initialized: all elements are overwritten by the parser
+    auto* const elements = new T[capacity];
+    auto ret = std::make_shared<values::Array>();
+    ret->data = memory::SharedPointer<char>(
+            // NOLINTNEXTLINE(modernize-avoid-c-arrays)
+            new memory::DefaultRefCounter<T[]>(elements));
+    *data = reinterpret_cast<char*>(elements);
+    return ret;
+}
+
+template <typename T>
+void ParseInto(const char* const begin, const char* const end,
+               char* const data, const size_t row) {
+    reinterpret_cast<T*>(data)[row] = ParseNumber<T>(begin, end);
+}
+
+}  // namespace
+
+auto CountCsvQuotes(const char* const begin, const char* const end,
+                    const char quote) -> size_t {
+    return CountChar(begin, end, quote);
+}
+
+auto FindCsvRecordEnd(const char* const begin, const char* const end,
+                      const char quote, bool* const in_quotes) -> const char* {
+    bool is_quoted = *in_quotes;
+    const char* p = begin;
+#ifdef __SSE2__
+    const __m128i quotes = _mm_set1_epi8(quote);
+    const __m128i line_breaks = _mm_set1_epi8('\n');
+    for (; end - p >= static_cast<ptrdiff_t>(sizeof(__m128i));
+         p += sizeof(__m128i)) {
+        const __m128i block =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const auto quote_mask = static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(block, quotes)));
+        const auto line_break_mask = static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(block, line_breaks)));
+
+        // Bit i of the prefix XOR of the quote mask is set if an odd number
+        // of quotes precede byte i (inclusive), i.e., if it is quoted
+        uint32_t quoted_mask = quote_mask;
+        quoted_mask ^= quoted_mask << 1U;
+        quoted_mask ^= quoted_mask << 2U;
+        quoted_mask ^= quoted_mask << 4U;
+        quoted_mask ^= quoted_mask << 8U;
+        if (is_quoted) quoted_mask = ~quoted_mask;
+
+        const uint32_t record_ends = line_break_mask & ~quoted_mask & 0xFFFFU;
+        if (record_ends != 0) {
+            *in_quotes = false;
+            return p + __builtin_ctz(record_ends);
+        }
+        is_quoted ^= (__builtin_popcount(quote_mask) & 1U) != 0;
+    }
+#endif
+    for (; p < end; p++) {
+        if (*p == quote) {
+            is_quoted = !is_quoted;
+        } else if (*p == '\n' && !is_quoted) {
+            *in_quotes = false;
+            return p;
+        }
+    }
+    *in_quotes = is_quoted;
+    return end;
+}
+
+CsvScanOperatorImpl::CsvScanOperatorImpl(
+        std::unique_ptr<ValueOperator> upstream,
+        std::unique_ptr<filesystem::FileSystem> fs,
+        const std::vector<std::string>& column_types,
+        const std::vector<int>& col_ids, const char delimiter,
+        const char quote, const bool has_header, const size_t max_num_threads)
+    : upstream_(std::move(upstream)),
+      fs_(std::move(fs)),
+      delimiter_(delimiter),
+      quote_(quote),
+      has_header_(has_header),
+      max_num_threads_(std::max<size_t>(1, max_num_threads)) {
+    assert(column_types.size() == col_ids.size());
+    for (size_t i = 0; i < col_ids.size(); i++) {
+        columns_.push_back(column_infos().at(column_types.at(i)));
+        const auto field = static_cast<size_t>(col_ids.at(i));
+        if (field >= field_columns_.size()) field_columns_.resize(field + 1);
+        field_columns_[field].push_back(i);
+    }
+}
+
+auto CsvScanOperatorImpl::column_infos()
+        -> const std::map<std::string, ColumnInfo>& {
+    static const std::map<std::string, ColumnInfo> map = {
+            {"int", {&AllocateArray<int32_t>, &ParseInto<int32_t>}},
+            {"long", {&AllocateArray<int64_t>, &ParseInto<int64_t>}},
+            {"float", {&AllocateArray<float>, &ParseInto<float>}},
+            {"double", {&AllocateArray<double>, &ParseInto<double>}}};
+    return map;
+}
+
+void CsvScanOperatorImpl::open() { upstream_->open(); }
+
+auto CsvScanOperatorImpl::next() -> std::shared_ptr<runtime::values::Value> {
+    while (batches_.empty()) {
+        if (!has_slice_ && !OpenNextSlice()) {
+            return std::make_shared<runtime::values::None>();
+        }
+        if (has_slice_) ReadWindow();
+    }
+
+    auto ret = std::move(batches_.front());
+    batches_.pop_front();
+    return ret;
+}
+
+void CsvScanOperatorImpl::close() {
+    file_.reset();
+    buffer_ = {};
+    upstream_->close();
+}
+
+auto CsvScanOperatorImpl::OpenNextSlice() -> bool {
+    auto const input = upstream_->next();
+    if (dynamic_cast<values::None*>(input.get()) != nullptr) {
+        return false;
+    }
+
+    auto const& fields = input->as<values::Tuple>()->fields;
+    auto const file_path = fields.at(0)->as<values::String>()->value;
+    const int64_t slice_from = fields.at(1)->as<values::Int64>()->value;
+    const int64_t slice_to = fields.at(2)->as<values::Int64>()->value;
+    const int64_t num_slices = fields.at(3)->as<values::Int64>()->value;
+
+    file_ = fs_->OpenForRead(file_path);
+    auto const file_size = file_->GetSize();
+    ThrowIfNotOK(file_size);
+    file_size_ = file_size.ValueUnsafe();
+
+    // The slice consists of the records starting in its byte range. Its first
+    // record thus starts after the first line break at or after the byte
+    // preceding that range. The quoting state at that byte is unknown, so that
+    // line break is assumed not to be quoted
+    const int64_t slice_begin = file_size_ * slice_from / num_slices;
+    slice_end_ = file_size_ * slice_to / num_slices;
+    if (slice_begin == 0) {
+        position_ = has_header_ ? ScanToRecordStart(0, false, false) : 0;
+    } else {
+        position_ = ScanToRecordStart(slice_begin - 1, std::nullopt, false);
+    }
+
+    has_slice_ = position_ < slice_end_;
+    return true;
+}
+
+void CsvScanOperatorImpl::ReadWindow() {
+    assert(has_slice_);
+    assert(position_ < slice_end_);
+
+    const int64_t window_end = std::min(position_ + window_size_, slice_end_);
+    const int64_t size = window_end - position_;
+    buffer_.resize(size);
+    ReadFully(position_, size, buffer_.data());
+
+    // Count the quotes of equally-sized chunks in parallel to know whether
+    // their first bytes are quoted
+    const auto max_num_chunks = static_cast<int64_t>(max_num_threads_);
+    const auto num_chunks = static_cast<size_t>(std::clamp<int64_t>(
+            size / min_chunk_size_, 1, max_num_chunks));
+
+    std::vector<int64_t> splits(num_chunks + 1);
+    for (size_t i = 0; i <= num_chunks; i++) {
+        splits[i] = size * static_cast<int64_t>(i) /
+                    static_cast<int64_t>(num_chunks);
+    }
+
+    auto const num_quotes = RunInParallel(num_chunks, [&](const size_t i) {
+        return CountCsvQuotes(buffer_.data() + splits[i],
+                              buffer_.data() + splits[i + 1], quote_);
+    });
+
+    std::vector<bool> is_split_quoted(num_chunks + 1, false);
+    for (size_t i = 0; i < num_chunks; i++) {
+        is_split_quoted[i + 1] =
+                is_split_quoted[i] != ((num_quotes[i] & 1U) != 0);
+    }
+
+    // The records of this window end at the first record start at or after
+    // its end, for which we may need to read further
+    bool in_quotes =
+            is_split_quoted[num_chunks] != (buffer_[size - 1] == quote_);
+    int64_t records_end = size;
+    {
+        const char* const last = buffer_.data() + size - 1;
+        if (FindCsvRecordEnd(last, last + 1, quote_, &in_quotes) != last) {
+            records_end =
+                    ScanToRecordStart(window_end, in_quotes, true) - position_;
+        }
+    }
+    assert(static_cast<int64_t>(buffer_.size()) == records_end);
+
+    // Move the splits to the next record start, which only depends on the
+    // quoting state at the split
+    const char* const data = buffer_.data();
+    std::vector<const char*> boundaries(num_chunks + 1);
+    boundaries[0] = data;
+    boundaries[num_chunks] = data + records_end;
+    for (size_t i = 1; i < num_chunks; i++) {
+        bool is_quoted = is_split_quoted[i];
+        const char* const record_end = FindCsvRecordEnd(
+                data + splits[i], data + records_end, quote_, &is_quoted);
+        boundaries[i] = record_end == data + records_end ? record_end
+                                                         : record_end + 1;
+    }
+
+    // Parse the chunks in parallel
+    auto chunks = RunInParallel(num_chunks, [&](const size_t i) {
+        return ParseChunk(boundaries[i], boundaries[i + 1]);
+    });
+    for (auto& chunk : chunks) {
+        if (chunk) batches_.push_back(std::move(chunk));
+    }
+
+    position_ += records_end;
+    has_slice_ = position_ < slice_end_;
+}
+
+auto CsvScanOperatorImpl::ParseChunk(const char* const begin,
+                                     const char* const end) const
+        -> std::shared_ptr<values::Value> {
+    // Every record but the last one ends with a line break
+    const size_t capacity = CountChar(begin, end, '\n') + 1;
+
+    std::vector<std::shared_ptr<values::Array>> arrays;
+    std::vector<char*> data(columns_.size());
+    for (size_t i = 0; i < columns_.size(); i++) {
+        arrays.push_back(columns_[i].allocate(capacity, &data[i]));
+    }
+
+    const size_t num_fields = field_columns_.size();
+    size_t num_rows = 0;
+    const char* p = begin;
+    while (p < end) {
+        // Skip empty lines
+        if (*p == '\n') {
+            p++;
+            continue;
+        }
+        if (*p == '\r' && p + 1 < end && *(p + 1) == '\n') {
+            p += 2;
+            continue;
+        }
+
+        size_t field = 0;
+        while (true) {
+            const char* field_begin = p;
+            const char* field_end = p;
+            if (p < end && *p == quote_) {
+                // Quoted field: ends at the first quote not followed by
+                // another one
+                const char* q = p + 1;
+                while (true) {
+                    q = static_cast<const char*>(
+                            std::memchr(q, quote_, end - q));
+                    if (q == nullptr) {
+                        throw std::runtime_error(
+                                "Unterminated quoted field in CSV file.");
+                    }
+                    if (q + 1 < end && *(q + 1) == quote_) {
+                        q += 2;
+                        continue;
+                    }
+                    break;
+                }
+                field_begin = p + 1;
+                field_end = q;
+                p = q + 1;
+            } else {
+                while (p < end && *p != delimiter_ && *p != '\n') p++;
+                field_end = p;
+                if (field_end > field_begin && *(field_end - 1) == '\r') {
+                    field_end--;
+                }
+            }
+
+            if (field < num_fields) {
+                for (auto const c : field_columns_[field]) {
+                    columns_[c].parse(field_begin, field_end, data[c],
+                                      num_rows);
+                }
+            }
+            field++;
+
+            if (p == end) break;
+            if (*p == delimiter_) {
+                p++;
+                continue;
+            }
+            if (*p == '\r' && (p + 1 == end || *(p + 1) == '\n')) p++;
+            if (p == end) break;
+            if (*p == '\n') {
+                p++;
+                break;
+            }
+            throw std::runtime_error(
+                    "Unexpected character after quoted field in CSV file.");
+        }
+
+        if (field < num_fields) {
+            throw std::runtime_error("CSV record has " + std::to_string(field) +
+                                     " fields but at least " +
+                                     std::to_string(num_fields) +
+                                     " are required.");
+        }
+        num_rows++;
+    }
+    assert(num_rows <= capacity);
+
+    if (num_rows == 0) return {};
+
+    auto ret = std::make_shared<values::Tuple>();
+    for (auto& array : arrays) {
+        array->outer_shape = {num_rows};
+        array->offsets = {0};
+        array->shape = {num_rows};
+        ret->fields.emplace_back(std::move(array));
+    }
+    return ret;
+}
+
+auto CsvScanOperatorImpl::ScanToRecordStart(const int64_t from,
+                                            std::optional<bool> in_quotes,
+                                            const bool append) -> int64_t {
+    std::vector<char> block;
+    for (int64_t position = from; position < file_size_;) {
+        const int64_t size = std::min(scan_block_size_, file_size_ - position);
+        char* data = nullptr;
+        if (append) {
+            buffer_.resize(buffer_.size() + size);
+            data = buffer_.data() + buffer_.size() - size;
+        } else {
+            block.resize(size);
+            data = block.data();
+        }
+        ReadFully(position, size, data);
+
+        const char* record_end = data + size;
+        if (in_quotes.has_value()) {
+            record_end = FindCsvRecordEnd(data, data + size, quote_,
+                                          &in_quotes.value());
+        } else if (const auto* const line_break = static_cast<const char*>(
+                           std::memchr(data, '\n', size))) {
+            record_end = line_break;
+        }
+        if (record_end != data + size) {
+            const int64_t num_consumed = record_end + 1 - data;
+            if (append) buffer_.resize(buffer_.size() - (size - num_consumed));
+            return position + num_consumed;
+        }
+        position += size;
+    }
+    return file_size_;
+}
+
+void CsvScanOperatorImpl::ReadFully(int64_t position, int64_t nbytes,
+                                    char* out) {
+    while (nbytes > 0) {
+        auto const num_read = file_->ReadAt(position, nbytes, out);
+        ThrowIfNotOK(num_read);
+        if (num_read.ValueUnsafe() == 0) {
+            throw std::runtime_error("Unexpected end of CSV file.");
+        }
+        position += num_read.ValueUnsafe();
+        nbytes -= num_read.ValueUnsafe();
+        out += num_read.ValueUnsafe();
+    }
+}
+
+}  // namespace runtime::operators
@@ -0,0 +1,94 @@
+#ifndef OPERATORS_CSV_SCAN_IMPL_HPP
+#define OPERATORS_CSV_SCAN_IMPL_HPP
+
+#include <cstdint>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <arrow/io/interfaces.h>
+
+#include "filesystem/filesystem.hpp"
+#include "runtime/jit/operators/csv_scan.hpp"
+#include "runtime/jit/operators/value_operator.hpp"
+#include "runtime/jit/values/array.hpp"
+#include "runtime/jit/values/value.hpp"
+
+namespace runtime {
+namespace operators {
+
+class CsvScanOperatorImpl : public ValueOperator {
+public:
+    CsvScanOperatorImpl(std::unique_ptr<ValueOperator> upstream,
+                        std::unique_ptr<filesystem::FileSystem> fs,
+                        const std::vector<std::string>& column_types,
+                        const std::vector<int>& col_ids, char delimiter,
+                        char quote, bool has_header, size_t max_num_threads);
+
+    void open() override;
+    auto next() -> std::shared_ptr<runtime::values::Value> override;
+    void close() override;
+
+private:
+    // Allocates an uninitialized array with the given capacity and returns a
+    // pointer to its data
+    using AllocateFunction = std::shared_ptr<values::Array> (*)(size_t capacity,
+                                                                char** data);
+    // Parses the field [begin, end) into the row-th element of data
+    using ParseFunction = void (*)(const char* begin, const char* end,
+                                   char* data, size_t row);
+
+    struct ColumnInfo {
+        AllocateFunction allocate;
+        ParseFunction parse;
+    };
+
+    static auto column_infos() -> const std::map<std::string, ColumnInfo>&;
+
+    auto OpenNextSlice() -> bool;
+    void ReadWindow();
+    auto ParseChunk(const char* begin, const char* end) const
+            -> std::shared_ptr<values::Value>;
+
+    // Returns the position after the first line break outside of quotes at or
+    // after from, or the file size, appending what was read to buffer_ if
+    // append is set. If the quoting state at from is unknown, the first line
+    // break is taken
+    auto ScanToRecordStart(int64_t from, std::optional<bool> in_quotes,
+                           bool append) -> int64_t;
+    void ReadFully(int64_t position, int64_t nbytes, char* out);
+
+    // Operator configuration
+    const std::unique_ptr<ValueOperator> upstream_;
+    const std::unique_ptr<filesystem::FileSystem> fs_;
+    std::vector<ColumnInfo> columns_;
+    // Output columns of each field of the file
+    std::vector<std::vector<size_t>> field_columns_;
+    const char delimiter_;
+    const char quote_;
+    const bool has_header_;
+    const size_t max_num_threads_;
+    const int64_t window_size_ = 1L << 25U;
+    const int64_t min_chunk_size_ = 1L << 20U;
+    const int64_t scan_block_size_ = 1L << 16U;
+
+    // Current slice
+    bool has_slice_ = false;
+    std::shared_ptr<arrow::io::RandomAccessFile> file_;
+    int64_t file_size_ = 0;
+    int64_t position_ = 0;  // Start of the next record
+    int64_t slice_end_ = 0;
+    std::vector<char> buffer_;
+
+    // Parsed chunks that have not been returned yet
+    std::deque<std::shared_ptr<values::Value>> batches_;
+};
+
+}  // namespace operators
+}  // namespace runtime
+
+#endif  // OPERATORS_CSV_SCAN_IMPL_HPP
@@ -0,0 +1,121 @@
+#include "runtime/jit/operators/exchange_levels.hpp"
+
+#include <cassert>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace runtime::operators {
+
+auto ExchangeCostModel::Cost(const std::vector<size_t> &fanouts) const
+        -> double {
+    double cost = 0;
+    for (auto const fanout : fanouts) {
+        cost += level_cost + request_cost * static_cast<double>(1 + fanout);
+    }
+    return cost;
+}
+
+namespace {
+
+// Enumerates all ways to write num_workers as a product of num_levels
+// ascending factors, each at least min_factor, and keeps the cheapest one
+void FindCheapestFactorization(const size_t num_workers,
+                               const size_t num_levels,
+                               const size_t min_factor,
+                               const ExchangeCostModel &cost_model,
+                               std::vector<size_t> *const factors,
+                               std::vector<size_t> *const best_factors,
+                               double *const best_cost) {
+    if (num_levels == 1) {
+        if (num_workers < min_factor) return;
+        factors->push_back(num_workers);
+        auto const cost = cost_model.Cost(*factors);
+        if (cost < *best_cost) {
+            *best_cost = cost;
+            *best_factors = *factors;
+        }
+        factors->pop_back();
+        return;
+    }
+
+    for (size_t f = min_factor; f * f <= num_workers; f++) {
+        if (num_workers % f != 0) continue;
+        factors->push_back(f);
+        FindCheapestFactorization(num_workers / f, num_levels - 1, f,
+                                  cost_model, factors, best_factors, best_cost);
+        factors->pop_back();
+    }
+}
+
+}  // namespace
+
+auto ComputeExchangeLevelFanouts(const size_t num_levels,
+                                 const size_t num_workers,
+                                 const ExchangeCostModel &cost_model)
+        -> std::vector<size_t> {
+    assert(num_levels > 0);
+    assert(num_workers > 0);
+
+    std::vector<size_t> factors;
+    std::vector<size_t> best_factors;
+    double best_cost = std::numeric_limits<double>::infinity();
+    FindCheapestFactorization(num_workers, num_levels, 1, cost_model, &factors,
+                              &best_factors, &best_cost);
+
+    assert(best_factors.size() == num_levels);
+    assert(std::accumulate(best_factors.begin(), best_factors.end(), 1UL,
+                           std::multiplies<>()) == num_workers);
+    return best_factors;
+}
+
+auto ComputeExchangeNumLevels(const size_t num_workers,
+                              const size_t max_num_levels,
+                              const ExchangeCostModel &cost_model) -> size_t {
+    assert(max_num_levels > 0);
+
+    size_t best_num_levels = 1;
+    double best_cost = std::numeric_limits<double>::infinity();
+    for (size_t num_levels = 1; num_levels <= max_num_levels; num_levels++) {
+        auto const fanouts =
+                ComputeExchangeLevelFanouts(num_levels, num_workers, cost_model);
+        auto const cost = cost_model.Cost(fanouts);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_num_levels = num_levels;
+        }
+    }
+    return best_num_levels;
+}
+
+auto ComputeExchangeGroupMembers(const size_t num_levels,
+                                 const size_t level_num,
+                                 const size_t num_workers,
+                                 const size_t worker_id)
+        -> std::vector<size_t> {
+    assert(level_num < num_levels);
+    assert(worker_id < num_workers);
+
+    auto const fanouts = ComputeExchangeLevelFanouts(num_levels, num_workers);
+
+    // Level 0 exchanges along the last (i.e., largest) dimension
+    const size_t dimension = num_levels - 1 - level_num;
+    const size_t stride = std::accumulate(fanouts.begin(),
+                                          fanouts.begin() + dimension, 1UL,
+                                          std::multiplies<>());
+    const size_t fanout = fanouts[dimension];
+
+    const size_t coordinate = worker_id / stride % fanout;
+    const size_t first_member = worker_id - coordinate * stride;
+
+    std::vector<size_t> group_members;
+    group_members.reserve(fanout);
+    for (size_t i = 0; i < fanout; i++) {
+        group_members.push_back(first_member + i * stride);
+    }
+    return group_members;
+}
+
+}  // namespace runtime::operators
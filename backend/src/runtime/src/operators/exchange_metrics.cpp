@@ -0,0 +1,76 @@
+#include "exchange_metrics.hpp"
+
+#include <cstdlib>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "runtime/jit/trace.hpp"
+
+namespace runtime::operators {
+
+// Partitions with more than this factor times the average number of rows are
+// reported as heavy
+constexpr double kHeavyPartitionFactor = 2.0;
+
+ExchangePartitionHistogram::ExchangePartitionHistogram(
+        std::string exchange_type, const size_t exchange_id,
+        const size_t level_num, const size_t worker_id,
+        std::vector<size_t> receiver_ids)
+    : exchange_type_(std::move(exchange_type)),
+      exchange_id_(exchange_id),
+      level_num_(level_num),
+      worker_id_(worker_id),
+      receiver_ids_(std::move(receiver_ids)),
+      num_rows_(receiver_ids_.size(), 0) {}
+
+auto ExchangePartitionHistogram::IsEnabled() -> bool {
+    static const char *const kMetricsVarName = "JITQ_EXCHANGE_METRICS";
+    static const bool is_enabled = std::getenv(kMetricsVarName) != nullptr;
+    return is_enabled;
+}
+
+void ExchangePartitionHistogram::Report() const {
+    if (!IsEnabled()) return;
+
+    const size_t total_rows =
+            std::accumulate(num_rows_.begin(), num_rows_.end(), size_t{0});
+    const size_t max_rows =
+            num_rows_.empty()
+                    ? 0
+                    : *std::max_element(num_rows_.begin(), num_rows_.end());
+    const double mean_rows =
+            num_rows_.empty() ? 0.0
+                              : static_cast<double>(total_rows) /
+                                        static_cast<double>(num_rows_.size());
+
+    std::vector<size_t> heavy_receivers;
+    for (size_t i = 0; i < num_rows_.size(); i++) {
+        if (static_cast<double>(num_rows_[i]) >
+            kHeavyPartitionFactor * mean_rows) {
+            heavy_receivers.push_back(receiver_ids_[i]);
+        }
+    }
+
+    nlohmann::json metrics;
+    metrics["exchange_type"] = exchange_type_;
+    metrics["exchange_id"] = exchange_id_;
+    metrics["level_num"] = level_num_;
+    metrics["worker_id"] = worker_id_;
+    metrics["receiver_ids"] = receiver_ids_;
+    metrics["partition_sizes"] = num_rows_;
+    metrics["total_rows"] = total_rows;
+    metrics["max_rows"] = max_rows;
+    metrics["skew"] = mean_rows > 0 ? static_cast<double>(max_rows) / mean_rows
+                                    : 1.0;
+    metrics["heavy_receivers"] = heavy_receivers;
+
+    Trace("exchange_metrics " + metrics.dump());
+}
+
+}  // namespace runtime::operators
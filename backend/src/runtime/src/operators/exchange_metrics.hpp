@@ -0,0 +1,41 @@
+#ifndef OPERATORS_EXCHANGE_METRICS_HPP
+#define OPERATORS_EXCHANGE_METRICS_HPP
+
+#include <string>
+#include <vector>
+
+namespace runtime::operators {
+
+/*
+ * Histogram of the number of rows one sender of an exchange ships to each of
+ * its receivers. Skew in this histogram means that some receivers get (much)
+ * more work than others, typically because of heavy-hitter keys. If the
+ * environment variable JITQ_EXCHANGE_METRICS is set, Report() writes the
+ * histogram as a single JSON line to the trace output.
+ */
+class ExchangePartitionHistogram {
+public:
+    ExchangePartitionHistogram(std::string exchange_type, size_t exchange_id,
+                               size_t level_num, size_t worker_id,
+                               std::vector<size_t> receiver_ids);
+
+    void Add(const size_t partition, const size_t num_rows) {
+        num_rows_.at(partition) += num_rows;
+    }
+
+    void Report() const;
+
+    static auto IsEnabled() -> bool;
+
+private:
+    const std::string exchange_type_;
+    const size_t exchange_id_;
+    const size_t level_num_;
+    const size_t worker_id_;
+    const std::vector<size_t> receiver_ids_;
+    std::vector<size_t> num_rows_;
+};
+
+}  // namespace runtime::operators
+
+#endif  // OPERATORS_EXCHANGE_METRICS_HPP
@@ -1,8 +1,8 @@
 #include "exchange_s3.hpp"
 
-#include <cmath>
-
+#include <algorithm>
 #include <chrono>
+#include <future>
 #include <memory>
 #include <string>
 #include <thread>
@@ -12,16 +12,17 @@
 
 #include <arrow/record_batch.h>
 #include <arrow/table.h>
-#include <aws/s3/model/HeadObjectRequest.h>
 #include <aws/s3/model/ListObjectsRequest.h>
+#include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
-#include <boost/range/algorithm/copy.hpp>
-#include <boost/range/irange.hpp>
 #include <parquet/arrow/writer.h>
 
 #include "aws/s3.hpp"
 #include "filesystem/filesystem.hpp"
+#include "memory/arrow_memory_pool.hpp"
 #include "operators/arrow_helpers.hpp"
+#include "operators/exchange_metrics.hpp"
+#include "runtime/jit/operators/exchange_levels.hpp"
 #include "runtime/jit/operators/exchange_s3.hpp"
 #include "runtime/jit/values/atomics.hpp"
 #include "runtime/jit/values/json_parsing.hpp"
@@ -86,6 +87,14 @@ auto ExchangeS3Operator::LookupBucketName() -> std::string {
     return bucket_name;
 }
 
+auto ExchangeS3Operator::LookupMemoryLimit() -> size_t {
+    static const char *const kMemoryLimitVarName =
+            "JITQ_EXCHANGE_S3_MEMORY_LIMIT";
+    auto *const memory_limit = std::getenv(kMemoryLimitVarName);
+    if (memory_limit == nullptr) return 0;
+    return std::stoull(memory_limit);
+}
+
 void ExchangeS3Operator::open() {
     // Read degree of parallelism
     {
@@ -127,74 +136,56 @@ void ExchangeS3Operator::open() {
 
 auto ExchangeS3Operator::next() -> std::shared_ptr<values::Value> {
     // This is the first call to next --> consume upstream
-    if (pending_results_.empty() && returned_results_.empty()) {
-        std::vector<std::string> group_member_strs;
-        for (auto const i : group_members_) {
-            group_member_strs.push_back(std::to_string(i));
-        }
+    if (!has_consumed_upstream_) {
+        has_consumed_upstream_ = true;
 
-        // Produce our output file
+        // Produce our output file(s)
         ConsumeUpstream();
 
-        // Spawn asynchronous tasks each waiting for an input file
-        for (size_t i = 0; i < group_size_; i++) {
-            pending_results_.emplace_back(std::async(
-                    [&](auto const i) {
-                        auto const sender_id = group_members_.at(i);
-                        return WaitForFile(sender_id);
-                    },
-                    i));
+        pending_senders_.insert(group_members_.begin(), group_members_.end());
+
+        // Our own file is readable right away
+        if (!is_streaming()) {
+            MarkFileReady(FileKey(worker_id_), ListPrefix());
         }
     }
 
-    // We have returned all results --> signal end-of-stream
-    if (pending_results_.empty()) {
-        return std::make_shared<values::None>();
+    // Wait until (at least) one more file is ready
+    if (ready_files_.empty() && !pending_senders_.empty()) {
+        WaitForFiles();
     }
 
-    const auto *const filesystem = "s3";
-    auto const fs = filesystem::MakeFilesystem(filesystem);
-
-    // Wait until (at least) one file is ready
-    std::string file_name;
-    while (true) {
-        for (auto it = pending_results_.begin(); it != pending_results_.end();
-             it++) {
-            auto &future = *it;
-            if (future.wait_for(std::chrono::seconds(0)) ==
-                std::future_status::ready) {
-                file_name = future.get();
-                pending_results_.erase(it);
-                break;
-            }
-        }
-
-        if (!file_name.empty()) break;
-
-        // Files not ready yet --> wait a bit before retrying
-        if (pending_results_.empty()) {
-            using namespace std::chrono_literals;
-            std::this_thread::sleep_for(500ms);
-        }
+    // We have returned all results --> signal end-of-stream
+    if (ready_files_.empty()) {
+        assert(pending_senders_.empty());
+        return std::make_shared<values::None>();
     }
 
-    auto const [it, has_inserted] = returned_results_.insert(file_name);
-    assert(has_inserted);
+    auto const file_name = ready_files_.front();
+    ready_files_.pop();
 
     auto const file_path = std::make_shared<values::String>();
     auto const slice_from = std::make_shared<values::Int64>();
     auto const slice_to = std::make_shared<values::Int64>();
     auto const num_slices = std::make_shared<values::Int64>();
 
-    for (size_t i = 0; i < group_members_.size(); i++) {
-        if (group_members_.at(i) == worker_id_) {
-            slice_from->value = i;
-            slice_to->value = i + 1;
+    if (is_streaming()) {
+        // Files of streaming mode contain only data for this worker
+        slice_from->value = 0;
+        slice_to->value = 1;
+        num_slices->value = 1;
+    } else {
+        // Otherwise, files contain one row group per receiver
+        for (size_t i = 0; i < group_members_.size(); i++) {
+            if (group_members_.at(i) == worker_id_) {
+                slice_from->value = i;
+                slice_to->value = i + 1;
+            }
         }
+        num_slices->value = group_size_;
     }
 
     file_path->value = file_name;
-    num_slices->value = group_size_;
 
     auto const ret = std::make_shared<values::Tuple>();
     ret->fields = {file_path, slice_from, slice_to, num_slices};
@@ -206,26 +197,8 @@ auto ExchangeS3Operator::ComputeGroupMembers(const size_t num_levels,
                                              const size_t num_workers,
                                              const size_t worker_id)
         -> std::vector<size_t> {
-    std::vector<size_t> group_members;
-    if (num_levels == 1) {
-        boost::copy(boost::irange(0UL, num_workers),
-                    std::inserter(group_members, group_members.begin()));
-    } else if (num_levels == 2 && level_num == 0) {
-        const auto num_groups = static_cast<size_t>(sqrt(num_workers));
-        const size_t group_id = worker_id % num_groups;
-        for (size_t i = 0; i < num_workers; i++) {
-            if (i % num_groups == group_id) group_members.push_back(i);
-        }
-    } else if (num_levels == 2 && level_num == 1) {
-        const auto num_groups = static_cast<size_t>(sqrt(num_workers));
-        const size_t group_id = worker_id / num_groups;
-        for (size_t i = 0; i < num_workers; i++) {
-            if (i / num_groups == group_id) group_members.push_back(i);
-        }
-    } else {
-        assert(false);
-    }
-    return group_members;
+    return ComputeExchangeGroupMembers(num_levels, level_num, num_workers,
+                                       worker_id);
 }
 
 auto ExchangeS3Operator::ComputeGroupSize(const size_t num_levels,
@@ -236,34 +209,104 @@ auto ExchangeS3Operator::ComputeGroupSize(const size_t num_levels,
             .size();
 }
 
-auto ExchangeS3Operator::WaitForFile(const size_t sender_id) const
+auto ExchangeS3Operator::GroupPrefix() const -> std::string {
+    // All senders of a group write below a common prefix, so a single listing
+    // request reveals which of them are done
+    return (boost::format("jitq/query-%1%/exchange-%2%/group-%3%/") %
+            query_id_ % exchange_id_ % group_members_.front())
+            .str();
+}
+
+auto ExchangeS3Operator::ListPrefix() const -> std::string {
+    if (!is_streaming()) return GroupPrefix();
+    return (boost::format("%1%to-%2%/") % GroupPrefix() % worker_id_).str();
+}
+
+auto ExchangeS3Operator::FileKey(const size_t sender_id) const
         -> std::string {
-    auto const file_name = (boost::format("jitq/query-%1%/exchange-%2%/"
-                                          "%3%.parquet") %
-                            query_id_ % exchange_id_ % sender_id)
-                                   .str();
-
-    Aws::S3::Model::HeadObjectRequest request;
-    request.WithBucket(bucket_name_).WithKey(file_name);
-    request.SetResponseStreamFactory(
-            []() { return Aws::New<Aws::StringStream>("exchange"); });
-
-    for (size_t j = 0; true; j++) {
-        const auto outcome = s3_client_->HeadObject(request);
-        if (outcome.IsSuccess()) break;
-
-        using namespace std::chrono_literals;
-        // NOLINTNEXTLINE(readability-magic-numbers)
-        std::this_thread::sleep_for(100ms * (1UL << std::min(j, 2UL)));
+    return (boost::format("%1%%2%.parquet") % GroupPrefix() % sender_id).str();
+}
+
+auto ExchangeS3Operator::ChunkKey(const size_t receiver_id,
+                                  const size_t chunk_num,
+                                  const bool is_last) const -> std::string {
+    return (boost::format("%1%to-%2%/%3%.%4%%5%.parquet") % GroupPrefix() %
+            receiver_id % worker_id_ % chunk_num % (is_last ? ".last" : ""))
+            .str();
+}
+
+void ExchangeS3Operator::MarkFileReady(const std::string &key,
+                                       const std::string &prefix) {
+    // Each file becomes ready the first time we see it
+    if (!seen_keys_.insert(key).second) return;
+    ready_files_.push(
+            (boost::format("s3://%1%/%2%") % bucket_name_ % key).str());
+
+    // Parse "<sender>.parquet" (one file per sender) or
+    // "<sender>.<chunk>[.last].parquet" (streaming mode)
+    std::vector<std::string> tokens;
+    auto const file_name = key.substr(prefix.size());
+    boost::split(tokens, file_name, boost::is_any_of("."));
+    const size_t sender_id = std::stoull(tokens.at(0));
+    const bool is_last = tokens.size() != 3;
+    const size_t chunk_num = tokens.size() > 2 ? std::stoull(tokens.at(1)) : 0;
+
+    // The sender is done once we have seen all of its chunks
+    auto &num_seen_chunks = num_seen_chunks_[sender_id];
+    num_seen_chunks++;
+    if (is_last) num_expected_chunks_[sender_id] = chunk_num + 1;
+
+    auto const it = num_expected_chunks_.find(sender_id);
+    if (it != num_expected_chunks_.end() && it->second == num_seen_chunks) {
+        pending_senders_.erase(sender_id);
     }
+}
+
+void ExchangeS3Operator::WaitForFiles() {
+    auto const prefix = ListPrefix();
+
+    for (size_t j = 0; ready_files_.empty(); j++) {
+        // Back off exponentially while no new files arrive
+        if (j > 0) {
+            using namespace std::chrono_literals;
+            // NOLINTNEXTLINE(readability-magic-numbers)
+            std::this_thread::sleep_for(25ms * (1UL << std::min(j - 1, 4UL)));
+        }
 
-    auto const file_path =
-            (boost::format("s3://%1%/%2%") % bucket_name_ % file_name).str();
-    return file_path;
+        // List the files written so far by the senders of our group for us
+        // (one page holds up to 1000 files, so this is mostly one request)
+        Aws::S3::Model::ListObjectsRequest request;
+        request.WithBucket(bucket_name_.c_str()).WithPrefix(prefix.c_str());
+        while (true) {
+            auto const outcome = s3_client_->ListObjects(request);
+            if (!outcome.IsSuccess()) break;  // Retry in next round
+
+            auto const &objects = outcome.GetResult().GetContents();
+            for (auto const &object : objects) {
+                MarkFileReady(object.GetKey().c_str(), prefix);
+            }
+
+            if (!outcome.GetResult().GetIsTruncated() || objects.empty()) {
+                break;
+            }
+            request.SetMarker(objects.back().GetKey());
+        }
+    }
 }
 
 void ExchangeS3Operator::ConsumeUpstream() {
-    std::unordered_map<int64_t, RecordBatches> partitions;
+    ExchangePartitionHistogram histogram("s3", exchange_id_, level_num_,
+                                         worker_id_, group_members_);
+
+    std::vector<RecordBatches> partitions(group_size_);
+    chunks_.assign(group_size_, {});
+    chunk_sizes_.assign(group_size_, 0);
+    num_chunks_.assign(group_size_, 0);
+    buffered_size_ = 0;
+
+    // Chunks of this size can be uploaded concurrently within the budget
+    const size_t max_chunk_size =
+            std::max<size_t>(1, memory_limit_ / kMaxNumPendingUploads);
 
     while (true) {
         auto const input = main_upstream_->next();
@@ -271,23 +314,93 @@ void ExchangeS3Operator::ConsumeUpstream() {
 
         // Convert upstream value to arrow record batch
         auto *const tuple = input->as<values::Tuple>();
-        auto const key = tuple->fields.at(0)->as<values::Int64>()->value;
+        const size_t key = tuple->fields.at(0)->as<values::Int64>()->value;
 
         std::vector<std::shared_ptr<values::Value>> columns(
                 tuple->fields.begin() + 1, tuple->fields.end());
         auto value = std::make_shared<values::Tuple>();
         value->fields = std::move(columns);
 
+        auto record_batch = ConvertValueToRecordBatch(value, schema_);
+        histogram.Add(key, record_batch->num_rows());
+
         // Append to output partition
-        partitions[key].emplace_back(ConvertValueToRecordBatch(value, schema_));
+        if (!is_streaming()) {
+            partitions.at(key).emplace_back(std::move(record_batch));
+            continue;
+        }
+
+        // Append to current chunk of output partition
+        size_t size = 0;
+        for (int i = 0; i < record_batch->num_columns(); i++) {
+            for (auto const &buffer : record_batch->column_data(i)->buffers) {
+                if (buffer != nullptr) size += buffer->size();
+            }
+        }
+
+        chunks_.at(key).emplace_back(std::move(record_batch));
+        chunk_sizes_.at(key) += size;
+        buffered_size_ += size;
+
+        // Upload full chunks, then the largest ones while above the budget
+        if (chunk_sizes_.at(key) >= max_chunk_size) {
+            FlushChunk(key, /*is_last=*/false);
+        }
+        while (buffered_size_ > memory_limit_) {
+            auto const largest =
+                    std::max_element(chunk_sizes_.begin(), chunk_sizes_.end());
+            FlushChunk(largest - chunk_sizes_.begin(), /*is_last=*/false);
+        }
     }
 
+    if (!is_streaming()) {
+        WriteFile(FileKey(worker_id_), partitions);
+    } else {
+        // Upload the remaining data; the last chunk of each receiver (which
+        // may be empty) signals the end of our stream to that receiver
+        for (size_t i = 0; i < group_size_; i++) {
+            FlushChunk(i, /*is_last=*/true);
+        }
+        for (auto &upload : pending_uploads_) {
+            upload.get();
+        }
+        pending_uploads_.clear();
+    }
+
+    histogram.Report();
+}
+
+void ExchangeS3Operator::FlushChunk(const size_t receiver_index,
+                                    const bool is_last) {
+    if (chunks_.at(receiver_index).empty() && !is_last) return;
+
+    auto const key = ChunkKey(group_members_.at(receiver_index),
+                              num_chunks_.at(receiver_index)++, is_last);
+    std::vector<RecordBatches> row_groups(1);
+    row_groups[0].swap(chunks_.at(receiver_index));
+    buffered_size_ -= chunk_sizes_.at(receiver_index);
+    chunk_sizes_.at(receiver_index) = 0;
+
+    // Bound the memory held by uploads in flight
+    while (pending_uploads_.size() >= kMaxNumPendingUploads) {
+        pending_uploads_.front().get();
+        pending_uploads_.pop_front();
+    }
+
+    pending_uploads_.emplace_back(std::async(
+            std::launch::async,
+            [this, key, row_groups = std::move(row_groups)]() {
+                WriteFile(key, row_groups);
+            }));
+}
+
+void ExchangeS3Operator::WriteFile(
+        const std::string &key,
+        const std::vector<RecordBatches> &row_groups) const {
     // Open Parquet file writer
     const auto *const filesystem = "s3";
     auto const filename =
-            (boost::format("s3://%1%/jitq/query-%2%/exchange-%3%/%4%.parquet") %
-             bucket_name_ % query_id_ % exchange_id_ % worker_id_)
-                    .str();
+            (boost::format("s3://%1%/%2%") % bucket_name_ % key).str();
 
     parquet::WriterProperties::Builder properties_builder;
     properties_builder.created_by("JITQ :)");
@@ -301,13 +414,10 @@ void ExchangeS3Operator::ConsumeUpstream() {
 
     std::unique_ptr<parquet::arrow::FileWriter> file_writer;
     operators::ThrowIfNotOK(parquet::arrow::FileWriter::Open(
-            *schema_, arrow::default_memory_pool(), output_stream,
+            *schema_, memory::TrackingArrowMemoryPool(), output_stream,
             writer_properties, &file_writer));
 
-    for (size_t i = 0; i < group_size_; i++) {
-        // Note: [] creates an empty vector if key not present
-        auto const &record_batches = partitions[i];
-
+    for (auto const &record_batches : row_groups) {
         // Create arrow table from record batches
         auto maybe_table =
                 arrow::Table::FromRecordBatches(schema_, record_batches);
@@ -315,7 +425,7 @@ void ExchangeS3Operator::ConsumeUpstream() {
         auto const table = std::move(maybe_table).ValueOrDie();
         const size_t num_rows = table->num_rows();
 
-        // Write current file
+        // Write current row group
         operators::ThrowIfNotOK(file_writer->NewRowGroup(num_rows));
         for (size_t j = 0; j < table->num_columns(); j++) {
             operators::ThrowIfNotOK(file_writer->WriteColumnChunk(
@@ -4,7 +4,10 @@
 #include <future>
 #include <list>
 #include <memory>
+#include <queue>
+#include <string>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -35,6 +38,7 @@ public:
           bucket_name_(LookupBucketName()),
           s3_client_(aws::s3::MakeClient()),
           query_id_(LookupQueryId()),
+          memory_limit_(LookupMemoryLimit()),
           exchange_id_(exchange_id),
           num_levels_(num_levels),
           level_num_(level_num) {}
@@ -53,13 +57,32 @@ public:
 private:
     using RecordBatches = std::vector<std::shared_ptr<arrow::RecordBatch>>;
 
+    // Maximum number of chunks being uploaded concurrently in streaming mode
+    static constexpr size_t kMaxNumPendingUploads = 4;
+
     static auto LookupQueryId() -> size_t;
     static auto LookupBucketName() -> std::string;
+    static auto LookupMemoryLimit() -> size_t;
 
     // cppcheck-suppress unusedPrivateFunction  // false positive
     void ConsumeUpstream();
+    void WriteFile(const std::string &key,
+                   const std::vector<RecordBatches> &row_groups) const;
+    void FlushChunk(size_t receiver_index, bool is_last);
     // cppcheck-suppress unusedPrivateFunction  // false positive
-    auto WaitForFile(size_t sender_id) const -> std::string;
+    void WaitForFiles();
+    void MarkFileReady(const std::string &key, const std::string &prefix);
+    [[nodiscard]] auto GroupPrefix() const -> std::string;
+    [[nodiscard]] auto ListPrefix() const -> std::string;
+    [[nodiscard]] auto FileKey(size_t sender_id) const -> std::string;
+    [[nodiscard]] auto ChunkKey(size_t receiver_id, size_t chunk_num,
+                                bool is_last) const -> std::string;
+
+    // Streaming mode: the sender uploads chunks of each receiver's partition
+    // while consuming its upstream, using about twice memory_limit_ bytes
+    [[nodiscard]] auto is_streaming() const -> bool {
+        return memory_limit_ > 0;
+    }
 
     const std::unique_ptr<ValueOperator> main_upstream_;
     const std::unique_ptr<ValueOperator> dop_upstream_;
@@ -68,6 +91,7 @@ private:
     const std::string bucket_name_;
     std::shared_ptr<Aws::S3::S3Client> s3_client_;
     const size_t query_id_;
+    const size_t memory_limit_;
     const size_t exchange_id_;
     const size_t num_levels_;
     const size_t level_num_;
@@ -75,8 +99,21 @@ private:
     size_t worker_id_{};
     std::vector<size_t> group_members_{};
     size_t group_size_{};
-    std::list<std::future<std::string>> pending_results_;
-    std::unordered_set<std::string> returned_results_;
+
+    // Sending side of streaming mode
+    std::vector<RecordBatches> chunks_;
+    std::vector<size_t> chunk_sizes_;
+    std::vector<size_t> num_chunks_;
+    size_t buffered_size_{};
+    std::list<std::future<void>> pending_uploads_;
+
+    // Receiving side
+    bool has_consumed_upstream_ = false;
+    std::unordered_set<size_t> pending_senders_;
+    std::unordered_set<std::string> seen_keys_;
+    std::unordered_map<size_t, size_t> num_seen_chunks_;
+    std::unordered_map<size_t, size_t> num_expected_chunks_;
+    std::queue<std::string> ready_files_;
 };
 
 }  // namespace operators
@@ -24,9 +24,11 @@
 
 #include "aws/s3.hpp"
 #include "filesystem/filesystem.hpp"
+#include "memory/arrow_memory_pool.hpp"
 #include "net/tcp/exchange_service.hpp"
 #include "operators/arrow_helpers.hpp"
 #include "operators/arrow_table_scan.hpp"
+#include "operators/exchange_metrics.hpp"
 #include "operators/record_batch_to_value.hpp"
 #include "operators/value_to_record_batch.hpp"
 #include "runtime/jit/values/atomics.hpp"
@@ -149,6 +151,9 @@ void ExchangeTcpOperator::ConsumeUpstream() {
     properties_builder.enable_dictionary();
     auto const writer_properties = properties_builder.build();
 
+    ExchangePartitionHistogram histogram("tcp", exchange_id_, level_num_,
+                                         worker_id_, group_members_);
+
     while (true) {
         auto const input = upstream_->next();
         if (dynamic_cast<const values::None *>(input.get()) != nullptr) break;
@@ -170,6 +175,7 @@ void ExchangeTcpOperator::ConsumeUpstream() {
         auto const &table = maybe_table.ValueOrDie();
 
         const size_t num_rows = table->num_rows();
+        histogram.Add(key, num_rows);
 
         // Open Parquet file writer
         auto const maybe_output_stream =
@@ -179,7 +185,7 @@ void ExchangeTcpOperator::ConsumeUpstream() {
 
         std::unique_ptr<parquet::arrow::FileWriter> file_writer;
         operators::ThrowIfNotOK(parquet::arrow::FileWriter::Open(
-                *schema_, arrow::default_memory_pool(), output_stream,
+                *schema_, memory::TrackingArrowMemoryPool(), output_stream,
                 writer_properties, &file_writer));
 
         // Write table to Parquet file writer
@@ -206,14 +212,13 @@ void ExchangeTcpOperator::ConsumeUpstream() {
     for (auto const receiver_id : group_members_) {
         exchange_service()->SendMessage(exchange_id_, receiver_id, {});
     }
+
+    histogram.Report();
 }
 
 void ExchangeTcpOperator::open() {
-    // XXX: ExchangeService does not support varying subset of hosts
-    assert(group_members_.size() == tcp_num_workers());
-
     upstream_->open();
-    exchange_service()->StartExchange(exchange_id_);
+    exchange_service()->StartExchange(exchange_id_, group_size_);
 }
 
 auto ExchangeTcpOperator::next() -> std::shared_ptr<arrow::Table> {
@@ -236,7 +241,7 @@ auto ExchangeTcpOperator::next() -> std::shared_ptr<arrow::Table> {
     auto const source = std::make_shared<arrow::io::BufferReader>(buffer);
     std::unique_ptr<parquet::arrow::FileReader> arrow_reader;
     auto file_reader = parquet::arrow::OpenFile(
-            source, arrow::default_memory_pool(), &arrow_reader);
+            source, memory::TrackingArrowMemoryPool(), &arrow_reader);
 
     // Read Parquet file as Arrow table
     std::shared_ptr<arrow::Table> table;
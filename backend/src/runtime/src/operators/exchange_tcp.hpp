@@ -27,6 +27,7 @@ struct ExchangeTcpOperator : public ArrowTableOperator {
         : upstream_(std::move(upstream)),
           schema_(std::move(schema)),
           exchange_id_(exchange_id),
+          level_num_(level_num),
           num_workers_(tcp_num_workers()),
           worker_id_(tcp_worker_id()),
           group_members_(ExchangeS3Operator::ComputeGroupMembers(
@@ -44,6 +45,7 @@ private:
     const std::unique_ptr<ValueOperator> upstream_;
     const std::shared_ptr<arrow::Schema> schema_;
     const size_t exchange_id_;
+    const size_t level_num_;
     const size_t num_workers_;
     const size_t worker_id_;
     std::vector<size_t> group_members_;
@@ -18,6 +18,7 @@
 #include <parquet/arrow/writer.h>
 
 #include "filesystem/filesystem.hpp"
+#include "memory/arrow_memory_pool.hpp"
 #include "operators/arrow_helpers.hpp"
 #include "operators/value_to_record_batch.hpp"
 #include "runtime/jit/values/atomics.hpp"
@@ -163,7 +164,7 @@ auto MaterializeParquetOperatorImpl::next()
 
     std::unique_ptr<parquet::arrow::FileWriter> file_writer;
     operators::ThrowIfNotOK(parquet::arrow::FileWriter::Open(
-            *schema_, arrow::default_memory_pool(), output_stream,
+            *schema_, memory::TrackingArrowMemoryPool(), output_stream,
             writer_properties, &file_writer));
 
     // Consume upstream
@@ -2,7 +2,6 @@
 
 #include <cassert>
 
-#include <chrono>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -10,6 +9,7 @@
 #include <set>
 #include <thread>
 #include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -41,6 +41,64 @@ auto MakeParquetScanOperator(
                                        col_ids);
 }
 
+namespace {
+
+struct ParquetMetaDataCache {
+    std::mutex mutex;
+    bool is_enabled = false;
+    std::map<std::pair<std::string, int64_t>,
+             std::shared_ptr<parquet::FileMetaData>>
+            entries;
+};
+
+auto parquet_metadata_cache() -> ParquetMetaDataCache* {
+    static ParquetMetaDataCache cache;
+    return &cache;
+}
+
+auto OpenParquetFile(
+        const std::string& path,
+        const std::shared_ptr<::arrow::io::RandomAccessFile>& source)
+        -> std::unique_ptr<parquet::ParquetFileReader> {
+    auto* const cache = parquet_metadata_cache();
+    {
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        if (!cache->is_enabled) {
+            return parquet::ParquetFileReader::Open(source);
+        }
+    }
+
+    auto const file_size = source->GetSize();
+    if (!file_size.ok()) {
+        return parquet::ParquetFileReader::Open(source);
+    }
+    auto const key = std::make_pair(path, file_size.ValueUnsafe());
+
+    std::shared_ptr<parquet::FileMetaData> metadata;
+    {
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        auto const it = cache->entries.find(key);
+        if (it != cache->entries.end()) metadata = it->second;
+    }
+
+    auto reader = parquet::ParquetFileReader::Open(
+            source, parquet::default_reader_properties(), metadata);
+    if (!metadata) {
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        cache->entries.emplace(key, reader->metadata());
+    }
+    return reader;
+}
+
+}  // namespace
+
+void SetParquetMetaDataCacheEnabled(const bool enabled) {
+    auto* const cache = parquet_metadata_cache();
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    cache->is_enabled = enabled;
+    if (!enabled) cache->entries.clear();
+}
+
 void ParquetFileOperator::open() {
     // Spawned in a separate thread to supply the file handles as soon as they
     // are in
@@ -117,7 +175,7 @@ void ParquetFileOperator::FetchMetaData() {
         assert(!path.empty());
 
         auto source = fs_->OpenForRead(path);
-        auto pq_file_reader = parquet::ParquetFileReader::Open(source);
+        auto pq_file_reader = OpenParquetFile(path, source);
         auto file_metadata = pq_file_reader->metadata();
 
         std::unique_ptr<ParquetFileHandle> handle(new ParquetFileHandle{
@@ -128,15 +186,14 @@ void ParquetFileOperator::FetchMetaData() {
             file_handles_.push(
                     std::unique_ptr<ParquetFileHandle>(std::move(handle)));
         }
+        file_handles_cv_.notify_one();
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    has_prefetching_completed_ = true;
-}
-
-auto ParquetFileOperator::HasPendingFileHandles() -> bool {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return file_handles_.empty() && !has_prefetching_completed_;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        has_prefetching_completed_ = true;
+    }
+    file_handles_cv_.notify_one();
 }
 
 auto ParquetFileOperator::AreAllFilesProcessed() -> bool {
@@ -145,10 +202,10 @@ auto ParquetFileOperator::AreAllFilesProcessed() -> bool {
 }
 
 void ParquetFileOperator::WaitForFileHandles() {
-    while (HasPendingFileHandles()) {
-        std::this_thread::sleep_for(
-                std::chrono::milliseconds(WAIT_DOWNLOAD_MS));
-    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    file_handles_cv_.wait(lock, [this]() {
+        return !file_handles_.empty() || has_prefetching_completed_;
+    });
 }
 
 void ParquetRowGroupOperator::open() { upstream_->open(); }
@@ -38,6 +38,13 @@ struct RowGroupRange {
 
 }  // namespace impl
 
+/*
+ * Enables a process-wide cache of the metadata of Parquet files, which is
+ * keyed by path and file size. This is meant for long-running processes that
+ * read the same (immutable) files repeatedly; it is disabled by default.
+ */
+void SetParquetMetaDataCacheEnabled(bool enabled);
+
 class ParquetFileOperator {
 public:
     struct ParquetFileHandle {
@@ -67,11 +74,8 @@ public:
     void close();
 
 private:
-    static constexpr int32_t WAIT_DOWNLOAD_MS = 10;
-
     void FetchMetaData();
 
-    auto HasPendingFileHandles() -> bool;
     auto AreAllFilesProcessed() -> bool;
     void WaitForFileHandles();
 
@@ -85,6 +89,7 @@ private:
     bool has_upstream_completed_ = false;
     bool has_prefetching_completed_ = false;
     std::condition_variable file_infos_cv_;
+    std::condition_variable file_handles_cv_;
     std::queue<std::unique_ptr<ParquetFileHandle>> file_handles_;
     std::queue<std::pair<std::string, impl::RowGroupRange>> file_infos_;
 };
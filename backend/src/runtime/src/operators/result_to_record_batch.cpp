@@ -0,0 +1,198 @@
+#include "result_to_record_batch.hpp"
+
+#include <cassert>
+#include <cstring>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/builder.h>
+#include <arrow/scalar.h>
+#include <arrow/type.h>
+
+#include "arrow_helpers.hpp"
+#include "dag/type/array.hpp"
+#include "dag/type/atomic.hpp"
+#include "runtime/jit/values/array.hpp"
+#include "runtime/jit/values/atomics.hpp"
+#include "runtime/jit/values/none.hpp"
+#include "runtime/jit/values/tuple.hpp"
+
+namespace runtime::operators {
+
+namespace {
+
+struct AtomicTypeInfo {
+    std::shared_ptr<arrow::DataType> arrow_type;
+    size_t width;
+};
+
+auto LookUpAtomicType(const dag::type::FieldType *const field_type)
+        -> const AtomicTypeInfo & {
+    static const std::map<std::string, AtomicTypeInfo> map = {
+            {"bool", {arrow::boolean(), sizeof(bool)}},   //
+            {"int", {arrow::int32(), sizeof(int32_t)}},   //
+            {"long", {arrow::int64(), sizeof(int64_t)}},  //
+            {"float", {arrow::float32(), sizeof(float)}},  //
+            {"double", {arrow::float64(), sizeof(double)}}};
+
+    const auto *const atomic_type =
+            dynamic_cast<const dag::type::Atomic *>(field_type);
+    if (atomic_type == nullptr || map.count(atomic_type->type) == 0) {
+        throw std::invalid_argument("Cannot convert field of type " +
+                                    field_type->to_string() +
+                                    " to Arrow column");
+    }
+    return map.at(atomic_type->type);
+}
+
+auto MakeScalar(const values::Value *const value,
+                const std::shared_ptr<arrow::DataType> &type)
+        -> std::shared_ptr<arrow::Scalar> {
+    switch (type->id()) {
+        case arrow::Type::BOOL:
+            return std::make_shared<arrow::BooleanScalar>(
+                    value->as<values::Bool>()->value);
+        case arrow::Type::INT32:
+            return std::make_shared<arrow::Int32Scalar>(
+                    value->as<values::Int32>()->value);
+        case arrow::Type::INT64:
+            return std::make_shared<arrow::Int64Scalar>(
+                    value->as<values::Int64>()->value);
+        case arrow::Type::FLOAT:
+            return std::make_shared<arrow::FloatScalar>(
+                    value->as<values::Float>()->value);
+        case arrow::Type::DOUBLE:
+            return std::make_shared<arrow::DoubleScalar>(
+                    value->as<values::Double>()->value);
+        default:
+            assert(false);
+            return {};
+    }
+}
+
+}  // namespace
+
+ResultToRecordBatches::ResultToRecordBatches(
+        std::shared_ptr<const values::Value> result,
+        const dag::type::Tuple *const result_type, const size_t batch_size)
+    : result_(std::move(result)), batch_size_(std::max<size_t>(1, batch_size)) {
+    // Determine fields of the rows and their position in memory
+    const auto &field_types = result_type->field_types;
+    const auto *const array_type =
+            field_types.size() == 1
+                    ? dynamic_cast<const dag::type::Array *>(field_types[0])
+                    : nullptr;
+    is_array_ = array_type != nullptr;
+    num_rows_ = is_array_ ? 0 : 1;
+
+    const auto &row_field_types =
+            is_array_ ? array_type->tuple_type->field_types : field_types;
+    if (is_array_ && array_type->num_dimensions != 1) {
+        throw std::invalid_argument(
+                "Only one-dimensional arrays can be converted to Arrow");
+    }
+
+    // Field offsets follow the layout of the generated structs, i.e., each
+    // field is aligned to its size
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    size_t offset = 0;
+    size_t max_width = 1;
+    for (size_t i = 0; i < row_field_types.size(); i++) {
+        auto const &info = LookUpAtomicType(row_field_types[i]);
+        offset = (offset + info.width - 1) / info.width * info.width;
+        columns_.push_back({info.arrow_type, offset, info.width});
+        fields.push_back(arrow::field("f" + std::to_string(i), info.arrow_type,
+                                      false));
+        offset += info.width;
+        max_width = std::max(max_width, info.width);
+    }
+    element_size_ = (offset + max_width - 1) / max_width * max_width;
+    schema_ = arrow::schema(std::move(fields));
+
+    // Locate the rows of array results
+    if (!is_array_ ||
+        dynamic_cast<const values::None *>(result_.get()) != nullptr) {
+        return;
+    }
+    const auto *const array =
+            result_->as<values::Tuple>()->fields.at(0)->as<values::Array>();
+    num_rows_ = array->shape.at(0);
+    data_ = array->data.get() + array->offsets.at(0) * element_size_;
+}
+
+auto ResultToRecordBatches::next()
+        -> Optional<std::shared_ptr<arrow::RecordBatch>> {
+    if (dynamic_cast<const values::None *>(result_.get()) != nullptr) {
+        return {};
+    }
+    if (next_row_ >= num_rows_) return {};
+    return is_array_ ? NextRows() : NextSingleRow();
+}
+
+auto ResultToRecordBatches::NextRows() -> std::shared_ptr<arrow::RecordBatch> {
+    const size_t num_rows = std::min(batch_size_, num_rows_ - next_row_);
+    const char *const rows = data_ + next_row_ * element_size_;
+    next_row_ += num_rows;
+
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+    arrays.reserve(columns_.size());
+    for (auto const &column : columns_) {
+        // Booleans are bit-packed in Arrow
+        if (column.type->id() == arrow::Type::BOOL) {
+            arrow::BooleanBuilder builder;
+            ThrowIfNotOK(builder.Reserve(num_rows));
+            for (size_t i = 0; i < num_rows; i++) {
+                builder.UnsafeAppend(
+                        *(rows + i * element_size_ + column.offset) != 0);
+            }
+            std::shared_ptr<arrow::Array> array;
+            ThrowIfNotOK(builder.Finish(&array));
+            arrays.push_back(std::move(array));
+            continue;
+        }
+
+        // Gather the field of all rows into a contiguous buffer
+        auto buffer = arrow::AllocateBuffer(num_rows * column.width);
+        ThrowIfNotOK(buffer);
+        auto *const out = (*buffer)->mutable_data();
+        for (size_t i = 0; i < num_rows; i++) {
+            std::memcpy(out + i * column.width,
+                        rows + i * element_size_ + column.offset,
+                        column.width);
+        }
+        arrays.push_back(std::make_shared<arrow::PrimitiveArray>(
+                column.type, num_rows,
+                std::shared_ptr<arrow::Buffer>(std::move(*buffer))));
+    }
+
+    return arrow::RecordBatch::Make(schema_, num_rows, std::move(arrays));
+}
+
+auto ResultToRecordBatches::NextSingleRow()
+        -> std::shared_ptr<arrow::RecordBatch> {
+    next_row_ = 1;
+
+    auto const &values = result_->as<values::Tuple>()->fields;
+    assert(values.size() == columns_.size());
+
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+    arrays.reserve(columns_.size());
+    for (size_t i = 0; i < columns_.size(); i++) {
+        auto const scalar = MakeScalar(values[i].get(), columns_[i].type);
+        auto array = arrow::MakeArrayFromScalar(*scalar, 1);
+        ThrowIfNotOK(array);
+        arrays.push_back(std::move(*array));
+    }
+
+    return arrow::RecordBatch::Make(schema_, 1, std::move(arrays));
+}
+
+}  // namespace runtime::operators
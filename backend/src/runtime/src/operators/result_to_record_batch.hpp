@@ -0,0 +1,62 @@
+#ifndef OPERATORS_RESULT_TO_RECORD_BATCH_HPP
+#define OPERATORS_RESULT_TO_RECORD_BATCH_HPP
+
+#include <memory>
+#include <vector>
+
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+
+#include "dag/type/tuple.hpp"
+#include "runtime/jit/operators/optional.hpp"
+#include "runtime/jit/values/value.hpp"
+
+namespace runtime {
+namespace operators {
+
+/*
+ * Converts the result of a plan with the given output type into Arrow record
+ * batches of at most batch_size rows. Results of type (array of T) produce one
+ * column per field of T, which has to consist of atomics; results that are a
+ * tuple of atomics produce a single row. A result of None produces no batch.
+ *
+ * The batches are converted one by one in next(), so only one of them is held
+ * in memory in addition to the result.
+ */
+struct ResultToRecordBatches {
+    ResultToRecordBatches(std::shared_ptr<const values::Value> result,
+                          const dag::type::Tuple* result_type,
+                          size_t batch_size);
+
+    [[nodiscard]] auto schema() const -> const std::shared_ptr<arrow::Schema>& {
+        return schema_;
+    }
+    auto next() -> Optional<std::shared_ptr<arrow::RecordBatch>>;
+
+private:
+    struct Column {
+        std::shared_ptr<arrow::DataType> type;
+        size_t offset;  // of the field inside of the element struct
+        size_t width;
+    };
+
+    auto NextRows() -> std::shared_ptr<arrow::RecordBatch>;
+    auto NextSingleRow() -> std::shared_ptr<arrow::RecordBatch>;
+
+    const std::shared_ptr<const values::Value> result_;
+    const size_t batch_size_;
+    std::shared_ptr<arrow::Schema> schema_;
+    std::vector<Column> columns_;
+
+    // Set if the result is an array of tuples
+    bool is_array_ = false;
+    const char* data_ = nullptr;
+    size_t element_size_ = 0;
+    size_t num_rows_ = 0;
+    size_t next_row_ = 0;
+};
+
+}  // namespace operators
+}  // namespace runtime
+
+#endif  // OPERATORS_RESULT_TO_RECORD_BATCH_HPP
@@ -0,0 +1,48 @@
+#include "runtime/jit/memory/chunk_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "runtime/jit/memory/shared_pointer.hpp"
+
+using runtime::memory::AllocateChunk;
+using runtime::memory::ChunkPoolRefCounter;
+using runtime::memory::ClearChunkPool;
+using runtime::memory::ReleaseChunk;
+using runtime::memory::SharedPointer;
+
+// cppcheck-suppress missingOverride
+TEST(ChunkPoolTest, ReusesReleasedChunks) {  // NOLINT
+    constexpr size_t kNumBytes = 1U << 20U;
+    void* const chunk = AllocateChunk(kNumBytes);
+    std::memset(chunk, 0, kNumBytes);
+    ReleaseChunk(chunk, kNumBytes);
+
+    // Chunks of other sizes come from elsewhere
+    void* const other = AllocateChunk(kNumBytes / 2);
+    EXPECT_NE(other, chunk);
+    EXPECT_EQ(AllocateChunk(kNumBytes), chunk);
+
+    ReleaseChunk(other, kNumBytes / 2);
+    ReleaseChunk(chunk, kNumBytes);
+    ClearChunkPool();
+}
+
+// cppcheck-suppress missingOverride
+TEST(ChunkPoolTest, RefCounterReleasesChunk) {  // NOLINT
+    constexpr size_t kNumElements = 1000;
+    constexpr size_t kNumBytes = kNumElements * sizeof(int64_t);
+    void* const chunk = AllocateChunk(kNumBytes);
+    {
+        SharedPointer<int64_t> pointer(new ChunkPoolRefCounter<int64_t>(
+                chunk, kNumElements, kNumBytes));
+        pointer.get()[kNumElements - 1] = 42;
+    }
+    EXPECT_EQ(AllocateChunk(kNumBytes), chunk);
+
+    ReleaseChunk(chunk, kNumBytes);
+    ClearChunkPool();
+}
@@ -0,0 +1,166 @@
+#include "runtime/jit/operators/csv_scan.hpp"
+
+#include <cstdint>
+#include <cstdio>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "runtime/jit/operators/value_operator.hpp"
+#include "runtime/jit/values/array.hpp"
+#include "runtime/jit/values/atomics.hpp"
+#include "runtime/jit/values/none.hpp"
+#include "runtime/jit/values/tuple.hpp"
+
+using runtime::operators::CountCsvQuotes;
+using runtime::operators::FindCsvRecordEnd;
+using runtime::operators::MakeCsvScanOperator;
+using runtime::operators::ValueOperator;
+namespace values = runtime::values;
+
+namespace {
+
+// Returns the slices of the given file, one per call of next()
+class SlicesOperator : public ValueOperator {
+public:
+    SlicesOperator(std::string path, const int64_t num_slices)
+        : path_(std::move(path)), num_slices_(num_slices) {}
+
+    auto next() -> std::shared_ptr<values::Value> override {
+        if (slice_ == num_slices_) return std::make_shared<values::None>();
+        auto ret = std::make_shared<values::Tuple>();
+        auto path = std::make_shared<values::String>();
+        path->value = path_;
+        ret->fields.emplace_back(path);
+        for (const int64_t v : {slice_, slice_ + 1, num_slices_}) {
+            auto field = std::make_shared<values::Int64>();
+            field->value = v;
+            ret->fields.emplace_back(field);
+        }
+        slice_++;
+        return ret;
+    }
+
+private:
+    const std::string path_;
+    const int64_t num_slices_;
+    int64_t slice_ = 0;
+};
+
+template <typename T>
+void AppendColumn(const values::Value* const value, std::vector<T>* const out) {
+    const auto* const array = value->as<values::Array>();
+    const auto* const data = reinterpret_cast<const T*>(array->data.get());
+    out->insert(out->end(), data, data + array->shape.at(0));
+}
+
+// Reads the columns 2 (as long) and 0 (as double) of the given file
+auto ScanFile(const std::string& path, const int64_t num_slices,
+              const bool has_header)
+        -> std::pair<std::vector<int64_t>, std::vector<double>> {
+    std::unique_ptr<ValueOperator> op(MakeCsvScanOperator(
+            std::make_unique<SlicesOperator>(path, num_slices),
+            {"long", "double"}, {2, 0}, ',', '"', has_header, "file", 4));
+
+    std::pair<std::vector<int64_t>, std::vector<double>> ret;
+    op->open();
+    while (true) {
+        auto const batch = op->next();
+        if (dynamic_cast<values::None*>(batch.get()) != nullptr) break;
+        auto const& fields = batch->as<values::Tuple>()->fields;
+        AppendColumn(fields.at(0).get(), &ret.first);
+        AppendColumn(fields.at(1).get(), &ret.second);
+    }
+    op->close();
+    return ret;
+}
+
+}  // namespace
+
+// cppcheck-suppress missingOverride
+TEST(CsvScanTest, FindRecordEndSkipsQuotedLineBreaks) {  // NOLINT
+    const std::string data =
+            "1,\"a long quoted\nfield\",\"\"\"\"\n"
+            "2,b,c\n";
+    bool in_quotes = false;
+    const char* const end = FindCsvRecordEnd(
+            data.data(), data.data() + data.size(), '"', &in_quotes);
+    EXPECT_EQ(static_cast<size_t>(end - data.data()),
+              data.find("\"\n") + 1);
+    EXPECT_FALSE(in_quotes);
+
+    // Starting inside of the quoted field
+    in_quotes = true;
+    const char* const begin = data.data() + data.find("long");
+    EXPECT_EQ(FindCsvRecordEnd(begin, data.data() + data.size(), '"',
+                               &in_quotes),
+              end);
+
+    // No record end: state at the end of the range is returned
+    in_quotes = false;
+    EXPECT_EQ(FindCsvRecordEnd(data.data(), begin, '"', &in_quotes), begin);
+    EXPECT_TRUE(in_quotes);
+}
+
+// cppcheck-suppress missingOverride
+TEST(CsvScanTest, CountQuotes) {  // NOLINT
+    const std::string data = "\"\"x\"yyyyyyyyyyyyyyyyyyyyyy\"\"\"";
+    EXPECT_EQ(CountCsvQuotes(data.data(), data.data() + data.size(), '"'),
+              6U);
+    EXPECT_EQ(CountCsvQuotes(data.data(), data.data() + 3, '"'), 2U);
+}
+
+// cppcheck-suppress missingOverride
+TEST(CsvScanTest, SlicesReturnEachRecordOnce) {  // NOLINT
+    const std::string path = testing::TempDir() + "csv_scan_test_slices.csv";
+    const size_t num_records = 100000;
+    {
+        std::ofstream file(path);
+        file << "x,label,id\r\n";
+        for (size_t i = 0; i < num_records; i++) {
+            file << i * 0.5 << ",\"a, b\"," << i << "\r\n";
+        }
+    }
+
+    for (const int64_t num_slices : {1, 2, 3, 16, 1000}) {
+        auto const [ids, xs] = ScanFile(path, num_slices, true);
+        ASSERT_EQ(ids.size(), num_records);
+        ASSERT_EQ(xs.size(), num_records);
+        for (size_t i = 0; i < num_records; i++) {
+            ASSERT_EQ(ids[i], static_cast<int64_t>(i));
+            ASSERT_EQ(xs[i], static_cast<double>(i) * 0.5);
+        }
+    }
+
+    std::remove(path.c_str());
+}
+
+// cppcheck-suppress missingOverride
+TEST(CsvScanTest, ChunksSplitOnlyBetweenRecords) {  // NOLINT
+    const std::string path = testing::TempDir() + "csv_scan_test_quotes.csv";
+    const size_t num_records = 200000;
+    {
+        std::ofstream file(path);
+        for (size_t i = 0; i < num_records; i++) {
+            file << "\"" << i << "\",\"line\nbreak, \"\"quote\"\"\"," << i
+                 << "\n";
+        }
+        // Last record without line break
+        file << "-1,,-1";
+    }
+
+    auto const [ids, xs] = ScanFile(path, 1, false);
+    ASSERT_EQ(ids.size(), num_records + 1);
+    for (size_t i = 0; i < num_records; i++) {
+        ASSERT_EQ(ids[i], static_cast<int64_t>(i));
+        ASSERT_EQ(xs[i], static_cast<double>(i));
+    }
+    EXPECT_EQ(ids.back(), -1);
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,122 @@
+#include "runtime/jit/operators/exchange_levels.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using runtime::operators::ComputeExchangeGroupMembers;
+using runtime::operators::ComputeExchangeLevelFanouts;
+using runtime::operators::ComputeExchangeNumLevels;
+
+// cppcheck-suppress missingOverride
+TEST(ExchangeLevelsTest, FanoutsMultiplyToNumWorkers) {  // NOLINT
+    for (size_t num_levels = 1; num_levels <= 4; num_levels++) {
+        for (size_t num_workers = 1; num_workers <= 300; num_workers++) {
+            auto const fanouts =
+                    ComputeExchangeLevelFanouts(num_levels, num_workers);
+            ASSERT_EQ(fanouts.size(), num_levels);
+            EXPECT_EQ(std::accumulate(fanouts.begin(), fanouts.end(), 1UL,
+                                      std::multiplies<>()),
+                      num_workers);
+            EXPECT_TRUE(std::is_sorted(fanouts.begin(), fanouts.end()));
+        }
+    }
+}
+
+// cppcheck-suppress missingOverride
+TEST(ExchangeLevelsTest, BalancedFanouts) {  // NOLINT
+    EXPECT_EQ(ComputeExchangeLevelFanouts(2, 100),
+              (std::vector<size_t>{10, 10}));
+    EXPECT_EQ(ComputeExchangeLevelFanouts(3, 1000),
+              (std::vector<size_t>{10, 10, 10}));
+    EXPECT_EQ(ComputeExchangeLevelFanouts(2, 12), (std::vector<size_t>{3, 4}));
+    EXPECT_EQ(ComputeExchangeLevelFanouts(2, 7), (std::vector<size_t>{1, 7}));
+}
+
+// cppcheck-suppress missingOverride
+TEST(ExchangeLevelsTest, NumLevelsGrowsWithNumWorkers) {  // NOLINT
+    EXPECT_EQ(ComputeExchangeNumLevels(1, 4), 1U);
+    EXPECT_EQ(ComputeExchangeNumLevels(16, 4), 1U);
+    EXPECT_EQ(ComputeExchangeNumLevels(1000, 4), 2U);
+    EXPECT_EQ(ComputeExchangeNumLevels(1000, 1), 1U);
+
+    size_t previous_num_levels = 1;
+    for (size_t num_workers = 1; num_workers <= 1UL << 16U; num_workers *= 2) {
+        auto const num_levels = ComputeExchangeNumLevels(num_workers, 4);
+        EXPECT_GE(num_levels, previous_num_levels);
+        previous_num_levels = num_levels;
+    }
+}
+
+// cppcheck-suppress missingOverride
+TEST(ExchangeLevelsTest, GroupsPartitionWorkers) {  // NOLINT
+    for (size_t num_levels = 1; num_levels <= 3; num_levels++) {
+        for (size_t num_workers : {1UL, 6UL, 7UL, 64UL, 120UL}) {
+            for (size_t level_num = 0; level_num < num_levels; level_num++) {
+                std::set<size_t> seen_workers;
+                for (size_t w = 0; w < num_workers; w++) {
+                    auto const members = ComputeExchangeGroupMembers(
+                            num_levels, level_num, num_workers, w);
+
+                    // Worker is in its own group; groups are symmetric
+                    EXPECT_EQ(std::count(members.begin(), members.end(), w),
+                              1U);
+                    for (auto const m : members) {
+                        ASSERT_LT(m, num_workers);
+                        EXPECT_EQ(ComputeExchangeGroupMembers(
+                                          num_levels, level_num, num_workers,
+                                          m),
+                                  members);
+                    }
+                    seen_workers.insert(members.begin(), members.end());
+                }
+                EXPECT_EQ(seen_workers.size(), num_workers);
+            }
+        }
+    }
+}
+
+// cppcheck-suppress missingOverride
+TEST(ExchangeLevelsTest, RoutingReachesUniqueWorker) {  // NOLINT
+    // Following partition i in every level must lead to the same worker
+    // regardless of the worker the data starts at
+    const size_t num_levels = 3;
+    const size_t num_workers = 60;
+
+    for (size_t key = 0; key < 100; key++) {
+        std::set<size_t> targets;
+        for (size_t w = 0; w < num_workers; w++) {
+            size_t current = w;
+            for (size_t l = 0; l < num_levels; l++) {
+                auto const members = ComputeExchangeGroupMembers(
+                        num_levels, l, num_workers, current);
+                current = members.at((key * (l + 7)) % members.size());
+            }
+            targets.insert(current);
+        }
+        EXPECT_EQ(targets.size(), 1U);
+    }
+}
+
+// cppcheck-suppress missingOverride
+TEST(ExchangeLevelsTest, TwoLevelsMatchSquareRootGroups) {  // NOLINT
+    // Grouping used before the generalization to arbitrary levels
+    const size_t num_workers = 36;
+    const size_t num_groups = 6;
+    for (size_t w = 0; w < num_workers; w++) {
+        std::vector<size_t> level0_members;
+        std::vector<size_t> level1_members;
+        for (size_t i = 0; i < num_workers; i++) {
+            if (i % num_groups == w % num_groups) level0_members.push_back(i);
+            if (i / num_groups == w / num_groups) level1_members.push_back(i);
+        }
+        EXPECT_EQ(ComputeExchangeGroupMembers(2, 0, num_workers, w),
+                  level0_members);
+        EXPECT_EQ(ComputeExchangeGroupMembers(2, 1, num_workers, w),
+                  level1_members);
+    }
+}
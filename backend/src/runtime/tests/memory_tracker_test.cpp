@@ -0,0 +1,157 @@
+#include "runtime/memory/memory_tracker.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include "runtime/jit/memory/free_ref_counter.hpp"
+#include "runtime/jit/memory/memory_tracker.hpp"
+
+using runtime::memory::AdmittedQuery;
+using runtime::memory::ConfigureMemoryTracker;
+using runtime::memory::FreeRefCounter;
+using runtime::memory::GetMemoryUsage;
+using runtime::memory::MemoryLimitExceeded;
+using runtime::memory::TrackedBytes;
+using runtime::memory::TrackingAllocator;
+
+// cppcheck-suppress missingOverride
+TEST(MemoryTrackerTest, TracksCurrentAndPeakBytesOfQuery) {  // NOLINT
+    {
+        const AdmittedQuery query;
+        {
+            TrackedBytes bytes;
+            bytes.Resize(1000);
+            EXPECT_EQ(query.memory()->current_bytes(), 1000);
+            bytes.Resize(300);
+            EXPECT_EQ(query.memory()->current_bytes(), 300);
+        }
+        EXPECT_EQ(query.memory()->current_bytes(), 0);
+        EXPECT_EQ(query.memory()->peak_bytes(), 1000);
+
+        const auto usage = nlohmann::json::parse(GetMemoryUsage());
+        ASSERT_EQ(usage["queries"].size(), 1);
+        EXPECT_EQ(usage["queries"][0]["id"], query.memory()->id());
+    }
+
+    const auto usage = nlohmann::json::parse(GetMemoryUsage());
+    EXPECT_TRUE(usage["queries"].empty());
+    EXPECT_EQ(usage["last_query"]["peak_bytes"], 1000);
+}
+
+// cppcheck-suppress missingOverride
+TEST(MemoryTrackerTest, BuffersKeepCountingTowardsTheirQuery) {  // NOLINT
+    TrackedBytes bytes;
+    std::shared_ptr<runtime::memory::QueryMemory> memory;
+    {
+        const AdmittedQuery query;
+        memory = query.memory();
+        bytes.Resize(4096);
+    }
+    EXPECT_EQ(memory->current_bytes(), 4096);
+    bytes.Resize(0);
+    EXPECT_EQ(memory->current_bytes(), 0);
+}
+
+// cppcheck-suppress missingOverride
+TEST(MemoryTrackerTest, AllocatorReservesInBatches) {  // NOLINT
+    const AdmittedQuery query;
+    {
+        std::unordered_set<int64_t, std::hash<int64_t>, std::equal_to<>,
+                           TrackingAllocator<int64_t>>
+                set;
+        for (int64_t i = 0; i < 1000; i++) set.insert(i);
+        const auto current = query.memory()->current_bytes();
+        EXPECT_GE(current, 1000 * sizeof(int64_t));
+        // Small allocations come out of the reservation of the thread
+        set.insert(1000);
+        EXPECT_EQ(query.memory()->current_bytes(), current);
+    }
+    EXPECT_GT(query.memory()->peak_bytes(), 0);
+}
+
+// cppcheck-suppress missingOverride
+TEST(MemoryTrackerTest, ReleasesToAllocatingQuery) {  // NOLINT
+    const AdmittedQuery query;
+    using Vector = std::vector<int64_t, TrackingAllocator<int64_t>>;
+    auto vector = std::make_unique<Vector>();
+    vector->reserve(1U << 20U);
+    EXPECT_EQ(query.memory()->current_bytes(), 8 << 20);
+
+    // Free the memory on a thread working on another query
+    std::thread thread([&] {
+        const AdmittedQuery other;
+        vector.reset();
+        EXPECT_EQ(other.memory()->current_bytes(), 0);
+    });
+    thread.join();
+    EXPECT_EQ(query.memory()->current_bytes(), 0);
+}
+
+// cppcheck-suppress missingOverride
+TEST(MemoryTrackerTest, ThrowsIfLimitIsExceeded) {  // NOLINT
+    ConfigureMemoryTracker(1U << 20U, 1.0);
+    {
+        const AdmittedQuery query;
+        TrackedBytes bytes;
+        bytes.Resize(1000);
+        EXPECT_THROW(bytes.Resize(2U << 20U), MemoryLimitExceeded);
+        EXPECT_EQ(query.memory()->current_bytes(), 1000);
+
+        std::vector<int64_t, TrackingAllocator<int64_t>> vector;
+        EXPECT_THROW(vector.resize(1U << 20U), MemoryLimitExceeded);
+    }
+    ConfigureMemoryTracker(0, 1.0);
+}
+
+// cppcheck-suppress missingOverride
+TEST(MemoryTrackerTest, ReleasesUnfilledBufferIfLimitIsExceeded) {  // NOLINT
+    // Elements that have not been constructed yet must not be destroyed
+    struct S {
+        ~S() { ADD_FAILURE() << "Destroyed unconstructed element"; }
+    };
+
+    ConfigureMemoryTracker(1U << 20U, 1.0);
+    {
+        const AdmittedQuery query;
+        const size_t capacity = (2U << 20U) / sizeof(S);
+        EXPECT_THROW(new FreeRefCounter<S>(malloc(capacity * sizeof(S)), 0,
+                                           capacity),
+                     MemoryLimitExceeded);
+        EXPECT_EQ(query.memory()->current_bytes(), 0);
+    }
+    ConfigureMemoryTracker(0, 1.0);
+}
+
+// cppcheck-suppress missingOverride
+TEST(MemoryTrackerTest, QueuesQueriesWhileMemoryIsShort) {  // NOLINT
+    ConfigureMemoryTracker(1U << 20U, 0.5);
+    std::atomic<bool> is_admitted{false};
+    {
+        const AdmittedQuery query;
+        TrackedBytes bytes;
+        bytes.Resize(600U << 10U);
+
+        std::thread waiting([&] {
+            const AdmittedQuery other;
+            is_admitted = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_FALSE(is_admitted);
+        EXPECT_EQ(nlohmann::json::parse(GetMemoryUsage())["num_waiting"], 1);
+
+        // Freeing memory lets the waiting query in
+        bytes.Resize(0);
+        waiting.join();
+        EXPECT_TRUE(is_admitted);
+    }
+    ConfigureMemoryTracker(0, 1.0);
+}
@@ -0,0 +1,106 @@
+#include "runtime/jit/memory/numa.hpp"
+
+#include <sched.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "runtime/jit/memory/munmap_ref_counter.hpp"
+#include "runtime/jit/memory/shared_pointer.hpp"
+
+using runtime::memory::AllocateOnNode;
+using runtime::memory::CurrentNumaNode;
+using runtime::memory::HomeNodeOfPartition;
+using runtime::memory::MapPages;
+using runtime::memory::MunmapRefCounter;
+using runtime::memory::NumNumaNodes;
+using runtime::memory::PageSize;
+using runtime::memory::PinWorkerThread;
+using runtime::memory::SharedPointer;
+using runtime::memory::UnmapPages;
+using runtime::memory::WorkerPinningScope;
+
+// cppcheck-suppress missingOverride
+TEST(NumaTest, SpreadsWorkersOverNodes) {  // NOLINT
+    const size_t num_nodes = NumNumaNodes();
+    ASSERT_GE(num_nodes, 1U);
+    EXPECT_LT(CurrentNumaNode(), num_nodes);
+
+    // Pin a separate thread to leave the affinity of the test process alone
+    for (size_t worker = 0; worker < 2 * num_nodes; worker++) {
+        std::thread thread([&] {
+            const size_t node = PinWorkerThread(worker);
+            EXPECT_EQ(node, worker % num_nodes);
+            EXPECT_EQ(CurrentNumaNode(), node);
+
+            cpu_set_t set;
+            ASSERT_EQ(sched_getaffinity(0, sizeof(set), &set), 0);
+            EXPECT_EQ(CPU_COUNT(&set), 1);
+        });
+        thread.join();
+    }
+
+    EXPECT_EQ(HomeNodeOfPartition(num_nodes + 1), 1 % num_nodes);
+}
+
+// cppcheck-suppress missingOverride
+TEST(NumaTest, RestoresAffinityAfterPinningScope) {  // NOLINT
+    std::thread thread([] {
+        cpu_set_t before;
+        ASSERT_EQ(sched_getaffinity(0, sizeof(before), &before), 0);
+
+        {
+            const WorkerPinningScope pinning(1);
+            cpu_set_t pinned;
+            ASSERT_EQ(sched_getaffinity(0, sizeof(pinned), &pinned), 0);
+            EXPECT_EQ(CPU_COUNT(&pinned), 1);
+        }
+
+        cpu_set_t after;
+        ASSERT_EQ(sched_getaffinity(0, sizeof(after), &after), 0);
+        EXPECT_TRUE(CPU_EQUAL(&before, &after));
+    });
+    thread.join();
+}
+
+// cppcheck-suppress missingOverride
+TEST(NumaTest, AllocatesPageAlignedBuffers) {  // NOLINT
+    for (size_t node = 0; node < NumNumaNodes(); node++) {
+        const size_t num_bytes = 3 * PageSize() + 5;
+        auto *const buffer =
+                reinterpret_cast<char *>(AllocateOnNode(num_bytes, node));
+        ASSERT_NE(buffer, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer) % PageSize(), 0U);
+        memset(buffer, 1, num_bytes);
+        EXPECT_EQ(buffer[num_bytes - 1], 1);
+        UnmapPages(buffer, num_bytes);
+    }
+}
+
+// cppcheck-suppress missingOverride
+TEST(NumaTest, UnmapsBuffersOfRefCounters) {  // NOLINT
+    static size_t num_destroyed = 0;
+    struct S {
+        S() = default;
+        S(const S &other) = delete;
+        S(S &&other) = delete;
+        auto operator=(const S &other) -> S & = delete;
+        auto operator=(S &&other) -> S & = delete;
+        ~S() { num_destroyed++; }
+    };
+
+    const size_t capacity = PageSize() + 1;
+    {
+        auto *const rc = new MunmapRefCounter<S>(
+                MapPages(capacity * sizeof(S)), 0, capacity);
+        const SharedPointer<S> ptr(rc);
+        for (size_t i = 0; i < 3; i++) new (ptr.get() + i) S();
+        rc->set_num_elements(3);
+        EXPECT_EQ(rc->num_elements(), 3U);
+    }
+    EXPECT_EQ(num_destroyed, 3U);
+}
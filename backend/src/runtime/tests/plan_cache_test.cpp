@@ -0,0 +1,90 @@
+#include "net/tcp/plan_cache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using runtime::net::tcp::PlanCache;
+
+// cppcheck-suppress missingOverride
+TEST(PlanCacheTest, LoadsEachPlanOnce) {  // NOLINT
+    PlanCache<std::string> cache(4);
+    int num_loads = 0;
+    auto const load = [&]() {
+        num_loads++;
+        return std::make_shared<const std::string>("plan");
+    };
+
+    auto const first = cache.LookUpOrLoad("a", load);
+    auto const second = cache.LookUpOrLoad("a", load);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(*first, "plan");
+    EXPECT_EQ(num_loads, 1);
+}
+
+// cppcheck-suppress missingOverride
+TEST(PlanCacheTest, EvictsLeastRecentlyUsedPlan) {  // NOLINT
+    PlanCache<std::string> cache(2);
+    auto const load = [](const std::string &value) {
+        return [=]() { return std::make_shared<const std::string>(value); };
+    };
+
+    auto const a = cache.LookUpOrLoad("a", load("a"));
+    cache.LookUpOrLoad("b", load("b"));
+    cache.LookUpOrLoad("a", load("a"));
+    cache.LookUpOrLoad("c", load("c"));
+    EXPECT_EQ(cache.size(), 2U);
+
+    // "a" was used more recently than "b"
+    EXPECT_EQ(cache.LookUpOrLoad("a", load("x")), a);
+    EXPECT_EQ(*cache.LookUpOrLoad("b", load("x")), "x");
+}
+
+// cppcheck-suppress missingOverride
+TEST(PlanCacheTest, DoesNotKeepFailedLoads) {  // NOLINT
+    PlanCache<std::string> cache(2);
+    EXPECT_THROW(cache.LookUpOrLoad("a",
+                                    []() -> std::shared_ptr<const std::string> {
+                                        throw std::runtime_error("failed");
+                                    }),
+                 std::runtime_error);
+    EXPECT_EQ(cache.size(), 0U);
+
+    auto const plan = cache.LookUpOrLoad(
+            "a", []() { return std::make_shared<const std::string>("a"); });
+    EXPECT_EQ(*plan, "a");
+}
+
+// cppcheck-suppress missingOverride
+TEST(PlanCacheTest, LoadsOtherPlansConcurrently) {  // NOLINT
+    PlanCache<std::string> cache(4);
+    std::atomic<bool> is_slow_load_done{false};
+    std::atomic<int> num_slow_loads{0};
+
+    auto const slow_load = [&]() {
+        num_slow_loads++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        is_slow_load_done = true;
+        return std::make_shared<const std::string>("slow");
+    };
+
+    std::thread first([&]() { cache.LookUpOrLoad("slow", slow_load); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Another plan does not wait for the slow one...
+    cache.LookUpOrLoad(
+            "fast", []() { return std::make_shared<const std::string>("f"); });
+    EXPECT_FALSE(is_slow_load_done);
+
+    // ...while the same plan waits for it instead of loading it again
+    EXPECT_EQ(*cache.LookUpOrLoad("slow", slow_load), "slow");
+    EXPECT_TRUE(is_slow_load_done);
+    EXPECT_EQ(num_slow_loads, 1);
+
+    first.join();
+}
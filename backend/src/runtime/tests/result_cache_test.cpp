@@ -0,0 +1,129 @@
+#include "runtime/memory/result_cache.hpp"
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "runtime/jit/memory/default_ref_counter.hpp"
+#include "runtime/jit/memory/shared_pointer.hpp"
+#include "runtime/jit/values/array.hpp"
+#include "runtime/jit/values/json_parsing.hpp"
+#include "runtime/jit/values/tuple.hpp"
+#include "runtime/memory/values.hpp"
+
+using runtime::memory::ClearResultCache;
+using runtime::memory::ConfigureResultCache;
+using runtime::memory::LookUpCachedResult;
+using runtime::memory::StoreCachedResult;
+namespace memory = runtime::memory;
+namespace values = runtime::values;
+
+namespace {
+
+constexpr size_t kNumElements = 1000;
+constexpr size_t kResultSize = kNumElements * sizeof(int64_t);
+
+// Returns a result with one column holding first, first + 1, ...
+auto MakeResult(const int64_t first) -> std::string {
+    auto* const data = new int64_t[kNumElements];
+    for (size_t i = 0; i < kNumElements; i++) {
+        data[i] = first + static_cast<int64_t>(i);
+    }
+
+    auto array = std::make_shared<values::Array>();
+    array->data = memory::SharedPointer<char>(
+            // NOLINTNEXTLINE(modernize-avoid-c-arrays)
+            new memory::DefaultRefCounter<int64_t[]>(data));
+    array->outer_shape = {kNumElements};
+    array->offsets = {0};
+    array->shape = {kNumElements};
+
+    auto tuple = std::make_shared<values::Tuple>();
+    tuple->fields.emplace_back(array);
+
+    // Like ExecutePlan, hand out one reference with the result
+    const values::VectorOfValues result = {tuple};
+    memory::Increment(result);
+    return values::ConvertToJsonString(result);
+}
+
+// Stores a result, releasing the reference of the caller like the Python side
+void Store(const std::string& key, const int64_t first) {
+    auto const result = MakeResult(first);
+    StoreCachedResult(key, result, {sizeof(int64_t)});
+    memory::Decrement(result);
+}
+
+// Returns whether the result under the given key starts with first
+auto LookUpAndCheck(const std::string& key, const int64_t first) -> bool {
+    auto const result = LookUpCachedResult(key);
+    if (result.empty()) return false;
+
+    bool ret = true;
+    {
+        auto const values = values::ConvertFromJsonString(result.c_str());
+        const auto* const tuple = values.at(0)->as<values::Tuple>();
+        const auto* const array = tuple->fields.at(0)->as<values::Array>();
+        const auto* const data =
+                reinterpret_cast<const int64_t*>(array->data.get());
+        for (size_t i = 0; i < kNumElements; i++) {
+            ret &= data[i] == first + static_cast<int64_t>(i);
+        }
+    }
+
+    memory::Decrement(result);
+    return ret;
+}
+
+class ResultCacheTest : public testing::Test {
+protected:
+    void TearDown() override {
+        ClearResultCache();
+        ConfigureResultCache(1UL << 32U, "");
+    }
+};
+
+}  // namespace
+
+// cppcheck-suppress missingOverride
+TEST_F(ResultCacheTest, StoreAndLookUp) {  // NOLINT
+    Store("a", 42);
+    EXPECT_TRUE(LookUpAndCheck("a", 42));
+    EXPECT_TRUE(LookUpAndCheck("a", 42));
+    EXPECT_TRUE(LookUpCachedResult("b").empty());
+
+    // Replace
+    Store("a", 7);
+    EXPECT_TRUE(LookUpAndCheck("a", 7));
+}
+
+// cppcheck-suppress missingOverride
+TEST_F(ResultCacheTest, DropsWithoutSpillDirectory) {  // NOLINT
+    ConfigureResultCache(kResultSize * 3 / 2, "");
+    Store("a", 1);
+    Store("b", 2);
+    EXPECT_TRUE(LookUpCachedResult("a").empty());
+    EXPECT_TRUE(LookUpAndCheck("b", 2));
+}
+
+// cppcheck-suppress missingOverride
+TEST_F(ResultCacheTest, SpillsLeastRecentlyUsed) {  // NOLINT
+    ConfigureResultCache(kResultSize * 5 / 2,
+                         testing::TempDir() + "result_cache_test");
+    Store("a", 1);
+    Store("b", 2);
+    EXPECT_TRUE(LookUpAndCheck("a", 1));
+
+    // Spills b, which is less recently used than a
+    Store("c", 3);
+
+    // Each of these reloads one result and spills another one
+    EXPECT_TRUE(LookUpAndCheck("b", 2));
+    EXPECT_TRUE(LookUpAndCheck("c", 3));
+    EXPECT_TRUE(LookUpAndCheck("a", 1));
+    EXPECT_TRUE(LookUpAndCheck("b", 2));
+}
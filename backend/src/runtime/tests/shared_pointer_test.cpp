@@ -366,3 +366,27 @@ TEST(SharedPointerTest, ThreadedMove) {  // NOLINT
     EXPECT_EQ(min, 1);
     EXPECT_LE(max, 4);
 }
+
+// cppcheck-suppress missingOverride
+TEST(SharedPointerTest, FreeDestroysOnlyConstructedElements) {  // NOLINT
+    static size_t num_destroyed = 0;
+    struct S {
+        S() = default;
+        S(const S& other) = delete;
+        S(S&& other) = delete;
+        auto operator=(const S& other) -> S& = delete;
+        auto operator=(S&& other) -> S& = delete;
+        ~S() { num_destroyed++; }
+    };
+
+    constexpr size_t kCapacity = 8;
+    {
+        auto* const rc = new FreeRefCounter<S>(malloc(kCapacity * sizeof(S)),
+                                               0, kCapacity);
+        const SharedPointer<S> ptr(rc);
+        for (size_t i = 0; i < 3; i++) new (ptr.get() + i) S();
+        rc->set_num_elements(3);
+        EXPECT_EQ(rc->num_elements(), 3U);
+    }
+    EXPECT_EQ(num_destroyed, 3U);
+}
@@ -0,0 +1,55 @@
+#include "runtime/jit/memory/spill_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using runtime::memory::SpillFile;
+
+// cppcheck-suppress missingOverride
+TEST(SpillFileTest, ReadsBackWrittenData) {  // NOLINT
+    SpillFile file("");
+    std::vector<int64_t> data(1000);
+    std::iota(data.begin(), data.end(), 0);
+    file.Write(data.data(), data.size() * sizeof(int64_t));
+    file.Write(data.data(), sizeof(int64_t));
+    EXPECT_EQ(file.num_bytes(), (data.size() + 1) * sizeof(int64_t));
+
+    std::vector<int64_t> read(data.size());
+    file.Rewind();
+    ASSERT_TRUE(file.Read(read.data(), read.size() * sizeof(int64_t)));
+    EXPECT_EQ(read, data);
+    int64_t last = -1;
+    ASSERT_TRUE(file.Read(&last, sizeof(last)));
+    EXPECT_EQ(last, 0);
+    EXPECT_FALSE(file.Read(&last, sizeof(last)));
+
+    // Writing after reading appends
+    last = 42;
+    file.Write(&last, sizeof(last));
+    file.Rewind();
+    ASSERT_TRUE(file.Read(read.data(), read.size() * sizeof(int64_t)));
+    ASSERT_TRUE(file.Read(&last, sizeof(last)));
+    ASSERT_TRUE(file.Read(&last, sizeof(last)));
+    EXPECT_EQ(last, 42);
+}
+
+// cppcheck-suppress missingOverride
+TEST(SpillFileTest, ReportsTruncatedData) {  // NOLINT
+    SpillFile file("");
+    const int32_t value = 1;
+    file.Write(&value, sizeof(value));
+    file.Rewind();
+    int64_t read = 0;
+    EXPECT_THROW(file.Read(&read, sizeof(read)), std::runtime_error);
+}
+
+// cppcheck-suppress missingOverride
+TEST(SpillFileTest, FailsOnMissingDirectory) {  // NOLINT
+    EXPECT_THROW(SpillFile("/nonexistent/spill/directory"), std::runtime_error);
+}
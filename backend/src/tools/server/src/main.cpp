@@ -0,0 +1,52 @@
+#include <cstdint>
+
+#include <iostream>
+#include <string>
+
+#include <boost/program_options.hpp>
+
+#include "runtime/query_server.hpp"
+
+namespace po = boost::program_options;
+
+auto main(int argc, char *argv[]) -> int {
+    std::string address;
+    uint16_t port = 0;
+    size_t batch_size = 0;
+    size_t max_request_size = 0;
+    size_t max_num_plans = 0;
+
+    po::options_description desc(
+            "Run compiled DAGs submitted over TCP and stream their results as "
+            "Arrow IPC.");
+    desc.add_options()                             //
+            ("help", "Produce this help message")  //
+            ("address,a",
+             po::value<std::string>(&address)->default_value("127.0.0.1"),
+             "Address to listen on")  //
+            ("port,p", po::value<uint16_t>(&port)->default_value(9090),
+             "Port to listen on")  //
+            ("batch-size,b",
+             po::value<size_t>(&batch_size)->default_value(1U << 16U),
+             "Maximum number of rows per record batch")  //
+            ("max-request-size",
+             po::value<size_t>(&max_request_size)->default_value(1U << 30U),
+             "Maximum size of a request in bytes")  //
+            ("max-num-plans",
+             po::value<size_t>(&max_num_plans)->default_value(64),
+             "Maximum number of compiled plans kept across requests")  //
+            ;
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+
+    if (vm.count("help") > 0) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    po::notify(vm);
+
+    runtime::RunQueryServer(address, port, batch_size, max_request_size,
+                            max_num_plans);
+}
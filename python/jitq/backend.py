@@ -9,7 +9,13 @@
 # pylint: disable=unused-import
 #         The imported symbols are used by other modules
 from jitq_backend import \
+    ClearResultCache, \
+    ConfigureMemoryTracker, \
+    ConfigureResultCache, \
     DumpDag, \
     ExecutePlan, \
     FreeResult, \
-    GenerateExecutable
+    GenerateExecutable, \
+    GetMemoryUsage, \
+    LookUpCachedResult, \
+    StoreCachedResult
@@ -77,6 +77,28 @@ def lookup_or_generate_plan(context, dag_str, conf_str):
     return plan_id
 
 
+def lookup_cached_result(key):
+    res = backend.LookUpCachedResult(key)
+    return ResultHandle(res) if res else None
+
+
+def execute_and_cache(context, dag_dict, inputs, key, item_sizes):
+    """
+    Executes the DAG and stores its result in the result cache of the runtime
+    under the given key. Returns the result unwrapped.
+    """
+    args_str = json.dumps(inputs)
+    dag_str = json.dumps(dag_dict, cls=RDDEncoder)
+    conf_str = json.dumps(context.conf)
+
+    plan_id = lookup_or_generate_plan(context, dag_str, conf_str)
+
+    res = ResultHandle(backend.ExecutePlan(plan_id, args_str))
+    backend.StoreCachedResult(key, res.string, item_sizes)
+
+    return res
+
+
 def execute(context, dag_dict, inputs, output_type):
     args_str = json.dumps(inputs)
     dag_str = json.dumps(dag_dict, cls=RDDEncoder)
@@ -6,8 +6,10 @@ import jsonmerge
 
 from pandas import DataFrame
 
+from jitq import backend
 from jitq.rdd import RowScan, GeneratorSource, Range, \
-    Cartesian, ConstantTuple, ColumnScan, ParquetScan, ExpandPattern
+    Cartesian, ConstantTuple, ColumnScan, CsvScan, ParquetScan, \
+    ExpandPattern
 from jitq.utils import get_project_path
 
 
@@ -31,12 +33,24 @@ class JitqContext:
         self.serialization_cache = {}
         self.executor_cache = {}
 
+        result_cache_conf = conf.get('result_cache', {})
+        backend.ConfigureResultCache(
+            result_cache_conf.get('budget', 1 << 32),
+            result_cache_conf.get('spill_directory', ''))
+
+        memory_tracker_conf = conf.get('memory_tracker', {})
+        backend.ConfigureMemoryTracker(
+            memory_tracker_conf.get('limit', 0),
+            memory_tracker_conf.get('admission_threshold', 1.0))
+
     def clear_caches(self):
         self.serialization_cache.clear()
         self.executor_cache.clear()
+        backend.ClearResultCache()
 
-    def read_csv(self, path, dtype=None):
-        raise NotImplementedError
+    @staticmethod
+    def memory_usage():
+        return json.loads(backend.GetMemoryUsage())
 
     def collection(self, values, add_index=False):
         if isinstance(values, DataFrame):
@@ -52,24 +66,46 @@ class JitqContext:
     def generator(self, func):
         return GeneratorSource(self, func)
 
+    def read_csv(self, filename_or_pattern, columns, delimiter=',',
+                 quote='"', header=False, pattern_range=(0, 1)):
+        return ColumnScan(
+            self,
+            CsvScan(
+                self,
+                self._file_slices(filename_or_pattern, pattern_range),
+                columns=columns,
+                filesystem=self._filesystem_of(filename_or_pattern),
+                delimiter=delimiter,
+                quote=quote,
+                header=header,
+            ),
+            False
+        )
+
     def read_parquet(self, filename_or_pattern, columns, pattern_range=(0, 1)):
-        filesystem = 'file'
-        try:
-            url = urlparse(filename_or_pattern)
-            if url.scheme == 's3':
-                filesystem = 's3'
-        except BaseException:
-            pass
         return ColumnScan(
             self,
             ParquetScan(
                 self,
-                Cartesian(
-                    self,
-                    ExpandPattern(self, filename_or_pattern, pattern_range),
-                    ConstantTuple(self, (0, 1, 1))),
+                self._file_slices(filename_or_pattern, pattern_range),
                 columns=columns,
-                filesystem=filesystem,
+                filesystem=self._filesystem_of(filename_or_pattern),
             ),
             False
         )
+
+    @staticmethod
+    def _filesystem_of(filename_or_pattern):
+        try:
+            url = urlparse(filename_or_pattern)
+            if url.scheme == 's3':
+                return 's3'
+        except BaseException:
+            pass
+        return 'file'
+
+    def _file_slices(self, filename_or_pattern, pattern_range):
+        return Cartesian(
+            self,
+            ExpandPattern(self, filename_or_pattern, pattern_range),
+            ConstantTuple(self, (0, 1, 1)))
@@ -4,6 +4,8 @@ from llvmlite import ir
 from llvmlite.ir import VoidType
 from numba import sigutils
 from numba.ccallback import CFunc
+from numba.generators import GeneratorDescriptor
+from numba.targets.callconv import RETCODE_OK
 
 from jitq.utils import replace_unituple, flatten, replace_record
 
@@ -24,6 +26,26 @@ def get_llvm_ir(sig, func, **options):
     # otherwise a return pointer is used
 
     res.compile()
+    return _make_deterministic(res)
+
+
+def get_generator_llvm_ir(sig, func, **options):
+    """
+    Returns the LLVM IR of the given generator function and the size of its
+    state. The entry function initializes the state from the arguments, the
+    entry function with suffix '_next' resumes it, see JITQGeneratorCFunc.
+    """
+    sig = sigutils.normalize_signature(sig)
+
+    args, gen_type = sig
+    args = tuple(replace_record(replace_unituple(arg)) for arg in args)
+
+    res = JITQGeneratorCFunc(func, (args, gen_type), {}, options=options)
+    res.compile()
+    return _make_deterministic(res), res.state_size
+
+
+def _make_deterministic(res):
     code = res.inspect_llvm()
 
     # Make some symbol names deterministic to enable caching, e.g.,
@@ -123,21 +145,115 @@ class JITQCFunc(CFunc):
         _, out = context.call_conv.call_function(
             builder, function_ir, sig.return_type, sig.args, args)
 
-        # Copy result into packed struct
-        ll_resty = retptr.type.pointee
-
-        if isinstance(ll_resty, ir.types.LiteralStructType):
-            # Copy struct element-wise to convert it to a packed one
-            ll_tmpptr = builder.alloca(ll_resty)
-            ll_res = builder.load(ll_tmpptr)
-            for i in range(len(ll_resty)):
-                val = builder.extract_value(out, i)
-                ll_res = builder.insert_value(ll_res, val, i)
-        else:
-            # Copy everything else as is
-            ll_res = out
-
-        # Copy packed struct into result pointer
-        cast_retptr = builder.bitcast(retptr, ir.PointerType(ll_res.type))
-        builder.store(ll_res, cast_retptr)
+        _store_packed(builder, out, retptr)
+        builder.ret_void()
+
+
+class JITQGeneratorCFunc(CFunc):
+    """
+    Numba Cfunc wrapper that produces JITQ compatible LLVM IR for generators
+
+    The signature must have the generator type as return type. Two C wrappers
+    are produced, which share the conventions of JITQCFunc for arguments and
+    yielded values:
+    1) void init(i8* state, args...) initializes the generator state
+    2) i32 init_next(yield_type* res, i8* state) resumes the generator and
+       returns 1 if it yielded a value and 0 otherwise
+    """
+
+    @property
+    def state_size(self):
+        context = self._targetdescr.target_context
+        return context.get_abi_sizeof(
+            context.get_data_type(self._sig.return_type))
+
+    def _compile_uncached(self):
+        # pylint: disable=too-many-locals  # Doesn't make sense to split...
+        sig = self._sig
+        gen_type = sig.return_type
+
+        cres = self._compiler.compile(sig.args, gen_type)
+        assert not cres.objectmode  # disabled by compiler above
+        fndesc = cres.fndesc
+
+        library = cres.library
+        module = library.create_ir_module(fndesc.unique_name)
+        context = cres.target_context
+
+        # Declare the functions of the generator, see numba.generators
+        gendesc = GeneratorDescriptor.from_generator_fndesc(
+            None, fndesc, gen_type, context.mangler)
+        init_fn = module.add_function(
+            context.call_conv.get_function_type(gen_type, sig.args),
+            fndesc.llvm_func_name)
+        next_fn = module.add_function(
+            context.call_conv.get_function_type(gen_type.yield_type,
+                                                [gen_type]),
+            gendesc.llvm_func_name)
+
+        state_ptr_type = ir.IntType(8).as_pointer()
+
+        # Init wrapper: the generator writes its initial state directly into
+        # the state provided by the caller
+        flat_args = flatten(sig.args)
+        ll_argtypes = [context.get_value_type(ty) for ty in flat_args]
+        wrapfn = module.add_function(
+            ir.FunctionType(VoidType(), [state_ptr_type] + ll_argtypes),
+            fndesc.llvm_cfunc_wrapper_name)
+        builder = ir.IRBuilder(wrapfn.append_basic_block('entry'))
+        gen_ptr = builder.bitcast(wrapfn.args[0], init_fn.args[0].type)
+        excinfo_ptr = builder.alloca(init_fn.args[1].type.pointee)
+        arg_packer = context.get_arg_packer(flat_args)
+        builder.call(init_fn, [gen_ptr, excinfo_ptr] +
+                     list(arg_packer.as_arguments(builder, wrapfn.args[1:])))
         builder.ret_void()
+
+        # Next wrapper: resume the generator and copy the yielded value
+        ll_resptr = context.call_conv.get_return_type(gen_type.yield_type)
+        if isinstance(ll_resptr.pointee, ir.types.LiteralStructType):
+            ll_resptr = ir.LiteralStructType(ll_resptr.pointee,
+                                             True).as_pointer()
+        wrapfn = module.add_function(
+            ir.FunctionType(ir.IntType(32), [ll_resptr, state_ptr_type]),
+            fndesc.llvm_cfunc_wrapper_name + '_next')
+        builder = ir.IRBuilder(wrapfn.append_basic_block('entry'))
+        yield_ptr = builder.alloca(next_fn.args[0].type.pointee)
+        excinfo_ptr = builder.alloca(next_fn.args[1].type.pointee)
+        gen_ptr = builder.bitcast(wrapfn.args[1], next_fn.args[2].type)
+        status = builder.call(next_fn, [yield_ptr, excinfo_ptr, gen_ptr])
+        is_ok = builder.icmp_signed('==', status,
+                                    ir.Constant(status.type, RETCODE_OK))
+        with builder.if_then(is_ok):
+            out = context.get_returned_value(
+                builder, gen_type.yield_type, builder.load(yield_ptr))
+            _store_packed(builder, out, wrapfn.args[0])
+        builder.ret(builder.zext(is_ok, ir.IntType(32)))
+
+        # Finalize and compile
+        library.add_ir_module(module)
+        library.finalize()
+
+        return cres
+
+
+def _store_packed(builder, out, retptr):
+    """
+    Copies the given value into the result pointer, converting structs to
+    packed ones.
+    """
+    ll_resty = retptr.type.pointee
+
+    if isinstance(ll_resty, ir.types.LiteralStructType):
+        # Copy struct element-wise to convert it to a packed one
+        ll_tmpptr = builder.alloca(ll_resty)
+        ll_res = builder.load(ll_tmpptr)
+        for i in range(len(ll_resty)):
+            val = builder.extract_value(out, i)
+            ll_res = builder.insert_value(ll_res, val, i)
+    else:
+        # Copy everything else as is
+        ll_res = out
+
+    # Copy packed struct into result pointer
+    cast_retptr = builder.bitcast(retptr, ir.PointerType(ll_res.type))
+    builder.store(ll_res, cast_retptr)
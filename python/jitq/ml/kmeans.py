@@ -69,6 +69,9 @@ class KMeans:
         self.tol = _tolerance(X, self.tol)
         in_ = self._context.collection(X, add_index=True)
         metric = self._metric
+        # keys are point and centroid indices, respectively, which are dense
+        point_range = (0, len(X) - 1)
+        centroid_range = (0, self.n_clusters - 1)
 
         def reduce_1(tuple_1, tuple_2):
             point = tuple_1[0][:]
@@ -113,12 +116,12 @@ class KMeans:
             # put points first to reduce on them
             cart = cart.map(map_0)
             # for every point compute the closest centroid (E step)
-            pnt_center = cart.reduce_by_key(reduce_1)
+            pnt_center = cart.reduce_by_key(reduce_1, point_range)
             # put centres first to reduce on them,
             # use the point index as the accumulator
             centr_pnt = pnt_center.map(lambda *t: (t[1], 1, t[0][1:]))
             # reassign each centroid to the mean (M step)
-            centr_pnt = centr_pnt.reduce_by_key(reduce_2)
+            centr_pnt = centr_pnt.reduce_by_key(reduce_2, centroid_range)
             # project the new centroids and compute the mean
             centroids = centr_pnt.map(map_1)
             # # compute the error
@@ -139,7 +142,8 @@ class KMeans:
         # put points first to reduce on them
         cart = cart.map(map_0)
         # for every point compute the closest centroid (E step)
-        pnt_center_distance = cart.reduce_by_key(reduce_1).collect()
+        pnt_center_distance = \
+            cart.reduce_by_key(reduce_1, point_range).collect()
 
         last_col_index = pnt_center_distance.dtype.names[-1]
         self.inertia_ = np.sum(
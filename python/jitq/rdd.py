@@ -15,10 +15,10 @@ from jitq import c_executor
 from jitq.rdd_result import NumpyResult
 from jitq.ast_optimizer import OPT_CONST_PROPAGATE, ast_optimize
 from jitq.config import FAST_MATH, DUMP_DAG
-from jitq.libs.numba.llvm_ir import get_llvm_ir
+from jitq.libs.numba.llvm_ir import get_llvm_ir, get_generator_llvm_ir
 from jitq.utils import replace_unituple, get_project_path, RDDEncoder, \
     make_tuple, item_typeof, numba_type_to_dtype, is_item_type, C_TYPE_MAP, \
-    make_flat_tuple, make_record
+    make_flat_tuple, make_record, get_type_size
 
 
 def clean_rdds(rdd):
@@ -55,6 +55,14 @@ def get_llvm_ir_for_generator(func):
     return llvm, output_type
 
 
+def check_num_keys(num_keys):
+    if num_keys <= 0:
+        raise TypeError(
+            "Number of keys cannot be zero or negative \n"
+            "  found :    {0}\n"
+            .format(num_keys))
+
+
 class RDD(abc.ABC):
     # pylint: disable=too-many-public-methods
     NAME = 'abstract'
@@ -71,6 +79,7 @@ class RDD(abc.ABC):
             self.visited = set()
 
         def visit(self, operator):
+            operator = operator.dag_node()
             if str(operator) in self.visited:
                 return
             self.visited.add(str(operator))
@@ -81,6 +90,7 @@ class RDD(abc.ABC):
     def __init__(self, context, parents):
         self.dic = None
         self._cache = False
+        self.cached_scan = None
         self.parents = parents
         self.context = context
         self.output_type = None
@@ -89,9 +99,95 @@ class RDD(abc.ABC):
             raise ValueError("The context of all parents must be the same!")
 
     def cache(self):
+        """
+        Keeps the result of this RDD in the result cache of the runtime once it
+        is computed by some action, so later actions read it instead of
+        recomputing it. Only results consisting of numbers are cached.
+        """
         self._cache = True
         return self
 
+    def dag_node(self):
+        """
+        Returns the RDD representing this one in DAGs, i.e., the scan of its
+        cached result if there is one.
+        """
+        return self.cached_scan if self.cached_scan is not None else self
+
+    def should_cache(self):
+        if not self._cache:
+            return False
+        type_ = self.output_type
+        if isinstance(type_, types.BaseTuple):
+            return all(isinstance(t, types.Number) for t in type_.types)
+        return isinstance(type_, types.Number)
+
+    def resolve_cached(self):
+        """
+        Replaces the cached RDDs that this RDD depends on by scans of their
+        results, computing those not found in the result cache. Returns the
+        replaced RDDs.
+        """
+        cached_rdds = []
+
+        # Keys are computed on the original DAGs, which do not change if a
+        # result needs to be recomputed
+        for operator in self.__original_operators():
+            operator.cached_scan = None
+            if operator is not self and operator.should_cache():
+                cached_rdds.append(operator)
+        keys = [operator.result_cache_key() for operator in cached_rdds]
+
+        # Parents come before their children, so results are computed from
+        # the cached results they depend on
+        for operator, key in zip(cached_rdds, keys):
+            operator.cached_scan = operator.make_cached_scan(key)
+
+        return cached_rdds
+
+    def __original_operators(self):
+        operators = []
+        visited = set()
+
+        def visit(operator):
+            if str(operator) in visited:
+                return
+            visited.add(str(operator))
+            for parent in operator.parents:
+                visit(parent)
+            operators.append(operator)
+
+        visit(self)
+        return operators
+
+    def result_cache_key(self):
+        inputs = [v for (_, v) in sorted(self.get_inputs().values(),
+                                         key=lambda input_: input_[0])]
+        return str(hash(self)) + '#' + json.dumps(inputs)
+
+    def make_cached_scan(self, key):
+        type_ = self.output_type
+        item_types = list(type_.types) if isinstance(type_, types.BaseTuple) \
+            else [type_]
+
+        handle = c_executor.lookup_cached_result(key)
+        if handle is None:
+            source = self if isinstance(type_, types.BaseTuple) \
+                else self.map(lambda x: (x,))
+            materialized = EnsureSingleTuple(
+                self.context, MaterializeColumnVector(self.context, source))
+            handle = c_executor.execute_and_cache(
+                self.context, materialized.get_final_dict(),
+                materialized.get_input_values(), key,
+                [get_type_size(t) for t in item_types])
+
+        value = json.loads(handle.string)[0]
+        parent = ParameterLookup(
+            self.context,
+            make_tuple([types.Array(t, 1, "C") for t in item_types]),
+            value, handle)
+        return ColumnScan(self.context, parent, False)
+
     def write_dag(self):
         op_dicts = dict()
 
@@ -103,7 +199,7 @@ class RDD(abc.ABC):
 
             op_dict['id'] = len(op_dicts)
             op_dict['predecessors'] = \
-                [{'op': op_dicts[str(p)]['id'], 'port': 0}
+                [{'op': op_dicts[str(p.dag_node())]['id'], 'port': 0}
                  for p in operator.parents]
             op_dict['op'] = operator.NAME
             op_dict['output_type'] = make_flat_tuple(operator.output_type)
@@ -149,14 +245,22 @@ class RDD(abc.ABC):
         return dag_dict
 
     def execute_dag(self):
+        cached_rdds = self.resolve_cached()
+        try:
+            dag_dict = self.get_final_dict()
+            input_values = self.get_input_values()
+            return c_executor.execute(
+                self.context, dag_dict, input_values, self.output_type)
+        finally:
+            # Release the cached results so the runtime can spill them
+            for operator in cached_rdds:
+                operator.cached_scan = None
+
+    def get_input_values(self):
         inputs = self.get_inputs()
-        dag_dict = self.get_final_dict()
-
-        input_values = [v for (_, v) in
-                        sorted(list(inputs.values()),
-                               key=lambda input_: input_[0])]
-        return c_executor.execute(
-            self.context, dag_dict, input_values, self.output_type)
+        return [v for (_, v) in
+                sorted(list(inputs.values()),
+                       key=lambda input_: input_[0])]
 
     def __hash__(self):
         hashes = []
@@ -206,27 +310,31 @@ class RDD(abc.ABC):
     def flat_map(self, func):
         return FlatMap(self.context, self, func)
 
-    def reduce_by_key(self, func):
-        return ReduceByKey(self.context, self, func)
+    def reduce_by_key(self, func, key_range=None, num_keys=1):
+        return ReduceByKey(self.context, self, func, key_range, num_keys)
 
     def reduce_by_index(self, func, min_idx, max_idx):
         return ReduceByIndex(self.context, self, func, min_idx, max_idx)
 
+    def window(self, func, frame_size=None, num_keys=0):
+        return Window(self.context, self, func, frame_size, num_keys)
+
     def reduce(self, func):
         return EnsureSingleTuple(self.context,
                                  Reduce(self.context, self, func)) \
             .execute_dag()
 
-    def join(self, other, num_keys=1):
-        return Join(self.context, self, other, num_keys)
+    def join(self, other, num_keys=1, broadcast=None):
+        return Join(self.context, self, other, num_keys, broadcast)
 
-    def antijoin(self, other, predicate=None):
+    def antijoin(self, other, predicate=None, num_keys=1):
         if not predicate:
-            return AntiJoin(self.context, self, other)
-        return AntiJoinPredicated(self.context, self, other, predicate)
+            return AntiJoin(self.context, self, other, num_keys)
+        return AntiJoinPredicated(self.context, self, other, predicate,
+                                  num_keys)
 
-    def semijoin(self, other):
-        return SemiJoin(self.context, self, other)
+    def semijoin(self, other, num_keys=1):
+        return SemiJoin(self.context, self, other, num_keys)
 
     def cartesian(self, other):
         return Cartesian(self.context, self, other)
@@ -237,6 +345,9 @@ class RDD(abc.ABC):
     def sort(self):
         return Sort(self.context, self)
 
+    def distinct(self):
+        return Distinct(self.context, self)
+
     def zip(self, other):
         return Zip(self.context, self, other)
 
@@ -274,6 +385,15 @@ class RDD(abc.ABC):
         ret = self.map(lambda t: 1).reduce(lambda t1, t2: t1 + t2)
         return ret if ret is not None else 0
 
+    def count_distinct(self):
+        return self.distinct().count()
+
+    def approx_count_distinct(self, precision=14):
+        return EnsureSingleTuple(
+            self.context,
+            ApproxCountDistinct(self.context, self, precision)) \
+            .execute_dag()
+
 
 class SourceRDD(RDD):
     def __init__(self, context):
@@ -437,10 +557,24 @@ class FlatMap(PipeRDD):
 
     def __init__(self, context, parent, func):
         super().__init__(context, parent, func)
-        self.llvm_ir, self.output_type = get_llvm_ir_for_generator(self.func)
+        arg_types = (self.parents[0].output_type,)
+        gen_type = numba.njit(arg_types, fastmath=FAST_MATH)(func) \
+            .nopython_signatures[0].return_type
+        if not isinstance(gen_type, types.Generator):
+            raise BaseException(
+                "Function given to flat_map must be a generator:\n"
+                "  found:    {0}".format(gen_type))
+        self.output_type = replace_unituple(gen_type.yield_type)
+        if not is_item_type(self.output_type):
+            raise BaseException(
+                "Function given to flat_map has the wrong yield type:\n"
+                "  found:    {0}".format(self.output_type))
+        self.llvm_ir, self.state_size = get_generator_llvm_ir(
+            gen_type(*arg_types), self.func, fastmath=FAST_MATH)
 
     def self_write_dag(self, dic):
         dic['func'] = self.llvm_ir
+        dic['state_size'] = self.state_size
 
 
 class Join(BinaryRDD):
@@ -448,16 +582,21 @@ class Join(BinaryRDD):
 
     """
     the first num_keys elements in a tuple are the key
+    broadcast is an optional hint ('left' or 'right') naming a small input,
+    which distributed plans replicate to all workers instead of partitioning
+    both inputs
     """
 
-    def __init__(self, context, left, right, num_keys):
+    def __init__(self, context, left, right, num_keys, broadcast=None):
         super().__init__(context, [left, right])
         self.num_keys = num_keys
-        if self.num_keys <= 0:
-            raise TypeError(
-                "Number of keys cannot be zero or negative \n"
+        self.broadcast = broadcast
+        check_num_keys(self.num_keys)
+        if self.broadcast not in (None, 'left', 'right'):
+            raise ValueError(
+                "Broadcast side must be 'left' or 'right'\n"
                 "  found :    {0}\n"
-                .format(self.num_keys))
+                .format(self.broadcast))
         self.output_type = self.compute_output_type()
 
     def compute_output_type(self):
@@ -495,8 +634,14 @@ class Join(BinaryRDD):
 
         return make_tuple((key_type) + left_payload + right_payload)
 
+    def self_hash(self):
+        hash_objects = [str(self.num_keys), str(self.broadcast)]
+        return hash("#".join(hash_objects))
+
     def self_write_dag(self, dic):
         dic['num_keys'] = self.num_keys
+        if self.broadcast is not None:
+            dic['broadcast'] = self.broadcast
 
 
 class TopK(UnaryRDD):
@@ -535,15 +680,64 @@ class Sort(UnaryRDD):
         pass
 
 
+class Distinct(UnaryRDD):
+    NAME = 'distinct'
+
+    """
+    removes duplicate tuples, comparing all fields, which must be atomic
+    the order of the result tuples is arbitrary
+    """
+
+    def __init__(self, context, parent):
+        super().__init__(context, parent)
+        self.output_type = self.parents[0].output_type
+
+    def self_hash(self):
+        hash_objects = [str(self.output_type)]
+        return hash("#".join(hash_objects))
+
+    def self_write_dag(self, dic):
+        pass
+
+
+class ApproxCountDistinct(UnaryRDD):
+    NAME = 'approx_count_distinct'
+
+    """
+    estimates the number of distinct tuples with a HyperLogLog sketch of
+    2^precision registers; the relative standard error of the estimate is
+    about 1.04 / sqrt(2^precision)
+    """
+
+    def __init__(self, context, parent, precision):
+        super().__init__(context, parent)
+        self.output_type = types.int64
+        self.precision = precision
+        if not 4 <= self.precision <= 18:
+            raise TypeError(
+                "ApproxCountDistinct takes a precision between 4 and 18.\n"
+                "  found :    {0}\n"
+                .format(self.precision))
+
+    def self_hash(self):
+        hash_objects = [str(self.output_type), str(self.precision)]
+        return hash("#".join(hash_objects))
+
+    def self_write_dag(self, dic):
+        dic['precision'] = self.precision
+
+
 class AntiJoin(BinaryRDD):
     NAME = 'antijoin'
 
     """
-    the first element in a tuple is the key
+    the first num_keys elements in a tuple are the key
     """
 
-    def __init__(self, context, left, right):
+    def __init__(self, context, left, right, num_keys=1):
         super().__init__(context, [left, right])
+        self.num_keys = num_keys
+        check_num_keys(self.num_keys)
         self.output_type = self.compute_output_type()
 
     def compute_output_type(self):
@@ -554,33 +748,42 @@ class AntiJoin(BinaryRDD):
         if not isinstance(right_type, types.Tuple):
             right_type = make_tuple([right_type])
 
-        if str(left_type[0]) != str(right_type[0]):
+        if min(len(left_type), len(right_type)) < self.num_keys:
             raise TypeError(
-                "AntiJoin keys must be of matching type.\n"
-                "  found left:    {0}\n"
-                "  found right:   {1}"
-                .format(left_type[0], right_type[0]))
+                "Number of keys cannot be bigger than \n"
+                "number of tuple elements found: \n"
+                "tuple elements: {0}, number of keys: {1}\n"
+                .format(min(len(left_type), len(right_type)), self.num_keys))
+
+        for pos in range(self.num_keys):
+            if str(left_type[pos]) != str(right_type[pos]):
+                raise TypeError(
+                    "AntiJoin keys must be of matching type.\n"
+                    "  found left:    {0}\n"
+                    "  found right:   {1}"
+                    .format(left_type[pos], right_type[pos]))
 
         # Special case: two scalar inputs produce a scalar output
         if not isinstance(self.parents[0].output_type, types.Tuple) and \
                 not isinstance(self.parents[1].output_type, types.Tuple):
             return self.parents[0].output_type
 
-        # Common case: concatenate tuples
-        key_type = left_type[0]
-        left_payload = left_type.types[1:]
+        # Common case: the output has the type of the left input
+        return make_tuple(left_type.types)
 
-        return make_tuple((key_type,) + left_payload)
+    def self_hash(self):
+        return hash(str(self.num_keys))
 
     def self_write_dag(self, dic):
-        pass
+        if self.num_keys != 1:
+            dic['num_keys'] = self.num_keys
 
 
 class AntiJoinPredicated(AntiJoin):
     NAME = 'antijoin_predicated'
 
-    def __init__(self, context, left, right, func):
-        super().__init__(context, left, right)
+    def __init__(self, context, left, right, func, num_keys=1):
+        super().__init__(context, left, right, num_keys)
         self.func = func
         left_type = self.parents[0].output_type
         right_type = self.parents[1].output_type
@@ -593,6 +796,7 @@ class AntiJoinPredicated(AntiJoin):
                 "  found:    {1}".format("bool", return_type))
 
     def self_write_dag(self, dic):
+        super().self_write_dag(dic)
         dic['func'] = self.llvm_ir
 
 
@@ -600,11 +804,13 @@ class SemiJoin(BinaryRDD):
     NAME = 'semijoin'
 
     """
-    the first element in a tuple is the key
+    the first num_keys elements in a tuple are the key
     """
 
-    def __init__(self, context, left, right):
+    def __init__(self, context, left, right, num_keys=1):
         super().__init__(context, [left, right])
+        self.num_keys = num_keys
+        check_num_keys(self.num_keys)
         self.output_type = self.compute_output_type()
 
     def compute_output_type(self):
@@ -615,26 +821,35 @@ class SemiJoin(BinaryRDD):
         if not isinstance(right_type, types.Tuple):
             right_type = make_tuple([right_type])
 
-        if str(left_type[0]) != str(right_type[0]):
+        if min(len(left_type), len(right_type)) < self.num_keys:
             raise TypeError(
-                "SemiJoin keys must be of matching type.\n"
-                "  found left:    {0}\n"
-                "  found right:   {1}"
-                .format(left_type[0], right_type[0]))
+                "Number of keys cannot be bigger than \n"
+                "number of tuple elements found: \n"
+                "tuple elements: {0}, number of keys: {1}\n"
+                .format(min(len(left_type), len(right_type)), self.num_keys))
+
+        for pos in range(self.num_keys):
+            if str(left_type[pos]) != str(right_type[pos]):
+                raise TypeError(
+                    "SemiJoin keys must be of matching type.\n"
+                    "  found left:    {0}\n"
+                    "  found right:   {1}"
+                    .format(left_type[pos], right_type[pos]))
 
         # Special case: two scalar inputs produce a scalar output
         if not isinstance(self.parents[0].output_type, types.Tuple) and \
                 not isinstance(self.parents[1].output_type, types.Tuple):
             return self.parents[0].output_type
 
-        # Common case: concatenate tuples
-        key_type = left_type[0]
-        left_payload = left_type.types[1:]
+        # Common case: the output has the type of the left input
+        return make_tuple(left_type.types)
 
-        return make_tuple((key_type,) + left_payload)
+    def self_hash(self):
+        return hash(str(self.num_keys))
 
     def self_write_dag(self, dic):
-        pass
+        if self.num_keys != 1:
+            dic['num_keys'] = self.num_keys
 
 
 class Cartesian(BinaryRDD):
@@ -732,16 +947,27 @@ class ReduceByKey(UnaryRDD):
     binary function must be commutative and associative
     the return value type should be the same as its arguments minus the key
     the input cannot be empty
+    the first num_keys elements in a tuple are the key
+    key_range is an optional pair (min, max) bounding all keys (inclusive),
+    which allows the optimizer to aggregate into a dense array (only for
+    single-field keys)
     """
 
-    def __init__(self, context, parent, func):
+    def __init__(self, context, parent, func, key_range=None, num_keys=1):
+        # pylint: disable=too-many-arguments
         super().__init__(context, parent)
         self.func = func
+        self.num_keys = num_keys
+        check_num_keys(self.num_keys)
+        if key_range is not None and self.num_keys != 1:
+            raise ValueError("Key ranges require single-field keys")
+        self.key_range = None if key_range is None else \
+            (int(key_range[0]), int(key_range[1]))
         input_type = self.parents[0].output_type
 
         if isinstance(input_type, types.Tuple):
             child_types = input_type.types
-            aggregate_type = make_tuple(child_types[1:])
+            aggregate_type = make_tuple(child_types[self.num_keys:])
             aggregate_tuple = aggregate_type
 
         elif isinstance(input_type, types.Record):
@@ -750,9 +976,10 @@ class ReduceByKey(UnaryRDD):
             dtypes = [t[0] for t in input_type.dtype.fields.values()]
 
             field_types = [numba.from_dtype(t) for t in dtypes]
-            aggregate_tuple = make_tuple(field_types[1:])
+            aggregate_tuple = make_tuple(field_types[self.num_keys:])
 
-            aggregate_type = make_record(aggregate_tuple, names[1:])
+            aggregate_type = make_record(aggregate_tuple,
+                                         names[self.num_keys:])
 
         else:
             assert False, "unexpected input type: {}".format(str(input_type))
@@ -774,10 +1001,15 @@ class ReduceByKey(UnaryRDD):
     def self_hash(self):
         file_ = io.StringIO()
         dis.dis(self.func, file=file_)
+        file_.write("#{}#{}".format(self.key_range, self.num_keys))
         return hash(file_.getvalue())
 
     def self_write_dag(self, dic):
         dic['func'] = self.llvm_ir
+        if self.key_range is not None:
+            dic['key_range'] = list(self.key_range)
+        if self.num_keys != 1:
+            dic['num_keys'] = self.num_keys
 
 
 class ReduceByIndex(UnaryRDD):
@@ -819,6 +1051,86 @@ class ReduceByIndex(UnaryRDD):
         dic['max'] = self.max_idx
 
 
+class Window(UnaryRDD):
+    NAME = 'window'
+
+    """
+    appends to each tuple the aggregate of the fields after the key over its
+    window frame, i.e., over the last frame_size tuples with the same key up
+    to and including itself, or over all of them if frame_size is None
+    binary function must be associative (but not necessarily commutative)
+    the return value type should be the same as its arguments minus the key
+    the first num_keys elements in a tuple are the key, which partitions the
+    input; frames follow the order of the input, so the input should be
+    sorted or at least grouped on the key
+    """
+
+    def __init__(self, context, parent, func, frame_size=None, num_keys=0):
+        # pylint: disable=too-many-arguments
+        super().__init__(context, parent)
+        self.func = func
+        self.frame_size = frame_size
+        self.num_keys = num_keys
+        if self.num_keys < 0:
+            raise TypeError(
+                "Number of keys cannot be negative \n"
+                "  found :    {0}\n"
+                .format(self.num_keys))
+        if self.frame_size is not None and self.frame_size <= 0:
+            raise TypeError(
+                "Frame size must be positive or None \n"
+                "  found :    {0}\n"
+                .format(self.frame_size))
+        input_type = self.parents[0].output_type
+
+        if isinstance(input_type, types.Tuple):
+            field_types = list(input_type.types)
+
+        elif isinstance(input_type, types.Record):
+            dtypes = [t[0] for t in input_type.dtype.fields.values()]
+            field_types = [numba.from_dtype(t) for t in dtypes]
+
+        else:
+            assert str(input_type) in C_TYPE_MAP
+            field_types = [input_type]
+
+        if self.num_keys >= len(field_types):
+            raise TypeError(
+                "Window needs at least one field besides the key\n"
+                "  found :    {0}\n"
+                .format(input_type))
+
+        aggregate_type = make_tuple(field_types[self.num_keys:])
+        aggregate_tuple = aggregate_type
+        if len(aggregate_tuple) == 1:
+            aggregate_type = aggregate_tuple.types[0]
+            aggregate_tuple = aggregate_tuple.types[0]
+
+        self.llvm_ir, output_type = get_llvm_ir_and_output_type(
+            func, [aggregate_type, aggregate_type])
+
+        if str(aggregate_tuple) != str(output_type):
+            raise BaseException(
+                "Function given to window has the wrong return type:\n"
+                "  expected: {0}\n"
+                "  found:    {1}".format(aggregate_type, output_type))
+        self.output_type = make_tuple(field_types +
+                                      field_types[self.num_keys:])
+
+    def self_hash(self):
+        file_ = io.StringIO()
+        dis.dis(self.func, file=file_)
+        file_.write("#{}#{}".format(self.frame_size, self.num_keys))
+        return hash(file_.getvalue())
+
+    def self_write_dag(self, dic):
+        dic['func'] = self.llvm_ir
+        if self.frame_size is not None:
+            dic['frame_size'] = self.frame_size
+        if self.num_keys != 0:
+            dic['num_keys'] = self.num_keys
+
+
 class CSVSource(SourceRDD):
     NAME = 'csv_source'
 
@@ -1119,6 +1431,33 @@ class ExpandPattern(BinaryRDD):
         dic["output_type"] = self.output_type
 
 
+class CsvScan(UnaryRDD):
+    NAME = 'csv_scan'
+
+    def __init__(self, context, parent, columns, filesystem, delimiter=',',
+                 quote='"', header=False):
+        super().__init__(context, parent)
+        self.columns = [{'idx': col[0]} for col in columns]
+        self.output_type = make_tuple(
+            [types.Array(col[1], 1, "C") for col in columns])
+        self.filesystem = filesystem
+        self.delimiter = delimiter
+        self.quote = quote
+        self.header = header
+
+    def self_hash(self):
+        hash_values = [str(self.columns), self.filesystem, self.delimiter,
+                       self.quote, str(self.header)]
+        return hash("#".join(hash_values))
+
+    def self_write_dag(self, dic):
+        dic['columns'] = self.columns
+        dic['filesystem'] = self.filesystem
+        dic['delimiter'] = self.delimiter
+        dic['quote'] = self.quote
+        dic['header'] = self.header
+
+
 class ParquetScan(UnaryRDD):
     NAME = 'parquet_scan'
 
@@ -14,12 +14,15 @@ import sys
 from cffi import FFI
 import numpy as np
 from numpy.testing import assert_array_equal
+import jsonmerge
 import numba
 import pandas as pd
 import pyarrow as pa
 import pyarrow.parquet as pq
 import pytest
 
+from jitq import backend
+
 
 class TestCollection:
 
@@ -207,6 +210,14 @@ class TestRange:
         res = jitq_context.range_(10, 20, 2).collect()
         assert sorted(res.astuples()) == list(range(10, 20, 2))
 
+    def test_negative_step(self, jitq_context):
+        res = jitq_context.range_(20, 3, -3).collect()
+        assert sorted(res.astuples()) == sorted(range(20, 3, -3))
+
+    def test_many_morsels(self, jitq_context):
+        res = jitq_context.range_(0, 1000003, 3).reduce(lambda i1, i2: i1 + i2)
+        assert res == sum(range(0, 1000003, 3))
+
     def test_float(self, jitq_context):
         res = jitq_context.range_(10.5, 20.0, 2.0).collect()
         assert sorted(res.astuples()) == list(np.arange(10.5, 20.0, 2.0))
@@ -381,6 +392,49 @@ class TestParquet:
         assert [] == sorted(res)
 
 
+class TestCsv:
+
+    @pytest.fixture(autouse=True)
+    def csv_files(self, filesystem_instance):
+        data = 'a,b,name,d\n' \
+            '1,1,"x, y",1.5\n' \
+            '1,2,"multi\nline",2.5\n' \
+            '2,1,"""quoted""",3.5\n'
+
+        for i in range(3):
+            filename = 'test-{:05d}.csv'.format(i)
+            with open(filesystem_instance.to_local(filename), 'w') as file:
+                file.write(data)
+            filesystem_instance.copy_to_remote(filename)
+
+        yield filesystem_instance
+
+        for i in range(3):
+            filename = 'test-{:05d}.csv'.format(i)
+            filesystem_instance.remove_from_remote(filename)
+
+    def test_single_file(self, jitq_context, csv_files):
+        filename = 'test-00000.csv'
+        cols = [(0, numba.int64), (3, numba.float64)]
+
+        res = jitq_context \
+            .read_csv(csv_files.to_remote(filename), cols, header=True) \
+            .collect()
+        truth = [(1, 1.5), (1, 2.5), (2, 3.5)]
+        assert list(res.astuples()) == truth
+
+    def test_multiple_files(self, jitq_context, csv_files):
+        file_pattern = 'test-%1$05d.csv'
+        cols = [(1, numba.int32), (0, numba.float32)]
+
+        res = jitq_context \
+            .read_csv(csv_files.to_remote(file_pattern), cols, header=True,
+                      pattern_range=(0, 3)) \
+            .collect()
+        truth = [(1, 1.0), (2, 1.0), (1, 2.0)] * 3
+        assert list(res.astuples()) == truth
+
+
 class TestJoin:
 
     def test_scalars(self, jitq_context):
@@ -451,6 +505,24 @@ class TestJoin:
         truth = [(r, r * 10) for r in range(5, 10)]
         assert sorted(res.astuples()) == truth
 
+    def test_broadcast(self, jitq_context):
+        input_1 = [(r, r * 10) for r in range(10)]
+        input_2 = [(r % 10, r) for r in range(100)]
+        truth = sorted([(r % 10, (r % 10) * 10, r) for r in range(100)])
+
+        for side in ['left', 'right']:
+            data1 = jitq_context.collection(input_1)
+            data2 = jitq_context.collection(input_2)
+            res = data1.join(data2, broadcast=side).collect()
+            assert sorted(res.astuples()) == truth
+
+    def test_invalid_broadcast(self, jitq_context):
+        data1 = jitq_context.collection(range(10))
+        data2 = jitq_context.collection(range(10))
+
+        with pytest.raises(ValueError):
+            data1.join(data2, broadcast='both')
+
     def test_repeated_keys(self, jitq_context):
         input_1 = [(1, 2), (1, 3), (2, 4), (3, 5), (2, 6)]
         input_2 = [(1, 22, 33), (1, 44, 55), (8, 66, 77), (2, 33, 44)]
@@ -595,6 +667,16 @@ class TestAntiJoin:
         truth = [(1, 11), (3, 13)]
         assert sorted(res.astuples()) == truth
 
+    def test_multiple_positions(self, jitq_context, predicate):
+        input_1 = [(1, 2, 5), (1, 3, 80), (2, 4, 50), (3, 5, 75), (2, 6, 23)]
+        input_2 = [(1, 3, 33), (2, 6, 55), (8, 66, 77), (2, 1, 44)]
+        data1 = jitq_context.collection(input_1)
+        data2 = jitq_context.collection(input_2)
+
+        res = data1.antijoin(data2, predicate, num_keys=2).collect()
+        truth = [(1, 2, 5), (2, 4, 50), (3, 5, 75)]
+        assert sorted(res.astuples()) == truth
+
 
 class TestAntiJoinPredicated:
     def test_predicate(self, jitq_context):
@@ -698,6 +780,16 @@ class TestSemiJoin:
         truth = [(0, 0), (2, 2), (4, 4), (6, 6), (8, 8)]
         assert sorted(res.astuples()) == truth
 
+    def test_multiple_positions(self, jitq_context):
+        input_1 = [(1, 2, 5), (1, 3, 80), (2, 4, 50), (3, 5, 75), (2, 6, 23)]
+        input_2 = [(1, 3, 33), (2, 6, 55), (8, 66, 77), (3, 2, 44)]
+        data1 = jitq_context.collection(input_1)
+        data2 = jitq_context.collection(input_2)
+
+        res = data1.semijoin(data2, num_keys=2).collect()
+        truth = [(1, 3, 80), (2, 6, 23)]
+        assert sorted(res.astuples()) == truth
+
 
 class TestFilter:
 
@@ -848,6 +940,43 @@ class TestMap:
         assert res == 10
 
 
+class TestFlatMap:
+
+    def test_scalar_to_scalar(self, jitq_context):
+        def func(i):
+            for j in range(i):
+                yield j
+
+        res = jitq_context.range_(0, 10).flat_map(func).collect()
+        truth = [j for i in range(0, 10) for j in range(i)]
+        assert sorted(res.astuples()) == sorted(truth)
+
+    def test_tuple_to_tuple(self, jitq_context):
+        def func(t):
+            for j in range(t[1]):
+                yield (t[0], j * 1.5)
+
+        input_ = [(i, i % 4) for i in range(0, 100)]
+        res = jitq_context.collection(input_).flat_map(func).collect()
+        truth = [(t[0], j * 1.5) for t in input_ for j in range(t[1])]
+        assert sorted(res.astuples()) == sorted(truth)
+
+    def test_pipeline(self, jitq_context):
+        def func(i):
+            yield i
+            if i % 2 == 0:
+                yield -i
+
+        res = jitq_context.range_(0, 1000) \
+            .filter(lambda i: i % 3 == 0) \
+            .flat_map(func) \
+            .map(lambda i: i * 2) \
+            .reduce(lambda i1, i2: i1 + i2)
+        truth = sum(2 * j for i in range(0, 1000) if i % 3 == 0
+                    for j in ([i, -i] if i % 2 == 0 else [i]))
+        assert res == truth
+
+
 class TestReduce:
 
     def test_sum(self, jitq_context):
@@ -915,6 +1044,23 @@ class TestReduceByKey:
         truth = {(-100, 2), (-5, -1), (100, 3)}
         assert set(data.astuples()) == truth
 
+    def test_basic_key_range(self, jitq_context):
+        input_ = [(-3, 1), (4, 1), (4, 1), (-3, 1), (4, 1), (0, -1)]
+        data = jitq_context.collection(input_) \
+            .reduce_by_key(lambda tuple_1, tuple_2: tuple_1 + tuple_2,
+                           key_range=(-3, 4)) \
+            .collect()
+        truth = {(-3, 2), (0, -1), (4, 3)}
+        assert set(data.astuples()) == truth
+
+    def test_bool_key(self, jitq_context):
+        data = jitq_context.range_(0, 10) \
+            .map(lambda i: (i % 3 == 0, i)) \
+            .reduce_by_key(lambda i1, i2: i1 + i2) \
+            .collect()
+        truth = {(True, 18), (False, 27)}
+        assert set(data.astuples()) == truth
+
     def test_tuple(self, jitq_context):
         input_ = [(0, 1, 2), (1, 1, 2), (1, 1, 2), (0, 1, 2), (1, 1, 2)]
         data = jitq_context.collection(input_) \
@@ -925,6 +1071,14 @@ class TestReduceByKey:
         truth = [(0, 2, 4), (1, 3, 6)]
         assert sorted(data.astuples()) == sorted(truth)
 
+    def test_multiple_keys(self, jitq_context):
+        input_ = [(0, 1, 2), (1, 0, 3), (1, 0, 4), (0, 1, 5), (1, 1, 6)]
+        data = jitq_context.collection(input_) \
+            .reduce_by_key(lambda i1, i2: i1 + i2, num_keys=2) \
+            .collect()
+        truth = {(0, 1, 7), (1, 0, 7), (1, 1, 6)}
+        assert set(data.astuples()) == truth
+
     def test_record1(self, jitq_context):
         dtype = [('x', 'i8'), ('y', 'i8')]
         input_ = np.array([(1, 2)], dtype=dtype)
@@ -1051,6 +1205,164 @@ class TestSort:
         assert list(res.astuples()) == sorted(input_)
 
 
+class TestDistinct:
+
+    def test_scalar(self, jitq_context):
+        input_ = [5, 7, 5, 600, 7, 5]
+        data = jitq_context.collection(input_)
+
+        res = data.distinct().collect()
+        assert sorted(res.astuples()) == sorted(set(input_))
+
+    def test_tuple(self, jitq_context):
+        input_ = [(1, 2), (1, 3), (2, 1), (1, 2), (2, 1)]
+        data = jitq_context.collection(input_)
+
+        res = data.distinct().collect()
+        assert sorted(res.astuples()) == sorted(set(input_))
+
+    def test_sorted(self, jitq_context):
+        input_ = [(3, 1), (1, 2), (3, 2), (1, 2), (3, 1), (2, 5)]
+        data = jitq_context.collection(input_)
+
+        res = data.sort().distinct().collect()
+        assert sorted(res.astuples()) == sorted(set(input_))
+
+    def test_large(self, jitq_context):
+        res = jitq_context.range_(0, 10000) \
+            .map(lambda i: (i % 100, i % 7)) \
+            .distinct() \
+            .collect()
+        truth = {(i % 100, i % 7) for i in range(10000)}
+        assert sorted(res.astuples()) == sorted(truth)
+
+    def test_empty(self, jitq_context):
+        res = jitq_context.range_(0, 0).distinct().count()
+        assert res == 0
+
+    def test_count_distinct(self, jitq_context):
+        res = jitq_context.range_(0, 1000) \
+            .map(lambda i: i % 37) \
+            .count_distinct()
+        assert res == 37
+
+    def test_approx_count_distinct(self, jitq_context):
+        res = jitq_context.range_(0, 100000) \
+            .map(lambda i: (i % 20000, i % 2)) \
+            .approx_count_distinct()
+        assert abs(res - 20000) < 20000 * 0.05
+
+    def test_approx_count_distinct_small(self, jitq_context):
+        res = jitq_context.collection([5, 7, 5, 600, 7, 5]) \
+            .approx_count_distinct(precision=8)
+        assert res == 3
+
+    def test_approx_count_distinct_empty(self, jitq_context):
+        res = jitq_context.range_(0, 0).approx_count_distinct()
+        assert res == 0
+
+
+class TestWindow:
+
+    def test_running(self, jitq_context):
+        input_ = [5, 3, 8, 1, 9, 2]
+        data = jitq_context.collection(input_)
+
+        res = data.sort().window(lambda a, b: a + b).collect()
+        sorted_input = sorted(input_)
+        truth = [(x, sum(sorted_input[:i + 1]))
+                 for i, x in enumerate(sorted_input)]
+        assert list(res.astuples()) == truth
+
+    def test_sliding(self, jitq_context):
+        input_ = [5, 3, 8, 1, 9, 2, 7]
+        data = jitq_context.collection(input_)
+
+        res = data.sort().window(lambda a, b: a + b, frame_size=3).collect()
+        sorted_input = sorted(input_)
+        truth = [(x, sum(sorted_input[max(0, i - 2):i + 1]))
+                 for i, x in enumerate(sorted_input)]
+        assert list(res.astuples()) == truth
+
+    def test_non_commutative(self, jitq_context):
+        input_ = [5, 3, 8, 1, 9, 2, 7]
+        data = jitq_context.collection(input_)
+
+        # Returns the first value of each frame, i.e., lags by two tuples
+        res = data.sort().window(lambda a, b: a, frame_size=3).collect()
+        sorted_input = sorted(input_)
+        truth = [(x, sorted_input[max(0, i - 2)])
+                 for i, x in enumerate(sorted_input)]
+        assert list(res.astuples()) == truth
+
+    def test_filter_after_window(self, jitq_context):
+        input_ = [5, 3, 8, 1, 9, 2, 7]
+        data = jitq_context.collection(input_)
+
+        # The filter must not be moved below the window
+        res = data.sort().window(lambda a, b: a + b) \
+            .filter(lambda t: t[0] > 4).collect()
+        sorted_input = sorted(input_)
+        truth = [(x, sum(sorted_input[:i + 1]))
+                 for i, x in enumerate(sorted_input) if x > 4]
+        assert list(res.astuples()) == truth
+
+    def test_partitioned(self, jitq_context):
+        input_ = [(i, i % 3, i * i) for i in range(20)]
+        data = jitq_context.collection(input_)
+
+        res = data.sort() \
+            .map(lambda t: (t[1], t[2])) \
+            .window(lambda a, b: a + b, frame_size=2, num_keys=1) \
+            .collect()
+
+        truth = []
+        previous = {}
+        for _, k, v in input_:
+            truth.append((k, v, v + previous.get(k, 0)))
+            previous[k] = v
+        assert list(res.astuples()) == truth
+
+    def test_grouped(self, jitq_context):
+        input_ = [3, 1, 3, 2, 3, 1]
+        data = jitq_context.collection(input_)
+
+        res = data.map(lambda x: (x, 1)).sort() \
+            .window(lambda a, b: a + b, num_keys=1) \
+            .collect()
+
+        truth = [(k, 1, i + 1) for k, g in groupby(sorted(input_))
+                 for i, _ in enumerate(g)]
+        assert sorted(res.astuples()) == truth
+
+    def test_moving_average(self, jitq_context):
+        input_ = [(i, i % 2, float(i)) for i in range(10)]
+        data = jitq_context.collection(input_)
+
+        res = data.sort() \
+            .map(lambda t: (t[1], t[2], 1)) \
+            .window(lambda a, b: (a[0] + b[0], a[1] + b[1]),
+                    frame_size=3, num_keys=1) \
+            .map(lambda t: (t[0], t[1], t[3] / t[4])) \
+            .collect()
+
+        truth = []
+        history = {}
+        for _, k, v in input_:
+            frame = (history.get(k, []) + [v])[-3:]
+            history[k] = frame
+            truth.append((k, v, sum(frame) / len(frame)))
+        assert list(res.astuples()) == truth
+
+    def test_invalid_arguments(self, jitq_context):
+        data = jitq_context.collection([(1, 2)])
+
+        with pytest.raises(TypeError):
+            data.window(lambda a, b: a + b, frame_size=0)
+        with pytest.raises(TypeError):
+            data.window(lambda a, b: a + b, num_keys=2)
+
+
 class TestCartesian:
 
     def test_count(self, jitq_context):
@@ -1210,6 +1522,248 @@ class TestCache:
         # TODO(sabir): test cases for the caching mechanism of all operators
 
 
+class TestResultCache:
+
+    def test_tuples(self, jitq_context):
+        cached = jitq_context.range_(0, 1000) \
+            .map(lambda i: (i % 10, i * 0.5)) \
+            .cache()
+        for _ in range(2):
+            res = cached.reduce_by_key(lambda v1, v2: v1 + v2).collect()
+            truth = [(k, sum(i * 0.5 for i in range(k, 1000, 10)))
+                     for k in range(10)]
+            assert sorted(res.astuples()) == truth
+            assert cached.count() == 1000
+
+    def test_scalars(self, jitq_context):
+        cached = jitq_context.range_(0, 100) \
+            .filter(lambda i: i % 3 == 0) \
+            .cache()
+        for _ in range(2):
+            res = cached.map(lambda i: i + 1).collect()
+            assert sorted(res.astuples()) == list(range(1, 100, 3))
+
+    def test_nested(self, jitq_context):
+        inner = jitq_context.range_(0, 100).map(lambda i: (i, i)).cache()
+        outer = inner.filter(lambda t: t[0] % 2 == 0).cache()
+        for _ in range(2):
+            assert outer.count() == 50
+            assert inner.join(outer).count() == 50
+
+    def test_evicted(self, jitq_context):
+        # Results that do not fit into the budget are dropped
+        backend.ConfigureResultCache(0, '')
+        try:
+            cached = jitq_context.range_(0, 100) \
+                .map(lambda i: (i, 2 * i)) \
+                .cache()
+            for _ in range(2):
+                assert cached.map(lambda t: t[1]).reduce(
+                    lambda v1, v2: v1 + v2) == 9900
+        finally:
+            backend.ConfigureResultCache(1 << 32, '')
+
+
+# Settings of optimizations that must not change any result, by name
+OPTIMIZATION_VARIANTS = {
+    # Partitions morsels with a histogram pass instead of chained blocks
+    'two-pass-partitioning': {
+        'parallelize': {'two-pass-partitioning': True},
+    },
+    # Splits join partitions with heavy hitters into several work units
+    'split-skewed-partitions': {
+        'parallelize': {'split-skewed-partitions': True},
+    },
+    # Probes one hash index of the left join input shared by all workers
+    'shared-hash-join': {
+        'parallelize': {'shared-hash-join': True},
+    },
+    # Filters probe sides of joins with Bloom filters of the build sides
+    'bloom-filter-join': {
+        'bloom-filter-join': {'active': True},
+    },
+    # Spills most partitions of hash-based operators to disk
+    'spilling': {
+        'code_gen': {'memory-budget': 1 << 10},
+    },
+    # Pins the workers and places partitions on their home nodes
+    'numa-aware': {
+        'code_gen': {'numa-aware': True},
+    },
+}
+
+
+@pytest.fixture(params=sorted(OPTIMIZATION_VARIANTS))
+def optimized_context(jitq_context, tmp_path, request):
+    # Merge into the existing settings to keep the ones of the environment
+    # config, e.g., for debugging
+    optimizer_conf = jitq_context.conf['optimizer']
+    optimizer_conf['optimizations'] = jsonmerge.merge(
+        optimizer_conf.get('optimizations', {}),
+        OPTIMIZATION_VARIANTS[request.param])
+    optimizer_conf['optimizations'] = jsonmerge.merge(
+        optimizer_conf['optimizations'],
+        {'code_gen': {'spill-directory': str(tmp_path)}})
+    return jitq_context
+
+
+def only_with(variant):
+    return pytest.mark.parametrize('optimized_context', [variant],
+                                   indirect=True)
+
+
+class TestOptimizationVariants:
+
+    def test_reduce_by_key(self, optimized_context):
+        res = optimized_context.range_(0, 10000) \
+            .map(lambda i: (i % 1000, i)) \
+            .reduce_by_key(lambda v1, v2: v1 + v2) \
+            .collect()
+        truth = [(k, sum(range(k, 10000, 1000))) for k in range(1000)]
+        assert sorted(res.astuples()) == truth
+
+    def test_join(self, optimized_context):
+        input_1 = [(i % 500, i) for i in range(2000)]
+        input_2 = [(i % 700, -i) for i in range(1400)]
+
+        data1 = optimized_context.collection(input_1)
+        data2 = optimized_context.collection(input_2)
+        res = data1.join(data2).collect()
+        truth = [(k1, v1, v2) for (k1, v1) in input_1
+                 for (k2, v2) in input_2 if k1 == k2]
+        assert sorted(res.astuples()) == sorted(truth)
+
+    @only_with('split-skewed-partitions')
+    def test_join_with_heavy_hitter(self, optimized_context):
+        input_1 = [(0, i) for i in range(20000)] + \
+            [(i, i) for i in range(1, 1000)]
+        input_2 = [(0, -1), (0, -2)] + [(i, -i) for i in range(1, 700)]
+
+        data1 = optimized_context.collection(input_1)
+        data2 = optimized_context.collection(input_2)
+        res = data1.join(data2).collect()
+        truth = [(k1, v1, v2) for (k1, v1) in input_1
+                 for (k2, v2) in input_2 if k1 == k2]
+        assert sorted(res.astuples()) == sorted(truth)
+
+    @only_with('shared-hash-join')
+    def test_join_with_filtered_probe_side(self, optimized_context):
+        input_1 = [(i, i * i) for i in range(1000)]
+
+        data1 = optimized_context.collection(input_1)
+        data2 = optimized_context.range_(0, 10000) \
+            .filter(lambda i: i % 3 == 0) \
+            .map(lambda i: (i % 1000, i))
+        res = data1.join(data2).collect()
+        truth = [(i % 1000, (i % 1000) ** 2, i)
+                 for i in range(0, 10000, 3)]
+        assert sorted(res.astuples()) == sorted(truth)
+
+    @only_with('bloom-filter-join')
+    def test_join_with_mapped_probe_side(self, optimized_context):
+        input_1 = [(i * 7, i) for i in range(100)]
+        input_2 = list(range(2000))
+
+        data1 = optimized_context.collection(input_1)
+        data2 = optimized_context.collection(input_2) \
+            .filter(lambda i: i % 2 == 0) \
+            .map(lambda i: (i, -i))
+        res = data1.join(data2).collect()
+        truth = [(k, v1, -k) for (k, v1) in input_1 if k % 2 == 0]
+        assert sorted(res.astuples()) == truth
+
+    @only_with('bloom-filter-join')
+    def test_semijoin_after_reduce_by_key(self, optimized_context):
+        input_1 = [(i % 300, i) for i in range(3000)]
+        input_2 = [(i * 3, i) for i in range(50)]
+
+        data1 = optimized_context.collection(input_1) \
+            .reduce_by_key(lambda v1, v2: v1 + v2)
+        data2 = optimized_context.collection(input_2)
+        res = data1.semijoin(data2).collect()
+        truth = [(k, sum(range(k, 3000, 300))) for k in range(0, 150, 3)]
+        assert sorted(res.astuples()) == truth
+
+    @only_with('bloom-filter-join')
+    def test_window_on_probe_side(self, optimized_context):
+        input_1 = [(3, 0), (8, 0)]
+        input_2 = [5, 3, 8, 1, 9, 2, 7]
+
+        # The running sums depend on all tuples, so the probe side must not
+        # be filtered before the window
+        data1 = optimized_context.collection(input_1)
+        data2 = optimized_context.collection(input_2).sort() \
+            .window(lambda a, b: a + b)
+        res = data1.join(data2).collect()
+        sorted_input = sorted(input_2)
+        truth = [(x, 0, sum(sorted_input[:i + 1]))
+                 for i, x in enumerate(sorted_input) if x in (3, 8)]
+        assert sorted(res.astuples()) == truth
+
+    @only_with('bloom-filter-join')
+    def test_key_computed_by_reduce_by_key(self, optimized_context):
+        input_1 = [(i % 10, 1) for i in range(100)]
+        input_2 = [(10, 0)]
+
+        # The join key is an aggregate, so the tuples must not be filtered
+        # before the aggregation
+        data1 = optimized_context.collection(input_1) \
+            .reduce_by_key(lambda v1, v2: v1 + v2) \
+            .map(lambda t: (t[1], t[0]))
+        data2 = optimized_context.collection(input_2)
+        res = data1.semijoin(data2).collect()
+        truth = [(10, k) for k in range(10)]
+        assert sorted(res.astuples()) == truth
+
+    @only_with('spilling')
+    def test_semijoin(self, optimized_context):
+        input_1 = [(i, -i) for i in range(3000)]
+        input_2 = [(i * 3, i) for i in range(2000)]
+
+        data1 = optimized_context.collection(input_1)
+        data2 = optimized_context.collection(input_2)
+        res = data1.semijoin(data2).collect()
+        truth = [t for t in input_1 if t[0] % 3 == 0]
+        assert sorted(res.astuples()) == truth
+
+    @only_with('spilling')
+    def test_antijoin(self, optimized_context):
+        input_1 = [(i, -i) for i in range(3000)]
+        input_2 = [(i * 3, i) for i in range(2000)]
+
+        data1 = optimized_context.collection(input_1)
+        data2 = optimized_context.collection(input_2)
+        res = data1.antijoin(data2).collect()
+        truth = [t for t in input_1 if t[0] % 3 != 0]
+        assert sorted(res.astuples()) == truth
+
+
+class TestMemoryTracker:
+
+    def test_peak_bytes_of_last_query(self, jitq_context):
+        res = jitq_context.range_(0, 100000) \
+            .map(lambda i: (i, i)) \
+            .reduce_by_key(lambda v1, v2: v1 + v2) \
+            .count()
+        assert res == 100000
+
+        usage = jitq_context.memory_usage()
+        assert usage['last_query']['peak_bytes'] > 100000 * 16
+        assert usage['queries'] == []
+        assert usage['num_waiting'] == 0
+
+    def test_limit_exceeded(self, jitq_context):
+        backend.ConfigureMemoryTracker(1 << 20, 1.0)
+        try:
+            with pytest.raises(MemoryError):
+                jitq_context.range_(0, 1000000) \
+                    .map(lambda i: (i, i)) \
+                    .reduce_by_key(lambda v1, v2: v1 + v2) \
+                    .count()
+        finally:
+            backend.ConfigureMemoryTracker(0, 1.0)
+
+
 class TestSortedness:
 
     def test_index_grouped(self, jitq_context):